@@ -0,0 +1,766 @@
+/*
+    Copyright Sven Bergström 2014
+    created for snow https://github.com/underscorediscovery/snow
+    MIT license
+*/
+
+//Audio decode benchmark.
+//Times the asset audio code (load_info_*, read_bytes_* at a range of chunk sizes, seek_bytes_*)
+//over the sink test assets, reporting PCM throughput, per call latency percentiles and
+//allocations per call. It links snow_assets_audio.cpp against the stdio io layer below,
+//so there is no SDL, window or OpenAL involved.
+//
+//  snow-bench-audio [asset_path] [--json] [--iterations n] [--verbose]
+//
+//asset_path defaults to tests/features/0_sink/assets, run from the snow root.
+//--json writes one document to stdout, for comparing runs between versions.
+
+#include "assets/snow_assets_audio.h"
+#include "audio/snow_audio_convert.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+//allocation counting
+
+    //every allocation is counted, including libvorbis, where the allocator can be wrapped (glibc).
+    //elsewhere only c++ allocations are seen
+namespace {
+
+    std::atomic<size_t> bench_allocs(0);
+    std::atomic<size_t> bench_alloc_bytes(0);
+
+} //namespace
+
+#if defined(__GLIBC__)
+
+    extern "C" {
+
+        void* __libc_malloc(size_t size);
+        void* __libc_calloc(size_t count, size_t size);
+        void* __libc_realloc(void* ptr, size_t size);
+        void  __libc_free(void* ptr);
+
+        void* malloc(size_t size) {
+            bench_allocs.fetch_add(1, std::memory_order_relaxed);
+            bench_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+            return __libc_malloc(size);
+        }
+
+        void* calloc(size_t count, size_t size) {
+            bench_allocs.fetch_add(1, std::memory_order_relaxed);
+            bench_alloc_bytes.fetch_add(count * size, std::memory_order_relaxed);
+            return __libc_calloc(count, size);
+        }
+
+        void* realloc(void* ptr, size_t size) {
+            bench_allocs.fetch_add(1, std::memory_order_relaxed);
+            bench_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+            return __libc_realloc(ptr, size);
+        }
+
+        void free(void* ptr) {
+            __libc_free(ptr);
+        }
+
+    } //extern C
+
+        //operator new goes through malloc above, so it is already counted
+    #define SNOW_BENCH_COUNT_NEW 0
+
+#else
+
+    #define SNOW_BENCH_COUNT_NEW 1
+
+#endif //__GLIBC__
+
+void* operator new( size_t size ) {
+
+    #if SNOW_BENCH_COUNT_NEW
+        bench_allocs.fetch_add(1, std::memory_order_relaxed);
+        bench_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+    #endif
+
+    void* ptr = malloc(size ? size : 1);
+    if(!ptr) throw std::bad_alloc();
+
+    return ptr;
+
+} //operator new
+
+void* operator new[]( size_t size ) { return operator new(size); }
+void operator delete( void* ptr ) noexcept { free(ptr); }
+void operator delete[]( void* ptr ) noexcept { free(ptr); }
+void operator delete( void* ptr, size_t ) noexcept { free(ptr); }
+void operator delete[]( void* ptr, size_t ) noexcept { free(ptr); }
+
+//stdio io layer, the same as the empty platform without SDL
+
+namespace snow {
+
+    int log_level = 0;
+
+    void log(int _level, const char *fmt, ...) {
+
+        if(_level > log_level) return;
+
+        va_list ap;
+        va_start(ap, fmt);
+        vfprintf(stderr, fmt, ap);
+        va_end(ap);
+
+        fprintf(stderr, "\n");
+
+    } //log
+
+    namespace io {
+
+        iosrc* iosrc_from_file(const char *file, const char *mode) {
+            return fopen(file, mode);
+        } //iosrc_from_file
+
+            //memory sources are a stdio stream over a cursor, so resident and in memory
+            //assets decode through the same calls as files. glibc and the bsd libc can
+            //build one, elsewhere memory sources aren't available and those benchmarks skip
+        #if defined(__GLIBC__) || defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+            #define SNOW_BENCH_MEM_SOURCE 1
+        #else
+            #define SNOW_BENCH_MEM_SOURCE 0
+        #endif
+
+    #if SNOW_BENCH_MEM_SOURCE
+
+        struct iosrc_mem_cursor {
+
+            const unsigned char* data;
+                //null for read only memory
+            unsigned char* writable;
+            long length;
+            long position;
+
+        }; //iosrc_mem_cursor
+
+        static long iosrc_mem_read( iosrc_mem_cursor* cursor, char* dest, long size ) {
+
+            long count = std::min(size, cursor->length - cursor->position);
+            if(count <= 0) return 0;
+
+            memcpy(dest, cursor->data + cursor->position, count);
+            cursor->position += count;
+
+            return count;
+
+        } //iosrc_mem_read
+
+        static long iosrc_mem_write( iosrc_mem_cursor* cursor, const char* data, long size ) {
+
+            if(!cursor->writable) return 0;
+
+            long count = std::min(size, cursor->length - cursor->position);
+            if(count <= 0) return 0;
+
+            memcpy(cursor->writable + cursor->position, data, count);
+            cursor->position += count;
+
+            return count;
+
+        } //iosrc_mem_write
+
+        static long iosrc_mem_seek( iosrc_mem_cursor* cursor, long offset, int whence ) {
+
+            long base = 0;
+
+            switch(whence) {
+                case SEEK_SET: base = 0; break;
+                case SEEK_CUR: base = cursor->position; break;
+                case SEEK_END: base = cursor->length; break;
+                default: return -1;
+            }
+
+            if(base + offset < 0 || base + offset > cursor->length) return -1;
+
+            cursor->position = base + offset;
+
+            return cursor->position;
+
+        } //iosrc_mem_seek
+
+        static int iosrc_mem_close( void* cookie ) {
+
+            delete (iosrc_mem_cursor*)cookie;
+
+            return 0;
+
+        } //iosrc_mem_close
+
+        #if defined(__GLIBC__)
+
+            static ssize_t iosrc_mem_cookie_read( void* cookie, char* dest, size_t size ) {
+                return iosrc_mem_read((iosrc_mem_cursor*)cookie, dest, (long)size);
+            }
+
+            static ssize_t iosrc_mem_cookie_write( void* cookie, const char* data, size_t size ) {
+                return iosrc_mem_write((iosrc_mem_cursor*)cookie, data, (long)size);
+            }
+
+            static int iosrc_mem_cookie_seek( void* cookie, off64_t* offset, int whence ) {
+                long position = iosrc_mem_seek((iosrc_mem_cursor*)cookie, (long)*offset, whence);
+                if(position < 0) return -1;
+                *offset = position;
+                return 0;
+            }
+
+        #else
+
+            static int iosrc_mem_cookie_read( void* cookie, char* dest, int size ) {
+                return (int)iosrc_mem_read((iosrc_mem_cursor*)cookie, dest, size);
+            }
+
+            static int iosrc_mem_cookie_write( void* cookie, const char* data, int size ) {
+                return (int)iosrc_mem_write((iosrc_mem_cursor*)cookie, data, size);
+            }
+
+            static fpos_t iosrc_mem_cookie_seek( void* cookie, fpos_t offset, int whence ) {
+                return iosrc_mem_seek((iosrc_mem_cursor*)cookie, (long)offset, whence);
+            }
+
+        #endif
+
+        static iosrc* iosrc_mem_open( const void* mem, void* writable, int size ) {
+
+            if(!mem || size < 0) return NULL;
+
+            iosrc_mem_cursor* cursor = new iosrc_mem_cursor();
+
+                cursor->data = (const unsigned char*)mem;
+                cursor->writable = (unsigned char*)writable;
+                cursor->length = size;
+                cursor->position = 0;
+
+            FILE* file = NULL;
+
+            #if defined(__GLIBC__)
+                cookie_io_functions_t funcs = { iosrc_mem_cookie_read, iosrc_mem_cookie_write, iosrc_mem_cookie_seek, iosrc_mem_close };
+                file = fopencookie(cursor, writable ? "r+" : "r", funcs);
+            #else
+                file = funopen(cursor, iosrc_mem_cookie_read, writable ? iosrc_mem_cookie_write : NULL, iosrc_mem_cookie_seek, iosrc_mem_close);
+            #endif
+
+            if(!file) {
+                iosrc_mem_close(cursor);
+            }
+
+            return file;
+
+        } //iosrc_mem_open
+
+    #else
+
+        static iosrc* iosrc_mem_open( const void*, void*, int ) {
+            return NULL;
+        } //iosrc_mem_open
+
+    #endif //SNOW_BENCH_MEM_SOURCE
+
+        iosrc* iosrc_from_mem(void *mem, int size) {
+            return iosrc_mem_open(mem, mem, size);
+        } //iosrc_from_mem
+
+        iosrc* iosrc_from_const_mem(const void *mem, int size) {
+            return iosrc_mem_open(mem, NULL, size);
+        } //iosrc_from_const_mem
+
+        iosrc* iosrc_from_fp(FILE * fp, bool /*autoclose*/) {
+            return fp;
+        } //iosrc_from_fp
+
+        size_t read(iosrc* src, void* dest, size_t size, size_t maxnum) {
+            return fread(dest, size, maxnum, src);
+        } //read
+
+        size_t write(iosrc* src, const void* data, size_t size, size_t num) {
+            return fwrite(data, size, num, src);
+        } //write
+
+        size_t seek(iosrc* src, long int offset, int whence) {
+            return fseek(src, offset, whence);
+        } //seek
+
+        long int tell(iosrc* src) {
+            return ftell(src);
+        } //tell
+
+        long int close(iosrc* src) {
+            return fclose(src);
+        } //close
+
+            //files are always read through stdio here, so parsing cost is measured
+        bool map_file(const char* /*file*/, iomap& /*map*/) {
+            return false;
+        } //map_file
+
+        void unmap_file(iomap& /*map*/) {
+        } //unmap_file
+
+    } //io namespace
+
+} //snow namespace
+
+//benchmark
+
+namespace {
+
+    using namespace snow::assets::audio;
+
+    typedef std::chrono::high_resolution_clock bench_clock;
+
+    struct Bench_result {
+
+        std::string         name;
+        std::string         asset;
+            //the chunk size for reads, 0 otherwise
+        long                chunk;
+        long                calls;
+        double              pcm_bytes;
+        double              seconds;
+        size_t              allocs;
+        size_t              alloc_bytes;
+            //per call, in microseconds
+        std::vector<double> latencies;
+
+        Bench_result() : chunk(0), calls(0), pcm_bytes(0), seconds(0), allocs(0), alloc_bytes(0) {}
+
+    }; //Bench_result
+
+    std::vector<Bench_result> bench_results;
+    std::string bench_path = "tests/features/0_sink/assets";
+    int bench_iterations = 50;
+    bool bench_json = false;
+        //open oggs as resident files rather than through stdio
+    bool bench_resident = false;
+
+    const long bench_chunks[] = { 4096, 16384, 65536, 262144 };
+    const int bench_chunk_count = sizeof(bench_chunks) / sizeof(bench_chunks[0]);
+
+        //times one call, which returns the pcm bytes it produced
+    template<typename F>
+    inline void measure( Bench_result &result, F call ) {
+
+        size_t _allocs = bench_allocs.load(std::memory_order_relaxed);
+        size_t _bytes = bench_alloc_bytes.load(std::memory_order_relaxed);
+
+        bench_clock::time_point start = bench_clock::now();
+
+            long pcm = call();
+
+        bench_clock::time_point end = bench_clock::now();
+
+        result.allocs += bench_allocs.load(std::memory_order_relaxed) - _allocs;
+        result.alloc_bytes += bench_alloc_bytes.load(std::memory_order_relaxed) - _bytes;
+
+        double seconds = std::chrono::duration<double>(end - start).count();
+
+        result.seconds += seconds;
+        result.pcm_bytes += pcm;
+        result.latencies.push_back(seconds * 1e6);
+        result.calls++;
+
+    } //measure
+
+    Bench_result& begin( const char* name, const std::string &asset, long chunk = 0 ) {
+
+        bench_results.push_back(Bench_result());
+
+        Bench_result &result = bench_results.back();
+
+            result.name = name;
+            result.asset = asset;
+            result.chunk = chunk;
+            result.latencies.reserve(1 << 16);
+
+        return result;
+
+    } //begin
+
+    std::string asset_path( const std::string &asset ) {
+
+        return bench_path + "/" + asset;
+
+    } //asset_path
+
+        //a fixed sequence of seek targets, the same on every run and platform
+    long seek_target( unsigned int &state, long frames, long frame_bytes ) {
+
+        state = state * 1664525u + 1013904223u;
+
+        return frames > 0 ? (long)((state >> 8) % (unsigned int)frames) * frame_bytes : 0;
+
+    } //seek_target
+
+//per format hooks, so the read and seek benchmarks are written once
+
+    OGG_file_source* open_source( const std::string &asset, OGG_file_source*, bool decode_float ) {
+
+        snow::QuickVec<unsigned char> unused;
+        OGG_file_source* source = new OGG_file_source();
+
+        source->decode_float = decode_float;
+        source->source_name = asset;
+
+            //resident oggs decode from the shared file bytes through a memory source, like the bindings do
+        if(bench_resident) {
+            source->resident = resident_bytes(asset_path(asset));
+            if(source->resident) {
+                source->file_source = snow::io::iosrc_from_const_mem(source->resident->data(), (int)source->resident->size());
+            }
+        } else {
+            source->file_source = snow::io::iosrc_from_file(asset_path(asset).c_str(), "rb");
+        }
+
+        if(!source->file_source || !load_info_ogg(unused, asset.c_str(), source, false)) {
+            delete source;
+            return NULL;
+        }
+
+        return source;
+
+    } //open_source ogg
+
+    WAV_file_source* open_source( const std::string &asset, WAV_file_source*, bool ) {
+
+        snow::QuickVec<unsigned char> unused;
+        WAV_file_source* source = new WAV_file_source();
+
+        source->source_name = asset;
+        source->file_source = snow::io::iosrc_from_file(asset_path(asset).c_str(), "rb");
+
+        if(!source->file_source || !load_info_wav(unused, asset.c_str(), source, false)) {
+            delete source;
+            return NULL;
+        }
+
+        return source;
+
+    } //open_source wav
+
+    PCM_file_source* open_source( const std::string &asset, PCM_file_source*, bool ) {
+
+        snow::QuickVec<unsigned char> unused;
+        PCM_file_source* source = new PCM_file_source();
+
+        source->source_name = asset;
+        source->file_source = snow::io::iosrc_from_file(asset_path(asset).c_str(), "rb");
+
+        if(!source->file_source || !load_info_pcm(unused, asset.c_str(), source, false)) {
+            delete source;
+            return NULL;
+        }
+
+        return source;
+
+    } //open_source pcm
+
+    ADPCM_file_source* open_source( const std::string &asset, ADPCM_file_source*, bool ) {
+
+        snow::QuickVec<unsigned char> unused;
+        ADPCM_file_source* source = new ADPCM_file_source();
+
+        source->source_name = asset;
+        source->file_source = snow::io::iosrc_from_file(asset_path(asset).c_str(), "rb");
+
+        if(!source->file_source || !load_info_adpcm(unused, asset.c_str(), source, false)) {
+            delete source;
+            return NULL;
+        }
+
+        return source;
+
+    } //open_source adpcm
+
+    inline bool read_into( OGG_file_source* s, unsigned char* d, long st, long l, long &r )   { return read_bytes_ogg_into(s, d, st, l, r); }
+    inline bool read_into( WAV_file_source* s, unsigned char* d, long st, long l, long &r )   { return read_bytes_wav_into(s, d, st, l, r); }
+    inline bool read_into( PCM_file_source* s, unsigned char* d, long st, long l, long &r )   { return read_bytes_pcm_into(s, d, st, l, r); }
+    inline bool read_into( ADPCM_file_source* s, unsigned char* d, long st, long l, long &r ) { return read_bytes_adpcm_into(s, d, st, l, r); }
+
+    inline bool seek( OGG_file_source* s, long to )   { return seek_bytes_ogg(s, to); }
+    inline bool seek( WAV_file_source* s, long to )   { return seek_bytes_wav(s, to); }
+    inline bool seek( PCM_file_source* s, long to )   { return seek_bytes_pcm(s, to); }
+    inline bool seek( ADPCM_file_source* s, long to ) { return seek_bytes_adpcm(s, to); }
+
+    inline void build_seek_index( OGG_file_source* s ) { seek_index_ogg(s); }
+    template<typename T> inline void build_seek_index( T* ) { }
+
+    inline long frame_bytes( OGG_file_source* s ) { return s->info->channels * (s->decode_float ? sizeof(float) : sizeof(short)); }
+    inline long frame_bytes( WAV_file_source* s ) { return s->channels * (s->bits_per_sample / 8); }
+    inline long frame_bytes( PCM_file_source* s ) { return s->channels * (s->bits_per_sample / 8); }
+    inline long frame_bytes( ADPCM_file_source* s ) { return s->channels * sizeof(short); }
+
+//the benchmarks
+
+        //opening, parsing the header and closing, with nothing decoded
+    template<typename T>
+    void bench_load_info( const char* name, const std::string &asset, int iterations, bool decode_float = false ) {
+
+        Bench_result &result = begin(name, asset);
+
+        for(int i = 0; i < iterations; ++i) {
+
+            bool ok = true;
+
+            measure(result, [&]() -> long {
+                T* source = open_source(asset, (T*)NULL, decode_float);
+                ok = source != NULL;
+                delete source;
+                return 0;
+            });
+
+            if(!ok) {
+                snow::log(0, "/ snow / bench / %s : could not load %s, skipped", name, asset.c_str());
+                bench_results.pop_back();
+                return;
+            }
+
+        } //each iteration
+
+    } //bench_load_info
+
+        //the whole asset from the start, chunk bytes at a time like a stream refill
+    template<typename T>
+    void bench_read( const char* name, const std::string &asset, long chunk, int passes, bool decode_float = false ) {
+
+        T* source = open_source(asset, (T*)NULL, decode_float);
+
+        if(!source) {
+            snow::log(0, "/ snow / bench / %s : could not load %s, skipped", name, asset.c_str());
+            return;
+        }
+
+        Bench_result &result = begin(name, asset, chunk);
+        std::vector<unsigned char> dest(chunk);
+
+        for(int pass = 0; pass < passes; ++pass) {
+
+            seek(source, 0);
+
+            bool complete = false;
+
+            while(!complete) {
+
+                measure(result, [&]() -> long {
+                    long bytes_read = 0;
+                    complete = read_into(source, dest.data(), -1, chunk, bytes_read);
+                    return bytes_read;
+                });
+
+            } //!complete
+
+        } //each pass
+
+        delete source;
+
+    } //bench_read
+
+        //random frame aligned seeks, each followed by a small read since that is when seeking costs
+    template<typename T>
+    void bench_seek( const char* name, const std::string &asset, int iterations, bool build_index = false ) {
+
+        T* source = open_source(asset, (T*)NULL, false);
+
+        if(!source) {
+            snow::log(0, "/ snow / bench / %s : could not load %s, skipped", name, asset.c_str());
+            return;
+        }
+
+        if(build_index) {
+            build_seek_index(source);
+        }
+
+        Bench_result &result = begin(name, asset, 4096);
+        std::vector<unsigned char> dest(4096);
+
+        long _frame_bytes = frame_bytes(source);
+        long _frames = source->length_pcm / _frame_bytes;
+        unsigned int state = 1;
+
+        for(int i = 0; i < iterations; ++i) {
+
+            long to = seek_target(state, _frames, _frame_bytes);
+
+            measure(result, [&]() -> long {
+                long bytes_read = 0;
+                seek(source, to);
+                read_into(source, dest.data(), -1, (long)dest.size(), bytes_read);
+                return bytes_read;
+            });
+
+        } //each iteration
+
+        delete source;
+
+    } //bench_seek
+
+//reporting
+
+    double percentile( const std::vector<double> &sorted, double p ) {
+
+        if(sorted.empty()) return 0;
+
+        size_t index = (size_t)(p * (sorted.size() - 1) + 0.5);
+
+        return sorted[std::min(index, sorted.size() - 1)];
+
+    } //percentile
+
+    const char* simd_name() {
+
+        #if defined(SNOW_AUDIO_SSE2)
+            return "sse2";
+        #elif defined(SNOW_AUDIO_NEON)
+            return "neon";
+        #else
+            return "scalar";
+        #endif
+
+    } //simd_name
+
+    void report() {
+
+        if(bench_json) {
+            printf("{\n  \"bench\": \"snow-bench-audio\",\n  \"format\": 1,\n  \"simd\": \"%s\",\n  \"results\": [\n", simd_name());
+        } else {
+            printf("snow / bench / audio / %s\n\n", simd_name());
+            printf("%-22s %-12s %7s %7s %10s %9s %9s %9s %9s %9s %11s\n",
+                "bench", "asset", "chunk", "calls", "MB pcm/s", "p50 us", "p90 us", "p99 us", "max us", "allocs", "alloc bytes");
+        }
+
+        for(size_t i = 0; i < bench_results.size(); ++i) {
+
+            Bench_result &result = bench_results[i];
+            std::vector<double> sorted(result.latencies);
+            std::sort(sorted.begin(), sorted.end());
+
+            double calls = result.calls > 0 ? (double)result.calls : 1.0;
+            double mb_per_second = result.seconds > 0 ? (result.pcm_bytes / 1e6) / result.seconds : 0;
+            double allocs = result.allocs / calls;
+            double alloc_bytes = result.alloc_bytes / calls;
+
+            if(bench_json) {
+
+                printf("    { \"bench\": \"%s\", \"asset\": \"%s\", \"chunk\": %ld, \"calls\": %ld, \"pcm_bytes\": %.0f, \"seconds\": %.6f, "
+                       "\"mb_pcm_per_s\": %.3f, \"p50_us\": %.3f, \"p90_us\": %.3f, \"p99_us\": %.3f, \"max_us\": %.3f, "
+                       "\"allocs_per_call\": %.3f, \"alloc_bytes_per_call\": %.1f }%s\n",
+                    result.name.c_str(), result.asset.c_str(), result.chunk, result.calls, result.pcm_bytes, result.seconds,
+                    mb_per_second, percentile(sorted, 0.5), percentile(sorted, 0.9), percentile(sorted, 0.99), sorted.empty() ? 0 : sorted.back(),
+                    allocs, alloc_bytes, (i + 1 < bench_results.size()) ? "," : "");
+
+            } else {
+
+                printf("%-22s %-12s %7ld %7ld %10.2f %9.2f %9.2f %9.2f %9.2f %9.2f %11.0f\n",
+                    result.name.c_str(), result.asset.c_str(), result.chunk, result.calls, mb_per_second,
+                    percentile(sorted, 0.5), percentile(sorted, 0.9), percentile(sorted, 0.99), sorted.empty() ? 0 : sorted.back(),
+                    allocs, alloc_bytes);
+
+            }
+
+        } //each result
+
+        if(bench_json) {
+            printf("  ]\n}\n");
+        }
+
+    } //report
+
+} //namespace
+
+int main( int argc, char** argv ) {
+
+    for(int i = 1; i < argc; ++i) {
+
+        if(strcmp(argv[i], "--json") == 0) {
+            bench_json = true;
+        } else if(strcmp(argv[i], "--verbose") == 0) {
+            snow::log_level = 3;
+        } else if(strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            bench_iterations = std::max(1, atoi(argv[++i]));
+        } else {
+            bench_path = argv[i];
+        }
+
+    } //each arg
+
+        //nothing here goes through the decoded audio cache, keep it empty regardless
+    cache_budget(0);
+
+    const char* oggs[] = { "music.ogg", "boop.ogg" };
+
+    for(int a = 0; a < 2; ++a) {
+
+        bench_load_info<OGG_file_source>("load_info_ogg", oggs[a], bench_iterations);
+
+        for(int c = 0; c < bench_chunk_count; ++c) {
+            bench_read<OGG_file_source>("read_bytes_ogg", oggs[a], bench_chunks[c], 1);
+        }
+
+        bench_read<OGG_file_source>("read_bytes_ogg_f32", oggs[a], 65536, 1, true);
+
+    } //each ogg
+
+        //the same decode from the resident bytes, held here so the file is read once up front
+    bench_resident = true;
+
+    Audio_resident_bytes held[2];
+
+    for(int a = 0; a < 2; ++a) {
+        held[a] = resident_bytes(asset_path(oggs[a]));
+    }
+
+    for(int a = 0; a < 2; ++a) {
+        bench_load_info<OGG_file_source>("load_info_ogg_res", oggs[a], bench_iterations);
+        bench_read<OGG_file_source>("read_bytes_ogg_res", oggs[a], 65536, 1);
+    }
+
+    bench_seek<OGG_file_source>("seek_bytes_ogg_res", "music.ogg", bench_iterations);
+
+    bench_resident = false;
+
+    bench_seek<OGG_file_source>("seek_bytes_ogg", "music.ogg", bench_iterations);
+    bench_seek<OGG_file_source>("seek_bytes_ogg_indexed", "music.ogg", bench_iterations, true);
+
+    bench_load_info<WAV_file_source>("load_info_wav", "music.wav", bench_iterations * 20);
+
+    for(int c = 0; c < bench_chunk_count; ++c) {
+        bench_read<WAV_file_source>("read_bytes_wav", "music.wav", bench_chunks[c], 3);
+    }
+
+    bench_seek<WAV_file_source>("seek_bytes_wav", "music.wav", bench_iterations * 20);
+
+    bench_load_info<PCM_file_source>("load_info_pcm", "sound.pcm", bench_iterations * 20);
+
+    for(int c = 0; c < bench_chunk_count; ++c) {
+        bench_read<PCM_file_source>("read_bytes_pcm", "sound.pcm", bench_chunks[c], 3);
+    }
+
+    bench_seek<PCM_file_source>("seek_bytes_pcm", "sound.pcm", bench_iterations * 20);
+
+        //16 bit wav is encoded at load, so this includes the encoder
+    bench_load_info<ADPCM_file_source>("load_info_adpcm", "music.wav", std::max(1, bench_iterations / 10));
+
+    for(int c = 0; c < bench_chunk_count; ++c) {
+        bench_read<ADPCM_file_source>("read_bytes_adpcm", "music.wav", bench_chunks[c], 3);
+    }
+
+    bench_seek<ADPCM_file_source>("seek_bytes_adpcm", "music.wav", bench_iterations * 20);
+
+    report();
+
+    return 0;
+
+} //main
@@ -0,0 +1,236 @@
+/*
+    Copyright Sven Bergström 2014
+    created for snow https://github.com/underscorediscovery/snow
+    MIT license
+*/
+
+    //Microbenchmarks for the audio conversion kernels.
+    //Build with `-Dsnow_bench`, which adds the snow-bench target to Build.xml.
+    //Each kernel runs over a second of 44.1khz stereo a number of times,
+    //and reports the best time per sample and the throughput against realtime.
+    //Before timing, each kernel is checked against a scalar reference on odd lengths,
+    //so both the vector body and the scalar tail are compared.
+
+#include "audio/snow_audio_convert.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include <chrono>
+
+namespace {
+
+    const long bench_frames = 44100;
+    const long bench_samples = bench_frames * 2;
+    const int bench_runs = 200;
+
+        //keeps the compiler from discarding a kernel whose output isn't otherwise read
+    volatile unsigned char bench_sink = 0;
+
+    template<typename F>
+    void bench( const char* name, long samples, F kernel ) {
+
+        double best = 1e30;
+
+        for(int i = 0; i < bench_runs; ++i) {
+
+            auto start = std::chrono::high_resolution_clock::now();
+
+                kernel();
+
+            auto end = std::chrono::high_resolution_clock::now();
+
+            double ns = std::chrono::duration<double, std::nano>(end - start).count();
+            if(ns < best) best = ns;
+
+        } //each run
+
+        double per_sample = best / samples;
+            //how many seconds of stereo 44.1khz one second of this kernel gets through
+        double realtime = 1e9 / (per_sample * 44100.0 * 2.0);
+
+        printf("%-16s %8.3f ns/sample %10.0fx realtime\n", name, per_sample, realtime);
+
+    } //bench
+
+    //scalar references, written out from the plain loops of snow_audio_convert.cpp
+
+        //lengths that aren't a multiple of any vector width, with short ones that are tail only
+    const long check_lengths[] = { 1, 3, 7, 9, 17, 33, 1001 };
+    const int check_length_count = sizeof(check_lengths) / sizeof(check_lengths[0]);
+
+    static short ref_s16( float sample ) {
+
+        long val = lrintf( sample * 32768.0f );
+
+        if(val > 32767) val = 32767;
+        if(val < -32768) val = -32768;
+
+        return (short)val;
+
+    } //ref_s16
+
+        //the first mismatch of two outputs, compared bit for bit, or -1
+    template<typename T>
+    long mismatch( const std::vector<T> &a, const std::vector<T> &b, long count ) {
+
+        for(long i = 0; i < count; ++i) {
+            if(memcmp(&a[i], &b[i], sizeof(T)) != 0) return i;
+        }
+
+        return -1;
+
+    } //mismatch
+
+    bool check_report( const char* name, long length, long at ) {
+
+        if(at < 0) return true;
+
+        printf("%-16s mismatch at %ld of a length %ld run\n", name, at, length);
+
+        return false;
+
+    } //check_report
+
+        //runs every kernel against its reference, returns false on any mismatch
+    bool check_kernels() {
+
+        using namespace snow::audio;
+
+        bool ok = true;
+        long most = check_lengths[check_length_count - 1];
+
+            //float input reaches past [-1, 1] so the clamping is compared too
+        std::vector<unsigned char> u8(most * 2);
+        std::vector<short> s16(most * 2);
+        std::vector<float> f32(most * 2);
+        std::vector<float> left(most);
+        std::vector<float> right(most);
+
+        for(long i = 0; i < most * 2; ++i) {
+            u8[i] = (unsigned char)(rand() & 0xff);
+            s16[i] = (short)(rand() & 0xffff);
+            f32[i] = ((rand() & 0xffff) / 32768.0f - 1.0f) * 1.25f;
+        }
+
+        for(long i = 0; i < most; ++i) {
+            left[i] = f32[i*2];
+            right[i] = f32[i*2 + 1];
+        }
+
+        float* planes[2] = { left.data(), right.data() };
+
+        std::vector<short> s16_out(most * 2);
+        std::vector<short> s16_ref(most * 2);
+        std::vector<float> f32_out(most * 2);
+        std::vector<float> f32_ref(most * 2);
+
+        for(int l = 0; l < check_length_count; ++l) {
+
+            long n = check_lengths[l];
+
+            planar_to_f32(planes, 2, n, f32_out.data());
+            for(long i = 0; i < n; ++i) { f32_ref[i*2] = left[i]; f32_ref[i*2 + 1] = right[i]; }
+            ok &= check_report("planar_to_f32", n, mismatch(f32_out, f32_ref, n * 2));
+
+            planar_to_s16(planes, 1, n, s16_out.data());
+            for(long i = 0; i < n; ++i) { s16_ref[i] = ref_s16(left[i]); }
+            ok &= check_report("planar_to_s16/1", n, mismatch(s16_out, s16_ref, n));
+
+            planar_to_s16(planes, 2, n, s16_out.data());
+            for(long i = 0; i < n; ++i) { s16_ref[i*2] = ref_s16(left[i]); s16_ref[i*2 + 1] = ref_s16(right[i]); }
+            ok &= check_report("planar_to_s16/2", n, mismatch(s16_out, s16_ref, n * 2));
+
+            u8_to_s16(u8.data(), n, s16_out.data());
+            for(long i = 0; i < n; ++i) { s16_ref[i] = (short)((u8[i] - 128) << 8); }
+            ok &= check_report("u8_to_s16", n, mismatch(s16_out, s16_ref, n));
+
+            s16_to_f32(s16.data(), n, f32_out.data());
+            for(long i = 0; i < n; ++i) { f32_ref[i] = s16[i] * (1.0f / 32768.0f); }
+            ok &= check_report("s16_to_f32", n, mismatch(f32_out, f32_ref, n));
+
+            f32_to_s16(f32.data(), n, s16_out.data());
+            for(long i = 0; i < n; ++i) { s16_ref[i] = ref_s16(f32[i]); }
+            ok &= check_report("f32_to_s16", n, mismatch(s16_out, s16_ref, n));
+
+            downmix_s16(s16.data(), n, s16_out.data());
+            for(long i = 0; i < n; ++i) { s16_ref[i] = (short)((s16[i*2] + s16[i*2 + 1]) >> 1); }
+            ok &= check_report("downmix_s16", n, mismatch(s16_out, s16_ref, n));
+
+            downmix_f32(f32.data(), n, f32_out.data());
+            for(long i = 0; i < n; ++i) { f32_ref[i] = (f32[i*2] + f32[i*2 + 1]) * 0.5f; }
+            ok &= check_report("downmix_f32", n, mismatch(f32_out, f32_ref, n));
+
+        } //each length
+
+        return ok;
+
+    } //check_kernels
+
+} //namespace
+
+int main() {
+
+    using namespace snow::audio;
+
+    #if defined(SNOW_AUDIO_SSE2)
+        printf("snow / bench / convert / sse2\n");
+    #elif defined(SNOW_AUDIO_NEON)
+        printf("snow / bench / convert / neon\n");
+    #else
+        printf("snow / bench / convert / scalar\n");
+    #endif
+
+    if(!check_kernels()) {
+        printf("kernels don't match their scalar references, not timing\n");
+        return 1;
+    }
+
+    printf("kernels match their scalar references\n");
+
+    std::vector<unsigned char> u8(bench_samples);
+    std::vector<short> s16(bench_samples);
+    std::vector<short> s16_out(bench_samples * 2);
+    std::vector<float> f32(bench_samples);
+    std::vector<float> f32_out(bench_samples * 2);
+    std::vector<float> left(bench_frames);
+    std::vector<float> right(bench_frames);
+
+    for(long i = 0; i < bench_samples; ++i) {
+        u8[i] = (unsigned char)(rand() & 0xff);
+        s16[i] = (short)(rand() & 0xffff);
+        f32[i] = s16[i] / 32768.0f;
+    }
+
+    for(long i = 0; i < bench_frames; ++i) {
+        left[i] = f32[i*2];
+        right[i] = f32[i*2 + 1];
+    }
+
+    float* planes[2] = { left.data(), right.data() };
+
+    bench("planar_to_f32", bench_samples, [&]() { planar_to_f32(planes, 2, bench_frames, f32_out.data()); bench_sink += (unsigned char)f32_out[7]; });
+    bench("planar_to_s16", bench_samples, [&]() { planar_to_s16(planes, 2, bench_frames, s16_out.data()); bench_sink += (unsigned char)s16_out[7]; });
+    bench("u8_to_s16", bench_samples, [&]() { u8_to_s16(u8.data(), bench_samples, s16_out.data()); bench_sink += (unsigned char)s16_out[7]; });
+    bench("s16_to_f32", bench_samples, [&]() { s16_to_f32(s16.data(), bench_samples, f32_out.data()); bench_sink += (unsigned char)f32_out[7]; });
+    bench("f32_to_s16", bench_samples, [&]() { f32_to_s16(f32.data(), bench_samples, s16_out.data()); bench_sink += (unsigned char)s16_out[7]; });
+    bench("downmix_s16", bench_samples, [&]() { downmix_s16(s16.data(), bench_frames, s16_out.data()); bench_sink += (unsigned char)s16_out[7]; });
+    bench("downmix_f32", bench_samples, [&]() { downmix_f32(f32.data(), bench_frames, f32_out.data()); bench_sink += (unsigned char)f32_out[7]; });
+    bench("resample_s16", bench_samples, [&]() { resample_s16(s16.data(), 2, bench_frames, 44100, 48000, s16_out.data()); bench_sink += (unsigned char)s16_out[7]; });
+    bench("resample_f32", bench_samples, [&]() { resample_f32(f32.data(), 2, bench_frames, 44100, 48000, f32_out.data()); bench_sink += (unsigned char)f32_out[7]; });
+
+        //stereo blocks the size adpcm assets are encoded to at load
+    int ima_align = 1024;
+    std::vector<unsigned char> ima;
+    long ima_blocks = ima_encode(s16.data(), 2, bench_frames, ima_align, ima);
+    long ima_samples = ima_blocks * ima_samples_per_block(ima_align, 2) * 2;
+    std::vector<short> ima_out(ima_samples);
+
+    bench("ima_decode_blocks", ima_samples, [&]() { ima_decode_blocks(ima.data(), ima_blocks, ima_align, 2, ima_out.data()); bench_sink += (unsigned char)ima_out[7]; });
+    bench("ima_encode", bench_samples, [&]() { ima.clear(); ima_encode(s16.data(), 2, bench_frames, ima_align, ima); bench_sink += ima[7]; });
+
+    return 0;
+
+} //main
@@ -0,0 +1,383 @@
+/*
+    Copyright Sven Bergström 2014
+    created for snow https://github.com/underscorediscovery/snow
+    MIT license
+*/
+
+    //GL call throughput, one prim call per gl call against the recorded command buffer.
+    //Build with `-Dsnow_bench`, which adds the snow-bench-gl target to Build.xml (linux, EGL).
+    //It makes a headless context, so under Mesa run it with LIBGL_ALWAYS_SOFTWARE=1 for llvmpipe.
+    //
+    //Each case issues the same frame of small draws, the state changes a sprite or material batch
+    //makes between them, three ways :
+    //  direct      the gl calls straight from c++, the floor neither path can beat
+    //  per_call    each call through a prim shaped the way snow_render_opengl.cpp defines them,
+    //              boxed arguments in, unboxed through the api table, called through a pointer.
+    //              the real hxcpp dispatch costs more than this, it also allocates and type checks
+    //  execute     the calls recorded into int and float streams, the way GLCommands records them,
+    //              then issued by gl_execute in one go. the recording is included in the time
+
+#include "render/opengl/snow_opengl.h"
+#include "render/opengl/snow_opengl_commands.h"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <vector>
+#include <chrono>
+
+namespace snow {
+
+    int log_level = 1;
+
+    void log(int _level, const char *fmt, ...) {
+
+        if(_level > log_level) return;
+
+        va_list ap;
+        va_start(ap, fmt);
+        vfprintf(stderr, fmt, ap);
+        va_end(ap);
+
+        fprintf(stderr, "\n");
+
+    } //log
+
+} //snow namespace
+
+namespace {
+
+    const int bench_runs = 20;
+        //gl calls per draw in the frame below
+    const int calls_per_draw = 6;
+
+    GLuint program = 0;
+    GLuint vbo = 0;
+    GLuint textures[4];
+    GLint u_tint = -1;
+    GLint u_sampler = -1;
+    GLint u_matrix = -1;
+
+    float matrix[16] = { 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1 };
+        //3 for a triangle per draw, 0 to leave out the draw work in the driver and time only the calls
+    int vertices = 3;
+
+//prims, the shape of the cffi ones
+
+        //an hxcpp Dynamic, boxed arguments cross as these
+    struct Bench_value {
+        int         type;
+        double      number;
+            //the data of a typed array, for the prims that take one
+        const void* bytes;
+    };
+
+    typedef Bench_value* value_t;
+
+        //a ring of boxes, so the per call path doesn't pay for allocating them
+    Bench_value boxes[64];
+    int box_next = 0;
+
+    inline value_t box( double number ) {
+        Bench_value* b = &boxes[box_next++ & 63];
+        b->type = 1;
+        b->number = number;
+        b->bytes = 0;
+        return b;
+    }
+
+    inline value_t box_bytes( const void* bytes ) {
+        Bench_value* b = &boxes[box_next++ & 63];
+        b->type = 2;
+        b->number = 0;
+        b->bytes = bytes;
+        return b;
+    }
+
+        //val_int and friends are calls through the cffi api table from a dynamic ndll
+    int val_int_impl( value_t v ) { return v->type ? (int)v->number : 0; }
+    double val_number_impl( value_t v ) { return v->type ? v->number : 0; }
+    value_t alloc_null_impl() { return 0; }
+        //bytes_from_hx, the buffer behind a typed array
+    const void* val_bytes_impl( value_t v ) { return v->type == 2 ? v->bytes : 0; }
+
+    int (* volatile val_int)( value_t ) = val_int_impl;
+    double (* volatile val_number)( value_t ) = val_number_impl;
+    value_t (* volatile alloc_null)() = alloc_null_impl;
+    const void* (* volatile val_bytes)( value_t ) = val_bytes_impl;
+
+    value_t prim_use_program( value_t p ) { glUseProgram(val_int(p)); return alloc_null(); }
+    value_t prim_bind_texture( value_t target, value_t t ) { glBindTexture(val_int(target), val_int(t)); return alloc_null(); }
+    value_t prim_uniform1i( value_t l, value_t x ) { glUniform1i(val_int(l), val_int(x)); return alloc_null(); }
+    value_t prim_uniform4f( value_t l, value_t x, value_t y, value_t z, value_t w ) { glUniform4f(val_int(l), val_number(x), val_number(y), val_number(z), val_number(w)); return alloc_null(); }
+    value_t prim_uniform_matrix( value_t l, value_t transpose, value_t data ) { glUniformMatrix4fv(val_int(l), 1, val_int(transpose) != 0, (const float*)val_bytes(data)); return alloc_null(); }
+    value_t prim_draw_arrays( value_t mode, value_t first, value_t count ) { glDrawArrays(val_int(mode), val_int(first), val_int(count)); return alloc_null(); }
+
+        //called through these, as Libs.load hands back a callable rather than the function
+    value_t (* volatile call_use_program)( value_t ) = prim_use_program;
+    value_t (* volatile call_bind_texture)( value_t, value_t ) = prim_bind_texture;
+    value_t (* volatile call_uniform1i)( value_t, value_t ) = prim_uniform1i;
+    value_t (* volatile call_uniform4f)( value_t, value_t, value_t, value_t, value_t ) = prim_uniform4f;
+    value_t (* volatile call_uniform_matrix)( value_t, value_t, value_t ) = prim_uniform_matrix;
+    value_t (* volatile call_draw_arrays)( value_t, value_t, value_t ) = prim_draw_arrays;
+
+//the frame, three ways
+
+    void frame_direct( int draws ) {
+
+        for(int d = 0; d < draws; ++d) {
+
+            float t = (d & 7) / 8.0f;
+
+            glUseProgram(program);
+            glBindTexture(GL_TEXTURE_2D, textures[d & 3]);
+            glUniform1i(u_sampler, 0);
+            glUniform4f(u_tint, t, 1.0f - t, 0.5f, 1.0f);
+            glUniformMatrix4fv(u_matrix, 1, GL_FALSE, matrix);
+            glDrawArrays(GL_TRIANGLES, 0, vertices);
+
+        } //each draw
+
+    } //frame_direct
+
+    void frame_per_call( int draws ) {
+
+        for(int d = 0; d < draws; ++d) {
+
+            float t = (d & 7) / 8.0f;
+
+            call_use_program(box(program));
+            call_bind_texture(box(GL_TEXTURE_2D), box(textures[d & 3]));
+            call_uniform1i(box(u_sampler), box(0));
+            call_uniform4f(box(u_tint), box(t), box(1.0f - t), box(0.5f), box(1.0f));
+            call_uniform_matrix(box(u_matrix), box(0), box_bytes(matrix));
+            call_draw_arrays(box(GL_TRIANGLES), box(0), box(vertices));
+
+        } //each draw
+
+    } //frame_per_call
+
+        //grown like the haxe side grows its streams, and reused between frames
+    std::vector<int> ints;
+    std::vector<float> floats;
+
+    void frame_execute( int draws ) {
+
+        using namespace snow::render;
+
+        size_t ni = 0;
+        size_t nf = 0;
+
+        size_t need_i = (size_t)draws * 24;
+        size_t need_f = (size_t)draws * 20;
+        if(ints.size() < need_i) ints.resize(need_i);
+        if(floats.size() < need_f) floats.resize(need_f);
+
+        int* i = ints.data();
+        float* f = floats.data();
+
+        for(int d = 0; d < draws; ++d) {
+
+            float t = (d & 7) / 8.0f;
+
+            i[ni++] = glc_use_program;      i[ni++] = program;
+            i[ni++] = glc_bind_texture;     i[ni++] = GL_TEXTURE_2D;    i[ni++] = textures[d & 3];
+            i[ni++] = glc_uniform1i;        i[ni++] = u_sampler;        i[ni++] = 0;
+            i[ni++] = glc_uniform4f;        i[ni++] = u_tint;
+                f[nf++] = t; f[nf++] = 1.0f - t; f[nf++] = 0.5f; f[nf++] = 1.0f;
+            i[ni++] = glc_uniform_matrix;   i[ni++] = u_matrix;         i[ni++] = 0;    i[ni++] = 4;    i[ni++] = 1;
+                memcpy(f + nf, matrix, sizeof(matrix)); nf += 16;
+            i[ni++] = glc_draw_arrays;      i[ni++] = GL_TRIANGLES;     i[ni++] = 0;    i[ni++] = vertices;
+
+        } //each draw
+
+        gl_execute(i, (int)ni, f, (int)nf, draws * calls_per_draw);
+
+    } //frame_execute
+
+    double time_frame( void (*frame)( int ), int draws ) {
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+            frame(draws);
+
+        auto end = std::chrono::high_resolution_clock::now();
+
+            //the rasterizing is the same whichever way the calls came in, so it's left out
+        glFinish();
+
+        return std::chrono::duration<double, std::nano>(end - start).count();
+
+    } //time_frame
+
+    void bench( const char* name, int draws ) {
+
+        void (*frames[3])( int ) = { frame_direct, frame_per_call, frame_execute };
+        double best[3] = { 1e30, 1e30, 1e30 };
+
+            //once untimed, so every path starts from the same warm state
+        for(int p = 0; p < 3; ++p) {
+            time_frame(frames[p], draws);
+        }
+
+            //the paths take turns in a rotating order, so clock changes
+            //and whatever the driver carries between frames land on all of them
+        for(int r = 0; r < bench_runs; ++r) {
+            for(int k = 0; k < 3; ++k) {
+                int p = (r + k) % 3;
+                double ns = time_frame(frames[p], draws);
+                if(ns < best[p]) best[p] = ns;
+            }
+        }
+
+        double calls = (double)draws * calls_per_draw;
+
+        printf("%-10s %6d draws %8.0f calls   direct %7.1f ns/call   per_call %7.1f ns/call   execute %7.1f ns/call   %5.2fx\n",
+            name, draws, calls, best[0] / calls, best[1] / calls, best[2] / calls, best[1] / best[2]);
+
+    } //bench
+
+//setup
+
+    bool make_context() {
+
+        EGLDisplay display = EGL_NO_DISPLAY;
+
+            //headless where mesa offers it, so no window system is needed
+        PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+
+        #ifdef EGL_PLATFORM_SURFACELESS_MESA
+            if(get_platform_display) {
+                display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+            }
+        #endif
+
+        if(display == EGL_NO_DISPLAY) {
+            display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        }
+
+        if(display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL)) {
+            snow::log(0, "/ snow / bench / gl : no egl display");
+            return false;
+        }
+
+        const EGLint config_attr[] = {
+            EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+            EGL_NONE
+        };
+
+        EGLConfig config;
+        EGLint configs = 0;
+
+        if(!eglBindAPI(EGL_OPENGL_API) || !eglChooseConfig(display, config_attr, &config, 1, &configs) || configs < 1) {
+            snow::log(0, "/ snow / bench / gl : no egl config for desktop gl");
+            return false;
+        }
+
+        const EGLint surface_attr[] = { EGL_WIDTH, 64, EGL_HEIGHT, 64, EGL_NONE };
+
+        EGLSurface surface = eglCreatePbufferSurface(display, config, surface_attr);
+        EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, NULL);
+
+        if(surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT || !eglMakeCurrent(display, surface, surface, context)) {
+            snow::log(0, "/ snow / bench / gl : could not make a context current");
+            return false;
+        }
+
+        return true;
+
+    } //make_context
+
+    GLuint compile( GLenum type, const char* source ) {
+
+        GLuint shader = glCreateShader(type);
+        glShaderSource(shader, 1, &source, NULL);
+        glCompileShader(shader);
+
+        return shader;
+
+    } //compile
+
+    void make_resources() {
+
+        const char* vert =
+            "attribute vec2 pos;\n"
+            "uniform mat4 matrix;\n"
+            "varying vec2 uv;\n"
+            "void main() { uv = pos; gl_Position = matrix * vec4(pos, 0.0, 1.0); }\n";
+
+        const char* frag =
+            "uniform sampler2D tex;\n"
+            "uniform vec4 tint;\n"
+            "varying vec2 uv;\n"
+            "void main() { gl_FragColor = texture2D(tex, uv) * tint; }\n";
+
+        program = glCreateProgram();
+        glAttachShader(program, compile(GL_VERTEX_SHADER, vert));
+        glAttachShader(program, compile(GL_FRAGMENT_SHADER, frag));
+        glBindAttribLocation(program, 0, "pos");
+        glLinkProgram(program);
+
+        u_tint = glGetUniformLocation(program, "tint");
+        u_sampler = glGetUniformLocation(program, "tex");
+        u_matrix = glGetUniformLocation(program, "matrix");
+
+            //a tiny triangle, the draws are about the calls, not the fill
+        const float tri[] = { 0.0f, 0.0f, 0.05f, 0.0f, 0.0f, 0.05f };
+
+        glGenBuffers(1, &vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(tri), tri, GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, 0);
+
+        const unsigned char pixel[] = { 255, 255, 255, 255 };
+
+        glGenTextures(4, textures);
+
+        for(int t = 0; t < 4; ++t) {
+            glBindTexture(GL_TEXTURE_2D, textures[t]);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+        }
+
+    } //make_resources
+
+} //namespace
+
+int main() {
+
+    if(!make_context()) {
+        return 1;
+    }
+
+    const char* renderer = (const char*)glGetString(GL_RENDERER);
+    printf("snow / bench / gl / %s\n", renderer ? renderer : "unknown renderer");
+
+    make_resources();
+
+    const int counts[] = { 100, 1000, 5000, 20000 };
+
+    for(int c = 0; c < 4; ++c) {
+
+        vertices = 3;
+        bench("triangles", counts[c]);
+            //the same calls, with draws the driver drops after validating them
+        vertices = 0;
+        bench("calls", counts[c]);
+
+    } //each count
+
+    GLenum error = glGetError();
+    if(error != GL_NO_ERROR) {
+        snow::log(0, "/ snow / bench / gl : gl error 0x%x during the run", error);
+    }
+
+    return 0;
+
+} //main
@@ -0,0 +1,228 @@
+/*
+    Copyright Sven Bergström 2014
+    created for snow https://github.com/underscorediscovery/snow
+    MIT license
+*/
+
+    //Voices per core for the software mixer the OpenAL module uses for sound effects.
+    //Build with `-Dsnow_bench`, which adds the snow-bench-mix target to Build.xml.
+    //Each case mixes a second of 44.1khz stereo output in the blocks the mixer thread uses,
+    //over a range of voice counts, and reports the best time per voice and output frame,
+    //and how many voices one core could mix in realtime at that cost.
+    //Before timing, the mixing kernels are checked against a scalar reference on odd lengths,
+    //so both the vector body and the scalar tail are compared.
+
+#include "audio/snow_audio_mix.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include <chrono>
+
+namespace {
+
+    const int bench_rate = 44100;
+        //matches ALHX_MIXER_FRAMES in the openal module
+    const long bench_block = 512;
+    const long bench_blocks = bench_rate / bench_block;
+    const int bench_runs = 20;
+
+        //keeps the compiler from discarding a mix whose output isn't otherwise read
+    volatile float bench_sink = 0;
+
+        //a short hit, as most sound effects are, so voices loop through it often
+    const long sample_frames = 11025;
+
+    std::shared_ptr<snow::audio::Mix_sample> make_sample( int channels, int rate ) {
+
+        std::vector<short> pcm(sample_frames * channels);
+
+        for(size_t i = 0; i < pcm.size(); ++i) {
+            pcm[i] = (short)((rand() & 0xffff) - 32768);
+        }
+
+        return snow::audio::mix_sample( (const unsigned char*)pcm.data(), (long)(pcm.size() * sizeof(short)), snow::audio::sf_s16, channels, rate );
+
+    } //make_sample
+
+    void bench( const char* name, std::shared_ptr<snow::audio::Mix_sample> sample, float pitch, int count ) {
+
+        snow::audio::Mixer mixer(bench_rate);
+        std::vector<snow::audio::Mix_voice*> voices;
+        std::vector<float> block(bench_block * 2);
+
+        for(int i = 0; i < count; ++i) {
+
+            snow::audio::Mix_voice* voice = new snow::audio::Mix_voice(sample);
+
+            voice->gain = 1.0f / count;
+            voice->pan = (i % 21) / 10.0f - 1.0f;
+            voice->pitch = pitch;
+            voice->looping = true;
+
+            mixer.add(voice);
+            mixer.play(voice);
+                //spread out, so they don't all wrap in the same block
+            voice->position = (double)((i * 997) % sample_frames);
+
+            voices.push_back(voice);
+
+        } //each voice
+
+        double best = 1e30;
+
+        for(int r = 0; r < bench_runs; ++r) {
+
+                //a gain change every run, so the ramps are part of the cost
+            for(int i = 0; i < count; ++i) {
+                voices[i]->gain = (r & 1) ? 0.5f / count : 1.0f / count;
+            }
+
+            auto start = std::chrono::high_resolution_clock::now();
+
+                for(long b = 0; b < bench_blocks; ++b) {
+                    mixer.mix(block.data(), bench_block);
+                    bench_sink += block[7];
+                }
+
+            auto end = std::chrono::high_resolution_clock::now();
+
+            double ns = std::chrono::duration<double, std::nano>(end - start).count();
+            if(ns < best) best = ns;
+
+        } //each run
+
+        double frames = (double)bench_blocks * bench_block;
+        double per_voice_frame = best / (frames * count);
+            //the seconds of output one second of mixing gets through, times the voices in it
+        double seconds = frames / bench_rate;
+        double per_core = count * (seconds * 1e9 / best);
+
+        printf("%-16s %6d voices %8.3f ns/voice/frame %10.0f voices/core\n", name, count, per_voice_frame, per_core);
+
+        for(size_t i = 0; i < voices.size(); ++i) {
+            delete voices[i];
+        }
+
+    } //bench
+
+    //scalar references, written out from the tail loops of snow_audio_mix.cpp
+
+        //lengths that aren't a multiple of the vector width, with short ones that are tail only
+    const long check_lengths[] = { 1, 3, 5, 7, 17, 33, 513, 1001 };
+    const int check_length_count = sizeof(check_lengths) / sizeof(check_lengths[0]);
+
+    void ref_mix( const float* src, int channels, long frames, float left_from, float right_from, float left_to, float right_to, float* dest ) {
+
+        const float dl = (left_to - left_from) / frames;
+        const float dr = (right_to - right_from) / frames;
+
+        for(long i = 0; i < frames; ++i) {
+            dest[i*2]     += src[i*channels]                  * (left_from + dl * i);
+            dest[i*2 + 1] += src[i*channels + channels - 1]   * (right_from + dr * i);
+        }
+
+    } //ref_mix
+
+        //the vector paths step the ramp by adding to it rather than multiplying it out,
+        //so they can drift from the reference by a few ulp of the gain over a long run
+    bool check_close( const char* name, long length, const std::vector<float> &out, const std::vector<float> &ref ) {
+
+        for(long i = 0; i < length * 2; ++i) {
+            if(fabsf(out[i] - ref[i]) > 1e-4f * (1.0f + fabsf(ref[i]))) {
+                printf("%-16s mismatch at %ld of a length %ld run, %f against %f\n", name, i, length, out[i], ref[i]);
+                return false;
+            }
+        }
+
+        return true;
+
+    } //check_close
+
+        //runs both kernels against the reference, with a ramp and with a constant gain, returns false on any mismatch
+    bool check_kernels() {
+
+        bool ok = true;
+        long most = check_lengths[check_length_count - 1];
+
+        std::vector<float> src(most * 2);
+        std::vector<float> base(most * 2);
+        std::vector<float> out(most * 2);
+        std::vector<float> ref(most * 2);
+
+        for(long i = 0; i < most * 2; ++i) {
+            src[i] = (rand() & 0xffff) / 32768.0f - 1.0f;
+            base[i] = (rand() & 0xffff) / 32768.0f - 1.0f;
+        }
+
+        const float gains[2][4] = { { 0.2f, 0.9f, 0.7f, 0.1f }, { 0.5f, 0.25f, 0.5f, 0.25f } };
+
+        for(int l = 0; l < check_length_count; ++l) {
+
+            long n = check_lengths[l];
+
+            for(int g = 0; g < 2; ++g) {
+
+                const float* _g = gains[g];
+
+                out = base; ref = base;
+                snow::audio::mix_mono(src.data(), n, _g[0], _g[1], _g[2], _g[3], out.data());
+                ref_mix(src.data(), 1, n, _g[0], _g[1], _g[2], _g[3], ref.data());
+                ok &= check_close("mix_mono", n, out, ref);
+
+                out = base; ref = base;
+                snow::audio::mix_stereo(src.data(), n, _g[0], _g[1], _g[2], _g[3], out.data());
+                ref_mix(src.data(), 2, n, _g[0], _g[1], _g[2], _g[3], ref.data());
+                ok &= check_close("mix_stereo", n, out, ref);
+
+            } //each gain
+
+        } //each length
+
+        return ok;
+
+    } //check_kernels
+
+} //namespace
+
+int main() {
+
+    #if defined(SNOW_AUDIO_SSE2)
+        printf("snow / bench / mix / sse2\n");
+    #elif defined(SNOW_AUDIO_NEON)
+        printf("snow / bench / mix / neon\n");
+    #else
+        printf("snow / bench / mix / scalar\n");
+    #endif
+
+    if(!check_kernels()) {
+        printf("kernels don't match the scalar reference, not timing\n");
+        return 1;
+    }
+
+    printf("kernels match the scalar reference\n");
+
+    std::shared_ptr<snow::audio::Mix_sample> mono = make_sample(1, bench_rate);
+    std::shared_ptr<snow::audio::Mix_sample> stereo = make_sample(2, bench_rate);
+    std::shared_ptr<snow::audio::Mix_sample> mono_22k = make_sample(1, 22050);
+
+    const int counts[] = { 16, 64, 256, 1024 };
+
+    for(int c = 0; c < 4; ++c) {
+
+        int count = counts[c];
+
+            //straight from the sample data
+        bench("mono", mono, 1.0f, count);
+        bench("stereo", stereo, 1.0f, count);
+            //resampled through the scratch
+        bench("mono_pitched", mono, 1.3f, count);
+        bench("stereo_pitched", stereo, 0.8f, count);
+        bench("mono_22khz", mono_22k, 1.0f, count);
+
+    } //each count
+
+    return 0;
+
+} //main
@@ -2,6 +2,13 @@
 #define _SNOW_ASSETS_AUDIO_H_
 
 #include <string>
+#include <string.h> //memcpy
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include "common/QuickVec.h"
 
@@ -19,19 +26,86 @@ namespace snow {
             class OGG_file_source;
             class WAV_file_source;
         	class PCM_file_source;
+            class ADPCM_file_source;
 
         		//function declarations
         	bool load_info_ogg( QuickVec<unsigned char> &out_buffer, const char* _id, OGG_file_source*& ogg_source, bool read = true );
             bool read_bytes_ogg( OGG_file_source* ogg_source, QuickVec<unsigned char> &out_buffer, long start, long len );
+            bool read_bytes_ogg_into( OGG_file_source* ogg_source, unsigned char* dest, long start, long len, long &bytes_read );
         	bool seek_bytes_ogg( OGG_file_source* ogg_source, long to );
+            bool stream_start_ogg( OGG_file_source* ogg_source, long ring_length );
+            void stream_stop_ogg( OGG_file_source* ogg_source );
+                //ends the decode workers, called as audio shuts down
+            void stream_shutdown_ogg();
+            bool seek_index_ogg( OGG_file_source* ogg_source );
+            void seek_index_files_ogg( bool enabled );
 
             bool load_info_wav( QuickVec<unsigned char> &out_buffer, const char *_id, WAV_file_source*& wav_source, bool read = true );
             bool read_bytes_wav( WAV_file_source* wav_source, QuickVec<unsigned char> &out_buffer, long start, long len );
+            bool read_bytes_wav_into( WAV_file_source* wav_source, unsigned char* dest, long start, long len, long &bytes_read );
             bool seek_bytes_wav( WAV_file_source* wav_source, long to );
+            bool view_bytes_wav( WAV_file_source* wav_source, long start, long len, const unsigned char*& view, long &bytes_read );
 
             bool load_info_pcm( QuickVec<unsigned char> &out_buffer, const char *_id, PCM_file_source*& pcm_source, bool read = true );
             bool read_bytes_pcm( PCM_file_source* pcm_source, QuickVec<unsigned char> &out_buffer, long start, long len );
+            bool read_bytes_pcm_into( PCM_file_source* pcm_source, unsigned char* dest, long start, long len, long &bytes_read );
             bool seek_bytes_pcm( PCM_file_source* pcm_source, long to );
+            bool view_bytes_pcm( PCM_file_source* pcm_source, long start, long len, const unsigned char*& view, long &bytes_read );
+
+            bool load_info_adpcm( QuickVec<unsigned char> &out_buffer, const char *_id, ADPCM_file_source*& adpcm_source, bool read = true );
+            bool read_bytes_adpcm( ADPCM_file_source* adpcm_source, QuickVec<unsigned char> &out_buffer, long start, long len );
+            bool read_bytes_adpcm_into( ADPCM_file_source* adpcm_source, unsigned char* dest, long start, long len, long &bytes_read );
+            bool seek_bytes_adpcm( ADPCM_file_source* adpcm_source, long to );
+
+            class Audio_batch;
+
+                //counters for the decoded audio cache, see cache_stats
+            struct Audio_cache_stats {
+                size_t hits;
+                size_t misses;
+                size_t evictions;
+                size_t entries;
+                size_t bytes;
+                size_t budget;
+            };
+
+            typedef std::shared_ptr< const std::vector<unsigned char> > Audio_cache_samples;
+
+                //the time spent in the read_bytes_*_into readers, from every thread, see decode_stats
+            struct Audio_decode_stats {
+                long long calls;
+                long long bytes;
+                long long ns;
+                    //the longest single call, since the max was last reset
+                long long ns_max;
+            };
+
+            Audio_decode_stats decode_stats( bool reset_max );
+
+            std::string cache_key( const std::string &_id, int format, bool decode_float );
+            Audio_cache_samples cache_find( const std::string &key );
+            void cache_store( const std::string &key, const unsigned char* data, size_t length );
+                //stores samples that are shared with the caller, rather than a copy
+            void cache_store( const std::string &key, Audio_cache_samples samples );
+            void cache_budget( size_t bytes );
+            void cache_clear();
+            Audio_cache_stats cache_stats();
+
+                //a whole compressed file held in memory, shared by every source streaming from it
+            typedef std::shared_ptr< const std::vector<unsigned char> > Audio_resident_bytes;
+
+            struct Audio_resident_stats {
+                size_t entries;
+                size_t bytes;
+            };
+
+                //the bytes of the file at path, read once and shared while any source holds them, or null if it can't be read
+            Audio_resident_bytes resident_bytes( const std::string &path );
+            Audio_resident_stats resident_stats();
+
+            Audio_batch* load_batch_start( const std::vector<std::string> &ids, const std::vector<int> &formats, bool decode_float );
+            void load_batch_poll( Audio_batch* batch, std::vector<size_t> &finished );
+            void load_batch_end( Audio_batch* batch );
 
 
         	std::string ogg_error_string(int code);
@@ -46,6 +120,140 @@ namespace snow {
             #endif
 
 
+        //PCM ring buffer
+
+                //A fixed size single producer/single consumer ring of decoded bytes.
+                //The decode worker is the only writer and the main thread the only reader,
+                //so the two sides only ever meet through the head/tail counters.
+                //The capacity is rounded up to a power of two so wrapping is a mask.
+            class PCM_ring {
+
+                public:
+                    unsigned char*          data;
+                    size_t                  capacity;
+                    size_t                  mask;
+                        //total bytes ever written, only changed by the producer
+                    std::atomic<size_t>     head;
+                        //total bytes ever read, only changed by the consumer
+                    std::atomic<size_t>     tail;
+
+                PCM_ring( size_t _length ) : head(0), tail(0) {
+
+                    capacity = 1;
+                    while(capacity < _length) {
+                        capacity <<= 1;
+                    }
+
+                    mask = capacity - 1;
+                    data = new unsigned char[capacity];
+
+                } //PCM_ring
+
+                ~PCM_ring() {
+
+                    delete [] data;
+                    data = NULL;
+
+                } //~
+
+                inline size_t readable() const {
+                    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_relaxed);
+                }
+
+                inline size_t writable() const {
+                    return capacity - (head.load(std::memory_order_relaxed) - tail.load(std::memory_order_acquire));
+                }
+
+                    //producer side: the contiguous free region the decoder can write into directly,
+                    //followed by commit() with the amount that was actually written
+                inline unsigned char* write_span( size_t &_length ) {
+
+                    size_t _head = head.load(std::memory_order_relaxed);
+                    size_t _offset = _head & mask;
+                    size_t _contiguous = capacity - _offset;
+                    size_t _free = writable();
+
+                    _length = _free < _contiguous ? _free : _contiguous;
+
+                    return data + _offset;
+
+                } //write_span
+
+                inline void commit( size_t _length ) {
+                    head.store(head.load(std::memory_order_relaxed) + _length, std::memory_order_release);
+                }
+
+                    //consumer side: copy up to _length ready bytes out, returns the amount copied
+                inline size_t read( unsigned char* _dest, size_t _length ) {
+
+                    size_t _tail = tail.load(std::memory_order_relaxed);
+                    size_t _ready = readable();
+                    size_t _count = _length < _ready ? _length : _ready;
+                    size_t _offset = _tail & mask;
+                    size_t _first = capacity - _offset;
+
+                    if(_first > _count) {
+                        _first = _count;
+                    }
+
+                    memcpy(_dest, data + _offset, _first);
+                    memcpy(_dest + _first, data, _count - _first);
+
+                    tail.store(_tail + _count, std::memory_order_release);
+
+                    return _count;
+
+                } //read
+
+                    //only valid while the producer is halted
+                inline void reset() {
+                    head.store(0, std::memory_order_relaxed);
+                    tail.store(0, std::memory_order_relaxed);
+                }
+
+            }; //PCM_ring
+
+        //OGG stream state
+
+                //When a source is streamed, a decode worker keeps the ring topped up
+                //ahead of the reader. The flags below, other than the atomics, are only
+                //touched while holding the decode pool lock.
+            class OGG_stream {
+
+                public:
+                    PCM_ring            ring;
+                        //set by the worker once ov_read reports the end of the data
+                    std::atomic<bool>   eof;
+                        //asks the worker to stop decoding at the next chunk boundary
+                    std::atomic<bool>   interrupt;
+                        //signaled by the worker after each commit and at the end, for a reader waiting on it
+                    std::mutex              ready_lock;
+                    std::condition_variable ready;
+                    bool                queued;
+                    bool                busy;
+                    bool                halted;
+                    bool                requeue;
+
+                OGG_stream( size_t _ring_length ) :
+                    ring(_ring_length), eof(false), interrupt(false),
+                    queued(false), busy(false), halted(false), requeue(false)
+                        { }
+
+            }; //OGG_stream
+
+        //OGG seek index
+
+                //A page that ends at least one packet, pairing its byte offset in the file
+                //with the granule position (the pcm frame) that decoding reaches at its end.
+            struct OGG_seek_point {
+                ogg_int64_t offset;
+                ogg_int64_t granule;
+            };
+
+                //Sorted by both offset and granule, so seeks are a binary search.
+                //Immutable once built, so sources of the same asset share one.
+            typedef std::vector<OGG_seek_point> OGG_seek_index;
+
         //OGG file source
 
             class OGG_file_source {
@@ -54,14 +262,29 @@ namespace snow {
                     snow::io::iosrc*   file_source;
                     ov_callbacks        callbacks;
                     std::string         source_name;
+                        //the key decoded samples are cached under, empty when they aren't cached
+                    std::string         cache_key;
                     OggVorbis_File*     ogg_file;
                     vorbis_info*        info;
                     vorbis_comment*     comments;
+                    OGG_stream*         stream;
                     off_t               offset;
                     off_t               length;
                     off_t               length_pcm;
-
-                OGG_file_source() : offset(0), length(0), length_pcm(0) {
+                        //the key the seek index is shared and persisted under, empty for memory sources
+                    std::string         seek_index_key;
+                    bool                seek_index_built;
+                        //decode to interleaved float32 instead of int16, set before load_info_ogg
+                    bool                decode_float;
+                        //the LOOPSTART and LOOPLENGTH comments, in sample frames, -1 when the file has none
+                    long                loop_start;
+                    long                loop_length;
+                        //the compressed file this source reads from memory, when it is resident.
+                        //a member so it outlives the file_source closed in the destructor
+                    Audio_resident_bytes resident;
+                    std::shared_ptr<const OGG_seek_index> seek_index;
+
+                OGG_file_source() : stream(NULL), offset(0), length(0), length_pcm(0), seek_index_built(false), decode_float(false), loop_start(-1), loop_length(-1) {
 
                     ogg_file = new OggVorbis_File();
 
@@ -69,6 +292,9 @@ namespace snow {
 
                 ~OGG_file_source() {
 
+                        //the decode worker must let go of the file before it closes
+                    stream_stop_ogg(this);
+
                     ov_clear(ogg_file);
                     delete ogg_file;
 
@@ -83,6 +309,8 @@ namespace snow {
                 public:
                     snow::io::iosrc*   file_source;
                     std::string         source_name;
+                        //the key decoded samples are cached under, empty when they aren't cached
+                    std::string         cache_key;
                     int                 channels;
                     int                 rate;
                     int                 bitrate;
@@ -91,6 +319,8 @@ namespace snow {
                     off_t               offset;
                     off_t               length;
                     off_t               length_pcm;
+                        //when mapped, file_source reads from this instead of the file
+                    snow::io::iomap     map;
 
                 WAV_file_source() : offset(0), length(0), length_pcm(0) {
 
@@ -105,6 +335,8 @@ namespace snow {
 
                     file_source = NULL;
 
+                    snow::io::unmap_file( map );
+
                 } //~
 
             }; //WAV_file_source
@@ -116,6 +348,8 @@ namespace snow {
                 public:
                     snow::io::iosrc*   file_source;
                     std::string         source_name;
+                        //the key decoded samples are cached under, empty when they aren't cached
+                    std::string         cache_key;
                     int                 channels;
                     int                 rate;
                     int                 bitrate;
@@ -123,6 +357,8 @@ namespace snow {
                     off_t               offset;
                     off_t               length;
                     off_t               length_pcm;
+                        //when mapped, file_source reads from this instead of the file
+                    snow::io::iomap     map;
 
                 PCM_file_source() : offset(0), length(0), length_pcm(0) {
 
@@ -137,10 +373,100 @@ namespace snow {
 
                     file_source = NULL;
 
+                    snow::io::unmap_file( map );
+
                 } //~
 
             }; //PCM_file_source
 
+        //ADPCM file source
+
+                //IMA-ADPCM samples held compressed in memory, about a quarter the size of 16 bit pcm.
+                //The blocks come from a wav with format tag 0x11, or are encoded from a 16 bit pcm wav at load,
+                //and are decoded to int16 a block at a time as they are read. The file is closed once loaded.
+            class ADPCM_file_source {
+
+                public:
+                    snow::io::iosrc*   file_source;
+                    std::string         source_name;
+                        //always empty, caching the decoded samples would undo the saving
+                    std::string         cache_key;
+                    int                 channels;
+                    int                 rate;
+                    int                 bitrate;
+                    int                 bits_per_sample;
+                        //bytes in one block, for all channels
+                    int                 block_align;
+                        //frames decoded from one block
+                    int                 samples_per_block;
+                    long                block_count;
+                        //the decoded position, in bytes of int16 pcm
+                    off_t               offset;
+                        //compressed bytes
+                    off_t               length;
+                    off_t               length_pcm;
+                    std::vector<unsigned char>  blocks;
+                        //one decoded block, for reads that start or end part way into one
+                    std::vector<short>  scratch;
+                    long                scratch_block;
+
+                ADPCM_file_source() : file_source(NULL), channels(0), rate(0), bitrate(0), bits_per_sample(16),
+                    block_align(0), samples_per_block(0), block_count(0), offset(0), length(0), length_pcm(0), scratch_block(-1) {
+
+                } //ADPCM_file_source
+
+                ~ADPCM_file_source() {
+
+                    if(file_source) {
+                        snow::io::close( file_source );
+                    }
+
+                    file_source = NULL;
+
+                } //~
+
+            }; //ADPCM_file_source
+
+
+        //Batch loading
+
+                //One file of a batch, opened and fully decoded by a worker thread.
+                //Once finished, exactly one of the sources is set if it succeeded,
+                //and the caller takes ownership of it (and the samples) when collecting.
+                //Samples that are cached are shared with the cache, the rest are in samples.
+            struct Audio_batch_item {
+
+                std::string                 id;
+                int                         format; //1 ogg, 2 wav, 3 pcm
+                OGG_file_source*            ogg_source;
+                WAV_file_source*            wav_source;
+                PCM_file_source*            pcm_source;
+                std::vector<unsigned char>  samples;
+                Audio_cache_samples         shared;
+
+                Audio_batch_item() : format(0), ogg_source(NULL), wav_source(NULL), pcm_source(NULL) {}
+
+            }; //Audio_batch_item
+
+                //A list of files decoded in parallel by a set of workers sized to the machine.
+                //Workers claim the next item through a counter, and report finished indices
+                //under the lock, which the main thread drains with load_batch_poll.
+            class Audio_batch {
+
+                public:
+                    std::vector<Audio_batch_item>   items;
+                    std::vector<std::thread>        workers;
+                    std::atomic<size_t>             next;
+                    std::atomic<bool>               cancel;
+                    bool                            decode_float;
+                        //finished but not yet collected, guarded by lock
+                    std::mutex                      lock;
+                    std::vector<size_t>             finished;
+
+                Audio_batch() : next(0), cancel(false), decode_float(false) {}
+
+            }; //Audio_batch
+
         } //assets::audio namespace
 
     } //assets namespace
@@ -0,0 +1,83 @@
+#ifndef _SNOW_AUDIO_CONVERT_H_
+#define _SNOW_AUDIO_CONVERT_H_
+
+#include <vector>
+
+    //pick the widest vector path the target guarantees, anything else takes the scalar path
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define SNOW_AUDIO_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #define SNOW_AUDIO_NEON 1
+#endif
+
+namespace snow {
+
+    namespace audio {
+
+            //planar float channels (as libvorbis decodes them) into interleaved float32 frames
+        void planar_to_f32( float** planes, int channels, long frames, float* dest );
+
+            //planar float channels into interleaved int16 frames,
+            //rounded and clamped the same way ov_read does it
+        void planar_to_s16( float** planes, int channels, long frames, short* dest );
+
+        //interleaved sample conversion, counts are in samples (frames * channels)
+
+            //unsigned 8 bit (as wav stores it) to signed 16 bit
+        void u8_to_s16( const unsigned char* src, long count, short* dest );
+            //16 bit to float in [-1, 1)
+        void s16_to_f32( const short* src, long count, float* dest );
+            //float to 16 bit, rounded and clamped like planar_to_s16
+        void f32_to_s16( const float* src, long count, short* dest );
+
+        //stereo to mono, averaging each frame
+
+        void downmix_s16( const short* src, long frames, short* dest );
+        void downmix_f32( const float* src, long frames, float* dest );
+
+        //linear interpolation rate conversion of interleaved frames
+
+            //the number of frames resampling frames at from_rate gives at to_rate
+        long resample_frames( long frames, int from_rate, int to_rate );
+        void resample_s16( const short* src, int channels, long frames, int from_rate, int to_rate, short* dest );
+        void resample_f32( const float* src, int channels, long frames, int from_rate, int to_rate, float* dest );
+
+        //whole buffer conversion
+
+            //sample formats, the values match AudioSampleFormat on the haxe side
+        enum Sample_format {
+            sf_unknown  = 0,
+            sf_u8       = 1,
+            sf_s16      = 2,
+            sf_f32      = 3
+        };
+
+            //a 0 in any field of a target means keep the source value
+        struct Audio_format {
+            int sample_format;
+            int channels;
+            int rate;
+        };
+
+            //convert interleaved samples between formats, downmixing stereo to mono and changing rate as requested.
+            //the target is resolved to what was produced: u8 output and channel counts other than 2 -> 1 are not done.
+            //returns false, leaving out empty, if nothing needed converting.
+        bool convert( const unsigned char* src, long length, const Audio_format &from, Audio_format &to, std::vector<unsigned char> &out );
+
+        //IMA-ADPCM, in the block layout of wav format tag 0x11.
+        //each block starts with a 4 byte header per channel (the first sample and step index),
+        //followed by 4 bytes of 8 nibbles per channel in turn.
+
+            //the frames one block of block_align bytes holds
+        int ima_samples_per_block( int block_align, int channels );
+            //decode whole blocks to interleaved int16, ima_samples_per_block frames each
+        void ima_decode_blocks( const unsigned char* src, long blocks, int block_align, int channels, short* dest );
+            //encode interleaved int16 frames, appending whole blocks to out with the last padded with silence.
+            //returns the number of blocks appended
+        long ima_encode( const short* src, int channels, long frames, int block_align, std::vector<unsigned char> &out );
+
+    } //audio namespace
+
+} //snow namespace
+
+#endif //_SNOW_AUDIO_CONVERT_H_
@@ -0,0 +1,104 @@
+#ifndef _SNOW_AUDIO_MIX_H_
+#define _SNOW_AUDIO_MIX_H_
+
+#include "audio/snow_audio_convert.h"
+
+#include <vector>
+#include <memory>
+
+namespace snow {
+
+    namespace audio {
+
+        //software mixing of many light voices into one interleaved stereo float32 block.
+        //this is only the mixing, whoever owns a Mixer owns the thread it runs on and where the
+        //output goes, and serializes access to the mixer and its voices.
+
+        //mixing kernels, counts are in frames. the gains ramp linearly from the from pair
+        //at the first frame toward the to pair, so a gain or pan change doesn't click
+
+            //adds mono src into interleaved stereo dest
+        void mix_mono( const float* src, long frames, float left_from, float right_from, float left_to, float right_to, float* dest );
+            //adds interleaved stereo src into interleaved stereo dest
+        void mix_stereo( const float* src, long frames, float left_from, float right_from, float left_to, float right_to, float* dest );
+
+            //decoded audio, interleaved float32 frames of 1 or 2 channels, shared by the voices playing it
+        struct Mix_sample {
+
+            std::vector<float>  data;
+            int                 channels;
+            int                 rate;
+            long                frames;
+
+        }; //Mix_sample
+
+            //samples of any Sample_format as a Mix_sample, or null for anything but 1 or 2 channels
+        std::shared_ptr<Mix_sample> mix_sample( const unsigned char* src, long length, int sample_format, int channels, int rate );
+
+        enum Mix_state {
+            mix_stopped = 0,
+            mix_playing = 1,
+            mix_paused  = 2
+        };
+
+            //one playing instance of a sample
+        struct Mix_voice {
+
+            std::shared_ptr<Mix_sample> sample;
+                //in frames of the sample, with a fraction while pitched
+            double  position;
+            float   gain;
+                //-1 is left, 1 is right. stereo samples are balanced rather than panned
+            float   pan;
+                //a rate scale, 2 is an octave up
+            float   pitch;
+            bool    looping;
+            int     state;
+                //the gains the last block ended on, the next block ramps from them
+            float   left;
+            float   right;
+
+            Mix_voice( std::shared_ptr<Mix_sample> _sample ) :
+                sample(_sample), position(0), gain(1.0f), pan(0.0f), pitch(1.0f),
+                looping(false), state(mix_stopped), left(0.0f), right(0.0f) {}
+
+        }; //Mix_voice
+
+        class Mixer {
+
+            public:
+
+                    //the rate the output is mixed at, voices are resampled to it
+                int                         rate;
+                    //the voices are owned by the caller, and added and removed by it
+                std::vector<Mix_voice*>     voices;
+
+                Mixer( int _rate ) : rate(_rate) {}
+
+                void add( Mix_voice* voice );
+                void remove( Mix_voice* voice );
+
+                    //start a voice, from the start unless it was paused
+                void play( Mix_voice* voice );
+
+                    //mix the playing voices into frames of interleaved stereo, overwriting dest.
+                    //voices that reach the end without looping are stopped and rewound.
+                    //returns the number of voices that were mixed
+                int mix( float* dest, long frames );
+
+            private:
+
+                    //resampled frames, for pitched voices or voices at another rate
+                std::vector<float> scratch;
+
+                    //up to frames of the voice from its position, pointing src at them,
+                    //either the sample data itself or the scratch. 0 at the end of a sample that isn't looping
+                long fetch( Mix_voice* voice, long frames, const float* &src );
+
+        }; //Mixer
+
+    } //audio namespace
+
+} //snow namespace
+
+#endif //_SNOW_AUDIO_MIX_H_
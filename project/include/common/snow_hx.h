@@ -84,6 +84,23 @@ namespace snow {
         } //non-const to_bytes_rw
 
 
+            //the length of haxe.io.BytesData in bytes, 0 for null
+        inline int bytes_length_hx( value bytes ) {
+
+            if (val_is_string(bytes)) {
+                return val_strlen(bytes);
+            }
+
+            buffer buf = val_to_buffer(bytes);
+
+            if (buf == 0) {
+                return 0;
+            }
+
+            return buffer_size(buf);
+
+        } //bytes_length_hx
+
             //take note that the from_bytes function copies the memory into a newly allocated
             //haxe byte Array before returning the value to it! clean up your original if you don't need it
 
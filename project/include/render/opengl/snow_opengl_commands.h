@@ -0,0 +1,83 @@
+/*
+    Copyright Sven Bergström 2014
+    created for snow https://github.com/underscorediscovery/snow
+    MIT license
+*/
+
+#ifndef _SNOW_OPENGL_COMMANDS_H_
+#define _SNOW_OPENGL_COMMANDS_H_
+
+namespace snow {
+
+    namespace render {
+
+        //recorded gl calls, issued together by gl_execute instead of one prim call each.
+        //a command is its opcode in the int stream followed by its int arguments,
+        //and its float arguments, if any, in order in the float stream.
+        //the commands with an array argument carry their element count as an int argument,
+        //with the elements following in the stream of their type.
+        //the opcodes are mirrored in snow.modules.opengl.native.GLCommands, keep them in sync
+
+        enum GL_command {
+
+            glc_enable                          = 1,    //cap
+            glc_disable                         = 2,    //cap
+            glc_viewport                        = 3,    //x, y, width, height
+            glc_scissor                         = 4,    //x, y, width, height
+            glc_clear                           = 5,    //mask
+            glc_clear_color                     = 6,    //: r, g, b, a
+            glc_clear_depth                     = 7,    //: depth
+            glc_clear_stencil                   = 8,    //stencil
+            glc_color_mask                      = 9,    //r, g, b, a
+            glc_depth_func                      = 10,   //func
+            glc_depth_mask                      = 11,   //flag
+            glc_cull_face                       = 12,   //mode
+            glc_front_face                      = 13,   //mode
+            glc_blend_func                      = 14,   //src, dst
+            glc_blend_func_separate             = 15,   //src_rgb, dst_rgb, src_alpha, dst_alpha
+            glc_blend_equation                  = 16,   //mode
+            glc_blend_equation_separate         = 17,   //mode_rgb, mode_alpha
+            glc_blend_color                     = 18,   //: r, g, b, a
+            glc_stencil_func                    = 19,   //func, ref, mask
+            glc_stencil_op                      = 20,   //fail, zfail, zpass
+            glc_stencil_mask                    = 21,   //mask
+            glc_line_width                      = 22,   //: width
+            glc_polygon_offset                  = 23,   //: factor, units
+            glc_use_program                     = 24,   //program
+            glc_bind_buffer                     = 25,   //target, buffer
+            glc_bind_framebuffer                = 26,   //target, framebuffer
+            glc_bind_renderbuffer               = 27,   //target, renderbuffer
+            glc_active_texture                  = 28,   //texture
+            glc_bind_texture                    = 29,   //target, texture
+            glc_tex_parameteri                  = 30,   //target, pname, param
+            glc_pixel_storei                    = 31,   //pname, param
+            glc_enable_vertex_attrib_array      = 32,   //index
+            glc_disable_vertex_attrib_array     = 33,   //index
+            glc_vertex_attrib_pointer           = 34,   //index, size, type, normalized, stride, offset
+            glc_uniform1i                       = 35,   //location, x
+            glc_uniform2i                       = 36,   //location, x, y
+            glc_uniform3i                       = 37,   //location, x, y, z
+            glc_uniform4i                       = 38,   //location, x, y, z, w
+            glc_uniform1f                       = 39,   //location : x
+            glc_uniform2f                       = 40,   //location : x, y
+            glc_uniform3f                       = 41,   //location : x, y, z
+            glc_uniform4f                       = 42,   //location : x, y, z, w
+            glc_uniform_iv                      = 43,   //location, size, count, size*count ints
+            glc_uniform_fv                      = 44,   //location, size, count : size*count floats
+            glc_uniform_matrix                  = 45,   //location, transpose, size, count : size*size*count floats
+            glc_draw_arrays                     = 46,   //mode, first, count
+            glc_draw_elements                   = 47,   //mode, count, type, offset
+
+            glc_count                           = 48
+
+        }; //GL_command
+
+            //issue up to count commands from the streams, returns the number issued.
+            //stops early, logging why, at an unknown opcode or a command that runs past the end of a stream
+        int gl_execute( const int* ints, int int_count, const float* floats, int float_count, int count );
+
+    } //render namespace
+
+} //snow namespace
+
+#endif //_SNOW_OPENGL_COMMANDS_H_
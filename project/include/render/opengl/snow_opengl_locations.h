@@ -0,0 +1,37 @@
+/*
+    Copyright Sven Bergström 2014
+    created for snow https://github.com/underscorediscovery/snow
+    MIT license
+*/
+
+#ifndef _SNOW_OPENGL_LOCATIONS_H_
+#define _SNOW_OPENGL_LOCATIONS_H_
+
+#include "render/opengl/snow_opengl.h"
+
+namespace snow {
+
+    namespace render {
+
+        //the uniform and attribute locations of each program, read once when it links
+        //from the active uniforms and attributes, and looked up after by an interned name id
+        //instead of a string. array uniforms are there as both `name` and `name[i]`.
+        //a relink reads them again, deleting the program drops them
+
+            //the id of a name, the same for the same name, from 0 up
+        int gl_name_intern( const char* name );
+
+            //read the locations of a program, after it links
+        void gl_locations_build( GLuint program );
+            //forget the locations of a program, when it's deleted
+        void gl_locations_forget( GLuint program );
+
+            //-1 when the program has no such active uniform or attribute, or didn't link
+        GLint gl_uniform_location( GLuint program, int name );
+        GLint gl_attrib_location( GLuint program, int name );
+
+    } //render namespace
+
+} //snow namespace
+
+#endif //_SNOW_OPENGL_LOCATIONS_H_
@@ -0,0 +1,58 @@
+/*
+    Copyright Sven Bergström 2014
+    created for snow https://github.com/underscorediscovery/snow
+    MIT license
+*/
+
+#ifndef _SNOW_OPENGL_STATE_H_
+#define _SNOW_OPENGL_STATE_H_
+
+#include "render/opengl/snow_opengl.h"
+
+namespace snow {
+
+    namespace render {
+
+        //an optional shadow of the gl state that's changed most, so that setting it
+        //to what it already is doesn't reach the driver. Off by default, in which case
+        //the gl_state_* calls below only forward to gl.
+        //it tracks the current program, the array and element array buffers, the active texture unit
+        //and its 2d and cube map textures, the common caps, blend, depth, cull and the viewport.
+        //anything changing those without going through here leaves the shadow wrong,
+        //so whoever does that has to call gl_state_invalidate after.
+
+            //turn the shadow on or off, either way it starts over as unknown
+        void gl_state_cache_enable( bool enable );
+        bool gl_state_cache_enabled();
+            //forget everything, so the next call of each kind reaches gl
+        void gl_state_invalidate();
+            //end a frame, the counters of the frame are kept for gl_state_counters and start over
+        void gl_state_frame();
+            //the calls that reached gl, and the ones dropped as redundant, in the last frame
+        void gl_state_counters( int* issued, int* skipped );
+
+        void gl_state_enable( GLenum cap, bool enable );
+        void gl_state_use_program( GLuint program );
+        void gl_state_bind_buffer( GLenum target, GLuint buffer );
+        void gl_state_active_texture( GLenum texture );
+        void gl_state_bind_texture( GLenum target, GLuint texture );
+        void gl_state_blend_func( GLenum src, GLenum dst );
+        void gl_state_blend_func_separate( GLenum src_rgb, GLenum dst_rgb, GLenum src_alpha, GLenum dst_alpha );
+        void gl_state_blend_equation( GLenum mode );
+        void gl_state_blend_equation_separate( GLenum mode_rgb, GLenum mode_alpha );
+        void gl_state_depth_func( GLenum func );
+        void gl_state_depth_mask( bool flag );
+        void gl_state_cull_face( GLenum mode );
+        void gl_state_front_face( GLenum mode );
+        void gl_state_viewport( GLint x, GLint y, GLsizei width, GLsizei height );
+
+            //deleting a bound object unbinds it, these delete and keep the shadow in step
+        void gl_state_delete_program( GLuint program );
+        void gl_state_delete_buffer( GLuint buffer );
+        void gl_state_delete_texture( GLuint texture );
+
+    } //render namespace
+
+} //snow namespace
+
+#endif //_SNOW_OPENGL_STATE_H_
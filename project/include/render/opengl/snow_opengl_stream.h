@@ -0,0 +1,62 @@
+/*
+    Copyright Sven Bergström 2014
+    created for snow https://github.com/underscorediscovery/snow
+    MIT license
+*/
+
+#ifndef _SNOW_OPENGL_STREAM_H_
+#define _SNOW_OPENGL_STREAM_H_
+
+#include "render/opengl/snow_opengl.h"
+
+namespace snow {
+
+    namespace render {
+
+        //a buffer for geometry rewritten every frame, written without waiting on the gpu.
+        //it's a ring of gl_stream_segments segments, each big enough for a frame,
+        //written through unsynchronized mapped ranges. a fence at the end of each segment
+        //keeps writes out of one the gpu may still be drawing from.
+        //where mapping isn't available (gles2) it orphans the storage instead when it fills up
+
+        enum {
+            gl_stream_segments = 3
+        };
+
+        #ifdef SNOW_GLES
+            typedef void* GL_stream_fence;
+        #else
+            typedef GLsync GL_stream_fence;
+        #endif
+
+        struct GL_stream_buffer {
+
+            GLuint      buffer;
+            GLenum      target;
+            GLenum      usage;
+                //the size of one segment in bytes
+            int         size;
+                //the segment being written, and how far into it
+            int         segment;
+            int         offset;
+                //whether this uses mapped ranges, or orphans otherwise
+            bool        mapped;
+            GL_stream_fence fences[gl_stream_segments];
+
+        }; //GL_stream_buffer
+
+            //a stream buffer for target with segments of size bytes, null if the buffer couldn't be made
+        GL_stream_buffer* gl_stream_create( GLenum target, int size, GLenum usage );
+        void gl_stream_destroy( GL_stream_buffer* stream );
+            //copy bytes into the stream, moving to the next segment when they don't fit in this one.
+            //returns the byte offset in the gl buffer they were written at, or -1 when they're bigger than a segment.
+            //leaves the buffer bound to its target
+        int gl_stream_write( GL_stream_buffer* stream, const unsigned char* bytes, int length );
+            //done with the current segment for this frame, the next write starts on the next segment
+        void gl_stream_next( GL_stream_buffer* stream );
+
+    } //render namespace
+
+} //snow namespace
+
+#endif //_SNOW_OPENGL_STREAM_H_
@@ -23,6 +23,9 @@ namespace snow {
         void update_filewatch();
         void shutdown_filewatch();
     }
+    namespace assets { namespace audio {
+        void cache_clear();
+    } }
 
 //snow systems
 
@@ -202,6 +205,11 @@ namespace snow {
                 //tell the platform
             on_system_event_platform(event);
 
+                //decoded audio can be decoded again, so it goes first
+            if(event == se_app_lowmemory) {
+                snow::assets::audio::cache_clear();
+            }
+
             event_handler(event);
 
         } //dispatch_system_event
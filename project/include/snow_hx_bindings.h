@@ -91,6 +91,17 @@ namespace snow {
     extern int id_rate;
     extern int id_bitrate;
     extern int id_bits_per_sample;
+    extern int id_sample_format;
+    extern int id_mapped;
+    extern int id_loop_start;
+    extern int id_loop_length;
+    extern int id_index;
+    extern int id_info;
+    extern int id_hits;
+    extern int id_misses;
+    extern int id_evictions;
+    extern int id_entries;
+    extern int id_budget;
     extern int id_bitrate_upper;
     extern int id_bitrate_nominal;
     extern int id_bitrate_lower;
@@ -196,6 +207,17 @@ namespace snow {
         id_rate                 = val_id("rate");
         id_bitrate              = val_id("bitrate");
         id_bits_per_sample      = val_id("bits_per_sample");
+        id_sample_format        = val_id("sample_format");
+        id_mapped               = val_id("mapped");
+        id_loop_start           = val_id("loop_start");
+        id_loop_length          = val_id("loop_length");
+        id_index                = val_id("index");
+        id_info                 = val_id("info");
+        id_hits                 = val_id("hits");
+        id_misses               = val_id("misses");
+        id_evictions            = val_id("evictions");
+        id_entries              = val_id("entries");
+        id_budget               = val_id("budget");
         id_bitrate_upper        = val_id("bitrate_upper");
         id_bitrate_nominal      = val_id("bitrate_nominal");
         id_bitrate_lower        = val_id("bitrate_lower");
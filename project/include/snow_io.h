@@ -200,6 +200,22 @@ namespace snow {
         long int tell(iosrc* src);
         long int close(iosrc* src);
 
+//memory mapped files
+
+            //a read only mapping of a whole file, shared through the page cache.
+        struct iomap {
+
+            const unsigned char* data;
+            size_t length;
+
+            iomap() : data(NULL), length(0) {}
+
+        }; //iomap
+
+            //filled in by platform specific handlers, returns false where unsupported
+        bool map_file(const char *file, iomap &map);
+        void unmap_file(iomap &map);
+
 
         class iosrc_file {
 
@@ -9,6 +9,11 @@
 
 
 namespace snow {
+
+    namespace window {
+        class Window;
+    }
+
     namespace render {
 
         void set_context_attributes(
@@ -16,6 +21,47 @@ namespace snow {
             int depth_bits, int stencil_bits, int antialiasing
         );
 
+            //the optional render thread. while it runs, the gl context of the window lives on it,
+            //drawing the recorded frames handed to it and swapping after them,
+            //so the main thread can work on the next frame meanwhile.
+            //direct gl calls from another thread need the context, and have to acquire it first
+
+            //move the window's context onto a new render thread, false if one is running already
+        bool render_thread_start( window::Window* window );
+            //finish the submitted frames, stop the thread and make the context current on the calling thread again
+        void render_thread_stop();
+            //whether a render thread is running, and for which window
+        bool render_thread_active();
+        bool render_thread_owns( window::Window* window );
+            //whether the context is acquired away from the render thread. direct gl calls
+            //are only safe while it is, or while no render thread is running
+        bool render_thread_acquired();
+            //copy a recorded frame (see gl_execute) into a free slot for the render thread,
+            //swapping the window after it when swap is true. There are two slots,
+            //so this waits while the thread still has two earlier frames to draw
+        void render_thread_submit( const int* ints, int int_count, const float* floats, int float_count, int count, bool swap );
+            //wait until the submitted frames are drawn
+        void render_thread_finish();
+            //a sync point, the submitted frames are drawn and the context is made current on the
+            //calling thread, until the matching release. these nest, only the outer pair moves the context
+        void render_thread_acquire();
+        void render_thread_release();
+
+            //acquires the context for its scope when a render thread is running, for direct calls that need it
+        struct Render_thread_sync {
+
+            bool acquired;
+
+            Render_thread_sync() : acquired(render_thread_active()) {
+                if(acquired) render_thread_acquire();
+            }
+
+            ~Render_thread_sync() {
+                if(acquired) render_thread_release();
+            }
+
+        }; //Render_thread_sync
+
     } //render namespace
 } //snow namespace
 
@@ -251,6 +251,8 @@ namespace snow {
                 virtual void update() = 0;
                 virtual void render() = 0;
                 virtual void swap() = 0;
+                    //make the gl context current on the calling thread, or release it from it
+                virtual void make_current( bool current ) = 0;
                 virtual void close() = 0;
                 virtual void show() = 0;
                 virtual void destroy() = 0;
@@ -6,10 +6,25 @@
 */
 
 #include "assets/snow_assets_audio.h"
+#include "audio/snow_audio_convert.h"
 
 #include "snow_core.h"
 
 #include <string>
+#include <deque>
+#include <map>
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <atomic>
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
 
 
 namespace snow {
@@ -17,15 +32,96 @@ namespace snow {
         namespace audio {
 
 
+        //decode counters
+
+                //every call into a reader, the pcm it gave back and the time it took, from any thread
+            static std::atomic<long long> decode_calls(0);
+            static std::atomic<long long> decode_bytes(0);
+            static std::atomic<long long> decode_ns(0);
+            static std::atomic<long long> decode_ns_max(0);
+
+                //times the reader it is made in, counting what was read as it goes out of scope
+            class Decode_timer {
+
+                public:
+
+                    Decode_timer( long &_bytes_read ) : bytes_read(_bytes_read), start(std::chrono::steady_clock::now()) {}
+
+                    ~Decode_timer() {
+
+                        long long _ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+                        decode_calls++;
+                        decode_bytes += bytes_read;
+                        decode_ns += _ns;
+
+                        long long _max = decode_ns_max.load();
+                        while(_ns > _max && !decode_ns_max.compare_exchange_weak(_max, _ns)) {}
+
+                    } //~
+
+                private:
+
+                    long &bytes_read;
+                    std::chrono::steady_clock::time_point start;
+
+            }; //Decode_timer
+
+            Audio_decode_stats decode_stats( bool reset_max ) {
+
+                Audio_decode_stats _stats;
+
+                    _stats.calls = decode_calls.load();
+                    _stats.bytes = decode_bytes.load();
+                    _stats.ns = decode_ns.load();
+                    _stats.ns_max = reset_max ? decode_ns_max.exchange(0) : decode_ns_max.load();
+
+                return _stats;
+
+            } //decode_stats
+
+
         //OGG files
 
                 //forward
+            static void     ogg_decode_ahead(OGG_file_source* ogg_source);
+            static long     ogg_decode(OGG_file_source* ogg_source, unsigned char* dest, long len);
+            static long     ogg_frame_bytes(OGG_file_source* ogg_source);
             static size_t   ogg_read_func(void* ptr, size_t size, size_t nmemb, void* datasource);
             static int      ogg_seek_func(void* datasource, ogg_int64_t offset, int whence);
             static int      ogg_close_func(void* datasource);
             static long     ogg_tell_func(void* datasource);
 
 
+                //the value of a NAME=value comment as a number, or -1 when the comments don't have it.
+                //the names of vorbis comments are case insensitive
+            static long ogg_comment_long( vorbis_comment* comments, const char* name ) {
+
+                size_t _name_len = strlen(name);
+
+                for(int i = 0; i < comments->comments; i++) {
+
+                    const char* _comment = comments->user_comments[i];
+
+                    if((size_t)comments->comment_lengths[i] <= _name_len || _comment[_name_len] != '=') {
+                        continue;
+                    }
+
+                    size_t c = 0;
+                    while(c < _name_len && toupper((unsigned char)_comment[c]) == name[c]) {
+                        ++c;
+                    }
+
+                    if(c == _name_len) {
+                        return atol(_comment + _name_len + 1);
+                    }
+
+                } //each comment
+
+                return -1;
+
+            } //ogg_comment_long
+
                 //load an ogg info object, if read is false it will not read any data from the file, just open and setup the info/comments
             bool load_info_ogg( QuickVec<unsigned char> &out_buffer, const char* _id, OGG_file_source*& ogg_source, bool read ) {
 
@@ -71,8 +167,8 @@ namespace snow {
                 ogg_source->info = ov_info(ogg_source->ogg_file, -1);
                 ogg_source->comments = ov_comment(ogg_source->ogg_file, -1);
 
-                    //(2) here is word size, 16 bit is 2, 8 bit is 1
-                ogg_int64_t total_length = ov_pcm_total( ogg_source->ogg_file, -1 ) * ogg_source->info->channels * (2);
+                    //in bytes of the decoded format, int16 or float32 frames
+                ogg_int64_t total_length = ov_pcm_total( ogg_source->ogg_file, -1 ) * ogg_frame_bytes(ogg_source);
 
                 ogg_source->length_pcm = total_length;
 
@@ -94,6 +190,10 @@ namespace snow {
                     snow::log(3, "/ snow /           %s\n",  ogg_source->comments->user_comments[i]);
                 }
 
+                    //loop points, in the LOOPSTART and LOOPLENGTH convention many tools write
+                ogg_source->loop_start = ogg_comment_long(ogg_source->comments, "LOOPSTART");
+                ogg_source->loop_length = ogg_comment_long(ogg_source->comments, "LOOPLENGTH");
+
                     //use the reader to read it, if requested
                 if(read) {
                     read_bytes_ogg( ogg_source, out_buffer, 0, total_length );
@@ -105,353 +205,1219 @@ namespace snow {
             } //load_info_ogg
 
 
-            bool seek_bytes_ogg( OGG_file_source* ogg_source, long to ) {
+        //OGG decode workers
 
-                if(ogg_source) {
+                //A small pool of threads shared by all streamed ogg sources, sized to the
+                //machine so that many concurrent streams decode in parallel. A source sits
+                //in the pending queue at most once, and is only ever decoded by one worker at a time.
+                //The workers are ended by shutdown, from the audio shutdown path, never by a destructor.
+            class OGG_decode_pool {
 
-                    snow::log(3, "/ snow / seeking in %s ogg source to %d/%d (%f)", ogg_source->source_name.c_str(), to, ogg_source->length_pcm, (float)to / (float)ogg_source->length_pcm);
+                public:
 
-                        //:todo: ogg is always 16?
-                    long to_samples = to/16;
+                    std::mutex                      lock;
+                    std::condition_variable         work_cond;
+                    std::condition_variable         idle_cond;
+                    std::deque<OGG_file_source*>    pending;
+                    std::vector<std::thread>        workers;
+                    bool                            running;
 
-                        //pcm seek is in samples, not bytes
-                    int res = ov_pcm_seek( ogg_source->ogg_file, to_samples );
+                OGG_decode_pool() : running(false) {}
 
-                    if(res != 0) {
+                    //end the workers, after the one decoding lets go of its source.
+                    //a later kick starts them again
+                void shutdown() {
 
-                        if(res == OV_ENOSEEK) {
-                            snow::log(1, "/ snow / audio / ogg seek error %s", "OV_ENOSEEK");
-                        }
-                        if(res == OV_EINVAL) {
-                            snow::log(1, "/ snow / audio / ogg seek error %s", "OV_EINVAL");
-                        }
-                        if(res == OV_EREAD) {
-                            snow::log(1, "/ snow / audio / ogg seek error %s", "OV_EREAD");
-                        }
-                        if(res == OV_EFAULT) {
-                            snow::log(1, "/ snow / audio / ogg seek error %s", "OV_EFAULT");
-                        }
-                        if(res == OV_EBADLINK) {
-                            snow::log(1, "/ snow / audio / ogg seek error %s", "OV_EBADLINK");
+                    {
+                        std::unique_lock<std::mutex> _guard(lock);
+
+                        running = false;
+
+                        for(size_t i = 0; i < pending.size(); ++i) {
+                            pending[i]->stream->queued = false;
                         }
 
-                        return false;
+                        pending.clear();
                     }
 
-                    // snow::log("seeking ogg_source %d res:%d", to, res);
+                    work_cond.notify_all();
 
-                    return true;
-                }
+                    for(size_t i = 0; i < workers.size(); ++i) {
+                        workers[i].join();
+                    }
 
-                return false;
+                    workers.clear();
 
-            } //seek_bytes_ogg
+                    idle_cond.notify_all();
 
+                } //shutdown
 
-                //this reads a portion of an already opened ogg source into the buffer from start, for len
-            bool read_bytes_ogg( OGG_file_source* ogg_source, QuickVec<unsigned char> &out_buffer, long start, long len ) {
+                    //wake a worker for this source, if it isn't already pending or decoding
+                void kick( OGG_file_source* ogg_source ) {
 
-                //it is assumed here that ogg_source is opened. Maybe we can ask the file if it is open and if not reopen it?
+                    {
+                        std::unique_lock<std::mutex> _guard(lock);
+                        enqueue(ogg_source);
+                    }
 
-                bool complete = false;
-                int word = 2; //1 for 8 bit, 2 for 16 bit. 2 is typical
-                int sgned = 1; //0 for unsigned, 1 is typical
-                int bit_stream = 1;
+                    work_cond.notify_one();
 
-                long _read_len = len;
+                } //kick
 
-                if(start != -1) {
-                    // snow::log("start was %d, skipping there first", start);
-                    seek_bytes_ogg( ogg_source, start );
-                }
+                    //take a source out of circulation and wait until no worker is touching it,
+                    //after which the caller may use the ogg file and ring from this thread
+                void halt( OGG_file_source* ogg_source ) {
 
-                    //resize to fit the requested length, but pad it slightly to align
-                long byte_gap = (_read_len & 0x03);
-                out_buffer.resize(_read_len + byte_gap);
+                    OGG_stream* stream = ogg_source->stream;
 
-                bool reading = true;
-                long bytes_left = _read_len;
-                long total_read = 0;
-                long bytes_read = 0;
+                    stream->interrupt.store(true);
 
-                while(reading) {
+                    std::unique_lock<std::mutex> _guard(lock);
 
-                    long _read_max = OGG_BUFFER_LENGTH;
+                    stream->halted = true;
+                    stream->requeue = false;
 
-                    if(bytes_left < _read_max) {
-                        _read_max = bytes_left;
+                    if(stream->queued) {
+                        pending.erase( std::find(pending.begin(), pending.end(), ogg_source) );
+                        stream->queued = false;
                     }
 
-                        // Read the decoded sound data
-                    bytes_read = ov_read( ogg_source->ogg_file, (char*)out_buffer.begin() + total_read, _read_max, OGG_BUFFER_READ_TYPE, word, sgned, &bit_stream);
-
-                    total_read += bytes_read;
-                    bytes_left -= bytes_read;
-
-                        //at the end?
-                    if(bytes_read == 0) {
-                        reading = false;
-                        complete = true;
+                    while(stream->busy) {
+                        idle_cond.wait(_guard);
                     }
 
-                    if(total_read >= _read_len) {
-                        reading = false;
-                    }
+                    stream->interrupt.store(false);
 
-                } //while
+                } //halt
 
-                    //we need the buffer length to reflect the real size,
-                    //just in case it read shorter than requested
-                if(total_read != _read_len) {
-                    long byte_gap = (_read_len & 0x03);
-                    out_buffer.resize(total_read+byte_gap);
-                }
+                void resume( OGG_file_source* ogg_source ) {
 
-                return complete;
+                    {
+                        std::unique_lock<std::mutex> _guard(lock);
+                        ogg_source->stream->halted = false;
+                        enqueue(ogg_source);
+                    }
 
-            } //read_bytes_ogg
+                    work_cond.notify_one();
 
+                } //resume
 
-            static size_t ogg_read_func(void* ptr, size_t size, size_t nmemb, void* datasource) {
+                private:
 
-                OGG_file_source *source = (OGG_file_source*)datasource;
+                        //must be called with the lock held
+                    void enqueue( OGG_file_source* ogg_source ) {
 
-                // snow::log("\t read  : %s, filelen:%lld amount:%lu\n", source->source_name.c_str(),source->length, size * nmemb);
+                        OGG_stream* stream = ogg_source->stream;
 
-                return snow::io::read(source->file_source, ptr, size, nmemb);
+                        if(stream->halted || stream->queued) {
+                            return;
+                        }
 
-            } //read_func
+                            //the worker will pick it up again once it's done
+                        if(stream->busy) {
+                            stream->requeue = true;
+                            return;
+                        }
 
-            static int ogg_seek_func(void* datasource, ogg_int64_t offset, int whence) {
+                        if(!running) {
+                            start();
+                        }
 
-                OGG_file_source *source = (OGG_file_source*)datasource;
+                        stream->queued = true;
+                        pending.push_back(ogg_source);
 
-                int _type = whence;
+                    } //enqueue
 
-                switch (whence) {
+                        //must be called with the lock held
+                    void start() {
 
-                    case SEEK_SET: {
-                        _type = snow_seek_set;
-                        break;
-                    }
-                    case SEEK_CUR: {
-                        _type = snow_seek_cur;
-                        break;
-                    }
-                    case SEEK_END: {
-                        _type = snow_seek_end;
-                        break;
-                    }
+                        unsigned int _cores = std::thread::hardware_concurrency();
+                        unsigned int _count = _cores > 1 ? _cores - 1 : 1;
 
-                } //switch(whence)
+                        running = true;
 
-                // snow::log("\t seek  : %s, offset:%lld whence:%d \n", source->source_name.c_str(), offset, _type);
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            workers.push_back( std::thread(&OGG_decode_pool::run, this) );
+                        }
 
-                return snow::io::seek(source->file_source, offset, _type);
+                        snow::log(2, "/ snow / audio / started %d ogg decode workers", _count);
 
-            } //seek_func
+                    } //start
 
-            static int ogg_close_func(void* datasource) {
+                    void run() {
 
-                OGG_file_source *source = (OGG_file_source*)datasource;
+                        std::unique_lock<std::mutex> _guard(lock);
 
-                snow::log(2, "/ snow / ogg closing the file source for %s", source->source_name.c_str());
+                        while(running) {
 
-                return snow::io::close(source->file_source);
+                            if(pending.empty()) {
+                                work_cond.wait(_guard);
+                                continue;
+                            }
 
-            } //close_func
+                            OGG_file_source* ogg_source = pending.front();
+                            OGG_stream* stream = ogg_source->stream;
 
-            static long ogg_tell_func(void* datasource) {
+                            pending.pop_front();
 
-                OGG_file_source *source = (OGG_file_source*)datasource;
+                            stream->queued = false;
+                            stream->busy = true;
 
-                return (long)snow::io::tell(source->file_source) - source->offset;
+                            _guard.unlock();
 
-            } //tell_func
+                                ogg_decode_ahead(ogg_source);
 
-            std::string ogg_error_string(int code) {
+                            _guard.lock();
 
-                switch(code) {
+                            stream->busy = false;
 
-                    case OV_EREAD:
-                        return std::string("failed to read from media");
-                    case OV_ENOTVORBIS:
-                        return std::string("not vorbis data");
-                    case OV_EVERSION:
-                        return std::string("vorbis version mismatch");
-                    case OV_EBADHEADER:
-                        return std::string("invalid vorbis header");
-                    case OV_EFAULT:
-                        return std::string("internal logic fault (bug or heap/stack corruption.");
-                    default:
-                        return std::string("unknown ogg error");
-                }
+                            if(stream->requeue) {
+                                stream->requeue = false;
+                                enqueue(ogg_source);
+                            }
 
-            } //ogg_error_string
+                            idle_cond.notify_all();
 
+                        } //while running
 
+                    } //run
 
+            }; //OGG_decode_pool
 
-        //WAV files
+                //never destroyed, so nothing joins the workers in static destruction order,
+                //when the sources they read may already be gone. see stream_shutdown_ogg
+            static OGG_decode_pool& ogg_decode_pool = *new OGG_decode_pool();
 
+                //decodes whole frames into dest, up to len bytes, in the format the source asked for.
+                //libvorbis only hands out planar floats, the interleave and int16 conversion are done
+                //by the vector kernels rather than the scalar loop inside ov_read.
+                //returns the bytes written, 0 at the end, or a negative vorbisfile error
+            static long ogg_decode( OGG_file_source* ogg_source, unsigned char* dest, long len ) {
 
+                int channels = ogg_source->info->channels;
+                long frame_bytes = ogg_frame_bytes(ogg_source);
+                long frames = len / frame_bytes;
 
+                float** pcm = NULL;
+                int bit_stream = 0;
 
-            struct RIFF_Header {
-                char ID[4];
-                unsigned int chunkSize; //size not including chunkSize or chunkID
-                char format[4];
-            };
+                long decoded = ov_read_float( ogg_source->ogg_file, &pcm, (int)frames, &bit_stream );
 
-            struct WAVE_Format {
-                char subChunkID[4];
-                unsigned int subChunkSize;
-                short audioFormat;
-                short numChannels;
-                unsigned int sampleRate;
-                unsigned int byteRate;
-                short blockAlign;
-                short bitsPerSample;
-            };
+                if(decoded <= 0) {
+                    return decoded;
+                }
 
-            struct WAVE_Data {
-                char subChunkID[4]; //should contain the word data
-                unsigned int subChunkSize; //Stores the size of the data block
-            };
+                if(ogg_source->decode_float) {
+                    snow::audio::planar_to_f32( pcm, channels, decoded, (float*)dest );
+                } else {
+                    snow::audio::planar_to_s16( pcm, channels, decoded, (short*)dest );
+                }
 
+                return decoded * frame_bytes;
 
+            } //ogg_decode
 
-            bool wav_confirm_header(RIFF_Header &header) {
+                //how long a read waits on a worker that has fallen behind, before returning what it has
+            static const int ogg_stream_wait_ms = 500;
 
-                //ID should be == "RIFF"
-                //format should == "WAVE"
+                //wakes a reader waiting in read_bytes_ogg_stream.
+                //the lock is taken so the signal can't land between its check and its wait
+            static void ogg_stream_signal( OGG_stream* stream ) {
 
-                if( (header.ID[0] != 'R' || header.ID[1] != 'I' || header.ID[2] != 'F' || header.ID[3] != 'F')   ||
-                    (header.format[0] != 'W' || header.format[1] != 'A' || header.format[2] != 'V' || header.format[3] != 'E' ) ) {
-                    return false;
+                {
+                    std::lock_guard<std::mutex> _guard(stream->ready_lock);
                 }
 
-                return true;
+                stream->ready.notify_all();
 
-            } //wav_confirm_header
+            } //ogg_stream_signal
 
+                //runs on a decode worker, fills the free space in the ring straight from the decoder
+            static void ogg_decode_ahead( OGG_file_source* ogg_source ) {
 
-            bool load_info_wav( QuickVec<unsigned char> &out_buffer, const char *_id, WAV_file_source*& wav_source, bool read ) {
+                OGG_stream* stream = ogg_source->stream;
 
-                // http://www.dunsanyinteractive.com/blogs/oliver/?p=72
+                long frame_bytes = ogg_frame_bytes(ogg_source);
 
-                if(!wav_source) {
-                    snow::log(1, "/ snow / invalid source for %s", _id);
-                    return false;
-                }
+                    //a frame that straddles the end of the ring is decoded here, then copied in two parts
+                unsigned char split_frame[255 * 4];
 
-                if (!wav_source->file_source) {
-                    snow::log(1, "/ snow / cannot open wav file from %s", _id);
-                    return false;
-                }
+                while(!stream->eof.load() && !stream->interrupt.load()) {
 
-                    //for checking validity of the header
-                RIFF_Header riff_header;
+                    size_t _free = 0;
+                    unsigned char* _dest = stream->ring.write_span(_free);
 
-                    // Read in the first chunk into the struct
-                int result = snow::io::read(wav_source->file_source, &riff_header, sizeof(RIFF_Header), 1);
+                        //wait for the reader to make a useful amount of room
+                    if(_free < OGG_BUFFER_LENGTH && stream->ring.writable() < OGG_BUFFER_LENGTH) {
+                        break;
+                    }
 
-                    //check for RIFF and WAVE tag in memory
-                if( !wav_confirm_header(riff_header) ) {
-                    snow::log(1, "/ snow / %s : %s\n", _id, "RIFF or WAVE header not found, is this a WAV file?");
-                    return false;
-                } //!wav header
+                    if(_free > OGG_BUFFER_LENGTH) {
+                        _free = OGG_BUFFER_LENGTH;
+                    }
 
+                    bool split = (long)_free < frame_bytes;
 
-                long int current_head = 0;
-                bool found_format = false;
-                WAVE_Format wave_format;
+                    long bytes_read = ogg_decode( ogg_source, split ? split_frame : _dest, split ? frame_bytes : (long)_free );
 
-                while (!found_format) {
+                    if(bytes_read == OV_HOLE) {
+                        continue;
+                    }
 
-                        // Save the current position indicator of the stream
-                    current_head = snow::io::tell(wav_source->file_source);
+                    if(bytes_read <= 0) {
 
-                        //Read in the 2nd chunk for the wave info
-                    result = snow::io::read(wav_source->file_source, &wave_format, sizeof(WAVE_Format), 1);
+                        if(bytes_read < 0) {
+                            snow::log(1, "/ snow / audio / ogg stream decode error %d in %s", (int)bytes_read, ogg_source->source_name.c_str());
+                        }
 
-                    if (result != 1) {
-                        snow::log(1, "/ snow / %s : %s\n", _id, "Invalid WAV format!");
-                        return false;
-                    }
+                        stream->eof.store(true);
+                        ogg_stream_signal(stream);
+                        break;
 
-                    //check for fmt tag in memory
-                    if( wave_format.subChunkID[0] != 'f' ||
-                        wave_format.subChunkID[1] != 'm' ||
-                        wave_format.subChunkID[2] != 't' ||
-                        wave_format.subChunkID[3] != ' '
-                    ) {
-                        snow::io::seek(wav_source->file_source, wave_format.subChunkSize, snow_seek_cur);
-                    } else {
-                        found_format = true;
-                    }
+                    } //bytes_read <= 0
 
-                } //while !found_format
+                    if(split) {
 
-                    //check for extra parameters;
-                if (wave_format.subChunkSize > 16) {
-                    snow::io::seek(wav_source->file_source, sizeof(short), snow_seek_cur);
-                }
+                        memcpy( _dest, split_frame, _free );
+                        stream->ring.commit(_free);
 
-                bool found_data = false;
-                WAVE_Data wave_data;
+                        size_t _rest = 0;
+                        unsigned char* _wrapped = stream->ring.write_span(_rest);
+                        memcpy( _wrapped, split_frame + _free, bytes_read - _free );
 
-                while (!found_data) {
+                    } //split
 
-                        // Save the current position indicator of the stream
-                    current_head = snow::io::tell(wav_source->file_source);
+                    stream->ring.commit(bytes_read - (split ? _free : 0));
 
-                    //Read in the the last byte of data before the sound file
-                    result = snow::io::read(wav_source->file_source, &wave_data, sizeof(WAVE_Data), 1);
+                    ogg_stream_signal(stream);
 
-                    if (result != 1) {
-                        snow::log(1, "/ snow / %s : %s\n", _id, "Invalid WAV data header");
-                        return false;
-                    }
+                } //while
 
-                    if(
-                        wave_data.subChunkID[0] != 'd' ||
-                        wave_data.subChunkID[1] != 'a' ||
-                        wave_data.subChunkID[2] != 't' ||
-                        wave_data.subChunkID[3] != 'a'
-                    ) {
-                        snow::io::seek(wav_source->file_source, wave_data.subChunkSize, snow_seek_cur);
-                    } else {
-                        found_data = true;
-                    }
+            } //ogg_decode_ahead
 
-                } //!found_data
+                //switch a source over to decoding ahead on the workers,
+                //reads will now be served from the ring instead of calling ov_read
+            bool stream_start_ogg( OGG_file_source* ogg_source, long ring_length ) {
 
-                    //we need to store the start of the data for when we want to rewind to the
-                    //beginning, for example, when doing a stream from the file and looping
-                wav_source->data_start = snow::io::tell(wav_source->file_source);
-                    //store the size of the wav data
-                wav_source->length = wave_data.subChunkSize;
-                    //since wav is uncompressed, it's size matches
-                wav_source->length_pcm = wav_source->length;
-                    //assign the sound format values
-                wav_source->rate = wave_format.sampleRate;
-                wav_source->bitrate = (int)wave_format.byteRate;
-                wav_source->channels = wave_format.numChannels;
-                wav_source->bits_per_sample = wave_format.bitsPerSample;
+                if(!ogg_source || ring_length <= 0) {
+                    return false;
+                }
 
-                if(read) {
-                    read_bytes_wav( wav_source, out_buffer, -1, wav_source->length_pcm );
+                if(ogg_source->stream) {
+                    return true;
                 }
 
+                ogg_source->stream = new OGG_stream( ring_length );
+
+                snow::log(2, "/ snow / audio / streaming %s with a %d byte ring", ogg_source->source_name.c_str(), (int)ogg_source->stream->ring.capacity);
+
+                ogg_decode_pool.kick(ogg_source);
+
                 return true;
 
-            } // load_info_wav
+            } //stream_start_ogg
 
+            void stream_shutdown_ogg() {
 
-            bool seek_bytes_wav( WAV_file_source* wav_source, long to ) {
+                ogg_decode_pool.shutdown();
 
-                if(wav_source) {
+            } //stream_shutdown_ogg
+
+            void stream_stop_ogg( OGG_file_source* ogg_source ) {
+
+                if(!ogg_source || !ogg_source->stream) {
+                    return;
+                }
+
+                ogg_decode_pool.halt(ogg_source);
+
+                delete ogg_source->stream;
+                ogg_source->stream = NULL;
+
+            } //stream_stop_ogg
+
+                //copies ready pcm out of the ring, only waiting on the worker if it has fallen behind
+            static bool read_bytes_ogg_stream( OGG_file_source* ogg_source, unsigned char* dest, long len, long &bytes_read ) {
+
+                OGG_stream* stream = ogg_source->stream;
+
+                bool complete = false;
+                long total_read = 0;
+
+                std::chrono::steady_clock::time_point deadline =
+                    std::chrono::steady_clock::now() + std::chrono::milliseconds(ogg_stream_wait_ms);
+
+                while(total_read < len) {
+
+                    size_t _count = stream->ring.read( dest + total_read, len - total_read );
+
+                    total_read += _count;
+
+                        //room was made, or the worker is behind, either way it should be decoding
+                    ogg_decode_pool.kick(ogg_source);
+
+                    if(total_read >= len) {
+                        break;
+                    }
+
+                        //eof is checked before the ring, since the worker sets it after its last commit
+                    if(stream->eof.load() && stream->ring.readable() == 0) {
+                        complete = true;
+                        break;
+                    }
+
+                    if(_count == 0) {
+
+                        std::unique_lock<std::mutex> _guard(stream->ready_lock);
+
+                        bool _ready = stream->ready.wait_until(_guard, deadline, [stream]() {
+                            return stream->ring.readable() > 0 || stream->eof.load();
+                        });
+
+                            //a short read, the caller sees it as an underrun rather than blocking on a stalled worker
+                        if(!_ready) {
+                            snow::log(1, "/ snow / audio / ogg stream %s waited %dms for the decoder, returning %d of %d bytes",
+                                ogg_source->source_name.c_str(), ogg_stream_wait_ms, (int)total_read, (int)len);
+                            break;
+                        }
+
+                    } //_count == 0
+
+                } //while
+
+                bytes_read = total_read;
+
+                return complete;
+
+            } //read_bytes_ogg_stream
+
+
+        //OGG seek index
+
+                //sources opened from the same asset share their index, and it can be persisted next to it
+            static std::mutex seek_index_lock;
+            static std::map< std::string, std::shared_ptr<const OGG_seek_index> > seek_index_cache;
+            static bool seek_index_files = false;
+
+                //the file is little endian whatever the host, a header of magic, version, the length
+                //of the ogg file and the count, then the count of (offset, granule) pairs, all 64 bit after the first two
+            #define OGG_SEEK_INDEX_MAGIC    0x6b73736e //nssk
+            #define OGG_SEEK_INDEX_VERSION  2
+            #define OGG_SEEK_INDEX_HEADER   24
+            #define OGG_SEEK_INDEX_POINT    16
+                //a chunk always holds the largest possible page, 27 + 255 + 255*255
+            #define OGG_PAGE_MAX            65307
+            #define OGG_SEEK_SCAN_LENGTH    (OGG_PAGE_MAX * 2)
+
+            void seek_index_files_ogg( bool enabled ) {
+
+                std::lock_guard<std::mutex> guard(seek_index_lock);
+
+                seek_index_files = enabled;
+
+            } //seek_index_files_ogg
+
+                //the size of one decoded pcm frame across all channels
+            static long ogg_frame_bytes( OGG_file_source* ogg_source ) {
+
+                return ogg_source->info->channels * (ogg_source->decode_float ? 4 : 2);
+
+            } //ogg_frame_bytes
+
+            static ogg_int64_t ogg_read_le64( const unsigned char* p ) {
+
+                ogg_int64_t v = 0;
+                for(int i = 7; i >= 0; --i) {
+                    v = (v << 8) | p[i];
+                }
+
+                return v;
+
+            } //ogg_read_le64
+
+            static unsigned int ogg_read_le32( const unsigned char* p ) {
+
+                return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+
+            } //ogg_read_le32
+
+            static void ogg_write_le64( unsigned char* p, ogg_int64_t v ) {
+
+                for(int i = 0; i < 8; ++i) {
+                    p[i] = (unsigned char)(v >> (i * 8));
+                }
+
+            } //ogg_write_le64
+
+            static void ogg_write_le32( unsigned char* p, unsigned int v ) {
+
+                for(int i = 0; i < 4; ++i) {
+                    p[i] = (unsigned char)(v >> (i * 8));
+                }
+
+            } //ogg_write_le32
+
+            static bool ogg_granule_before( ogg_int64_t frame, const OGG_seek_point& point ) {
+
+                return frame < point.granule;
+
+            } //ogg_granule_before
+
+                //walks every page header in the file, keeping the ones that end a packet.
+                //chained files have more than one logical stream, those are left to vorbisfile.
+            static bool ogg_scan_seek_index( OGG_file_source* ogg_source, OGG_seek_index &index ) {
+
+                std::vector<unsigned char> chunk( OGG_SEEK_SCAN_LENGTH );
+
+                ogg_int64_t chunk_offset = 0;
+                size_t filled = 0;
+                size_t pos = 0;
+                bool at_end = false;
+                bool have_serial = false;
+                unsigned int serial = 0;
+
+                snow::io::seek( ogg_source->file_source, 0, snow_seek_set );
+
+                while(true) {
+
+                        //keep at least one whole page ahead of pos
+                    if(!at_end && (filled - pos) < OGG_PAGE_MAX) {
+
+                        memmove( &chunk[0], &chunk[pos], filled - pos );
+                        chunk_offset += pos;
+                        filled -= pos;
+                        pos = 0;
+
+                        while(filled < chunk.size()) {
+                            size_t _count = snow::io::read( ogg_source->file_source, &chunk[filled], 1, chunk.size() - filled );
+                            if(_count == 0) {
+                                at_end = true;
+                                break;
+                            }
+                            filled += _count;
+                        }
+
+                    } //refill
+
+                    if(filled - pos < 27) {
+                        break;
+                    }
+
+                    const unsigned char* page = &chunk[pos];
+
+                        //not on a capture pattern, resync a byte at a time
+                    if(memcmp(page, "OggS", 4) != 0) {
+                        ++pos;
+                        continue;
+                    }
+
+                    size_t segments = page[26];
+
+                    if(filled - pos < 27 + segments) {
+                        break;
+                    }
+
+                    size_t page_length = 27 + segments;
+                    for(size_t i = 0; i < segments; ++i) {
+                        page_length += page[27 + i];
+                    }
+
+                        //truncated final page
+                    if(filled - pos < page_length) {
+                        break;
+                    }
+
+                    unsigned int page_serial = page[14] | (page[15] << 8) | (page[16] << 16) | ((unsigned int)page[17] << 24);
+
+                    if(!have_serial) {
+                        serial = page_serial;
+                        have_serial = true;
+                    } else if(page_serial != serial) {
+                        snow::log(2, "/ snow / audio / %s is chained, not indexing for seeks", ogg_source->source_name.c_str());
+                        return false;
+                    }
+
+                        //headers are granule 0, and -1 means no packet ends on this page
+                    ogg_int64_t granule = ogg_read_le64( page + 6 );
+
+                    if(granule > 0 && (index.empty() || granule > index.back().granule)) {
+                        OGG_seek_point point = { chunk_offset + (ogg_int64_t)pos, granule };
+                        index.push_back(point);
+                    }
+
+                    pos += page_length;
+
+                } //while
+
+                return !index.empty();
+
+            } //ogg_scan_seek_index
+
+            static bool ogg_load_seek_index( const std::string &path, off_t length, OGG_seek_index &index ) {
+
+                snow::io::iosrc* file = snow::io::iosrc_from_file( path.c_str(), "rb" );
+
+                if(!file) {
+                    return false;
+                }
+
+                unsigned char header[OGG_SEEK_INDEX_HEADER];
+                bool valid = snow::io::read( file, header, OGG_SEEK_INDEX_HEADER, 1 ) == 1;
+
+                ogg_int64_t count = valid ? ogg_read_le64( header + 16 ) : 0;
+
+                    //a page is at least 28 bytes, anything claiming more entries than that is stale or broken
+                valid = valid &&
+                        ogg_read_le32( header ) == OGG_SEEK_INDEX_MAGIC &&
+                        ogg_read_le32( header + 4 ) == OGG_SEEK_INDEX_VERSION &&
+                        ogg_read_le64( header + 8 ) == (ogg_int64_t)length &&
+                        count > 0 && count <= (ogg_int64_t)(length / 28);
+
+                if(valid) {
+
+                    std::vector<unsigned char> points( (size_t)count * OGG_SEEK_INDEX_POINT );
+                    valid = snow::io::read( file, &points[0], OGG_SEEK_INDEX_POINT, (size_t)count ) == (size_t)count;
+
+                    index.resize( (size_t)count );
+
+                    for(size_t i = 0; valid && i < index.size(); ++i) {
+                        index[i].offset = ogg_read_le64( &points[i * OGG_SEEK_INDEX_POINT] );
+                        index[i].granule = ogg_read_le64( &points[i * OGG_SEEK_INDEX_POINT + 8] );
+                    }
+
+                } //valid
+
+                snow::io::close(file);
+
+                if(!valid) {
+                    index.clear();
+                }
+
+                return valid;
+
+            } //ogg_load_seek_index
+
+            static void ogg_save_seek_index( const std::string &path, off_t length, const OGG_seek_index &index ) {
+
+                snow::io::iosrc* file = snow::io::iosrc_from_file( path.c_str(), "wb" );
+
+                    //asset folders are often read only, which is fine
+                if(!file) {
+                    snow::log(2, "/ snow / audio / could not write seek index %s", path.c_str());
+                    return;
+                }
+
+                std::vector<unsigned char> bytes( OGG_SEEK_INDEX_HEADER + index.size() * OGG_SEEK_INDEX_POINT );
+
+                ogg_write_le32( &bytes[0], OGG_SEEK_INDEX_MAGIC );
+                ogg_write_le32( &bytes[4], OGG_SEEK_INDEX_VERSION );
+                ogg_write_le64( &bytes[8], (ogg_int64_t)length );
+                ogg_write_le64( &bytes[16], (ogg_int64_t)index.size() );
+
+                for(size_t i = 0; i < index.size(); ++i) {
+                    unsigned char* point = &bytes[OGG_SEEK_INDEX_HEADER + i * OGG_SEEK_INDEX_POINT];
+                    ogg_write_le64( point, index[i].offset );
+                    ogg_write_le64( point + 8, index[i].granule );
+                }
+
+                snow::io::write( file, &bytes[0], bytes.size(), 1 );
+
+                snow::io::close(file);
+
+            } //ogg_save_seek_index
+
+                //builds (or finds) the index once per source, the decode worker must not be using the file
+            static bool ogg_build_seek_index( OGG_file_source* ogg_source ) {
+
+                if(ogg_source->seek_index_built) {
+                    return ogg_source->seek_index.get() != NULL;
+                }
+
+                ogg_source->seek_index_built = true;
+
+                const std::string &key = ogg_source->seek_index_key;
+                std::string path = key + ".seekindex";
+                bool use_files = false;
+
+                if(!key.empty()) {
+
+                    std::lock_guard<std::mutex> guard(seek_index_lock);
+
+                    use_files = seek_index_files;
+
+                    std::map< std::string, std::shared_ptr<const OGG_seek_index> >::iterator cached = seek_index_cache.find(key);
+                    if(cached != seek_index_cache.end()) {
+                        ogg_source->seek_index = cached->second;
+                        return true;
+                    }
+
+                } //key
+
+                std::shared_ptr<OGG_seek_index> index = std::make_shared<OGG_seek_index>();
+
+                bool loaded = use_files && ogg_load_seek_index( path, ogg_source->length, *index );
+
+                if(!loaded) {
+
+                        //vorbisfile expects the file where it left it
+                    long restore = snow::io::tell( ogg_source->file_source );
+                    bool scanned = ogg_scan_seek_index( ogg_source, *index );
+                    snow::io::seek( ogg_source->file_source, restore, snow_seek_set );
+
+                    if(!scanned) {
+                        return false;
+                    }
+
+                    if(use_files) {
+                        ogg_save_seek_index( path, ogg_source->length, *index );
+                    }
+
+                } //!loaded
+
+                snow::log(3, "/ snow / audio / %s seek index has %d pages (%s)", ogg_source->source_name.c_str(), (int)index->size(), loaded ? "file" : "scanned");
+
+                ogg_source->seek_index = index;
+
+                if(!key.empty()) {
+                    std::lock_guard<std::mutex> guard(seek_index_lock);
+                    seek_index_cache.insert( std::make_pair(key, ogg_source->seek_index) );
+                }
+
+                return true;
+
+            } //ogg_build_seek_index
+
+                //builds the index ahead of the first seek, so it doesn't hitch
+            bool seek_index_ogg( OGG_file_source* ogg_source ) {
+
+                if(!ogg_source) {
+                    return false;
+                }
+
+                if(ogg_source->stream) {
+                    ogg_decode_pool.halt(ogg_source);
+                }
+
+                bool result = ogg_build_seek_index( ogg_source );
+
+                if(ogg_source->stream) {
+                    ogg_decode_pool.resume(ogg_source);
+                }
+
+                return result;
+
+            } //seek_index_ogg
+
+                //decodes and drops frames, to land exactly inside a page.
+                //the planar floats are just discarded, nothing is converted
+            static int ogg_skip_frames( OGG_file_source* ogg_source, ogg_int64_t frames ) {
+
+                float** pcm = NULL;
+                int bit_stream = 0;
+
+                while(frames > 0) {
+
+                    int _max = frames < OGG_BUFFER_LENGTH ? (int)frames : OGG_BUFFER_LENGTH;
+                    long _count = ov_read_float( ogg_source->ogg_file, &pcm, _max, &bit_stream );
+
+                    if(_count == OV_HOLE) {
+                        continue;
+                    }
+
+                    if(_count <= 0) {
+                        return (int)_count;
+                    }
+
+                    frames -= _count;
+
+                } //while
+
+                return 0;
+
+            } //ogg_skip_frames
+
+                //seeks to an exact pcm frame, jumping straight to the page through the index when there is one.
+                //the index is only built by the first seek past the start, so sources that are
+                //only ever read from the start, like most sounds, never scan the file
+            static int ogg_seek_frames( OGG_file_source* ogg_source, ogg_int64_t to ) {
+
+                if(to <= 0) {
+                    return ov_pcm_seek( ogg_source->ogg_file, 0 );
+                }
+
+                if(!ogg_build_seek_index( ogg_source )) {
+                    return ov_pcm_seek( ogg_source->ogg_file, to );
+                }
+
+                const OGG_seek_index &index = *ogg_source->seek_index;
+
+                    //the first page that ends past the target is the one holding it
+                size_t page = std::upper_bound( index.begin(), index.end(), to, ogg_granule_before ) - index.begin();
+
+                if(page >= index.size()) {
+                    return ov_pcm_seek( ogg_source->ogg_file, to );
+                }
+
+                    //decoding from a page can start up to a packet late, step back one if it landed past
+                for(int attempt = 0; attempt < 2; ++attempt) {
+
+                    int res = ov_raw_seek( ogg_source->ogg_file, index[page].offset );
+
+                    if(res != 0) {
+                        return res;
+                    }
+
+                    ogg_int64_t at = ov_pcm_tell( ogg_source->ogg_file );
+
+                    if(at >= 0 && at <= to) {
+                        return ogg_skip_frames( ogg_source, to - at );
+                    }
+
+                    if(page == 0) {
+                        break;
+                    }
+
+                    --page;
+
+                } //attempt
+
+                return ov_pcm_seek( ogg_source->ogg_file, to );
+
+            } //ogg_seek_frames
+
+            bool seek_bytes_ogg( OGG_file_source* ogg_source, long to ) {
+
+                if(ogg_source) {
+
+                    snow::log(3, "/ snow / seeking in %s ogg source to %d/%d (%f)", ogg_source->source_name.c_str(), to, ogg_source->length_pcm, (float)to / (float)ogg_source->length_pcm);
+
+                        //bytes to frames, by the real channel count and word size
+                    ogg_int64_t to_frames = to / ogg_frame_bytes(ogg_source);
+
+                        //the worker has to let go of the file before it can be moved
+                    if(ogg_source->stream) {
+                        ogg_decode_pool.halt(ogg_source);
+                    }
+
+                    int res = ogg_seek_frames( ogg_source, to_frames );
+
+                    if(res != 0) {
+
+                        if(ogg_source->stream) {
+                            ogg_decode_pool.resume(ogg_source);
+                        }
+
+                        if(res == OV_ENOSEEK) {
+                            snow::log(1, "/ snow / audio / ogg seek error %s", "OV_ENOSEEK");
+                        }
+                        if(res == OV_EINVAL) {
+                            snow::log(1, "/ snow / audio / ogg seek error %s", "OV_EINVAL");
+                        }
+                        if(res == OV_EREAD) {
+                            snow::log(1, "/ snow / audio / ogg seek error %s", "OV_EREAD");
+                        }
+                        if(res == OV_EFAULT) {
+                            snow::log(1, "/ snow / audio / ogg seek error %s", "OV_EFAULT");
+                        }
+                        if(res == OV_EBADLINK) {
+                            snow::log(1, "/ snow / audio / ogg seek error %s", "OV_EBADLINK");
+                        }
+
+                        return false;
+                    }
+
+                    // snow::log("seeking ogg_source %d res:%d", to, res);
+
+                    if(ogg_source->stream) {
+                        ogg_source->stream->eof.store(false);
+                        ogg_source->stream->ring.reset();
+                        ogg_decode_pool.resume(ogg_source);
+                    }
+
+                    return true;
+                }
+
+                return false;
+
+            } //seek_bytes_ogg
+
+
+                //this reads a portion of an already opened ogg source into the buffer from start, for len
+            bool read_bytes_ogg( OGG_file_source* ogg_source, QuickVec<unsigned char> &out_buffer, long start, long len ) {
+
+                    //resize to fit the requested length, but pad it slightly to align
+                long byte_gap = (len & 0x03);
+                out_buffer.resize(len + byte_gap);
+
+                long bytes_read = 0;
+                bool complete = read_bytes_ogg_into( ogg_source, out_buffer.begin(), start, len, bytes_read );
+
+                    //we need the buffer length to reflect the real size,
+                    //just in case it read shorter than requested
+                if(bytes_read != len) {
+                    out_buffer.resize(bytes_read > 0 ? bytes_read + byte_gap : 0);
+                }
+
+                return complete;
+
+            } //read_bytes_ogg
+
+                //this decodes a portion of an already opened ogg source directly into dest, which must hold len bytes
+            bool read_bytes_ogg_into( OGG_file_source* ogg_source, unsigned char* dest, long start, long len, long &bytes_read ) {
+
+                Decode_timer _timer(bytes_read);
+
+                //it is assumed here that ogg_source is opened. Maybe we can ask the file if it is open and if not reopen it?
+
+                bool complete = false;
+
+                if(start != -1) {
+                    // snow::log("start was %d, skipping there first", start);
+                    seek_bytes_ogg( ogg_source, start );
+                }
+
+                if(ogg_source->stream) {
+                    return read_bytes_ogg_stream( ogg_source, dest, len, bytes_read );
+                }
+
+                bool reading = true;
+                long bytes_left = len;
+                long total_read = 0;
+                long frame_bytes = ogg_frame_bytes(ogg_source);
+
+                    //only whole frames are decoded, a partial frame at the end of len is left unread
+                while(reading && bytes_left >= frame_bytes) {
+
+                    long _read_max = OGG_BUFFER_LENGTH;
+
+                    if(bytes_left < _read_max) {
+                        _read_max = bytes_left;
+                    }
+
+                        // Read the decoded sound data
+                    long _count = ogg_decode( ogg_source, dest + total_read, _read_max );
+
+                        //a hole in the data is recoverable, keep going
+                    if(_count == OV_HOLE) {
+                        continue;
+                    }
+
+                        //at the end, or unable to continue?
+                    if(_count <= 0) {
+
+                        if(_count < 0) {
+                            snow::log(1, "/ snow / audio / ogg decode error %d in %s", (int)_count, ogg_source->source_name.c_str());
+                        }
+
+                        reading = false;
+                        complete = true;
+                        break;
+
+                    } //_count <= 0
+
+                    total_read += _count;
+                    bytes_left -= _count;
+
+                } //while
+
+                bytes_read = total_read;
+
+                return complete;
+
+            } //read_bytes_ogg_into
+
+
+            static size_t ogg_read_func(void* ptr, size_t size, size_t nmemb, void* datasource) {
+
+                OGG_file_source *source = (OGG_file_source*)datasource;
+
+                // snow::log("\t read  : %s, filelen:%lld amount:%lu\n", source->source_name.c_str(),source->length, size * nmemb);
+
+                return snow::io::read(source->file_source, ptr, size, nmemb);
+
+            } //read_func
+
+            static int ogg_seek_func(void* datasource, ogg_int64_t offset, int whence) {
+
+                OGG_file_source *source = (OGG_file_source*)datasource;
+
+                int _type = whence;
+
+                switch (whence) {
+
+                    case SEEK_SET: {
+                        _type = snow_seek_set;
+                        break;
+                    }
+                    case SEEK_CUR: {
+                        _type = snow_seek_cur;
+                        break;
+                    }
+                    case SEEK_END: {
+                        _type = snow_seek_end;
+                        break;
+                    }
+
+                } //switch(whence)
+
+                // snow::log("\t seek  : %s, offset:%lld whence:%d \n", source->source_name.c_str(), offset, _type);
+
+                return snow::io::seek(source->file_source, offset, _type);
+
+            } //seek_func
+
+            static int ogg_close_func(void* datasource) {
+
+                OGG_file_source *source = (OGG_file_source*)datasource;
+
+                snow::log(2, "/ snow / ogg closing the file source for %s", source->source_name.c_str());
+
+                return snow::io::close(source->file_source);
+
+            } //close_func
+
+            static long ogg_tell_func(void* datasource) {
+
+                OGG_file_source *source = (OGG_file_source*)datasource;
+
+                return (long)snow::io::tell(source->file_source) - source->offset;
+
+            } //tell_func
+
+            std::string ogg_error_string(int code) {
+
+                switch(code) {
+
+                    case OV_EREAD:
+                        return std::string("failed to read from media");
+                    case OV_ENOTVORBIS:
+                        return std::string("not vorbis data");
+                    case OV_EVERSION:
+                        return std::string("vorbis version mismatch");
+                    case OV_EBADHEADER:
+                        return std::string("invalid vorbis header");
+                    case OV_EFAULT:
+                        return std::string("internal logic fault (bug or heap/stack corruption.");
+                    default:
+                        return std::string("unknown ogg error");
+                }
+
+            } //ogg_error_string
+
+
+
+
+        //WAV files
+
+
+
+
+            struct RIFF_Header {
+                char ID[4];
+                unsigned int chunkSize; //size not including chunkSize or chunkID
+                char format[4];
+            };
+
+            struct WAVE_Format {
+                char subChunkID[4];
+                unsigned int subChunkSize;
+                short audioFormat;
+                short numChannels;
+                unsigned int sampleRate;
+                unsigned int byteRate;
+                short blockAlign;
+                short bitsPerSample;
+            };
+
+                //the wav format tags handled here
+            #define WAV_FORMAT_PCM          0x0001
+            #define WAV_FORMAT_IMA_ADPCM    0x0011
+
+            struct WAVE_Data {
+                char subChunkID[4]; //should contain the word data
+                unsigned int subChunkSize; //Stores the size of the data block
+            };
+
+
+
+            bool wav_confirm_header(RIFF_Header &header) {
+
+                //ID should be == "RIFF"
+                //format should == "WAVE"
+
+                if( (header.ID[0] != 'R' || header.ID[1] != 'I' || header.ID[2] != 'F' || header.ID[3] != 'F')   ||
+                    (header.format[0] != 'W' || header.format[1] != 'A' || header.format[2] != 'V' || header.format[3] != 'E' ) ) {
+                    return false;
+                }
+
+                return true;
+
+            } //wav_confirm_header
+
+
+                //chunks are padded to an even length
+            static inline long wav_chunk_length( unsigned int size ) {
+                return (long)size + (size & 1);
+            }
+
+                //walks the chunks up to "fmt ", leaving the source just past it
+            static bool wav_find_format( snow::io::iosrc* src, const char* _id, WAVE_Format &wave_format ) {
+
+                bool found_format = false;
+
+                while (!found_format) {
+
+                        //Read in the 2nd chunk for the wave info
+                    int result = snow::io::read(src, &wave_format, sizeof(WAVE_Format), 1);
+
+                    if (result != 1) {
+                        snow::log(1, "/ snow / %s : %s\n", _id, "Invalid WAV format!");
+                        return false;
+                    }
+
+                        //the read took the chunk header and 16 bytes of the chunk
+                    long remaining = wav_chunk_length(wave_format.subChunkSize) - 16;
+
+                    //check for fmt tag in memory
+                    if( wave_format.subChunkID[0] != 'f' ||
+                        wave_format.subChunkID[1] != 'm' ||
+                        wave_format.subChunkID[2] != 't' ||
+                        wave_format.subChunkID[3] != ' '
+                    ) {
+                        snow::io::seek(src, remaining, snow_seek_cur);
+                    } else {
+
+                            //skip any extra parameters
+                        if(remaining > 0) {
+                            snow::io::seek(src, remaining, snow_seek_cur);
+                        }
+
+                        found_format = true;
+
+                    }
+
+                } //while !found_format
+
+                return true;
+
+            } //wav_find_format
+
+                //walks the chunks up to "data", leaving the source at the first sample.
+                //if fact_frames is given, it takes the frame count from a "fact" chunk on the way
+            static bool wav_find_data( snow::io::iosrc* src, const char* _id, WAVE_Data &wave_data, unsigned int* fact_frames ) {
+
+                bool found_data = false;
+
+                while (!found_data) {
+
+                    //Read in the the last byte of data before the sound file
+                    int result = snow::io::read(src, &wave_data, sizeof(WAVE_Data), 1);
+
+                    if (result != 1) {
+                        snow::log(1, "/ snow / %s : %s\n", _id, "Invalid WAV data header");
+                        return false;
+                    }
+
+                    bool is_data =
+                        wave_data.subChunkID[0] == 'd' &&
+                        wave_data.subChunkID[1] == 'a' &&
+                        wave_data.subChunkID[2] == 't' &&
+                        wave_data.subChunkID[3] == 'a';
+
+                    bool is_fact =
+                        wave_data.subChunkID[0] == 'f' &&
+                        wave_data.subChunkID[1] == 'a' &&
+                        wave_data.subChunkID[2] == 'c' &&
+                        wave_data.subChunkID[3] == 't';
+
+                    if(is_data) {
+                        found_data = true;
+                    } else if(is_fact && fact_frames && wave_data.subChunkSize >= 4) {
+                        snow::io::read(src, fact_frames, sizeof(unsigned int), 1);
+                        snow::io::seek(src, wav_chunk_length(wave_data.subChunkSize) - 4, snow_seek_cur);
+                    } else {
+                        snow::io::seek(src, wav_chunk_length(wave_data.subChunkSize), snow_seek_cur);
+                    }
+
+                } //!found_data
+
+                return true;
+
+            } //wav_find_data
+
+
+            bool load_info_wav( QuickVec<unsigned char> &out_buffer, const char *_id, WAV_file_source*& wav_source, bool read ) {
+
+                // http://www.dunsanyinteractive.com/blogs/oliver/?p=72
+
+                if(!wav_source) {
+                    snow::log(1, "/ snow / invalid source for %s", _id);
+                    return false;
+                }
+
+                if (!wav_source->file_source) {
+                    snow::log(1, "/ snow / cannot open wav file from %s", _id);
+                    return false;
+                }
+
+                    //for checking validity of the header
+                RIFF_Header riff_header;
+
+                    // Read in the first chunk into the struct
+                if(snow::io::read(wav_source->file_source, &riff_header, sizeof(RIFF_Header), 1) != 1) {
+                    snow::log(1, "/ snow / %s : %s\n", _id, "file is too short for a RIFF header");
+                    return false;
+                }
+
+                    //check for RIFF and WAVE tag in memory
+                if( !wav_confirm_header(riff_header) ) {
+                    snow::log(1, "/ snow / %s : %s\n", _id, "RIFF or WAVE header not found, is this a WAV file?");
+                    return false;
+                } //!wav header
+
+
+                WAVE_Format wave_format;
+                WAVE_Data wave_data;
+
+                if(!wav_find_format(wav_source->file_source, _id, wave_format)) {
+                    return false;
+                }
+
+                    //compressed wav data can't be handed over as pcm
+                if(wave_format.audioFormat == WAV_FORMAT_IMA_ADPCM) {
+                    snow::log(1, "/ snow / %s : %s\n", _id, "IMA-ADPCM wav, load it as AudioFormatType.adpcm");
+                    return false;
+                }
+
+                if(!wav_find_data(wav_source->file_source, _id, wave_data, NULL)) {
+                    return false;
+                }
+
+                    //we need to store the start of the data for when we want to rewind to the
+                    //beginning, for example, when doing a stream from the file and looping
+                wav_source->data_start = snow::io::tell(wav_source->file_source);
+                    //store the size of the wav data
+                wav_source->length = wave_data.subChunkSize;
+                    //since wav is uncompressed, it's size matches
+                wav_source->length_pcm = wav_source->length;
+                    //assign the sound format values
+                wav_source->rate = wave_format.sampleRate;
+                wav_source->bitrate = (int)wave_format.byteRate;
+                wav_source->channels = wave_format.numChannels;
+                wav_source->bits_per_sample = wave_format.bitsPerSample;
+
+                if(read) {
+                    read_bytes_wav( wav_source, out_buffer, -1, wav_source->length_pcm );
+                }
+
+                return true;
+
+            } // load_info_wav
+
+
+            bool seek_bytes_wav( WAV_file_source* wav_source, long to ) {
+
+                if(wav_source) {
 
                         //start at the wav data for seeking, ignoring the header stuff now
                     snow::log(3, "/ snow / wav jumping to %d+%d/%d", wav_source->data_start, to, wav_source->length_pcm);
@@ -463,163 +1429,945 @@ namespace snow {
 
                 return false;
 
-            } //seek_bytes_wav
+            } //seek_bytes_wav
+
+
+            bool read_bytes_wav( WAV_file_source* wav_source, QuickVec<unsigned char> &out_buffer, long start, long len ) {
+
+                    //resize to fit the requested/remaining length
+                long byte_gap = (len & 0x03);
+                out_buffer.resize(len + byte_gap);
+
+                long bytes_read = 0;
+                bool complete = read_bytes_wav_into( wav_source, out_buffer.begin(), start, len, bytes_read );
+
+                if(bytes_read != len) {
+                    out_buffer.resize(bytes_read > 0 ? bytes_read + byte_gap : 0);
+                }
+
+                return complete;
+
+            } //read_bytes_wav
+
+
+            bool read_bytes_wav_into( WAV_file_source* wav_source, unsigned char* dest, long start, long len, long &bytes_read ) {
+
+                Decode_timer _timer(bytes_read);
+
+                long _read_len = len;
+                bool complete = false;
+
+                bytes_read = 0;
+
+                if(start != -1) {
+                    snow::log(3, "/ snow / wav / start was %d, skipping there first", start);
+                    seek_bytes_wav( wav_source, start );
+                }
+
+                    //read the data into the given buffer
+                long current_pos = (snow::io::tell( wav_source->file_source ) - wav_source->data_start);
+                long distance_to_end = wav_source->length_pcm - current_pos;
+
+                    //if we are reading near the end of the file,
+                    //mark complete as true because there is no more data
+                if(distance_to_end <= _read_len) {
+                    _read_len = distance_to_end;
+                    complete = true;
+                }
+
+
+                if(_read_len > 0) {
+
+                    snow::log(2, "/ snow / wav / reading %d bytes from %d", _read_len, start);
+
+                        //read from the wav source, in bytes so a short read is still counted
+                    bytes_read = snow::io::read( wav_source->file_source, dest, 1, _read_len );
+
+                        //if nothing was read, it was an error
+                        //or end of file so either way it's complete.
+                    if(bytes_read == 0) {
+                        complete = true;
+                    } //bytes_read == 0
+
+                    snow::log(2, "/ snow / wav / total read %d bytes, complete? %d", bytes_read, complete);
+
+                } //_read_len > 0
+
+                return complete;
+
+            } //read_bytes_wav_into
+
+                //like read_bytes_wav_into, but hands back a view straight into the mapped file instead of copying.
+                //only possible for mapped sources, the view lives as long as the source does
+            bool view_bytes_wav( WAV_file_source* wav_source, long start, long len, const unsigned char*& view, long &bytes_read ) {
+
+                view = NULL;
+                bytes_read = 0;
+
+                if(!wav_source || !wav_source->map.data) {
+                    return false;
+                }
+
+                if(start != -1) {
+                    seek_bytes_wav( wav_source, start );
+                }
+
+                long current_pos = (snow::io::tell( wav_source->file_source ) - wav_source->data_start);
+                long distance_to_end = wav_source->length_pcm - current_pos;
+
+                bool complete = (distance_to_end <= len);
+                long _read_len = complete ? distance_to_end : len;
+
+                if(_read_len > 0) {
+                    view = wav_source->map.data + wav_source->data_start + current_pos;
+                    bytes_read = _read_len;
+                    snow::io::seek( wav_source->file_source, _read_len, snow_seek_cur );
+                }
+
+                return complete;
+
+            } //view_bytes_wav
+
+
+
+
+        //PCM files
+
+
+
+
+            bool load_info_pcm( QuickVec<unsigned char> &out_buffer, const char *_id, PCM_file_source*& pcm_source, bool read ) {
+
+                if(!pcm_source) {
+                    snow::log(1, "/ snow / invalid source for %s", _id);
+                    return false;
+                }
+
+                if (!pcm_source->file_source) {
+                    snow::log(1, "/ snow / cannot open pcm file from %s", _id);
+                    return false;
+                }
+
+                snow::io::seek(pcm_source->file_source, 0, snow_seek_end);
+
+                    pcm_source->length = snow::io::tell(pcm_source->file_source);
+                    pcm_source->length_pcm = pcm_source->length;
+
+                snow::io::seek(pcm_source->file_source, 0, snow_seek_set);
+
+                    //assign the sound format values, these are defaults
+                    //and need to be assigned on the haxe side if you want different values,
+                    //right before creating the sound itself...
+                pcm_source->rate = 44100;
+                pcm_source->bitrate = 88200;
+                pcm_source->channels = 1;
+                pcm_source->bits_per_sample = 16;
+
+                if(read) {
+                    read_bytes_pcm( pcm_source, out_buffer, -1, pcm_source->length_pcm );
+                }
+
+                return true;
+
+            } //load_info_pcm
+
+
+            bool seek_bytes_pcm( PCM_file_source* pcm_source, long to ) {
+
+                if(pcm_source) {
+
+                        //start at the pcm data for seeking, ignoring the header stuff now
+                    snow::io::seek(pcm_source->file_source, to, snow_seek_set);
+
+                    return true;
+
+                } //pcm_source
+
+                return false;
+
+            } //seek_bytes_pcm
+
+
+            bool read_bytes_pcm( PCM_file_source* pcm_source, QuickVec<unsigned char> &out_buffer, long start, long len ) {
+
+                    //resize to fit the requested/remaining length
+                long byte_gap = (len & 0x03);
+                out_buffer.resize(len + byte_gap);
+
+                long bytes_read = 0;
+                bool complete = read_bytes_pcm_into( pcm_source, out_buffer.begin(), start, len, bytes_read );
+
+                if(bytes_read != len) {
+                    out_buffer.resize(bytes_read > 0 ? bytes_read + byte_gap : 0);
+                }
+
+                return complete;
+
+            } //read_bytes_pcm
+
+
+            bool read_bytes_pcm_into( PCM_file_source* pcm_source, unsigned char* dest, long start, long len, long &bytes_read ) {
+
+                Decode_timer _timer(bytes_read);
+
+                long _read_len = len;
+                bool complete = false;
+
+                bytes_read = 0;
+
+                if(start != -1) {
+                    snow::log(3, "/ snow / pcm / start was %d, skipping there first", start);
+                    seek_bytes_pcm( pcm_source, start );
+                }
+
+                    //read the data into the given buffer
+                long current_pos = snow::io::tell( pcm_source->file_source );
+                long distance_to_end = pcm_source->length_pcm - current_pos;
+
+                    //if we are reading near the end of the file,
+                    //mark complete as true because there is no more data
+                if(distance_to_end <= _read_len) {
+                    _read_len = distance_to_end;
+                    complete = true;
+                }
+
+                if(_read_len > 0) {
+
+                    snow::log(2, "/ snow / pcm / reading %d bytes from %d", _read_len, start);
+
+                        //read from the pcm source, in bytes so a short read is still counted
+                    bytes_read = snow::io::read( pcm_source->file_source, dest, 1, _read_len );
+
+                        //if nothing was read, it was an error
+                        //or end of file so either way it's complete.
+                    if(bytes_read == 0) {
+                        complete = true;
+                    } //bytes_read == 0
+
+                    snow::log(2, "/ snow / pcm / total read %d bytes, complete? %d", bytes_read, complete);
+
+                } //_read_len > 0
+
+                return complete;
+
+            } //read_bytes_pcm_into
+
+                //like read_bytes_pcm_into, but hands back a view straight into the mapped file instead of copying.
+                //only possible for mapped sources, the view lives as long as the source does
+            bool view_bytes_pcm( PCM_file_source* pcm_source, long start, long len, const unsigned char*& view, long &bytes_read ) {
+
+                view = NULL;
+                bytes_read = 0;
+
+                if(!pcm_source || !pcm_source->map.data) {
+                    return false;
+                }
+
+                if(start != -1) {
+                    seek_bytes_pcm( pcm_source, start );
+                }
+
+                long current_pos = snow::io::tell( pcm_source->file_source );
+                long distance_to_end = pcm_source->length_pcm - current_pos;
+
+                bool complete = (distance_to_end <= len);
+                long _read_len = complete ? distance_to_end : len;
+
+                if(_read_len > 0) {
+                    view = pcm_source->map.data + current_pos;
+                    bytes_read = _read_len;
+                    snow::io::seek( pcm_source->file_source, _read_len, snow_seek_cur );
+                }
+
+                return complete;
+
+            } //view_bytes_pcm
+
+
+        //ADPCM files
+
+
+
+
+                //the per channel block size when encoding 16 bit pcm at load, 1017 frames a block
+            #define ADPCM_ENCODE_BLOCK_ALIGN 512
+
+            bool load_info_adpcm( QuickVec<unsigned char> &out_buffer, const char *_id, ADPCM_file_source*& adpcm_source, bool read ) {
+
+                if(!adpcm_source) {
+                    snow::log(1, "/ snow / invalid source for %s", _id);
+                    return false;
+                }
+
+                if (!adpcm_source->file_source) {
+                    snow::log(1, "/ snow / cannot open adpcm file from %s", _id);
+                    return false;
+                }
+
+                snow::io::iosrc* src = adpcm_source->file_source;
+
+                RIFF_Header riff_header;
+                WAVE_Format wave_format;
+                WAVE_Data wave_data;
+                unsigned int fact_frames = 0;
+
+                if(snow::io::read(src, &riff_header, sizeof(RIFF_Header), 1) != 1) {
+                    snow::log(1, "/ snow / %s : %s\n", _id, "file is too short for a RIFF header");
+                    return false;
+                }
+
+                if( !wav_confirm_header(riff_header) ) {
+                    snow::log(1, "/ snow / %s : %s\n", _id, "RIFF or WAVE header not found, is this a WAV file?");
+                    return false;
+                }
+
+                if(!wav_find_format(src, _id, wave_format)) {
+                    return false;
+                }
+
+                if(!wav_find_data(src, _id, wave_data, &fact_frames)) {
+                    return false;
+                }
+
+                int channels = wave_format.numChannels;
+                long frames = 0;
+
+                if(channels <= 0) {
+                    snow::log(1, "/ snow / %s : %s\n", _id, "invalid channel count");
+                    return false;
+                }
+
+                if(wave_format.audioFormat == WAV_FORMAT_IMA_ADPCM && wave_format.bitsPerSample == 4) {
+
+                        //already compressed, the blocks are kept as they are
+                    adpcm_source->block_align = (unsigned short)wave_format.blockAlign;
+                    adpcm_source->samples_per_block = snow::audio::ima_samples_per_block( adpcm_source->block_align, channels );
+
+                    if(adpcm_source->samples_per_block == 0) {
+                        snow::log(1, "/ snow / %s : %s\n", _id, "invalid IMA-ADPCM block size");
+                        return false;
+                    }
+
+                    long _count = wave_data.subChunkSize / adpcm_source->block_align;
+
+                    adpcm_source->blocks.resize( _count * adpcm_source->block_align );
+                    long _read = snow::io::read( src, adpcm_source->blocks.data(), 1, adpcm_source->blocks.size() );
+
+                        //a truncated file keeps the whole blocks it has
+                    adpcm_source->block_count = _read / adpcm_source->block_align;
+                    adpcm_source->blocks.resize( adpcm_source->block_count * adpcm_source->block_align );
+
+                        //the last block is usually only partly used, which the fact chunk says
+                    frames = adpcm_source->block_count * adpcm_source->samples_per_block;
+                    if(fact_frames > 0 && (long)fact_frames < frames) {
+                        frames = fact_frames;
+                    }
+
+                } else if(wave_format.audioFormat == WAV_FORMAT_PCM && wave_format.bitsPerSample == 16) {
+
+                        //encoded here, so only the compressed blocks stay in memory
+                    std::vector<short> _pcm( wave_data.subChunkSize / sizeof(short) );
+                    long _read = snow::io::read( src, _pcm.data(), 1, _pcm.size() * sizeof(short) );
+
+                    frames = _read / (channels * sizeof(short));
+
+                    adpcm_source->block_align = ADPCM_ENCODE_BLOCK_ALIGN * channels;
+                    adpcm_source->samples_per_block = snow::audio::ima_samples_per_block( adpcm_source->block_align, channels );
+                    adpcm_source->block_count = snow::audio::ima_encode( _pcm.data(), channels, frames, adpcm_source->block_align, adpcm_source->blocks );
+
+                    snow::log(2, "/ snow / adpcm / %s encoded %d frames into %d blocks", _id, frames, adpcm_source->block_count);
+
+                } else {
+
+                    snow::log(1, "/ snow / %s : %s\n", _id, "only IMA-ADPCM or 16 bit pcm wav files can be loaded as adpcm");
+                    return false;
+
+                }
+
+                    //everything needed is in memory now
+                snow::io::close( src );
+                adpcm_source->file_source = NULL;
+
+                adpcm_source->offset = 0;
+                adpcm_source->length = adpcm_source->blocks.size();
+                adpcm_source->length_pcm = frames * channels * sizeof(short);
+                adpcm_source->rate = wave_format.sampleRate;
+                adpcm_source->channels = channels;
+                    //what it decodes to, which is what playback and timing work with
+                adpcm_source->bits_per_sample = 16;
+                adpcm_source->bitrate = adpcm_source->rate * channels * sizeof(short);
+
+                adpcm_source->scratch.resize( adpcm_source->samples_per_block * channels );
+                adpcm_source->scratch_block = -1;
+
+                if(read) {
+                    read_bytes_adpcm( adpcm_source, out_buffer, -1, adpcm_source->length_pcm );
+                }
+
+                return true;
+
+            } //load_info_adpcm
+
+
+            bool seek_bytes_adpcm( ADPCM_file_source* adpcm_source, long to ) {
+
+                if(adpcm_source) {
+
+                    if(to < 0) to = 0;
+                    if(to > adpcm_source->length_pcm) to = adpcm_source->length_pcm;
+
+                    snow::log(3, "/ snow / adpcm jumping to %d/%d", to, adpcm_source->length_pcm);
+                    adpcm_source->offset = to;
+
+                    return true;
+
+                }
+
+                return false;
+
+            } //seek_bytes_adpcm
 
 
-            bool read_bytes_wav( WAV_file_source* wav_source, QuickVec<unsigned char> &out_buffer, long start, long len ) {
+            bool read_bytes_adpcm( ADPCM_file_source* adpcm_source, QuickVec<unsigned char> &out_buffer, long start, long len ) {
 
-                long _read_len = len;
-                bool complete = false;
+                    //resize to fit the requested/remaining length
+                long byte_gap = (len & 0x03);
+                out_buffer.resize(len + byte_gap);
+
+                long bytes_read = 0;
+                bool complete = read_bytes_adpcm_into( adpcm_source, out_buffer.begin(), start, len, bytes_read );
+
+                if(bytes_read != len) {
+                    out_buffer.resize(bytes_read > 0 ? bytes_read + byte_gap : 0);
+                }
+
+                return complete;
+
+            } //read_bytes_adpcm
+
+
+            bool read_bytes_adpcm_into( ADPCM_file_source* adpcm_source, unsigned char* dest, long start, long len, long &bytes_read ) {
+
+                bytes_read = 0;
+
+                Decode_timer _timer(bytes_read);
+
+                if(!adpcm_source || adpcm_source->samples_per_block == 0) {
+                    return true;
+                }
 
                 if(start != -1) {
-                    snow::log(3, "/ snow / wav / start was %d, skipping there first", start);
-                    seek_bytes_wav( wav_source, start );
+                    snow::log(3, "/ snow / adpcm / start was %d, skipping there first", start);
+                    seek_bytes_adpcm( adpcm_source, start );
                 }
 
-                    //read the data into the given buffer
-                int n_elements = 1;
-                long current_pos = (snow::io::tell( wav_source->file_source ) - wav_source->data_start);
-                long distance_to_end = wav_source->length_pcm - current_pos;
+                long _read_len = len;
+                bool complete = false;
+
+                long current_pos = adpcm_source->offset;
+                long distance_to_end = adpcm_source->length_pcm - current_pos;
 
-                    //if we are reading near the end of the file,
-                    //mark complete as true because there is no more data
                 if(distance_to_end <= _read_len) {
                     _read_len = distance_to_end;
                     complete = true;
                 }
 
+                int channels = adpcm_source->channels;
+                int block_align = adpcm_source->block_align;
+                long block_bytes = (long)adpcm_source->samples_per_block * channels * sizeof(short);
 
-                if(_read_len > 0) {
+                while(_read_len > 0) {
 
-                    snow::log(2, "/ snow / wav / reading %d bytes from %d", _read_len, start);
+                    long _block = current_pos / block_bytes;
+                    long _inside = current_pos % block_bytes;
+                    long _count = 0;
+                    const unsigned char* _src = adpcm_source->blocks.data() + _block * block_align;
 
-                        //resize to fit the requested/remaining length
-                    long byte_gap = (_read_len & 0x03);
-                    out_buffer.resize(_read_len+byte_gap);
+                    if(_inside == 0 && _read_len >= block_bytes && ((size_t)dest & 1) == 0) {
 
-                        //read from the wav source
-                    long elements_read = snow::io::read( wav_source->file_source, (char*)out_buffer.begin(), _read_len, n_elements);
+                            //whole blocks decode straight into the destination
+                        long _blocks = _read_len / block_bytes;
+                        snow::audio::ima_decode_blocks( _src, _blocks, block_align, channels, (short*)dest );
+                        _count = _blocks * block_bytes;
 
-                        //if no elements were read, it was an error
-                        //or end of file so either way it's complete.
-                    if(elements_read == 0) {
-                        complete = true;
-                    } //elements_read == 0
+                    } else {
+
+                            //the edges go through the last decoded block
+                        if(adpcm_source->scratch_block != _block) {
+                            snow::audio::ima_decode_blocks( _src, 1, block_align, channels, adpcm_source->scratch.data() );
+                            adpcm_source->scratch_block = _block;
+                        }
 
-                    snow::log(2, "/ snow / wav / total read %d bytes, complete? %d", _read_len, complete);
+                        _count = block_bytes - _inside;
+                        if(_count > _read_len) _count = _read_len;
+
+                        memcpy( dest, (const unsigned char*)adpcm_source->scratch.data() + _inside, _count );
+
+                    }
+
+                    dest += _count;
+                    current_pos += _count;
+                    _read_len -= _count;
+                    bytes_read += _count;
 
                 } //_read_len > 0
 
+                adpcm_source->offset = current_pos;
+
+                snow::log(2, "/ snow / adpcm / total read %d bytes, complete? %d", bytes_read, complete);
+
                 return complete;
 
-            } //read_bytes_wav
+            } //read_bytes_adpcm_into
 
 
+        //Decoded audio cache
 
+                //Fully decoded samples, keyed by asset path and decode parameters, so that
+                //creating the same sound again is a lookup instead of a decode. The entries
+                //are kept most recently used first, and the least recent ones are evicted
+                //while the total is over budget. Only files are cached, never bytes from memory.
 
-        //PCM files
+            #define AUDIO_CACHE_BUDGET_DEFAULT (32 * 1024 * 1024)
 
+            struct Audio_cache_entry {
+                std::string             key;
+                Audio_cache_samples     samples;
+            };
 
+            typedef std::list<Audio_cache_entry> Audio_cache_list;
 
+            static std::mutex cache_lock;
+            static Audio_cache_list cache_list;
+            static std::unordered_map<std::string, Audio_cache_list::iterator> cache_map;
+            static Audio_cache_stats cache_counters = { 0, 0, 0, 0, 0, AUDIO_CACHE_BUDGET_DEFAULT };
 
-            bool load_info_pcm( QuickVec<unsigned char> &out_buffer, const char *_id, PCM_file_source*& pcm_source, bool read ) {
+                //must be called with the lock held
+            static void cache_evict( size_t budget ) {
 
-                if(!pcm_source) {
-                    snow::log(1, "/ snow / invalid source for %s", _id);
-                    return false;
+                while(cache_counters.bytes > budget && !cache_list.empty()) {
+
+                    Audio_cache_entry &_entry = cache_list.back();
+
+                    cache_counters.bytes -= _entry.samples->size();
+                    cache_counters.evictions++;
+
+                    cache_map.erase(_entry.key);
+                    cache_list.pop_back();
+
+                } //while over
+
+                cache_counters.entries = cache_list.size();
+
+            } //cache_evict
+
+                //must be called with the lock held, once the entry is known to fit and be new
+            static void cache_insert( const std::string &key, Audio_cache_samples samples ) {
+
+                Audio_cache_entry _entry;
+
+                    _entry.key = key;
+                    _entry.samples = samples;
+
+                cache_list.push_front(_entry);
+                cache_map[key] = cache_list.begin();
+                cache_counters.bytes += samples->size();
+
+                cache_evict(cache_counters.budget);
+
+            } //cache_insert
+
+            std::string cache_key( const std::string &_id, int format, bool decode_float ) {
+
+                std::string _key(_id);
+
+                    _key += (char)('0' + format);
+                    _key += decode_float ? 'f' : 'i';
+
+                return _key;
+
+            } //cache_key
+
+                //returns null on a miss. the samples stay valid while held, even if evicted
+            Audio_cache_samples cache_find( const std::string &key ) {
+
+                std::unique_lock<std::mutex> _guard(cache_lock);
+
+                auto _found = cache_map.find(key);
+
+                if(_found == cache_map.end()) {
+                    cache_counters.misses++;
+                    return Audio_cache_samples();
                 }
 
-                if (!pcm_source->file_source) {
-                    snow::log(1, "/ snow / cannot open pcm file from %s", _id);
-                    return false;
+                    //move to the front, most recently used
+                cache_list.splice(cache_list.begin(), cache_list, _found->second);
+                cache_counters.hits++;
+
+                return _found->second->samples;
+
+            } //cache_find
+
+            void cache_store( const std::string &key, const unsigned char* data, size_t length ) {
+
+                if(!data || length == 0) {
+                    return;
                 }
 
-                snow::io::seek(pcm_source->file_source, 0, snow_seek_end);
+                std::unique_lock<std::mutex> _guard(cache_lock);
 
-                    pcm_source->length = snow::io::tell(pcm_source->file_source);
-                    pcm_source->length_pcm = pcm_source->length;
+                    //larger than the whole budget, or already stored by another loader
+                if(length > cache_counters.budget || cache_map.count(key)) {
+                    return;
+                }
 
-                snow::io::seek(pcm_source->file_source, 0, snow_seek_set);
+                cache_insert( key, std::make_shared< const std::vector<unsigned char> >(data, data + length) );
 
-                    //assign the sound format values, these are defaults
-                    //and need to be assigned on the haxe side if you want different values,
-                    //right before creating the sound itself...
-                pcm_source->rate = 44100;
-                pcm_source->bitrate = 88200;
-                pcm_source->channels = 1;
-                pcm_source->bits_per_sample = 16;
+            } //cache_store
 
-                if(read) {
-                    read_bytes_pcm( pcm_source, out_buffer, -1, pcm_source->length_pcm );
+            void cache_store( const std::string &key, Audio_cache_samples samples ) {
+
+                if(!samples || samples->empty()) {
+                    return;
                 }
 
-                return true;
+                std::unique_lock<std::mutex> _guard(cache_lock);
 
-            } //load_info_pcm
+                if(samples->size() > cache_counters.budget || cache_map.count(key)) {
+                    return;
+                }
 
+                cache_insert( key, samples );
 
-            bool seek_bytes_pcm( PCM_file_source* pcm_source, long to ) {
+            } //cache_store
 
-                if(pcm_source) {
+            void cache_budget( size_t bytes ) {
 
-                        //start at the pcm data for seeking, ignoring the header stuff now
-                    snow::io::seek(pcm_source->file_source, to, snow_seek_set);
+                std::unique_lock<std::mutex> _guard(cache_lock);
 
-                    return true;
+                cache_counters.budget = bytes;
+                cache_evict(bytes);
 
-                } //pcm_source
+            } //cache_budget
 
-                return false;
+            void cache_clear() {
 
-            } //seek_bytes_pcm
+                std::unique_lock<std::mutex> _guard(cache_lock);
 
+                size_t _entries = cache_list.size();
 
-            bool read_bytes_pcm( PCM_file_source* pcm_source, QuickVec<unsigned char> &out_buffer, long start, long len ) {
+                cache_evict(0);
 
-                long _read_len = len;
-                bool complete = false;
+                snow::log(2, "/ snow / audio / cleared %d cached sounds", (int)_entries);
 
-                if(start != -1) {
-                    snow::log(3, "/ snow / pcm / start was %d, skipping there first", start);
-                    seek_bytes_pcm( pcm_source, start );
+            } //cache_clear
+
+            Audio_cache_stats cache_stats() {
+
+                std::unique_lock<std::mutex> _guard(cache_lock);
+
+                return cache_counters;
+
+            } //cache_stats
+
+
+        //Resident files
+
+                //held weakly, so a file stays in memory only while a source is reading it
+            static std::mutex resident_lock;
+            static std::map< std::string, std::weak_ptr< const std::vector<unsigned char> > > resident_files;
+
+            Audio_resident_bytes resident_bytes( const std::string &path ) {
+
+                std::unique_lock<std::mutex> _guard(resident_lock);
+
+                std::map< std::string, std::weak_ptr< const std::vector<unsigned char> > >::iterator _found = resident_files.find(path);
+
+                if(_found != resident_files.end()) {
+
+                    Audio_resident_bytes _bytes = _found->second.lock();
+
+                    if(_bytes) {
+                        return _bytes;
+                    }
+
+                    resident_files.erase(_found);
+
+                } //_found
+
+                snow::io::iosrc* _file = snow::io::iosrc_from_file(path.c_str(), "rb");
+
+                if(!_file) {
+                    return Audio_resident_bytes();
                 }
 
-                    //read the data into the given buffer
-                int n_elements = 1;
-                long current_pos = snow::io::tell( pcm_source->file_source );
-                long distance_to_end = pcm_source->length_pcm - current_pos;
+                snow::io::seek(_file, 0, snow_seek_end);
+                long _length = snow::io::tell(_file);
+                snow::io::seek(_file, 0, snow_seek_set);
 
-                    //if we are reading near the end of the file,
-                    //mark complete as true because there is no more data
-                if(distance_to_end <= _read_len) {
-                    _read_len = distance_to_end;
-                    complete = true;
+                std::shared_ptr< std::vector<unsigned char> > _bytes = std::make_shared< std::vector<unsigned char> >( _length > 0 ? (size_t)_length : 0 );
+
+                size_t _read = _length > 0 ? snow::io::read(_file, _bytes->data(), 1, (size_t)_length) : 0;
+
+                snow::io::close(_file);
+
+                if(_length <= 0 || _read != (size_t)_length) {
+                    snow::log(1, "/ snow / could not read %s into memory, read %d of %d bytes", path.c_str(), (int)_read, (int)_length);
+                    return Audio_resident_bytes();
                 }
 
-                if(_read_len > 0) {
+                resident_files[path] = _bytes;
 
-                    snow::log(2, "/ snow / pcm / reading %d bytes from %d", _read_len, start);
+                snow::log(3, "/ snow / %s is resident, %d bytes", path.c_str(), (int)_length);
 
-                        //resize to fit the requested/remaining length
-                    long byte_gap = (_read_len & 0x03);
-                    out_buffer.resize(_read_len+byte_gap);
+                return _bytes;
 
-                        //read from the pcm source
-                    long elements_read = snow::io::read( pcm_source->file_source, (char*)out_buffer.begin(), _read_len, n_elements);
+            } //resident_bytes
 
-                        //if no elements were read, it was an error
-                        //or end of file so either way it's complete.
-                    if(elements_read == 0) {
-                        complete = true;
-                    } //elements_read == 0
+            Audio_resident_stats resident_stats() {
 
-                    snow::log(2, "/ snow / pcm / total read %d bytes, complete? %d", _read_len, complete);
+                std::unique_lock<std::mutex> _guard(resident_lock);
 
-                } //_read_len > 0
+                Audio_resident_stats _stats = { 0, 0 };
 
-                return complete;
+                for(std::map< std::string, std::weak_ptr< const std::vector<unsigned char> > >::iterator it = resident_files.begin(); it != resident_files.end(); ++it) {
 
-            } //read_bytes_pcm
+                    Audio_resident_bytes _bytes = it->second.lock();
+
+                    if(_bytes) {
+                        _stats.entries++;
+                        _stats.bytes += _bytes->size();
+                    }
+
+                } //each file
+
+                return _stats;
+
+            } //resident_stats
+
+
+        //Batch loading
+
+                //open an uncompressed file through a mapping where possible, like the single file loaders
+            static snow::io::iosrc* load_batch_open_mapped( const std::string &_id, snow::io::iomap &map ) {
+
+                if(snow::io::map_file(_id.c_str(), map)) {
+                    return snow::io::iosrc_from_const_mem( map.data, (int)map.length );
+                }
+
+                return snow::io::iosrc_from_file(_id.c_str(), "rb");
+
+            } //load_batch_open_mapped
+
+                //fill an item's samples from the cache hit found before opening, or read them from the opened source
+                //and hand them to the cache, which shares them with the item rather than keeping a copy.
+                //mapped files are already in memory, so they are read directly and not cached.
+            template<typename T>
+            static void load_batch_decode( Audio_batch_item &item, T* source, bool (*reader)(T*, unsigned char*, long, long, long&), long start, const std::string &_key, Audio_cache_samples _cached, bool cached ) {
+
+                if(cached) {
+                    source->cache_key = _key;
+                }
+
+                if(_cached) {
+                    item.shared = _cached;
+                    return;
+                }
+
+                long _bytes_read = 0;
+
+                item.samples.resize( (size_t)source->length_pcm );
+
+                if(!item.samples.empty()) {
+                    reader( source, &item.samples[0], start, source->length_pcm, _bytes_read );
+                }
+
+                    //a short decode keeps what was read
+                item.samples.resize( _bytes_read > 0 ? (size_t)_bytes_read : 0 );
+
+                if(cached && !item.samples.empty()) {
+
+                    std::shared_ptr< std::vector<unsigned char> > _samples = std::make_shared< std::vector<unsigned char> >();
+                    _samples->swap(item.samples);
+
+                    cache_store( _key, _samples );
+                    item.shared = _samples;
+
+                } //cached
+
+            } //load_batch_decode
+
+                //open and decode one item fully into its own samples, on a worker thread.
+                //nothing here touches the haxe heap, the result is handed over by the main thread.
+            static void load_batch_item( Audio_batch_item &item, bool decode_float ) {
+
+                    //unused, the info loaders are asked not to read
+                QuickVec<unsigned char> _unused;
+                const char* _id = item.id.c_str();
+
+                std::string _key = cache_key(item.id, item.format, item.format == 1 && decode_float);
+
+                switch(item.format) {
+
+                    case 1: {
+
+                            //the cache is looked at before the file is opened, so a hit costs no more than reading the header for the info
+                        Audio_cache_samples _cached = cache_find(_key);
+
+                        OGG_file_source* ogg_source = new OGG_file_source();
+                        ogg_source->source_name = item.id;
+                        ogg_source->seek_index_key = item.id;
+                        ogg_source->decode_float = decode_float;
+                        ogg_source->file_source = snow::io::iosrc_from_file(_id, "rb");
+
+                        if(!load_info_ogg(_unused, _id, ogg_source, false)) {
+                            delete ogg_source;
+                            return;
+                        }
+
+                        load_batch_decode( item, ogg_source, read_bytes_ogg_into, 0, _key, _cached, true );
+
+                        item.ogg_source = ogg_source;
+
+                    } break; //ogg
+
+                    case 2: {
+
+                        WAV_file_source* wav_source = new WAV_file_source();
+                        wav_source->source_name = item.id;
+                        wav_source->file_source = load_batch_open_mapped(item.id, wav_source->map);
+
+                        if(!load_info_wav(_unused, _id, wav_source, false)) {
+                            delete wav_source;
+                            return;
+                        }
+
+                        bool _cacheable = wav_source->map.data == NULL;
+                        load_batch_decode( item, wav_source, read_bytes_wav_into, -1, _key, _cacheable ? cache_find(_key) : Audio_cache_samples(), _cacheable );
+
+                        item.wav_source = wav_source;
+
+                    } break; //wav
+
+                    case 3: {
+
+                        PCM_file_source* pcm_source = new PCM_file_source();
+                        pcm_source->source_name = item.id;
+                        pcm_source->file_source = load_batch_open_mapped(item.id, pcm_source->map);
+
+                        if(!load_info_pcm(_unused, _id, pcm_source, false)) {
+                            delete pcm_source;
+                            return;
+                        }
+
+                        bool _cacheable = pcm_source->map.data == NULL;
+                        load_batch_decode( item, pcm_source, read_bytes_pcm_into, -1, _key, _cacheable ? cache_find(_key) : Audio_cache_samples(), _cacheable );
+
+                        item.pcm_source = pcm_source;
+
+                    } break; //pcm
+
+                    case 4: {
+                            //decoding it whole would undo keeping it compressed, it loads on its own
+                        snow::log(1, "/ snow / adpcm isn't batch loaded, load %s with audio_load_info instead", _id);
+                        return;
+                    }
+
+                    default: {
+                        snow::log(1, "/ snow / unknown audio format %d in batch for %s", item.format, _id);
+                        return;
+                    }
+
+                } //switch format
+
+            } //load_batch_item
+
+            static void load_batch_run( Audio_batch* batch ) {
+
+                size_t _count = batch->items.size();
+
+                while(!batch->cancel.load()) {
+
+                    size_t _index = batch->next.fetch_add(1);
+
+                    if(_index >= _count) {
+                        break;
+                    }
+
+                    load_batch_item( batch->items[_index], batch->decode_float );
+
+                    std::unique_lock<std::mutex> _guard(batch->lock);
+                    batch->finished.push_back(_index);
+
+                } //while
+
+            } //load_batch_run
+
+            Audio_batch* load_batch_start( const std::vector<std::string> &ids, const std::vector<int> &formats, bool decode_float ) {
+
+                Audio_batch* batch = new Audio_batch();
+
+                size_t _count = ids.size();
+
+                batch->decode_float = decode_float;
+                batch->items.resize(_count);
+
+                for(size_t i = 0; i < _count; ++i) {
+                    batch->items[i].id = ids[i];
+                    batch->items[i].format = i < formats.size() ? formats[i] : 0;
+                }
+
+                    //one worker per core, but never more than there are files
+                size_t _cores = std::max(1u, std::thread::hardware_concurrency());
+                size_t _workers = std::min(_cores, _count);
+
+                for(size_t i = 0; i < _workers; ++i) {
+                    batch->workers.push_back( std::thread(load_batch_run, batch) );
+                }
+
+                snow::log(2, "/ snow / audio / batch loading %d files on %d workers", (int)_count, (int)_workers);
+
+                return batch;
+
+            } //load_batch_start
+
+                //move the indices finished since the last poll into finished, on the main thread
+            void load_batch_poll( Audio_batch* batch, std::vector<size_t> &finished ) {
+
+                finished.clear();
+
+                if(!batch) {
+                    return;
+                }
+
+                std::unique_lock<std::mutex> _guard(batch->lock);
+                finished.swap(batch->finished);
+
+            } //load_batch_poll
+
+                //stop claiming items, wait for the workers, and release any sources not collected
+            void load_batch_end( Audio_batch* batch ) {
+
+                if(!batch) {
+                    return;
+                }
+
+                batch->cancel.store(true);
+
+                for(size_t i = 0; i < batch->workers.size(); ++i) {
+                    batch->workers[i].join();
+                }
+
+                for(size_t i = 0; i < batch->items.size(); ++i) {
+                    Audio_batch_item &item = batch->items[i];
+                    if(item.ogg_source) { delete item.ogg_source; item.ogg_source = NULL; }
+                    if(item.wav_source) { delete item.wav_source; item.wav_source = NULL; }
+                    if(item.pcm_source) { delete item.pcm_source; item.pcm_source = NULL; }
+                }
+
+                delete batch;
+
+            } //load_batch_end
 
 
         } //assets::audio namespace
@@ -11,6 +11,26 @@
 #include "snow_hx_bindings.h"
 #include "snow_core.h"
 #include "common/snow_hx.h"
+#include "assets/snow_assets_audio.h"
+#include "audio/snow_audio_mix.h"
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <math.h>
+#include <float.h>
+
+    //AL_SOFT_block_alignment, not in every al.h
+#ifndef AL_UNPACK_BLOCK_ALIGNMENT_SOFT
+    #define AL_UNPACK_BLOCK_ALIGNMENT_SOFT 0x200C
+#endif
 
 /**
     These go in order that the API has them listed
@@ -18,6 +38,165 @@
 */
 namespace alhx {
 
+        //how many floats alGetSourcefv/alGetListenerfv write for a param
+    static int fv_count( ALenum param ) {
+
+        switch(param) {
+            case AL_POSITION:
+            case AL_VELOCITY:
+            case AL_DIRECTION:
+                return 3;
+            case AL_ORIENTATION:
+                return 6;
+        }
+
+        return 1;
+
+    } //fv_count
+
+        //live counts of what this module has made in AL, for alhx_AudioCounters.
+        //sources and buffers made or deleted by way of these bindings are counted,
+        //and the bytes of pcm held in buffers uploaded through buffer_data
+    struct AL_counters {
+        std::atomic<long long>  sources;
+        std::atomic<long long>  buffers;
+        std::atomic<long long>  pcm_bytes;
+            //native streams whose source ran dry while there was data left
+        std::atomic<long long>  underruns;
+    };
+
+    static AL_counters counters;
+
+    static ALint buffer_bytes( ALuint buffer ) {
+
+        ALint _size = 0;
+
+        if(buffer && alIsBuffer(buffer)) {
+            alGetBufferi(buffer, AL_SIZE, &_size);
+        }
+
+        return _size;
+
+    } //buffer_bytes
+
+        //uploads to a buffer, keeping the resident pcm bytes in step with what it replaced
+    static void buffer_data( ALuint buffer, ALenum format, const ALvoid* data, ALsizei size, ALsizei freq ) {
+
+        ALint _before = buffer_bytes(buffer);
+
+            alBufferData(buffer, format, data, size, freq);
+
+        counters.pcm_bytes += buffer_bytes(buffer) - _before;
+
+    } //buffer_data
+
+    static void gen_sources( ALsizei n, ALuint* sources ) {
+
+        alGenSources(n, sources);
+
+        for(ALsizei i = 0; i < n; ++i) {
+            if(sources[i] && alIsSource(sources[i])) counters.sources++;
+        }
+
+    } //gen_sources
+
+    static void delete_sources( ALsizei n, const ALuint* sources ) {
+
+        long long _valid = 0;
+        for(ALsizei i = 0; i < n; ++i) {
+            if(sources[i] && alIsSource(sources[i])) _valid++;
+        }
+
+        alDeleteSources(n, sources);
+
+            //a source in use isn't deleted
+        for(ALsizei i = 0; i < n; ++i) {
+            if(sources[i] && alIsSource(sources[i])) _valid--;
+        }
+
+        counters.sources -= _valid;
+
+    } //delete_sources
+
+    static void gen_buffers( ALsizei n, ALuint* buffers ) {
+
+        alGenBuffers(n, buffers);
+
+        for(ALsizei i = 0; i < n; ++i) {
+            if(buffers[i] && alIsBuffer(buffers[i])) counters.buffers++;
+        }
+
+    } //gen_buffers
+
+    static void delete_buffers( ALsizei n, const ALuint* buffers ) {
+
+        long long _valid = 0;
+        long long _bytes = 0;
+        for(ALsizei i = 0; i < n; ++i) {
+            ALint _size = buffer_bytes(buffers[i]);
+            if(buffers[i] && alIsBuffer(buffers[i])) { _valid++; _bytes += _size; }
+        }
+
+        alDeleteBuffers(n, buffers);
+
+            //a buffer still queued somewhere isn't deleted
+        for(ALsizei i = 0; i < n; ++i) {
+            if(buffers[i] && alIsBuffer(buffers[i])) { _valid--; _bytes -= buffer_bytes(buffers[i]); }
+        }
+
+        counters.buffers -= _valid;
+        counters.pcm_bytes -= _bytes;
+
+    } //delete_buffers
+
+        //the typed array view a call writes into, with room set to how many values of _size fit in it.
+        //the view is clamped to the bytes that are actually there, null (with no room) if there is nowhere to write
+    static unsigned char* into_data( value _data, value _byteOffset, value _byteLength, int _size, int &room ) {
+
+        room = 0;
+
+        unsigned char* data = snow::bytes_from_hx_rw( _data );
+
+        if(!data) {
+            return NULL;
+        }
+
+        int _offset = val_int(_byteOffset);
+        int _length = val_int(_byteLength);
+        int _bytes = snow::bytes_length_hx( _data );
+
+        if(_offset < 0 || _length <= 0 || _offset >= _bytes) {
+            return NULL;
+        }
+
+        if(_length > _bytes - _offset) {
+            _length = _bytes - _offset;
+        }
+
+        room = _length / _size;
+
+        return data + _offset;
+
+    } //into_data
+
+        //copies counter values into a Float64Array, as many as fit, returning how many did
+    static int counters_write( const double* values, int count, value _data, value _byteOffset, value _byteLength ) {
+
+        int _fit = 0;
+        unsigned char* data = into_data( _data, _byteOffset, _byteLength, sizeof(double), _fit );
+
+        if(_fit > count) _fit = count;
+
+        if(!data || _fit <= 0) {
+            return 0;
+        }
+
+        memcpy(data, values, _fit * sizeof(double));
+
+        return _fit;
+
+    } //counters_write
+
     value alhx_DopplerFactor(value _value) {
 
         alDopplerFactor(val_float(_value));
@@ -92,6 +271,8 @@ namespace alhx {
             val_array_set_i(result, i, alloc_bool(vals[i]) );
         }
 
+        delete [] vals;
+
         return result;
 
     } DEFINE_PRIM(alhx_GetBooleanv, 2);
@@ -109,6 +290,8 @@ namespace alhx {
             val_array_set_i(result, i, alloc_int(vals[i]) );
         }
 
+        delete [] vals;
+
         return result;
 
     } DEFINE_PRIM(alhx_GetIntegerv, 2);
@@ -126,6 +309,8 @@ namespace alhx {
             val_array_set_i(result, i, alloc_float(vals[i]) );
         }
 
+        delete [] vals;
+
         return result;
 
     } DEFINE_PRIM(alhx_GetFloatv, 2);
@@ -143,6 +328,8 @@ namespace alhx {
             val_array_set_i(result, i, alloc_float((float)vals[i]) );
         }
 
+        delete [] vals;
+
         return result;
 
     } DEFINE_PRIM(alhx_GetDoublev, 2);
@@ -296,6 +483,8 @@ namespace alhx {
             val_array_set_i(result, i, alloc_float(vals[i]) );
         }
 
+        delete [] vals;
+
         return result;
 
     } DEFINE_PRIM(alhx_GetListenerfv, 2);
@@ -339,6 +528,8 @@ namespace alhx {
             val_array_set_i(result, i, alloc_int(vals[i]) );
         }
 
+        delete [] vals;
+
         return result;
 
     } DEFINE_PRIM(alhx_GetListeneriv, 2);
@@ -350,7 +541,7 @@ namespace alhx {
 
         ALuint source;
 
-        alGenSources((ALuint)1, &source);
+        gen_sources(1, &source);
 
         return alloc_int(source);
 
@@ -360,12 +551,163 @@ namespace alhx {
 
         ALuint source = val_int(_source);
 
-        alDeleteSources(1, &source);
+        delete_sources(1, &source);
 
         return alloc_null();
 
     } DEFINE_PRIM(alhx_DeleteSource, 1);
 
+        //AL_SOFT_deferred_updates, looked up once. Where it's missing,
+        //alcSuspendContext/alcProcessContext are the (often no-op) fallback
+    typedef void (*alhx_UpdatesSOFT)(void);
+
+    static bool batch_lookup = false;
+    static alhx_UpdatesSOFT batch_defer = NULL;
+    static alhx_UpdatesSOFT batch_process = NULL;
+
+    static void batch_begin() {
+
+        if(!batch_lookup) {
+
+            batch_lookup = true;
+
+            if(alIsExtensionPresent("AL_SOFT_deferred_updates")) {
+                batch_defer = (alhx_UpdatesSOFT)alGetProcAddress("alDeferUpdatesSOFT");
+                batch_process = (alhx_UpdatesSOFT)alGetProcAddress("alProcessUpdatesSOFT");
+            }
+
+        } //batch_lookup
+
+        if(batch_defer && batch_process) {
+            batch_defer();
+        } else {
+            alcSuspendContext( alcGetCurrentContext() );
+        }
+
+    } //batch_begin
+
+    static void batch_end() {
+
+        if(batch_defer && batch_process) {
+            batch_process();
+        } else {
+            alcProcessContext( alcGetCurrentContext() );
+        }
+
+    } //batch_end
+
+        //Applies a packed list of float source properties in one call, instead of one call per property.
+        //Each record is a (source, param, count) header as ints, with its count values taken in turn from
+        //the float array, count being 1, 3 or the length for alSourcefv. The ids stay ints, as a float
+        //can't hold every source id exactly. With _defer set, the whole batch reaches the mixer at once.
+        //Returns the number of records applied, stopping at the first malformed one.
+    value alhx_SourceBatchf(value *arg, int argCount) {
+
+        enum { A_headers, A_headersOffset, A_headersLength, A_values, A_valuesOffset, A_valuesLength, A_defer };
+
+        const unsigned char* headers = snow::bytes_from_hx( arg[A_headers] );
+        const unsigned char* values = snow::bytes_from_hx( arg[A_values] );
+
+        if(!headers || !values) {
+            return alloc_int(0);
+        }
+
+        const int* rec = (const int*)(headers + val_int(arg[A_headersOffset]));
+        const int* end = rec + (val_int(arg[A_headersLength]) / sizeof(int));
+
+        const float* vals = (const float*)(values + val_int(arg[A_valuesOffset]));
+        const float* vals_end = vals + (val_int(arg[A_valuesLength]) / sizeof(float));
+
+        bool defer = val_bool(arg[A_defer]);
+        int applied = 0;
+
+        if(defer) {
+            batch_begin();
+        }
+
+        while(end - rec >= 3) {
+
+            ALuint source = (ALuint)rec[0];
+            ALenum param = (ALenum)rec[1];
+            int count = rec[2];
+
+            if(count < 1 || vals_end - vals < count) {
+                snow::log(1, "/ alhx / source batch record %d is malformed, count %d", applied, count);
+                break;
+            }
+
+            switch(count) {
+                case 1:  alSourcef( source, param, vals[0] ); break;
+                case 3:  alSource3f( source, param, vals[0], vals[1], vals[2] ); break;
+                default: alSourcefv( source, param, vals ); break;
+            }
+
+            rec += 3;
+            vals += count;
+            ++applied;
+
+        } //each record
+
+        if(defer) {
+            batch_end();
+        }
+
+        return alloc_int(applied);
+
+    } DEFINE_PRIM_MULT(alhx_SourceBatchf);
+
+        //as alhx_SourceBatchf, for the integer properties like AL_BUFFER and AL_LOOPING,
+        //each record being (source, param, count, values...) as ints
+    value alhx_SourceBatchi(value _data, value _byteOffset, value _byteLength, value _defer) {
+
+        const unsigned char* data = snow::bytes_from_hx( _data );
+
+        if(!data) {
+            return alloc_int(0);
+        }
+
+        const int* rec = (const int*)(data + val_int(_byteOffset));
+        const int* end = rec + (val_int(_byteLength) / sizeof(int));
+
+        bool defer = val_bool(_defer);
+        int applied = 0;
+
+        if(defer) {
+            batch_begin();
+        }
+
+        while(end - rec >= 3) {
+
+            ALuint source = (ALuint)rec[0];
+            ALenum param = (ALenum)rec[1];
+            int count = rec[2];
+
+            if(count < 1 || end - rec - 3 < count) {
+                snow::log(1, "/ alhx / source batch record %d is malformed, count %d", applied, count);
+                break;
+            }
+
+            const int* vals = rec + 3;
+
+            switch(count) {
+                case 1:  alSourcei( source, param, vals[0] ); break;
+                case 3:  alSource3i( source, param, vals[0], vals[1], vals[2] ); break;
+                default: alSourceiv( source, param, vals ); break;
+            }
+
+            rec += 3 + count;
+            ++applied;
+
+        } //each record
+
+        if(defer) {
+            batch_end();
+        }
+
+        return alloc_int(applied);
+
+    } DEFINE_PRIM(alhx_SourceBatchi, 4);
+
 // --- >
 
     value alhx_GenSources(value _n) {
@@ -373,7 +715,7 @@ namespace alhx {
         int count = val_int(_n);
         ALuint* sources = new ALuint[count];
 
-        alGenSources( count, sources );
+        gen_sources( count, sources );
 
         value result = alloc_array(count);
 
@@ -381,6 +723,8 @@ namespace alhx {
             val_array_set_i(result, i, alloc_int(sources[i]) );
         }
 
+        delete [] sources;
+
         return result;
 
     } DEFINE_PRIM(alhx_GenSources, 1);
@@ -390,7 +734,7 @@ namespace alhx {
         int *sources = val_array_int(_sources);
 
         if(sources) {
-            alDeleteSources( val_int(_n), (ALuint*)sources );
+            delete_sources( val_int(_n), (ALuint*)sources );
         } else {
             //warn: try val_array normal approach?
         }
@@ -492,12 +836,15 @@ namespace alhx {
 
     } DEFINE_PRIM(alhx_GetSource3f, 2);
 
-    value alhx_GetSourcefv(value _source, value _param, value _count) {
+    value alhx_GetSourcefv(value _source, value _param) {
 
-        int count = val_int(_count);
-        ALfloat* vals = new ALfloat[count];
+        ALenum param = val_int(_param);
+        ALfloat vals[6] = { 0, 0, 0, 0, 0, 0 };
 
-        alGetSourcefv( val_int(_source), val_int(_param), vals );
+        alGetSourcefv( val_int(_source), param, vals );
+
+            //the haxe side doesn't pass a count, the param decides it
+        int count = fv_count(param);
 
         value result = alloc_array(count);
 
@@ -548,6 +895,8 @@ namespace alhx {
             val_array_set_i(result, i, alloc_int(vals[i]) );
         }
 
+        delete [] vals;
+
         return result;
 
     } DEFINE_PRIM(alhx_GetSourceiv, 3);
@@ -677,12 +1026,51 @@ namespace alhx {
     } DEFINE_PRIM(alhx_SourceUnqueueBuffers, 2);
 
 
+        //AL_EXT_STATIC_BUFFER, looked up once. Where present, openal plays decoded samples
+        //from memory snow keeps instead of its own copy, so the samples are held here until the buffer goes
+    typedef void (*alhx_BufferDataStaticProc)(ALint, ALenum, const ALvoid*, ALsizei, ALsizei);
+
+    static bool static_lookup = false;
+    static alhx_BufferDataStaticProc static_buffer_data = 0;
+    static std::map<ALuint, snow::assets::audio::Audio_cache_samples> static_buffers;
+
+    static alhx_BufferDataStaticProc static_buffer_proc() {
+
+        if(!static_lookup) {
+
+            static_lookup = true;
+
+            if(alIsExtensionPresent("AL_EXT_STATIC_BUFFER")) {
+                static_buffer_data = (alhx_BufferDataStaticProc)alGetProcAddress("alBufferDataStatic");
+            }
+
+        } //!static_lookup
+
+        return static_buffer_data;
+
+    } //static_buffer_proc
+
+        //lets go of the samples behind a buffer once openal no longer has it, or has other data in it
+    static void static_buffer_release( ALuint buffer, bool deleted ) {
+
+        if(static_buffers.empty()) {
+            return;
+        }
+
+        if(deleted && alIsBuffer(buffer)) {
+            return;
+        }
+
+        static_buffers.erase(buffer);
+
+    } //static_buffer_release
+
     value alhx_GenBuffers(value _n) {
 
         int count = val_int(_n);
         ALuint* buffers = new ALuint[count];
 
-        alGenBuffers( count, buffers );
+        gen_buffers( count, buffers );
 
         value result = alloc_array(count);
 
@@ -696,12 +1084,135 @@ namespace alhx {
 
     } DEFINE_PRIM(alhx_GenBuffers, 1);
 
+// --- > not official api
+// --- > allocation free forms, these write into and read from typed arrays the caller keeps,
+// --- > so a streaming loop or per frame query makes no garbage
+
+        //unqueues up to _nb processed buffers into the typed array, returns how many were unqueued
+    value alhx_SourceUnqueueBuffersInto(value *arg, int argCount) {
+
+        enum { A_source, A_nb, A_data, A_byteOffset, A_byteLength };
+
+        ALuint source = val_int( arg[A_source] );
+        int count = val_int( arg[A_nb] );
+        int room = 0;
+        unsigned char* data = into_data( arg[A_data], arg[A_byteOffset], arg[A_byteLength], sizeof(ALuint), room );
+
+        ALint processed = 0;
+        alGetSourcei( source, AL_BUFFERS_PROCESSED, &processed );
+
+        if(count > processed) { count = processed; }
+        if(count > room) { count = room; }
+
+        if(!data || count <= 0) {
+            return alloc_int(0);
+        }
+
+        alSourceUnqueueBuffers( source, count, (ALuint*)data );
+
+        return alloc_int(count);
+
+    } DEFINE_PRIM_MULT(alhx_SourceUnqueueBuffersInto);
+
+        //queues _nb buffer ids from the typed array
+    value alhx_SourceQueueBuffersFrom(value *arg, int argCount) {
+
+        enum { A_source, A_nb, A_data, A_byteOffset, A_byteLength };
+
+        int count = val_int( arg[A_nb] );
+        int room = 0;
+        const unsigned char* data = into_data( arg[A_data], arg[A_byteOffset], arg[A_byteLength], sizeof(ALuint), room );
+
+        if(count > room) { count = room; }
+
+        if(count > 0 && data) {
+            alSourceQueueBuffers( val_int(arg[A_source]), count, (const ALuint*)data );
+        }
+
+        return alloc_int(count > 0 ? count : 0);
+
+    } DEFINE_PRIM_MULT(alhx_SourceQueueBuffersFrom);
+
+        //generates up to _n buffers into the typed array, returns how many were generated
+    value alhx_GenBuffersInto(value _n, value _data, value _byteOffset, value _byteLength) {
+
+        int count = val_int(_n);
+        int room = 0;
+        unsigned char* data = into_data( _data, _byteOffset, _byteLength, sizeof(ALuint), room );
+
+        if(count > room) { count = room; }
+
+        if(!data || count <= 0) {
+            return alloc_int(0);
+        }
+
+        gen_buffers( count, (ALuint*)data );
+
+        return alloc_int(count);
+
+    } DEFINE_PRIM(alhx_GenBuffersInto, 4);
+
+        //writes the floats of a source param into the typed array, returns how many were written
+    value alhx_GetSourcefvInto(value *arg, int argCount) {
+
+        enum { A_source, A_param, A_data, A_byteOffset, A_byteLength };
+
+        ALenum param = val_int( arg[A_param] );
+        ALfloat vals[6] = { 0, 0, 0, 0, 0, 0 };
+
+        alGetSourcefv( val_int(arg[A_source]), param, vals );
+
+        int count = fv_count(param);
+        int room = 0;
+        unsigned char* data = into_data( arg[A_data], arg[A_byteOffset], arg[A_byteLength], sizeof(ALfloat), room );
+
+        if(count > room) { count = room; }
+
+        if(!data || count <= 0) {
+            return alloc_int(0);
+        }
+
+        memcpy( data, vals, count * sizeof(ALfloat) );
+
+        return alloc_int(count);
+
+    } DEFINE_PRIM_MULT(alhx_GetSourcefvInto);
+
+        //writes the floats of a listener param into the typed array, returns how many were written
+    value alhx_GetListenerfvInto(value _param, value _data, value _byteOffset, value _byteLength) {
+
+        ALenum param = val_int(_param);
+        ALfloat vals[6] = { 0, 0, 0, 0, 0, 0 };
+
+        alGetListenerfv( param, vals );
+
+        int count = fv_count(param);
+        int room = 0;
+        unsigned char* data = into_data( _data, _byteOffset, _byteLength, sizeof(ALfloat), room );
+
+        if(count > room) { count = room; }
+
+        if(!data || count <= 0) {
+            return alloc_int(0);
+        }
+
+        memcpy( data, vals, count * sizeof(ALfloat) );
+
+        return alloc_int(count);
+
+    } DEFINE_PRIM(alhx_GetListenerfvInto, 4);
+
+// --- >
+
     value alhx_DeleteBuffers(value _n, value _buffers) {
 
         int *buffers = val_array_int(_buffers);
 
         if(buffers) {
-            alDeleteBuffers( val_int(_n), (ALuint*)buffers );
+            delete_buffers( val_int(_n), (ALuint*)buffers );
+            for(int i = 0; i < val_int(_n); ++i) {
+                static_buffer_release( (ALuint)buffers[i], true );
+            }
         } else {
             //warn: try val_array normal approach
         }
@@ -723,7 +1234,7 @@ namespace alhx {
 
         ALuint buffer;
 
-        alGenBuffers( (ALuint)1, &buffer );
+        gen_buffers( 1, &buffer );
 
         return alloc_int(buffer);
 
@@ -733,7 +1244,8 @@ namespace alhx {
 
         ALuint buffer = val_int(_buffer);
 
-        alDeleteBuffers((ALuint)1, &buffer );
+        delete_buffers( 1, &buffer );
+        static_buffer_release( buffer, true );
 
         return alloc_null();
 
@@ -751,161 +1263,2513 @@ namespace alhx {
         int byteLength  = val_int( arg[A_byteLength] );
         int frequency   = val_int( arg[A_frequency]  );
 
-        const float* data = (float*)snow::bytes_from_hx( arg[A_data] );
+            //offset in bytes, regardless of what the typed array view holds
+        const unsigned char* data = snow::bytes_from_hx( arg[A_data] );
 
-        alBufferData( albufferid, format, data + byteOffset, byteLength, frequency );
+        buffer_data( albufferid, format, data + byteOffset, byteLength, frequency );
+        static_buffer_release( albufferid, false );
 
         return alloc_null();
 
     } DEFINE_PRIM_MULT( alhx_BufferData );
 
+        //uploads the whole pcm of a memory mapped wav/pcm source straight from the mapping,
+        //so a fully loaded sound never needs a copy of its samples on the heap.
+        //adpcm sources hand over their compressed blocks instead, for the AL_EXT_IMA4 formats
+    value alhx_BufferDataMapped(value _albufferid, value _format, value _info, value _frequency) {
 
-    value alhx_Bufferf(value _buffer, value _param, value _value) {
+        value _handle = snow::property_value(_info, snow::id_handle);
 
-        alBufferf(val_int(_buffer), val_int(_param), val_float(_value) );
+        if(val_is_null(_handle)) {
+            return alloc_bool(false);
+        }
 
-        return alloc_null();
+        const unsigned char* view = NULL;
+        long length = 0;
 
-    } DEFINE_PRIM(alhx_Bufferf, 3);
+        switch( snow::property_int(_info, snow::id_format, 0) ) {
 
-    value alhx_Buffer3f(value _buffer, value _param, value _value1, value _value2, value _value3) {
+            case 2: { //wav
+                snow::assets::audio::WAV_file_source* wav_source = snow::from_hx<snow::assets::audio::WAV_file_source>(_handle);
+                if(wav_source) {
+                    snow::assets::audio::view_bytes_wav( wav_source, 0, wav_source->length_pcm, view, length );
+                }
+                break;
+            }
 
-        alBuffer3f(val_int(_buffer), val_int(_param), val_float(_value1),val_float(_value2),val_float(_value3) );
+            case 3: { //pcm
+                snow::assets::audio::PCM_file_source* pcm_source = snow::from_hx<snow::assets::audio::PCM_file_source>(_handle);
+                if(pcm_source) {
+                    snow::assets::audio::view_bytes_pcm( pcm_source, 0, pcm_source->length_pcm, view, length );
+                }
+                break;
+            }
 
-        return alloc_null();
+            case 4: { //adpcm
+                snow::assets::audio::ADPCM_file_source* adpcm_source = snow::from_hx<snow::assets::audio::ADPCM_file_source>(_handle);
+                if(adpcm_source && !adpcm_source->blocks.empty()) {
 
-    } DEFINE_PRIM(alhx_Buffer3f, 5);
+                        //openal assumes 65 frame blocks, anything else has to be declared
+                    if(adpcm_source->samples_per_block != 65) {
+                        if(!alIsExtensionPresent("AL_SOFT_block_alignment")) {
+                            break;
+                        }
+                        alBufferi( val_int(_albufferid), AL_UNPACK_BLOCK_ALIGNMENT_SOFT, adpcm_source->samples_per_block );
+                    }
 
-    value alhx_Bufferfv(value _buffer, value _param, value _values) {
+                    view = adpcm_source->blocks.data();
+                    length = (long)adpcm_source->blocks.size();
 
-        float *vals = val_array_float(_values);
+                }
+                break;
+            }
 
-        if(vals) {
-            alBufferfv( val_int(_buffer), val_int(_param), vals );
-        } else {
-            //warn: try val_array normal approach?
-        }
+        } //switch format
 
-        return alloc_null();
+        if(!view) {
+            return alloc_bool(false);
+        }
 
-    } DEFINE_PRIM(alhx_Bufferfv, 3);
+        buffer_data( val_int(_albufferid), val_int(_format), view, length, val_int(_frequency) );
+        static_buffer_release( val_int(_albufferid), false );
 
-    value alhx_Bufferi(value _buffer, value _param, value _value) {
+        return alloc_bool(true);
 
-        alBufferi(val_int(_buffer), val_int(_param), val_int(_value) );
+    } DEFINE_PRIM(alhx_BufferDataMapped, 4);
 
-        return alloc_null();
+        //the whole pcm of a source, from the decoded audio cache when it has it,
+        //otherwise decoded here and offered to the cache, which shares rather than copies it
+    template<typename T>
+    static snow::assets::audio::Audio_cache_samples buffer_decode( bool (*_reader)( T*, unsigned char*, long, long, long& ), T* _source ) {
 
-    } DEFINE_PRIM(alhx_Bufferi, 3);
+        if(!_source) {
+            return snow::assets::audio::Audio_cache_samples();
+        }
 
-    value alhx_Buffer3i(value _buffer, value _param, value _value1, value _value2, value _value3) {
+        if(!_source->cache_key.empty()) {
 
-        alBuffer3i(val_int(_buffer), val_int(_param), val_int(_value1),val_int(_value2),val_int(_value3) );
+            snow::assets::audio::Audio_cache_samples _cached = snow::assets::audio::cache_find(_source->cache_key);
 
-        return alloc_null();
+            if(_cached) {
+                return _cached;
+            }
 
-    } DEFINE_PRIM(alhx_Buffer3i, 5);
+        } //cache_key
 
-    value alhx_Bufferiv(value _buffer, value _param, value _values) {
+        std::shared_ptr< std::vector<unsigned char> > _samples = std::make_shared< std::vector<unsigned char> >( (size_t)_source->length_pcm );
 
-        int *vals = val_array_int(_values);
+        long _bytes_read = 0;
 
-        if(vals) {
-            alBufferiv( val_int(_buffer), val_int(_param), vals );
-        } else {
-            //warn: try val_array normal approach?
+        if(!_samples->empty()) {
+            _reader( _source, _samples->data(), 0, _source->length_pcm, _bytes_read );
         }
 
-        return alloc_null();
+            //a short decode keeps what was read
+        _samples->resize( _bytes_read > 0 ? (size_t)_bytes_read : 0 );
 
-    } DEFINE_PRIM(alhx_Bufferiv, 3);
+        if(!_source->cache_key.empty()) {
+            snow::assets::audio::cache_store( _source->cache_key, _samples );
+        }
 
-    value alhx_GetBufferf(value _buffer, value _param) {
+        return _samples;
 
-        float the_value;
+    } //buffer_decode
 
-        alGetBufferf( val_int(_buffer), val_int(_param), &the_value );
+        //decodes the whole of an info source natively and uploads it to the buffer, so the pcm never
+        //reaches the haxe heap. openal has the only copy after, unless the cache keeps one too, in which case
+        //where AL_EXT_STATIC_BUFFER is present the two are the same memory. returns false if nothing was uploaded
+    value alhx_BufferDataDecode(value _albufferid, value _format, value _info, value _frequency) {
 
-        return alloc_float(the_value);
+        value _handle = snow::property_value(_info, snow::id_handle);
 
-    } DEFINE_PRIM(alhx_GetBufferf, 2);
+        if(val_is_null(_handle)) {
+            return alloc_bool(false);
+        }
 
-    value alhx_GetBuffer3f(value _buffer, value _param) {
+        snow::assets::audio::Audio_cache_samples _samples;
 
-        ALfloat val1, val2, val3;
+        switch( snow::property_int(_info, snow::id_format, 0) ) {
 
-        alGetBuffer3f( val_int(_buffer), val_int(_param), &val1, &val2, &val3 );
+            case 1: { //ogg
+                _samples = buffer_decode( snow::assets::audio::read_bytes_ogg_into, snow::from_hx<snow::assets::audio::OGG_file_source>(_handle) );
+                break;
+            }
+
+            case 2: { //wav
+                _samples = buffer_decode( snow::assets::audio::read_bytes_wav_into, snow::from_hx<snow::assets::audio::WAV_file_source>(_handle) );
+                break;
+            }
+
+            case 3: { //pcm
+                _samples = buffer_decode( snow::assets::audio::read_bytes_pcm_into, snow::from_hx<snow::assets::audio::PCM_file_source>(_handle) );
+                break;
+            }
+
+            case 4: { //adpcm, decoded to 16 bit
+                _samples = buffer_decode( snow::assets::audio::read_bytes_adpcm_into, snow::from_hx<snow::assets::audio::ADPCM_file_source>(_handle) );
+                break;
+            }
+
+        } //switch format
+
+        if(!_samples || _samples->empty()) {
+            return alloc_bool(false);
+        }
+
+        ALuint _buffer = val_int(_albufferid);
+        alhx_BufferDataStaticProc _static = static_buffer_proc();
+
+        if(_static) {
+            ALint _before = buffer_bytes(_buffer);
+            _static( _buffer, val_int(_format), _samples->data(), (ALsizei)_samples->size(), val_int(_frequency) );
+            counters.pcm_bytes += buffer_bytes(_buffer) - _before;
+            static_buffers[_buffer] = _samples;
+        } else {
+            buffer_data( _buffer, val_int(_format), _samples->data(), (ALsizei)_samples->size(), val_int(_frequency) );
+            static_buffer_release( _buffer, false );
+        }
+
+        return alloc_bool(true);
+
+    } DEFINE_PRIM(alhx_BufferDataDecode, 4);
+
+
+    value alhx_Bufferf(value _buffer, value _param, value _value) {
+
+        alBufferf(val_int(_buffer), val_int(_param), val_float(_value) );
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_Bufferf, 3);
+
+    value alhx_Buffer3f(value _buffer, value _param, value _value1, value _value2, value _value3) {
+
+        alBuffer3f(val_int(_buffer), val_int(_param), val_float(_value1),val_float(_value2),val_float(_value3) );
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_Buffer3f, 5);
+
+    value alhx_Bufferfv(value _buffer, value _param, value _values) {
+
+        float *vals = val_array_float(_values);
+
+        if(vals) {
+            alBufferfv( val_int(_buffer), val_int(_param), vals );
+        } else {
+            //warn: try val_array normal approach?
+        }
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_Bufferfv, 3);
+
+    value alhx_Bufferi(value _buffer, value _param, value _value) {
+
+        alBufferi(val_int(_buffer), val_int(_param), val_int(_value) );
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_Bufferi, 3);
+
+    value alhx_Buffer3i(value _buffer, value _param, value _value1, value _value2, value _value3) {
+
+        alBuffer3i(val_int(_buffer), val_int(_param), val_int(_value1),val_int(_value2),val_int(_value3) );
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_Buffer3i, 5);
+
+    value alhx_Bufferiv(value _buffer, value _param, value _values) {
+
+        int *vals = val_array_int(_values);
+
+        if(vals) {
+            alBufferiv( val_int(_buffer), val_int(_param), vals );
+        } else {
+            //warn: try val_array normal approach?
+        }
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_Bufferiv, 3);
+
+    value alhx_GetBufferf(value _buffer, value _param) {
+
+        float the_value;
+
+        alGetBufferf( val_int(_buffer), val_int(_param), &the_value );
+
+        return alloc_float(the_value);
+
+    } DEFINE_PRIM(alhx_GetBufferf, 2);
+
+    value alhx_GetBuffer3f(value _buffer, value _param) {
+
+        ALfloat val1, val2, val3;
+
+        alGetBuffer3f( val_int(_buffer), val_int(_param), &val1, &val2, &val3 );
+
+        value result = alloc_array(3);
+
+            val_array_set_i(result, 0, alloc_float( val1 ) );
+            val_array_set_i(result, 1, alloc_float( val2 ) );
+            val_array_set_i(result, 2, alloc_float( val3 ) );
+
+        return result;
+
+    } DEFINE_PRIM(alhx_GetBuffer3f, 2);
+
+    value alhx_GetBufferfv(value _buffer, value _param, value _count) {
+
+        int count = val_int(_count);
+        ALfloat* vals = new ALfloat[count];
+
+        alGetBufferfv( val_int(_buffer), val_int(_param), vals );
+
+        value result = alloc_array(count);
+
+        for( int i = 0; i < count; ++i ) {
+            val_array_set_i(result, i, alloc_float(vals[i]) );
+        }
+
+        delete [] vals;
+
+        return result;
+
+    } DEFINE_PRIM(alhx_GetBufferfv, 3);
+
+    value alhx_GetBufferi(value _buffer, value _param) {
+
+        int the_value;
+
+        alGetBufferi( val_int(_buffer), val_int(_param), &the_value );
+
+        return alloc_int(the_value);
+
+    } DEFINE_PRIM(alhx_GetBufferi, 2);
+
+    value alhx_GetBuffer3i(value _buffer, value _param) {
+
+        ALint val1, val2, val3;
+
+        alGetBuffer3i( val_int(_buffer), val_int(_param), &val1, &val2, &val3 );
+
+        value result = alloc_array(3);
+
+            val_array_set_i(result, 0, alloc_int( val1 ) );
+            val_array_set_i(result, 1, alloc_int( val2 ) );
+            val_array_set_i(result, 2, alloc_int( val3 ) );
+
+        return result;
+
+    } DEFINE_PRIM(alhx_GetBuffer3i, 2);
+
+    value alhx_GetBufferiv(value _buffer, value _param, value _count) {
+
+        int count = val_int(_count);
+        ALint* vals = new ALint[count];
+
+        alGetBufferiv( val_int(_buffer), val_int(_param), vals );
+
+        value result = alloc_array(count);
+
+        for( int i = 0; i < count; ++i ) {
+            val_array_set_i(result, i, alloc_int(vals[i]) );
+        }
+
+        delete [] vals;
+
+        return result;
+
+    } DEFINE_PRIM(alhx_GetBufferiv, 3);
+
+
+// --- > shared buffers, not official api
+// --- > added so many sounds from one asset hold one copy of its pcm
+
+        //A filled buffer, shared by every sound made from the same asset key.
+        //Each sound holds a reference and the buffer is deleted with the last one.
+    struct AL_shared_buffer {
+        ALuint  buffer;
+        int     refs;
+        ALint   bytes;
+    };
+
+    class AL_shared_buffers {
+
+        public:
+
+            std::map<std::string, AL_shared_buffer>     by_key;
+            std::map<ALuint, std::string>               keys;
+            long long                                   hits;
+            long long                                   misses;
+
+        AL_shared_buffers() : hits(0), misses(0) {}
+
+    }; //AL_shared_buffers
+
+    static AL_shared_buffers shared_buffers;
+
+        //true if a buffer for key is already filled, without taking a reference
+    value alhx_BufferShared(value _key) {
+
+        return alloc_bool( shared_buffers.by_key.count( std::string(val_string(_key)) ) > 0 );
+
+    } DEFINE_PRIM(alhx_BufferShared, 1);
+
+        //takes a reference to the buffer filled for key, returning it, or 0 when there is none yet
+    value alhx_BufferShare(value _key) {
+
+        std::map<std::string, AL_shared_buffer>::iterator _entry = shared_buffers.by_key.find( std::string(val_string(_key)) );
+
+        if(_entry == shared_buffers.by_key.end()) {
+            shared_buffers.misses++;
+            return alloc_int(0);
+        }
+
+        shared_buffers.hits++;
+        _entry->second.refs++;
+
+        return alloc_int( _entry->second.buffer );
+
+    } DEFINE_PRIM(alhx_BufferShare, 1);
+
+        //hands a freshly filled buffer to the cache under key, holding the first reference to it
+    value alhx_BufferShareStore(value _key, value _buffer) {
+
+        std::string _key_str(val_string(_key));
+        ALuint buffer = val_int(_buffer);
+
+        if(!buffer || shared_buffers.by_key.count(_key_str) || shared_buffers.keys.count(buffer)) {
+            return alloc_bool(false);
+        }
+
+        AL_shared_buffer _shared = { buffer, 1, buffer_bytes(buffer) };
+
+        shared_buffers.by_key[_key_str] = _shared;
+        shared_buffers.keys[buffer] = _key_str;
+
+        return alloc_bool(true);
+
+    } DEFINE_PRIM(alhx_BufferShareStore, 2);
+
+        //lets go of a reference, deleting the buffer with the last one.
+        //a buffer that was never shared is deleted straight away
+    value alhx_BufferRelease(value _buffer) {
+
+        ALuint buffer = val_int(_buffer);
+
+        std::map<ALuint, std::string>::iterator _key = shared_buffers.keys.find(buffer);
+
+        if(_key != shared_buffers.keys.end()) {
+
+            AL_shared_buffer &_shared = shared_buffers.by_key[_key->second];
+
+            if(--_shared.refs > 0) {
+                return alloc_bool(false);
+            }
+
+            shared_buffers.by_key.erase(_key->second);
+            shared_buffers.keys.erase(_key);
+
+        } //shared
+
+        delete_buffers( 1, &buffer );
+        static_buffer_release( buffer, true );
+
+        return alloc_bool(true);
+
+    } DEFINE_PRIM(alhx_BufferRelease, 1);
+
+        //returns [buffers, references, resident bytes, deduplicated bytes, hits, misses].
+        //the deduplicated bytes are what each extra reference would have cost as a buffer of its own
+    value alhx_BufferShareStats() {
+
+        double _refs = 0;
+        double _resident = 0;
+        double _saved = 0;
+
+        for(std::map<std::string, AL_shared_buffer>::iterator it = shared_buffers.by_key.begin(); it != shared_buffers.by_key.end(); ++it) {
+            _refs += it->second.refs;
+            _resident += it->second.bytes;
+            _saved += (double)it->second.bytes * (it->second.refs - 1);
+        }
+
+        value result = alloc_array(6);
+
+            val_array_set_i(result, 0, alloc_float( (double)shared_buffers.by_key.size() ));
+            val_array_set_i(result, 1, alloc_float( _refs ));
+            val_array_set_i(result, 2, alloc_float( _resident ));
+            val_array_set_i(result, 3, alloc_float( _saved ));
+            val_array_set_i(result, 4, alloc_float( (double)shared_buffers.hits ));
+            val_array_set_i(result, 5, alloc_float( (double)shared_buffers.misses ));
+
+        return result;
+
+    } DEFINE_PRIM(alhx_BufferShareStats, 0);
+
+// --- >
+
+// --- > voices, not official api
+// --- > added so sounds can outnumber the sources the device has
+
+        //a voice that already holds a source has its score scaled by this when sources
+        //are handed out, so two voices of about the same score don't swap back and forth
+    #define ALHX_VOICE_KEEP         1.25f
+        //the longest step virtual voices are moved on by in one update, in seconds,
+        //so a long gap between updates (a suspended app) doesn't jump them ahead
+    #define ALHX_VOICE_MAX_STEP     0.5
+        //sources the pool leaves to the device, for the streams, the mixer and plain sources,
+        //which make their own with alGenSources
+    #define ALHX_VOICE_RESERVE      8
+
+        //A sound that plays whether or not it holds a real source at the moment.
+        //Its properties live here and are applied when it is given a source,
+        //and while it has none its playback time keeps moving, so it comes back in where it would be.
+    struct AL_voice {
+
+        ALuint      buffer;
+        ALuint      source;
+        ALint       state;
+        int         rate;
+        float       priority;
+        float       gain;
+        float       pitch;
+        float       position[3];
+        float       velocity[3];
+        float       direction[3];
+        float       rolloff;
+        float       reference_distance;
+        float       max_distance;
+        float       min_gain;
+        float       max_gain;
+        float       cone_inner;
+        float       cone_outer;
+        float       cone_outer_gain;
+        bool        relative;
+        bool        looping;
+            //seconds into the buffer, kept up to date by voices_update while virtual
+        double      offset;
+        double      duration;
+        float       score;
+
+    }; //AL_voice
+
+    class AL_voices {
+
+        public:
+
+                //every source the pool owns, and the ones not given to a voice
+            std::vector<ALuint>         sources;
+            std::vector<ALuint>         unused;
+            std::vector<AL_voice*>      voices;
+            std::vector<AL_voice*>      ranked;
+            std::chrono::steady_clock::time_point last;
+            bool                        started;
+                //voices that lost their source to a louder one, ever
+            int                         stolen;
+
+        AL_voices() : started(false), stolen(0) {}
+
+    }; //AL_voices
+
+    static AL_voices voices;
+
+        //where the voice keeps a float property, null for one it doesn't keep
+    static float* voice_float( AL_voice* voice, ALenum param ) {
+
+        switch(param) {
+            case AL_GAIN:                   return &voice->gain;
+            case AL_PITCH:                  return &voice->pitch;
+            case AL_ROLLOFF_FACTOR:         return &voice->rolloff;
+            case AL_REFERENCE_DISTANCE:     return &voice->reference_distance;
+            case AL_MAX_DISTANCE:           return &voice->max_distance;
+            case AL_MIN_GAIN:               return &voice->min_gain;
+            case AL_MAX_GAIN:               return &voice->max_gain;
+            case AL_CONE_INNER_ANGLE:       return &voice->cone_inner;
+            case AL_CONE_OUTER_ANGLE:       return &voice->cone_outer;
+            case AL_CONE_OUTER_GAIN:        return &voice->cone_outer_gain;
+        }
+
+        return 0;
+
+    } //voice_float
+
+        //where the voice keeps a vector property, null for one it doesn't keep
+    static float* voice_float3( AL_voice* voice, ALenum param ) {
+
+        switch(param) {
+            case AL_POSITION:               return voice->position;
+            case AL_VELOCITY:               return voice->velocity;
+            case AL_DIRECTION:              return voice->direction;
+        }
+
+        return 0;
+
+    } //voice_float3
+
+        //moves a source onto a voice, with everything the voice remembers about itself
+    static void voice_bind( AL_voice* voice, ALuint source ) {
+
+        voice->source = source;
+
+        static const ALenum floats[] = {
+            AL_GAIN, AL_PITCH, AL_ROLLOFF_FACTOR, AL_REFERENCE_DISTANCE, AL_MAX_DISTANCE,
+            AL_MIN_GAIN, AL_MAX_GAIN, AL_CONE_INNER_ANGLE, AL_CONE_OUTER_ANGLE, AL_CONE_OUTER_GAIN
+        };
+
+        static const ALenum vectors[] = { AL_POSITION, AL_VELOCITY, AL_DIRECTION };
+
+        alSourcei( source, AL_BUFFER, voice->buffer );
+
+            //every property is set, so nothing the last voice on this source set is left behind
+        for(size_t i = 0; i < sizeof(floats) / sizeof(floats[0]); ++i) {
+            alSourcef( source, floats[i], *voice_float(voice, floats[i]) );
+        }
+
+        for(size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); ++i) {
+            alSourcefv( source, vectors[i], voice_float3(voice, vectors[i]) );
+        }
+
+        alSourcei( source, AL_SOURCE_RELATIVE, voice->relative ? AL_TRUE : AL_FALSE );
+        alSourcei( source, AL_LOOPING, voice->looping ? AL_TRUE : AL_FALSE );
+        alSourcef( source, AL_SEC_OFFSET, (ALfloat)voice->offset );
+
+        if(voice->state == AL_PLAYING) {
+            alSourcePlay( source );
+        }
+
+    } //voice_bind
+
+        //takes the source back from a voice, which carries on virtually from where the source was
+    static void voice_release( AL_voice* voice ) {
+
+        if(!voice->source) {
+            return;
+        }
+
+        ALfloat _offset = 0;
+        alGetSourcef( voice->source, AL_SEC_OFFSET, &_offset );
+
+        if(voice->state != AL_STOPPED) {
+            voice->offset = _offset;
+        }
+
+        alSourceStop( voice->source );
+        alSourcei( voice->source, AL_BUFFER, 0 );
+
+        voices.unused.push_back( voice->source );
+        voice->source = 0;
+
+    } //voice_release
+
+        //how loud the voice would be at the listener, by its gain and distances in the default inverse distance clamped model
+    static float voice_audibility( AL_voice* voice, const ALfloat* listener ) {
+
+        float _x = voice->position[0];
+        float _y = voice->position[1];
+        float _z = voice->position[2];
+
+        if(!voice->relative) {
+            _x -= listener[0];
+            _y -= listener[1];
+            _z -= listener[2];
+        }
+
+        float _distance = sqrtf(_x*_x + _y*_y + _z*_z);
+        float _reference = voice->reference_distance;
+
+        _distance = std::max(_reference, std::min(_distance, voice->max_distance));
+
+        float _falloff = _reference + voice->rolloff * (_distance - _reference);
+
+        if(_falloff <= 0.0f) {
+            return voice->gain;
+        }
+
+        return voice->gain * _reference / _falloff;
+
+    } //voice_audibility
+
+    static bool voice_ranks_above( const AL_voice* a, const AL_voice* b ) {
+        return a->score > b->score;
+    }
+
+        //creates up to _count sources for the voices to share, leaving ALHX_VOICE_RESERVE of the device
+        //sources free for everything else. Where the device doesn't say how many it has, the pool is made
+        //until it runs out and the reserve handed back after. returns the number of sources the pool ended up with
+    value alhx_VoicesInit(value _count) {
+
+        int count = val_int(_count);
+
+        ALCint _device_sources = 0;
+        ALCdevice* _device = alcGetContextsDevice( alcGetCurrentContext() );
+
+        if(_device) {
+            alcGetIntegerv( _device, ALC_MONO_SOURCES, 1, &_device_sources );
+        }
+
+        if(_device_sources > 0) {
+            count = std::min(count, std::max(0, (int)_device_sources - ALHX_VOICE_RESERVE));
+        }
+
+        alGetError();
+
+        bool _ran_out = false;
+
+        while((int)voices.sources.size() < count) {
+
+            ALuint source = 0;
+            gen_sources(1, &source);
+
+            if(alGetError() != AL_NO_ERROR || !source) {
+                _ran_out = true;
+                break;
+            }
+
+            voices.sources.push_back(source);
+            voices.unused.push_back(source);
+
+        } //while
+
+        if(_ran_out) {
+
+            int _reserve = std::min(ALHX_VOICE_RESERVE, (int)voices.sources.size());
+
+            for(int i = 0; i < _reserve; ++i) {
+                ALuint _source = voices.sources.back();
+                voices.sources.pop_back();
+                voices.unused.erase(std::find(voices.unused.begin(), voices.unused.end(), _source));
+                delete_sources(1, &_source);
+            }
+
+        } //_ran_out
+
+        snow::log(2, "/ alhx / voices have %d of %d requested sources", (int)voices.sources.size(), val_int(_count));
+
+        return alloc_int( (int)voices.sources.size() );
+
+    } DEFINE_PRIM(alhx_VoicesInit, 1);
+
+        //deletes the pool, once the voices are all destroyed
+    value alhx_VoicesDestroy() {
+
+        for(size_t i = 0; i < voices.voices.size(); ++i) {
+            voice_release(voices.voices[i]);
+        }
+
+        if(!voices.sources.empty()) {
+            delete_sources( (ALsizei)voices.sources.size(), voices.sources.data() );
+        }
+
+        voices.sources.clear();
+        voices.unused.clear();
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_VoicesDestroy, 0);
+
+        //Ranks every voice by priority × audibility and gives the pool's sources to the top of the list,
+        //taking them from the quietest voices first. Voices without one are moved on in time virtually.
+    value alhx_VoicesUpdate() {
+
+        std::chrono::steady_clock::time_point _now = std::chrono::steady_clock::now();
+
+        double _step = 0;
+        if(voices.started) {
+            _step = std::chrono::duration<double>(_now - voices.last).count();
+            if(_step > ALHX_VOICE_MAX_STEP) {
+                _step = ALHX_VOICE_MAX_STEP;
+            }
+        }
+
+        voices.last = _now;
+        voices.started = true;
+
+        ALfloat _listener[3] = { 0, 0, 0 };
+        alGetListener3f( AL_POSITION, &_listener[0], &_listener[1], &_listener[2] );
+
+        voices.ranked.clear();
+
+        for(size_t i = 0; i < voices.voices.size(); ++i) {
+
+            AL_voice* voice = voices.voices[i];
+
+            if(voice->source) {
+
+                    //a real voice that played out to the end
+                ALint _state = 0;
+                alGetSourcei( voice->source, AL_SOURCE_STATE, &_state );
+
+                if(voice->state == AL_PLAYING && _state == AL_STOPPED) {
+                    voice->state = AL_STOPPED;
+                    voice->offset = 0;
+                }
+
+            } else if(voice->state == AL_PLAYING) {
+
+                voice->offset += _step * voice->pitch;
+
+                if(voice->offset >= voice->duration) {
+                    if(voice->looping && voice->duration > 0) {
+                        voice->offset = fmod(voice->offset, voice->duration);
+                    } else {
+                        voice->state = AL_STOPPED;
+                        voice->offset = 0;
+                    }
+                }
+
+            } //virtual
+
+            if(voice->state != AL_PLAYING) {
+                voice_release(voice);
+                continue;
+            }
+
+            voice->score = voice->priority * voice_audibility(voice, _listener);
+
+            if(voice->source) {
+                voice->score *= ALHX_VOICE_KEEP;
+            }
+
+                //silent voices never need a source
+            if(voice->score > 0) {
+                voices.ranked.push_back(voice);
+            } else {
+                voice_release(voice);
+            }
+
+        } //each voice
+
+        std::sort(voices.ranked.begin(), voices.ranked.end(), voice_ranks_above);
+
+        size_t _real = voices.sources.size();
+
+            //the quietest give their sources up first
+        for(size_t i = _real; i < voices.ranked.size(); ++i) {
+            if(voices.ranked[i]->source) {
+                voice_release(voices.ranked[i]);
+                voices.stolen++;
+            }
+        }
+
+        for(size_t i = 0; i < _real && i < voices.ranked.size(); ++i) {
+
+            AL_voice* voice = voices.ranked[i];
+
+            if(!voice->source && !voices.unused.empty()) {
+                ALuint _source = voices.unused.back();
+                voices.unused.pop_back();
+                voice_bind(voice, _source);
+            }
+
+        } //each real
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_VoicesUpdate, 0);
+
+        //returns [sources, real, virtual, stolen], real and virtual counting the voices that are playing
+    value alhx_VoicesStats() {
+
+        int _real = 0;
+        int _virtual = 0;
+
+        for(size_t i = 0; i < voices.voices.size(); ++i) {
+
+            AL_voice* voice = voices.voices[i];
+
+            if(voice->state != AL_PLAYING) {
+                continue;
+            }
+
+            if(voice->source) {
+                _real++;
+            } else {
+                _virtual++;
+            }
+
+        } //each voice
+
+        value result = alloc_array(4);
+
+        val_array_set_i(result, 0, alloc_int( (int)voices.sources.size() ));
+        val_array_set_i(result, 1, alloc_int( _real ));
+        val_array_set_i(result, 2, alloc_int( _virtual ));
+        val_array_set_i(result, 3, alloc_int( voices.stolen ));
+
+        return result;
+
+    } DEFINE_PRIM(alhx_VoicesStats, 0);
+
+        //a voice playing _buffer, which lasts _duration seconds
+    value alhx_VoiceCreate(value _buffer, value _duration) {
+
+        AL_voice* voice = new AL_voice();
+
+        voice->buffer = val_int(_buffer);
+        voice->source = 0;
+        voice->state = AL_INITIAL;
+        voice->rate = 0;
+        voice->priority = 1.0f;
+        voice->gain = 1.0f;
+        voice->pitch = 1.0f;
+        voice->position[0] = voice->position[1] = voice->position[2] = 0.0f;
+        voice->velocity[0] = voice->velocity[1] = voice->velocity[2] = 0.0f;
+        voice->direction[0] = voice->direction[1] = voice->direction[2] = 0.0f;
+        voice->rolloff = 1.0f;
+        voice->reference_distance = 1.0f;
+        voice->max_distance = FLT_MAX;
+        voice->min_gain = 0.0f;
+        voice->max_gain = 1.0f;
+        voice->cone_inner = 360.0f;
+        voice->cone_outer = 360.0f;
+        voice->cone_outer_gain = 0.0f;
+        voice->relative = false;
+        voice->looping = false;
+        voice->offset = 0;
+        voice->duration = val_float(_duration);
+        voice->score = 0;
+
+        ALint _rate = 0;
+        alGetBufferi( voice->buffer, AL_FREQUENCY, &_rate );
+        voice->rate = _rate;
+
+        voices.voices.push_back(voice);
+
+        return snow::to_hx<AL_voice>( voice );
+
+    } DEFINE_PRIM(alhx_VoiceCreate, 2);
+
+    value alhx_VoiceDestroy(value _voice) {
+
+        AL_voice* voice = snow::from_hx<AL_voice>(_voice);
+
+        if(voice) {
+
+            voice_release(voice);
+
+            for(size_t i = 0; i < voices.voices.size(); ++i) {
+                if(voices.voices[i] == voice) {
+                    voices.voices.erase(voices.voices.begin() + i);
+                    break;
+                }
+            }
+
+            delete voice;
+
+        } //voice
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_VoiceDestroy, 1);
+
+    value alhx_VoicePlay(value _voice) {
+
+        AL_voice* voice = snow::from_hx<AL_voice>(_voice);
+
+        if(voice) {
+
+            if(voice->state != AL_PAUSED) {
+                voice->offset = 0;
+            }
+
+            voice->state = AL_PLAYING;
+
+                //where a source is free, start straight away rather than at the next update
+            if(!voice->source && !voices.unused.empty()) {
+                ALuint _source = voices.unused.back();
+                voices.unused.pop_back();
+                voice_bind(voice, _source);
+            } else if(voice->source) {
+                alSourcePlay(voice->source);
+            }
+
+        } //voice
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_VoicePlay, 1);
+
+    value alhx_VoicePause(value _voice) {
+
+        AL_voice* voice = snow::from_hx<AL_voice>(_voice);
+
+        if(voice && voice->state == AL_PLAYING) {
+
+            voice->state = AL_PAUSED;
+
+            if(voice->source) {
+                alSourcePause(voice->source);
+            }
+
+        } //voice
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_VoicePause, 1);
+
+    value alhx_VoiceStop(value _voice) {
+
+        AL_voice* voice = snow::from_hx<AL_voice>(_voice);
+
+        if(voice) {
+
+            voice->state = AL_STOPPED;
+            voice_release(voice);
+            voice->offset = 0;
+
+        } //voice
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_VoiceStop, 1);
+
+        //AL_INITIAL, AL_PLAYING, AL_PAUSED or AL_STOPPED, whether the voice is real or not
+    value alhx_VoiceState(value _voice) {
+
+        AL_voice* voice = snow::from_hx<AL_voice>(_voice);
+
+        if(!voice) {
+            return alloc_int(AL_STOPPED);
+        }
+
+        if(voice->source && voice->state == AL_PLAYING) {
+
+            ALint _state = 0;
+            alGetSourcei( voice->source, AL_SOURCE_STATE, &_state );
+
+            if(_state == AL_STOPPED) {
+                voice->state = AL_STOPPED;
+                voice->offset = 0;
+            }
+
+        } //real
+
+        return alloc_int(voice->state);
+
+    } DEFINE_PRIM(alhx_VoiceState, 1);
+
+        //sets a float property like alSourcef. The voice keeps its properties while virtual and sets them all
+        //on the source it's given, so one it doesn't keep is refused, rather than left on the source for the next voice.
+        //a "priority" is not an AL property, and is set with alhx_VoicePriority
+    value alhx_VoiceSourcef(value _voice, value _param, value _value) {
+
+        AL_voice* voice = snow::from_hx<AL_voice>(_voice);
+
+        if(!voice) {
+            return alloc_null();
+        }
+
+        ALenum param = val_int(_param);
+        ALfloat the_value = (ALfloat)val_float(_value);
+
+        float* _kept = voice_float(voice, param);
+
+        if(_kept) {
+            *_kept = the_value;
+        } else if(param == AL_SEC_OFFSET) {
+            voice->offset = the_value;
+        } else if(param == AL_SAMPLE_OFFSET) {
+            voice->offset = voice->rate > 0 ? the_value / voice->rate : 0;
+        } else {
+            snow::log(1, "/ alhx / voices don't keep the float property 0x%x, it was ignored", param);
+            return alloc_null();
+        }
+
+        if(voice->source) {
+            alSourcef( voice->source, param, the_value );
+        }
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_VoiceSourcef, 3);
+
+        //sets a vector property like alSource3f, AL_POSITION, AL_VELOCITY or AL_DIRECTION
+    value alhx_VoiceSource3f(value _voice, value _param, value _value1, value _value2, value _value3) {
+
+        AL_voice* voice = snow::from_hx<AL_voice>(_voice);
+
+        if(!voice) {
+            return alloc_null();
+        }
+
+        ALenum param = val_int(_param);
+        float* _kept = voice_float3(voice, param);
+
+        if(!_kept) {
+            snow::log(1, "/ alhx / voices don't keep the vector property 0x%x, it was ignored", param);
+            return alloc_null();
+        }
+
+        _kept[0] = (float)val_float(_value1);
+        _kept[1] = (float)val_float(_value2);
+        _kept[2] = (float)val_float(_value3);
+
+        if(voice->source) {
+            alSourcefv( voice->source, param, _kept );
+        }
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_VoiceSource3f, 5);
+
+        //sets AL_LOOPING or AL_SOURCE_RELATIVE, or one of the float properties as an int like alSourcei.
+        //the buffer belongs to the voice, and isn't set this way
+    value alhx_VoiceSourcei(value _voice, value _param, value _value) {
+
+        AL_voice* voice = snow::from_hx<AL_voice>(_voice);
+
+        if(!voice) {
+            return alloc_null();
+        }
+
+        ALenum param = val_int(_param);
+        ALint the_value = val_int(_value);
+
+        float* _kept = voice_float(voice, param);
+
+        if(_kept) {
+            *_kept = (float)the_value;
+        } else if(param == AL_LOOPING) {
+            voice->looping = the_value == AL_TRUE;
+        } else if(param == AL_SOURCE_RELATIVE) {
+            voice->relative = the_value == AL_TRUE;
+        } else {
+            snow::log(1, "/ alhx / voices don't keep the int property 0x%x, it was ignored", param);
+            return alloc_null();
+        }
+
+        if(voice->source) {
+            alSourcei( voice->source, param, the_value );
+        }
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_VoiceSourcei, 3);
+
+        //AL_SEC_OFFSET or AL_SAMPLE_OFFSET, from the source when real and the tracked time otherwise
+    value alhx_VoiceGetSourcef(value _voice, value _param) {
+
+        AL_voice* voice = snow::from_hx<AL_voice>(_voice);
+
+        if(!voice) {
+            return alloc_float(0);
+        }
+
+        ALenum param = val_int(_param);
+
+        if(voice->source) {
+            ALfloat the_value = 0;
+            alGetSourcef( voice->source, param, &the_value );
+            return alloc_float(the_value);
+        }
+
+        float* _kept = voice_float(voice, param);
+
+        if(_kept) {
+            return alloc_float( *_kept );
+        }
+
+        switch(param) {
+            case AL_SEC_OFFSET:     return alloc_float( voice->offset );
+            case AL_SAMPLE_OFFSET:  return alloc_float( voice->offset * voice->rate );
+        }
+
+        return alloc_float(0);
+
+    } DEFINE_PRIM(alhx_VoiceGetSourcef, 2);
+
+        //how much the voice matters against others at the same audibility, 1 by default
+    value alhx_VoicePriority(value _voice, value _priority) {
+
+        AL_voice* voice = snow::from_hx<AL_voice>(_voice);
+
+        if(voice) {
+            voice->priority = (float)val_float(_priority);
+        }
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_VoicePriority, 2);
+
+// --- >
+
+// --- > native streaming, not official api
+// --- > added so a stream doesn't depend on the main thread frame rate
+
+        //what alhx_StreamEvents reports, cleared once read
+    #define ALHX_STREAM_ENDED       1
+    #define ALHX_STREAM_LOOPED      2
+        //how often the stream thread looks at the queues in ms,
+        //far below the length of a buffer so a late pass never underruns
+    #define ALHX_STREAM_INTERVAL    5
+
+        //a buffer in a stream queue, and the byte of the pcm data it starts at,
+        //so the playback position can be worked out from the front of the queue
+    struct AL_stream_block {
+        ALuint  buffer;
+        long    start;
+            //the first buffer after the data looped back to the start
+        bool    wrapped;
+    };
+
+        //A streamed source whose queue is kept full by the stream thread, rather than from haxe
+        //every frame, so a hitch on the main thread (a gc pause, a loading spike) can't starve it.
+        //Other than the events, a stream is only touched while holding the streamer lock.
+        //The audio source is read by the thread with the lock released while busy is set,
+        //so anything else that moves the audio source has to wait for busy to clear.
+    class AL_stream {
+
+        public:
+            ALuint                          source;
+            ALenum                          format;
+            int                             rate;
+            int                             audio_format;
+            void*                           audio_source;
+            long                            frame_bytes;
+            long                            length_pcm;
+                //the byte of the pcm data the next read starts at
+            long                            read_position;
+            std::vector<unsigned char>      chunk;
+            std::deque<AL_stream_block>     queued;
+            std::vector<ALuint>             unqueued;
+            bool                            playing;
+            bool                            looping;
+                //the data ran out without looping, only the queue is left to play
+            bool                            drained;
+                //the next buffer queued is the start of the loop again
+            bool                            wrap_next;
+                //the loop region in bytes, a loop_end of 0 being the end of the data
+            long                            loop_start;
+            long                            loop_end;
+                //the first bytes of the loop region, decoded ahead so that wrapping is a copy within one fill
+            std::vector<unsigned char>      loop_head;
+                //the loop region moved, the head is decoded again before it is used
+            bool                            loop_head_dirty;
+            bool                            busy;
+                //the source has been started since it was last flushed, so stopping on its own is an underrun
+            bool                            started;
+            std::atomic<int>                events;
+
+                //instrumentation, see alhx_StreamCounters. the queue depth is sampled each service while playing,
+                //the min and the sums over a window that a reset starts again
+            long long                       underruns;
+            long long                       decodes;
+            long long                       decode_ns;
+            long long                       decode_ns_max;
+            long long                       queue_min;
+            long long                       queue_sum;
+            long long                       queue_samples;
+
+        AL_stream() :
+            source(0), format(0), rate(0), audio_format(0), audio_source(NULL),
+            frame_bytes(1), length_pcm(0), read_position(0),
+            playing(false), looping(false), drained(false), wrap_next(false),
+            loop_start(0), loop_end(0), loop_head_dirty(true), busy(false), started(false), events(0),
+            underruns(0), decodes(0), decode_ns(0), decode_ns_max(0), queue_min(-1), queue_sum(0), queue_samples(0)
+                { }
+
+    }; //AL_stream
+
+        //reads up to len bytes of the stream data into dest, returning true once the end was reached
+    static bool stream_read( AL_stream* stream, unsigned char* dest, long len, long &bytes_read ) {
+
+        bytes_read = 0;
+
+        switch(stream->audio_format) {
+
+            case 1: //ogg
+                return snow::assets::audio::read_bytes_ogg_into( (snow::assets::audio::OGG_file_source*)stream->audio_source, dest, -1, len, bytes_read );
+            case 2: //wav
+                return snow::assets::audio::read_bytes_wav_into( (snow::assets::audio::WAV_file_source*)stream->audio_source, dest, -1, len, bytes_read );
+            case 3: //pcm
+                return snow::assets::audio::read_bytes_pcm_into( (snow::assets::audio::PCM_file_source*)stream->audio_source, dest, -1, len, bytes_read );
+            case 4: //adpcm
+                return snow::assets::audio::read_bytes_adpcm_into( (snow::assets::audio::ADPCM_file_source*)stream->audio_source, dest, -1, len, bytes_read );
+
+        } //switch audio_format
+
+        return true;
+
+    } //stream_read
+
+        //moves the audio source only, see stream_seek
+    static void stream_seek_source( AL_stream* stream, long to ) {
+
+        switch(stream->audio_format) {
+
+            case 1: //ogg
+                snow::assets::audio::seek_bytes_ogg( (snow::assets::audio::OGG_file_source*)stream->audio_source, to );
+                break;
+            case 2: //wav
+                snow::assets::audio::seek_bytes_wav( (snow::assets::audio::WAV_file_source*)stream->audio_source, to );
+                break;
+            case 3: //pcm
+                snow::assets::audio::seek_bytes_pcm( (snow::assets::audio::PCM_file_source*)stream->audio_source, to );
+                break;
+            case 4: //adpcm
+                snow::assets::audio::seek_bytes_adpcm( (snow::assets::audio::ADPCM_file_source*)stream->audio_source, to );
+                break;
+
+        } //switch audio_format
+
+    } //stream_seek_source
+
+    static void stream_seek( AL_stream* stream, long to ) {
+
+        stream_seek_source(stream, to);
+
+        stream->read_position = to;
+
+    } //stream_seek
+
+    static long stream_loop_end( AL_stream* stream ) {
+
+        if(stream->loop_end > 0 && stream->loop_end < stream->length_pcm) {
+            return stream->loop_end;
+        }
+
+        return stream->length_pcm;
+
+    } //stream_loop_end
+
+        //decodes the head of the loop region into loop_head, leaving the audio source at resume.
+        //only called by the stream thread, with busy set
+    static void stream_decode_head( AL_stream* stream, long start, long end, long resume ) {
+
+        long _len = std::min( (long)stream->chunk.size(), end - start );
+        long _bytes_read = 0;
+
+        stream->loop_head.resize( _len > 0 ? _len : 0 );
+
+        if(_len > 0) {
+            stream_seek_source(stream, start);
+            stream_read(stream, stream->loop_head.data(), _len, _bytes_read);
+            stream_seek_source(stream, resume);
+        }
+
+        stream->loop_head.resize(_bytes_read);
+
+    } //stream_decode_head
+
+        //stops the source and takes back every buffer it had queued
+    static void stream_flush( AL_stream* stream ) {
+
+        alSourceStop(stream->source);
+
+        while(!stream->queued.empty()) {
+
+            ALuint _buffer = 0;
+            alSourceUnqueueBuffers(stream->source, 1, &_buffer);
+
+            stream->unqueued.push_back(stream->queued.front().buffer);
+            stream->queued.pop_front();
+
+        } //each queued
+
+        stream->wrap_next = false;
+        stream->started = false;
+
+    } //stream_flush
+
+        //(re)starts the source if it should be playing, after starting or running dry
+    static void stream_kick( AL_stream* stream ) {
+
+        if(!stream->playing || stream->queued.empty()) {
+            return;
+        }
+
+        ALint _state = 0;
+        alGetSourcei(stream->source, AL_SOURCE_STATE, &_state);
+
+        if(_state != AL_PLAYING) {
+
+                //it stopped by itself with more to play, the refill was too late
+            if(_state == AL_STOPPED && stream->started) {
+                stream->underruns++;
+                counters.underruns++;
+            }
+
+            alSourcePlay(stream->source);
+            stream->started = true;
+
+        } //_state
+
+    } //stream_kick
+
+        //The thread that owns the buffer queues of the native streams.
+        //AL calls are made from it against the current context, which openal holds process wide.
+    class AL_streamer {
+
+        public:
+
+            std::mutex                      lock;
+            std::condition_variable         wake_cond;
+            std::condition_variable         idle_cond;
+            std::vector<AL_stream*>         streams;
+            std::thread                     thread;
+            bool                            running;
+
+        AL_streamer() : running(false) {}
+
+        ~AL_streamer() {
+
+            {
+                std::unique_lock<std::mutex> _guard(lock);
+                running = false;
+            }
+
+            wake_cond.notify_all();
+
+            if(thread.joinable()) {
+                thread.join();
+            }
+
+        } //~
+
+            //must be called with the lock held
+        void add( AL_stream* stream ) {
+
+            if(!running) {
+                running = true;
+                thread = std::thread(&AL_streamer::run, this);
+                snow::log(2, "/ alhx / started the stream thread");
+            }
+
+            streams.push_back(stream);
+            wake_cond.notify_one();
+
+        } //add
+
+            //must be called with the lock held, waits until the thread isn't reading the stream
+        void wait_idle( std::unique_lock<std::mutex> &_guard, AL_stream* stream ) {
+
+            while(stream->busy) {
+                idle_cond.wait(_guard);
+            }
+
+        } //wait_idle
+
+            //must be called with the lock held, and waited idle
+        void remove( AL_stream* stream ) {
+
+            for(size_t i = 0; i < streams.size(); ++i) {
+                if(streams[i] == stream) {
+                    streams.erase(streams.begin() + i);
+                    break;
+                }
+            }
+
+        } //remove
+
+        private:
+
+                //unqueue what was played, refill and requeue it, and notice the end of the data
+            void service( std::unique_lock<std::mutex> &_guard, AL_stream* stream ) {
+
+                ALint _processed = 0;
+                alGetSourcei(stream->source, AL_BUFFERS_PROCESSED, &_processed);
+
+                while(_processed > 0 && !stream->queued.empty()) {
+
+                    ALuint _buffer = 0;
+                    alSourceUnqueueBuffers(stream->source, 1, &_buffer);
+
+                    stream->unqueued.push_back(stream->queued.front().buffer);
+                    stream->queued.pop_front();
+
+                    if(!stream->queued.empty() && stream->queued.front().wrapped) {
+                        stream->queued.front().wrapped = false;
+                        stream->events.fetch_or(ALHX_STREAM_LOOPED);
+                    }
+
+                    --_processed;
+
+                } //each processed
+
+                if(stream->playing) {
+
+                    long long _depth = (long long)stream->queued.size();
+
+                    if(stream->queue_min < 0 || _depth < stream->queue_min) {
+                        stream->queue_min = _depth;
+                    }
+
+                    stream->queue_sum += _depth;
+                    stream->queue_samples++;
+
+                } //playing
+
+                    //a looping stream decodes the head of its loop once, ahead of time,
+                    //so the wrap is filled from memory instead of waiting on a seek
+                if(stream->looping && stream->loop_head_dirty) {
+
+                    long _head_start = stream->loop_start;
+                    long _head_end = stream_loop_end(stream);
+                    long _resume = stream->read_position;
+
+                    stream->loop_head_dirty = false;
+                    stream->busy = true;
+                    _guard.unlock();
+
+                        stream_decode_head(stream, _head_start, _head_end, _resume);
+
+                    _guard.lock();
+                    stream->busy = false;
+                    idle_cond.notify_all();
+
+                } //loop_head_dirty
+
+                    //paused and stopped streams are refilled too,
+                    //so that playing them again starts straight away
+                while(!stream->drained && !stream->unqueued.empty()) {
+
+                    long _start = stream->read_position;
+                    long _loop_end = stream_loop_end(stream);
+                    long _len = (long)stream->chunk.size();
+                    long _bytes_read = 0;
+                    bool _complete = false;
+
+                        //with the head ready, reading stops at the loop end and the head fills the rest
+                    bool _seamless = stream->looping && !stream->loop_head_dirty && !stream->loop_head.empty();
+                    if(_seamless) {
+                        _len = std::min(_len, std::max(0L, _loop_end - _start));
+                    }
+
+                    stream->busy = true;
+                    _guard.unlock();
+
+                        std::chrono::steady_clock::time_point _read_start = std::chrono::steady_clock::now();
+
+                            if(_len > 0) {
+                                _complete = stream_read(stream, stream->chunk.data(), _len, _bytes_read);
+                            }
+
+                        long long _read_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _read_start).count();
+
+                    _guard.lock();
+                    stream->busy = false;
+                    idle_cond.notify_all();
+
+                    stream->decodes++;
+                    stream->decode_ns += _read_ns;
+                    stream->decode_ns_max = std::max(stream->decode_ns_max, _read_ns);
+
+                    long _head = 0;
+                    bool _seam = _seamless && (_complete || _start + _bytes_read >= _loop_end);
+
+                    if(_seam) {
+                        _head = std::min( (long)stream->chunk.size() - _bytes_read, (long)stream->loop_head.size() );
+                        memcpy(stream->chunk.data() + _bytes_read, stream->loop_head.data(), _head);
+                    }
+
+                    if(_bytes_read + _head > 0) {
+
+                        ALuint _buffer = stream->unqueued.back();
+                        stream->unqueued.pop_back();
+
+                        buffer_data(_buffer, stream->format, stream->chunk.data(), (ALsizei)(_bytes_read + _head), stream->rate);
+                        alSourceQueueBuffers(stream->source, 1, &_buffer);
+
+                        AL_stream_block _block = { _buffer, _start, stream->wrap_next };
+                        stream->queued.push_back(_block);
+
+                        stream->read_position += _bytes_read;
+                        stream->wrap_next = false;
+
+                    } //_bytes_read + _head
+
+                        //nothing came back yet more is to come, the data isn't there yet.
+                        //it counts as an underrun, and the stream waits for the next pass instead of spinning
+                    if(_bytes_read + _head == 0 && !_complete && !_seam) {
+                        stream->underruns++;
+                        counters.underruns++;
+                        break;
+                    }
+
+                    if(_seam) {
+
+                            //the seam is queued, the decoder carries on from after the head
+                        stream_seek(stream, stream->loop_start + _head);
+                        stream->wrap_next = true;
+
+                    } else if(_complete) {
+
+                            //an empty source would loop forever without reading anything
+                        if(stream->looping && (_bytes_read > 0 || _start > stream->loop_start)) {
+                            stream_seek(stream, stream->loop_start);
+                            stream->wrap_next = true;
+                        } else {
+                            stream->drained = true;
+                        }
+
+                    } //_complete
+
+                        //begin playing as soon as there is anything queued
+                    stream_kick(stream);
+
+                } //refill
+
+                if(stream->playing && stream->drained && stream->queued.empty()) {
+                    stream->playing = false;
+                    stream->started = false;
+                    stream->events.fetch_or(ALHX_STREAM_ENDED);
+                    return;
+                }
+
+                    //if the queue ran dry before it could be refilled, the source stopped
+                stream_kick(stream);
+
+            } //service
+
+            void run() {
+
+                std::unique_lock<std::mutex> _guard(lock);
+
+                while(running) {
+
+                        //streams may be removed while one is being read,
+                        //which at worst skips one until the next pass
+                    for(size_t i = 0; i < streams.size(); ++i) {
+                        service(_guard, streams[i]);
+                    }
+
+                    wake_cond.wait_for(_guard, std::chrono::milliseconds(ALHX_STREAM_INTERVAL));
+
+                } //while running
+
+            } //run
+
+    }; //AL_streamer
+
+    static AL_streamer streamer;
+
+        //hands the source and buffers of a streamed sound to the stream thread.
+        //returns null if the audio info source can't be streamed natively
+    value alhx_StreamCreate(value _source, value _buffers, value _info, value _format, value _buffer_length) {
+
+        value _handle = snow::property_value(_info, snow::id_handle);
+
+        if(val_is_null(_handle)) {
+            return alloc_null();
+        }
+
+        AL_stream* stream = new AL_stream();
+
+        stream->audio_format = snow::property_int(_info, snow::id_format, 0);
+
+        int _channels = 0;
+        int _bytes = 0;
+
+        switch(stream->audio_format) {
+
+            case 1: { //ogg
+                snow::assets::audio::OGG_file_source* ogg_source = snow::from_hx<snow::assets::audio::OGG_file_source>(_handle);
+                if(ogg_source && ogg_source->info) {
+                    stream->audio_source = ogg_source;
+                    stream->rate = ogg_source->info->rate;
+                    stream->length_pcm = ogg_source->length_pcm;
+                    _channels = ogg_source->info->channels;
+                    _bytes = ogg_source->decode_float ? 4 : 2;
+                }
+                break;
+            }
+
+            case 2: { //wav
+                snow::assets::audio::WAV_file_source* wav_source = snow::from_hx<snow::assets::audio::WAV_file_source>(_handle);
+                if(wav_source) {
+                    stream->audio_source = wav_source;
+                    stream->rate = wav_source->rate;
+                    stream->length_pcm = wav_source->length_pcm;
+                    _channels = wav_source->channels;
+                    _bytes = wav_source->bits_per_sample / 8;
+                }
+                break;
+            }
+
+            case 3: { //pcm
+                snow::assets::audio::PCM_file_source* pcm_source = snow::from_hx<snow::assets::audio::PCM_file_source>(_handle);
+                if(pcm_source) {
+                    stream->audio_source = pcm_source;
+                    stream->rate = pcm_source->rate;
+                    stream->length_pcm = pcm_source->length_pcm;
+                    _channels = pcm_source->channels;
+                    _bytes = pcm_source->bits_per_sample / 8;
+                }
+                break;
+            }
+
+            case 4: { //adpcm
+                snow::assets::audio::ADPCM_file_source* adpcm_source = snow::from_hx<snow::assets::audio::ADPCM_file_source>(_handle);
+                if(adpcm_source) {
+                    stream->audio_source = adpcm_source;
+                    stream->rate = adpcm_source->rate;
+                    stream->length_pcm = adpcm_source->length_pcm;
+                    _channels = adpcm_source->channels;
+                    _bytes = adpcm_source->bits_per_sample / 8;
+                }
+                break;
+            }
+
+        } //switch format
+
+        if(!stream->audio_source || _channels <= 0 || _bytes <= 0) {
+            delete stream;
+            return alloc_null();
+        }
+
+        stream->source = val_int(_source);
+        stream->format = val_int(_format);
+        stream->frame_bytes = _channels * _bytes;
+
+            //whole frames only, so a buffer never splits a frame
+        long _length = val_int(_buffer_length);
+        _length -= _length % stream->frame_bytes;
+        if(_length < stream->frame_bytes) {
+            _length = stream->frame_bytes;
+        }
+
+        stream->chunk.resize(_length);
+
+            //oggs decode ahead on the pool workers into a ring, so a service of the stream thread is only a copy
+            //and streams aren't decoded one after the other on it. if the ring can't start, reads decode inline
+        if(stream->audio_format == 1) {
+            snow::assets::audio::stream_start_ogg( (snow::assets::audio::OGG_file_source*)stream->audio_source, _length * 2 );
+        }
+
+        int _count = val_array_size(_buffers);
+        for(int i = 0; i < _count; ++i) {
+            stream->unqueued.push_back( (ALuint)val_int(val_array_i(_buffers, i)) );
+        }
+
+        stream_seek(stream, 0);
+
+        {
+            std::unique_lock<std::mutex> _guard(streamer.lock);
+            streamer.add(stream);
+        }
+
+        return snow::to_hx<AL_stream>( stream );
+
+    } DEFINE_PRIM(alhx_StreamCreate, 5);
+
+    value alhx_StreamPlay(value _stream) {
+
+        AL_stream* stream = snow::from_hx<AL_stream>(_stream);
+
+        if(stream) {
+
+            std::unique_lock<std::mutex> _guard(streamer.lock);
+
+                //played again after it ended, from the start
+            if(stream->drained && stream->queued.empty()) {
+                stream_seek(stream, 0);
+                stream->drained = false;
+            }
+
+            stream->playing = true;
+            stream_kick(stream);
+
+            streamer.wake_cond.notify_one();
+
+        } //stream
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_StreamPlay, 1);
+
+    value alhx_StreamPause(value _stream) {
+
+        AL_stream* stream = snow::from_hx<AL_stream>(_stream);
+
+        if(stream) {
+
+            std::unique_lock<std::mutex> _guard(streamer.lock);
+
+                //the queue is kept, so playing again resumes without a gap
+            stream->playing = false;
+            alSourcePause(stream->source);
+
+        } //stream
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_StreamPause, 1);
+
+    value alhx_StreamStop(value _stream) {
+
+        AL_stream* stream = snow::from_hx<AL_stream>(_stream);
+
+        if(stream) {
+
+            std::unique_lock<std::mutex> _guard(streamer.lock);
+
+            streamer.wait_idle(_guard, stream);
+
+            stream->playing = false;
+            stream_flush(stream);
+            stream_seek(stream, 0);
+            stream->drained = false;
+
+            streamer.wake_cond.notify_one();
+
+        } //stream
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_StreamStop, 1);
+
+    value alhx_StreamSeek(value _stream, value _bytes) {
+
+        AL_stream* stream = snow::from_hx<AL_stream>(_stream);
+
+        if(stream) {
+
+            long _to = val_int(_bytes);
+
+            if(_to < 0) { _to = 0; }
+            if(_to > stream->length_pcm) { _to = stream->length_pcm; }
+
+            _to -= _to % stream->frame_bytes;
+
+            std::unique_lock<std::mutex> _guard(streamer.lock);
+
+            streamer.wait_idle(_guard, stream);
+
+                //the thread refills from the new position, and plays again if it was playing
+            stream_flush(stream);
+            stream_seek(stream, _to);
+            stream->drained = false;
+
+            streamer.wake_cond.notify_one();
+
+        } //stream
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_StreamSeek, 2);
+
+    value alhx_StreamLoop(value _stream, value _loop) {
+
+        AL_stream* stream = snow::from_hx<AL_stream>(_stream);
+
+        if(stream) {
+
+            std::unique_lock<std::mutex> _guard(streamer.lock);
+
+            stream->looping = val_bool(_loop);
+
+                //the data already ran out, carry on from the loop start after what is queued
+            if(stream->looping && stream->drained) {
+                stream_seek(stream, stream->loop_start);
+                stream->drained = false;
+                stream->wrap_next = !stream->queued.empty();
+                streamer.wake_cond.notify_one();
+            }
+
+        } //stream
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_StreamLoop, 2);
+
+        //the region a looping stream repeats, in bytes, where an end of 0 is the end of the data.
+        //the head of the loop is decoded ahead by the stream thread, so the wrap needs no seek
+    value alhx_StreamLoopPoints(value _stream, value _start, value _end) {
+
+        AL_stream* stream = snow::from_hx<AL_stream>(_stream);
+
+        if(stream) {
+
+            long _loop_start = val_int(_start);
+            long _loop_end = val_int(_end);
+
+            if(_loop_start < 0 || _loop_start >= stream->length_pcm) { _loop_start = 0; }
+            if(_loop_end <= _loop_start || _loop_end >= stream->length_pcm) { _loop_end = 0; }
+
+            _loop_start -= _loop_start % stream->frame_bytes;
+            _loop_end -= _loop_end % stream->frame_bytes;
+
+            std::unique_lock<std::mutex> _guard(streamer.lock);
+
+            stream->loop_start = _loop_start;
+            stream->loop_end = _loop_end;
+            stream->loop_head_dirty = true;
+
+            streamer.wake_cond.notify_one();
+
+        } //stream
+
+        return alloc_null();
 
-        value result = alloc_array(3);
+    } DEFINE_PRIM(alhx_StreamLoopPoints, 3);
 
-            val_array_set_i(result, 0, alloc_float( val1 ) );
-            val_array_set_i(result, 1, alloc_float( val2 ) );
-            val_array_set_i(result, 2, alloc_float( val3 ) );
+        //the playback position in bytes, from the buffer at the front of the queue
+    value alhx_StreamPosition(value _stream) {
 
-        return result;
+        AL_stream* stream = snow::from_hx<AL_stream>(_stream);
 
-    } DEFINE_PRIM(alhx_GetBuffer3f, 2);
+        if(!stream) {
+            return alloc_int(0);
+        }
 
-    value alhx_GetBufferfv(value _buffer, value _param, value _count) {
+        std::unique_lock<std::mutex> _guard(streamer.lock);
 
-        int count = val_int(_count);
-        ALfloat* vals = new ALfloat[count];
+        if(stream->queued.empty()) {
+            return alloc_int( stream->read_position );
+        }
 
-        alGetBufferfv( val_int(_buffer), val_int(_param), vals );
+        ALint _offset = 0;
+        alGetSourcei(stream->source, AL_SAMPLE_OFFSET, &_offset);
 
-        value result = alloc_array(count);
+        long _position = stream->queued.front().start + (long)_offset * stream->frame_bytes;
 
-        for( int i = 0; i < count; ++i ) {
-            val_array_set_i(result, i, alloc_float(vals[i]) );
+            //the offset runs on past the loop end when the queue holds the seam
+        long _loop_end = stream_loop_end(stream);
+        if(_loop_end > stream->loop_start && _position >= _loop_end) {
+            _position = stream->loop_start + (_position - _loop_end) % (_loop_end - stream->loop_start);
         }
 
-        return result;
+        return alloc_int( _position );
 
-    } DEFINE_PRIM(alhx_GetBufferfv, 3);
+    } DEFINE_PRIM(alhx_StreamPosition, 1);
 
-    value alhx_GetBufferi(value _buffer, value _param) {
+        //returns and clears the ALHX_STREAM_* flags raised since the last call
+    value alhx_StreamEvents(value _stream) {
 
-        int the_value;
+        AL_stream* stream = snow::from_hx<AL_stream>(_stream);
 
-        alGetBufferi( val_int(_buffer), val_int(_param), &the_value );
+        if(!stream) {
+            return alloc_int(0);
+        }
 
-        return alloc_int(the_value);
+        return alloc_int( stream->events.exchange(0) );
 
-    } DEFINE_PRIM(alhx_GetBufferi, 2);
+    } DEFINE_PRIM(alhx_StreamEvents, 1);
 
-    value alhx_GetBuffer3i(value _buffer, value _param) {
+        //takes the stream off the thread, the source and buffers are left for the caller to delete
+    value alhx_StreamDestroy(value _stream) {
 
-        ALint val1, val2, val3;
+        AL_stream* stream = snow::from_hx<AL_stream>(_stream);
 
-        alGetBuffer3i( val_int(_buffer), val_int(_param), &val1, &val2, &val3 );
+        if(stream) {
 
-        value result = alloc_array(3);
+            {
+                std::unique_lock<std::mutex> _guard(streamer.lock);
 
-            val_array_set_i(result, 0, alloc_int( val1 ) );
-            val_array_set_i(result, 1, alloc_int( val2 ) );
-            val_array_set_i(result, 2, alloc_int( val3 ) );
+                streamer.wait_idle(_guard, stream);
+                streamer.remove(stream);
+                stream_flush(stream);
+            }
 
-        return result;
+            delete stream;
 
-    } DEFINE_PRIM(alhx_GetBuffer3i, 2);
+        } //stream
 
-    value alhx_GetBufferiv(value _buffer, value _param, value _count) {
+        return alloc_null();
 
-        int count = val_int(_count);
-        ALint* vals = new ALint[count];
+    } DEFINE_PRIM(alhx_StreamDestroy, 1);
 
-        alGetBufferiv( val_int(_buffer), val_int(_param), vals );
+        //writes the counters of one stream into a Float64Array, in the order of AL.STREAM_COUNTER_*,
+        //returning how many were written. times are in milliseconds
+    value alhx_StreamCounters(value _stream, value _data, value _byteOffset, value _byteLength, value _reset) {
 
-        value result = alloc_array(count);
+        AL_stream* stream = snow::from_hx<AL_stream>(_stream);
 
-        for( int i = 0; i < count; ++i ) {
-            val_array_set_i(result, i, alloc_int(vals[i]) );
+        if(!stream) {
+            return alloc_int(0);
+        }
+
+        double _values[6];
+
+        {
+            std::unique_lock<std::mutex> _guard(streamer.lock);
+
+            _values[0] = (double)stream->underruns;
+            _values[1] = (double)stream->decodes;
+            _values[2] = stream->decode_ns / 1e6;
+            _values[3] = stream->decode_ns_max / 1e6;
+            _values[4] = (double)(stream->queue_min < 0 ? 0 : stream->queue_min);
+            _values[5] = stream->queue_samples > 0 ? (double)stream->queue_sum / stream->queue_samples : 0.0;
+
+            if(val_bool(_reset)) {
+                stream->decode_ns_max = 0;
+                stream->queue_min = -1;
+                stream->queue_sum = 0;
+                stream->queue_samples = 0;
+            }
+        }
+
+        return alloc_int( counters_write(_values, 6, _data, _byteOffset, _byteLength) );
+
+    } DEFINE_PRIM(alhx_StreamCounters, 5);
+
+        //a snapshot of the whole audio engine into a Float64Array, in the order of AL.COUNTER_*,
+        //returning how many were written. cheap enough to call every frame. with reset, the windowed
+        //values (the longest decode, the queue depths) start over after being read. times are in milliseconds
+    value alhx_AudioCounters(value _data, value _byteOffset, value _byteLength, value _reset) {
+
+        bool _reset_window = val_bool(_reset);
+
+        snow::assets::audio::Audio_decode_stats _decode = snow::assets::audio::decode_stats(_reset_window);
+        snow::assets::audio::Audio_cache_stats _cache = snow::assets::audio::cache_stats();
+
+        long long _queue_min = -1;
+        long long _queue_sum = 0;
+        long long _queue_samples = 0;
+        size_t _streams = 0;
+
+        {
+            std::unique_lock<std::mutex> _guard(streamer.lock);
+
+            _streams = streamer.streams.size();
+
+            for(size_t i = 0; i < _streams; ++i) {
+
+                AL_stream* stream = streamer.streams[i];
+
+                if(stream->queue_min >= 0 && (_queue_min < 0 || stream->queue_min < _queue_min)) {
+                    _queue_min = stream->queue_min;
+                }
+
+                _queue_sum += stream->queue_sum;
+                _queue_samples += stream->queue_samples;
+
+                if(_reset_window) {
+                    stream->queue_min = -1;
+                    stream->queue_sum = 0;
+                    stream->queue_samples = 0;
+                }
+
+            } //each stream
+        }
+
+        double _values[11];
+
+            _values[0] = (double)counters.sources.load();
+            _values[1] = (double)counters.buffers.load();
+            _values[2] = (double)counters.pcm_bytes.load();
+            _values[3] = (double)_cache.bytes;
+            _values[4] = (double)_streams;
+            _values[5] = (double)counters.underruns.load();
+            _values[6] = (double)_decode.calls;
+            _values[7] = _decode.ns / 1e6;
+            _values[8] = _decode.ns_max / 1e6;
+            _values[9] = (double)(_queue_min < 0 ? 0 : _queue_min);
+            _values[10] = _queue_samples > 0 ? (double)_queue_sum / _queue_samples : 0.0;
+
+        return alloc_int( counters_write(_values, 11, _data, _byteOffset, _byteLength) );
+
+    } DEFINE_PRIM(alhx_AudioCounters, 4);
+
+// --- >
+
+// --- > software mixer, not official api
+// --- > added so many short overlapping sounds cost one source between them
+
+        //frames in one mixed block, and the blocks queued on the output source.
+        //at 44.1khz that is about 11ms a block, and 46ms from a voice starting to it being heard
+    #define ALHX_MIXER_FRAMES       512
+    #define ALHX_MIXER_BUFFERS      4
+        //how often the mixer thread looks at the output queue in ms, well under a block
+    #define ALHX_MIXER_INTERVAL     3
+
+        //a playing voice as it was when a block started, and the voice it was copied from
+    struct AL_mix_snapshot {
+        snow::audio::Mix_voice* voice;
+        double                  position;
+        int                     state;
+    };
+
+        //Mixes the light voices of snow::audio::Mixer on its own thread,
+        //into blocks of stereo 16 bit queued on the one source it plays through.
+        //The voices are only touched with the lock held. A block copies the playing voices under it,
+        //mixes the copies with it released, and then takes it again to write back where each got to,
+        //unless the voice was stopped, played or moved in the meantime, in which case that wins.
+        //Voices destroyed while a block mixes are kept until it is done, so none is freed under it.
+    class AL_mixer {
+
+        public:
+
+            std::mutex                      lock;
+            std::condition_variable         wake_cond;
+            std::thread                     thread;
+            bool                            running;
+            snow::audio::Mixer*             mixer;
+                //mixes the copies, only touched by whichever thread is filling
+            snow::audio::Mixer*             work_mixer;
+            std::vector<snow::audio::Mix_voice> work;
+            std::vector<AL_mix_snapshot>    work_from;
+                //a block is being mixed with the lock released
+            bool                            mixing;
+            std::vector<snow::audio::Mix_voice*> retired;
+            ALuint                          source;
+            ALuint                          buffers[ALHX_MIXER_BUFFERS];
+            std::vector<float>              block;
+            std::vector<short>              output;
+                //times the output ran dry before the thread refilled it, ever
+            int                             underruns;
+                //the voices mixed into the last block, and the time it took against the time it plays for
+            int                             mixed;
+            float                           load;
+
+        AL_mixer() : running(false), mixer(0), work_mixer(0), mixing(false), source(0), underruns(0), mixed(0), load(0) {}
+
+        ~AL_mixer() {
+
+            stop();
+
+        } //~
+
+            //the source and buffers are made here, on the calling thread with the context current
+        bool start( int rate ) {
+
+            if(mixer) {
+                return true;
+            }
+
+            alGetError();
+
+            gen_sources(1, &source);
+            gen_buffers(ALHX_MIXER_BUFFERS, buffers);
+
+            if(alGetError() != AL_NO_ERROR) {
+                snow::log(1, "/ alhx / mixer / could not create the output source");
+                return false;
+            }
+
+                //the output is already placed, it plays as it is
+            alSourcei(source, AL_SOURCE_RELATIVE, AL_TRUE);
+            alSource3f(source, AL_POSITION, 0.0f, 0.0f, 0.0f);
+            alSourcef(source, AL_ROLLOFF_FACTOR, 0.0f);
+
+            mixer = new snow::audio::Mixer(rate);
+            work_mixer = new snow::audio::Mixer(rate);
+            block.resize(ALHX_MIXER_FRAMES * 2);
+            output.resize(ALHX_MIXER_FRAMES * 2);
+
+            {
+                std::unique_lock<std::mutex> _guard(lock);
+                for(int i = 0; i < ALHX_MIXER_BUFFERS; ++i) {
+                    fill(buffers[i], _guard);
+                }
+            }
+
+            alSourceQueueBuffers(source, ALHX_MIXER_BUFFERS, buffers);
+            alSourcePlay(source);
+
+            running = true;
+            thread = std::thread(&AL_mixer::run, this);
+
+            snow::log(2, "/ alhx / mixer / started at %dhz, %d frame blocks", rate, ALHX_MIXER_FRAMES);
+
+            return true;
+
+        } //start
+
+            //the voices are left to their owners, who destroy them after
+        void stop() {
+
+            {
+                std::unique_lock<std::mutex> _guard(lock);
+                running = false;
+            }
+
+            wake_cond.notify_all();
+
+            if(thread.joinable()) {
+                thread.join();
+            }
+
+        } //stop
+
+            //stopped first, with the context still current
+        void destroy() {
+
+            stop();
+
+            if(!mixer) {
+                return;
+            }
+
+            for(size_t i = 0; i < mixer->voices.size(); ++i) {
+                mixer->voices[i]->state = snow::audio::mix_stopped;
+            }
+
+            alSourceStop(source);
+            alSourcei(source, AL_BUFFER, 0);
+            delete_sources(1, &source);
+            delete_buffers(ALHX_MIXER_BUFFERS, buffers);
+
+            delete mixer;
+            delete work_mixer;
+            mixer = 0;
+            work_mixer = 0;
+            source = 0;
+
+        } //destroy
+
+        private:
+
+                //called with the lock held, which is released while mixing and held again on return
+            void fill( ALuint buffer, std::unique_lock<std::mutex> &_guard ) {
+
+                work.clear();
+                work_from.clear();
+
+                for(size_t i = 0; i < mixer->voices.size(); ++i) {
+
+                    snow::audio::Mix_voice* voice = mixer->voices[i];
+
+                    if(voice->state != snow::audio::mix_playing) continue;
+
+                    AL_mix_snapshot _from = { voice, voice->position, voice->state };
+
+                    work.push_back(*voice);
+                    work_from.push_back(_from);
+
+                } //each voice
+
+                mixing = true;
+                _guard.unlock();
+
+                    //the copies are in place now, so pointing at them is safe
+                work_mixer->voices.clear();
+                for(size_t i = 0; i < work.size(); ++i) {
+                    work_mixer->voices.push_back(&work[i]);
+                }
+
+                auto _start = std::chrono::steady_clock::now();
+
+                    int _mixed = work_mixer->mix(block.data(), ALHX_MIXER_FRAMES);
+                    snow::audio::f32_to_s16(block.data(), ALHX_MIXER_FRAMES * 2, output.data());
+
+                double _seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+
+                buffer_data(buffer, AL_FORMAT_STEREO16, output.data(), (ALsizei)(output.size() * sizeof(short)), work_mixer->rate);
+
+                _guard.lock();
+                mixing = false;
+
+                for(size_t i = 0; i < work.size(); ++i) {
+
+                    const AL_mix_snapshot &_from = work_from[i];
+                    snow::audio::Mix_voice* voice = _from.voice;
+
+                    if(voice->position != _from.position || voice->state != _from.state) continue;
+
+                    voice->position = work[i].position;
+                    voice->state = work[i].state;
+                    voice->left = work[i].left;
+                    voice->right = work[i].right;
+
+                } //each voice
+
+                for(size_t i = 0; i < retired.size(); ++i) {
+                    delete retired[i];
+                }
+
+                retired.clear();
+                work_mixer->voices.clear();
+
+                mixed = _mixed;
+                load = (float)(_seconds * work_mixer->rate / ALHX_MIXER_FRAMES);
+
+            } //fill
+
+            void run() {
+
+                std::unique_lock<std::mutex> _guard(lock);
+
+                while(running) {
+
+                    ALint _processed = 0;
+                    alGetSourcei(source, AL_BUFFERS_PROCESSED, &_processed);
+
+                    while(_processed > 0) {
+
+                        ALuint _buffer = 0;
+                        alSourceUnqueueBuffers(source, 1, &_buffer);
+
+                        fill(_buffer, _guard);
+                        alSourceQueueBuffers(source, 1, &_buffer);
+
+                        --_processed;
+
+                    } //each processed
+
+                    ALint _state = 0;
+                    alGetSourcei(source, AL_SOURCE_STATE, &_state);
+
+                        //it only stops if it ran dry, a suspended context leaves it playing
+                    if(_state == AL_STOPPED) {
+                        underruns++;
+                        alSourcePlay(source);
+                    }
+
+                    wake_cond.wait_for(_guard, std::chrono::milliseconds(ALHX_MIXER_INTERVAL));
+
+                } //while running
+
+            } //run
+
+    }; //AL_mixer
+
+    static AL_mixer mixer;
+
+        //starts the mixer, mixing at _rate, which should be the device rate. true if it is running
+    value alhx_MixerInit(value _rate) {
+
+        int _mix_rate = val_int(_rate);
+
+        if(_mix_rate <= 0) {
+            _mix_rate = 44100;
         }
 
+        return alloc_bool( mixer.start(_mix_rate) );
+
+    } DEFINE_PRIM(alhx_MixerInit, 1);
+
+        //stops the mixer and its output, the voices stay valid to be destroyed but won't play again
+    value alhx_MixerDestroy() {
+
+        mixer.destroy();
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_MixerDestroy, 0);
+
+        //returns [voices, mixed, underruns, load], load being the time the last block took to mix
+        //as a fraction of the time it plays for, so 1 / load is about how many times the voices would fit on one core
+    value alhx_MixerStats() {
+
+        std::unique_lock<std::mutex> _guard(mixer.lock);
+
+        value result = alloc_array(4);
+
+        val_array_set_i(result, 0, alloc_int( mixer.mixer ? (int)mixer.mixer->voices.size() : 0 ));
+        val_array_set_i(result, 1, alloc_int( mixer.mixed ));
+        val_array_set_i(result, 2, alloc_int( mixer.underruns ));
+        val_array_set_i(result, 3, alloc_float( mixer.load ));
+
         return result;
 
-    } DEFINE_PRIM(alhx_GetBufferiv, 3);
+    } DEFINE_PRIM(alhx_MixerStats, 0);
+
+        //a voice for the interleaved samples in the typed array, which are copied as float.
+        //returns null if the mixer isn't running or the samples can't be mixed
+    value alhx_MixerVoiceCreate(value *arg, int argCount) {
+
+        enum { A_data, A_byteOffset, A_byteLength, A_sample_format, A_channels, A_rate };
+
+        if(!mixer.mixer) {
+            return alloc_null();
+        }
+
+        const unsigned char* data = snow::bytes_from_hx( arg[A_data] );
+
+        if(!data) {
+            return alloc_null();
+        }
+
+        std::shared_ptr<snow::audio::Mix_sample> _sample = snow::audio::mix_sample(
+            data + val_int(arg[A_byteOffset]), val_int(arg[A_byteLength]),
+            val_int(arg[A_sample_format]), val_int(arg[A_channels]), val_int(arg[A_rate])
+        );
+
+        if(!_sample) {
+            return alloc_null();
+        }
+
+        snow::audio::Mix_voice* voice = new snow::audio::Mix_voice(_sample);
+
+        {
+            std::unique_lock<std::mutex> _guard(mixer.lock);
+            mixer.mixer->add(voice);
+        }
+
+        return snow::to_hx<snow::audio::Mix_voice>( voice );
+
+    } DEFINE_PRIM_MULT(alhx_MixerVoiceCreate);
+
+    value alhx_MixerVoiceDestroy(value _voice) {
+
+        snow::audio::Mix_voice* voice = snow::from_hx<snow::audio::Mix_voice>(_voice);
+
+        if(voice) {
+
+            {
+                std::unique_lock<std::mutex> _guard(mixer.lock);
+
+                if(mixer.mixer) {
+                    mixer.mixer->remove(voice);
+                }
+
+                    //a block mixing a copy of it writes back to it when done, which frees it then
+                if(mixer.mixing) {
+                    mixer.retired.push_back(voice);
+                    voice = NULL;
+                }
+            }
+
+            delete voice;
+
+        } //voice
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_MixerVoiceDestroy, 1);
+
+    value alhx_MixerVoicePlay(value _voice) {
+
+        snow::audio::Mix_voice* voice = snow::from_hx<snow::audio::Mix_voice>(_voice);
+
+        std::unique_lock<std::mutex> _guard(mixer.lock);
+
+        if(voice && mixer.mixer) {
+            mixer.mixer->play(voice);
+        }
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_MixerVoicePlay, 1);
 
+    value alhx_MixerVoicePause(value _voice) {
+
+        snow::audio::Mix_voice* voice = snow::from_hx<snow::audio::Mix_voice>(_voice);
+
+        std::unique_lock<std::mutex> _guard(mixer.lock);
+
+        if(voice && voice->state == snow::audio::mix_playing) {
+            voice->state = snow::audio::mix_paused;
+        }
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_MixerVoicePause, 1);
+
+    value alhx_MixerVoiceStop(value _voice) {
+
+        snow::audio::Mix_voice* voice = snow::from_hx<snow::audio::Mix_voice>(_voice);
+
+        std::unique_lock<std::mutex> _guard(mixer.lock);
+
+        if(voice) {
+            voice->state = snow::audio::mix_stopped;
+            voice->position = 0;
+        }
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_MixerVoiceStop, 1);
+
+        //AL_PLAYING, AL_PAUSED or AL_STOPPED, like a source would report
+    value alhx_MixerVoiceState(value _voice) {
+
+        snow::audio::Mix_voice* voice = snow::from_hx<snow::audio::Mix_voice>(_voice);
+
+        std::unique_lock<std::mutex> _guard(mixer.lock);
+
+        int _state = voice ? voice->state : snow::audio::mix_stopped;
+
+        switch(_state) {
+            case snow::audio::mix_playing:  return alloc_int(AL_PLAYING);
+            case snow::audio::mix_paused:   return alloc_int(AL_PAUSED);
+        }
+
+        return alloc_int(AL_STOPPED);
+
+    } DEFINE_PRIM(alhx_MixerVoiceState, 1);
+
+        //AL_GAIN, AL_PITCH, AL_SEC_OFFSET and AL_SAMPLE_OFFSET, like alSourcef
+    value alhx_MixerVoicef(value _voice, value _param, value _value) {
+
+        snow::audio::Mix_voice* voice = snow::from_hx<snow::audio::Mix_voice>(_voice);
+
+        std::unique_lock<std::mutex> _guard(mixer.lock);
+
+        if(!voice) {
+            return alloc_null();
+        }
+
+        float _val = (float)val_float(_value);
+
+        switch(val_int(_param)) {
+
+            case AL_GAIN:
+                if(_val >= 0.0f) voice->gain = _val;
+                break;
+            case AL_PITCH:
+                if(_val > 0.0f) voice->pitch = _val;
+                break;
+            case AL_SEC_OFFSET:
+                if(_val >= 0.0f) voice->position = (double)_val * voice->sample->rate;
+                break;
+            case AL_SAMPLE_OFFSET:
+                if(_val >= 0.0f) voice->position = (double)_val;
+                break;
+
+        } //switch param
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_MixerVoicef, 3);
+
+        //AL_LOOPING, like alSourcei
+    value alhx_MixerVoicei(value _voice, value _param, value _value) {
+
+        snow::audio::Mix_voice* voice = snow::from_hx<snow::audio::Mix_voice>(_voice);
+
+        std::unique_lock<std::mutex> _guard(mixer.lock);
+
+        if(voice && val_int(_param) == AL_LOOPING) {
+            voice->looping = val_int(_value) != AL_FALSE;
+        }
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_MixerVoicei, 3);
+
+        //-1 is left and 1 is right
+    value alhx_MixerVoicePan(value _voice, value _pan) {
+
+        snow::audio::Mix_voice* voice = snow::from_hx<snow::audio::Mix_voice>(_voice);
+
+        std::unique_lock<std::mutex> _guard(mixer.lock);
+
+        if(voice) {
+            voice->pan = (float)val_float(_pan);
+        }
+
+        return alloc_null();
+
+    } DEFINE_PRIM(alhx_MixerVoicePan, 2);
+
+        //AL_GAIN, AL_PITCH, AL_SEC_OFFSET and AL_SAMPLE_OFFSET, like alGetSourcef
+    value alhx_MixerGetVoicef(value _voice, value _param) {
+
+        snow::audio::Mix_voice* voice = snow::from_hx<snow::audio::Mix_voice>(_voice);
+
+        std::unique_lock<std::mutex> _guard(mixer.lock);
+
+        if(!voice) {
+            return alloc_float(0);
+        }
+
+        switch(val_int(_param)) {
+            case AL_GAIN:           return alloc_float( voice->gain );
+            case AL_PITCH:          return alloc_float( voice->pitch );
+            case AL_SEC_OFFSET:     return alloc_float( voice->position / voice->sample->rate );
+            case AL_SAMPLE_OFFSET:  return alloc_float( floor(voice->position) );
+        }
+
+        return alloc_float(0);
+
+    } DEFINE_PRIM(alhx_MixerGetVoicef, 2);
+
+// --- >
 
 //ALC
 
@@ -1095,6 +3959,8 @@ namespace alhx {
                 val_array_set_i(result, i, alloc_int(vals[i]) );
             }
 
+            delete [] vals;
+
             return result;
 
         } //fetch device
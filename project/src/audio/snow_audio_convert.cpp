@@ -0,0 +1,903 @@
+/*
+    Copyright Sven Bergström 2014
+    created for snow https://github.com/underscorediscovery/snow
+    MIT license
+*/
+
+#include "audio/snow_audio_convert.h"
+
+#include <string.h> //memcpy
+#include <math.h>
+#include <stdint.h>
+
+#if defined(SNOW_AUDIO_SSE2)
+    #include <emmintrin.h>
+#elif defined(SNOW_AUDIO_NEON)
+    #include <arm_neon.h>
+#endif
+
+
+namespace snow {
+
+    namespace audio {
+
+        //helpers
+
+                //ov_read scales by 32768 and clips, rather than by 32767
+            static inline short sample_to_s16( float sample ) {
+
+                long val = lrintf( sample * 32768.0f );
+
+                if(val > 32767) val = 32767;
+                if(val < -32768) val = -32768;
+
+                return (short)val;
+
+            } //sample_to_s16
+
+        //planar -> interleaved float32
+
+            void planar_to_f32( float** planes, int channels, long frames, float* dest ) {
+
+                if(channels == 1) {
+                    memcpy( dest, planes[0], frames * sizeof(float) );
+                    return;
+                }
+
+                long i = 0;
+
+                if(channels == 2) {
+
+                    const float* left = planes[0];
+                    const float* right = planes[1];
+
+                    #if defined(SNOW_AUDIO_SSE2)
+
+                        for(; i + 4 <= frames; i += 4) {
+                            __m128 l = _mm_loadu_ps(left + i);
+                            __m128 r = _mm_loadu_ps(right + i);
+                            _mm_storeu_ps(dest + i*2,     _mm_unpacklo_ps(l, r));
+                            _mm_storeu_ps(dest + i*2 + 4, _mm_unpackhi_ps(l, r));
+                        }
+
+                    #elif defined(SNOW_AUDIO_NEON)
+
+                        for(; i + 4 <= frames; i += 4) {
+                            float32x4x2_t lr = { { vld1q_f32(left + i), vld1q_f32(right + i) } };
+                            vst2q_f32(dest + i*2, lr);
+                        }
+
+                    #endif
+
+                    for(; i < frames; ++i) {
+                        dest[i*2]     = left[i];
+                        dest[i*2 + 1] = right[i];
+                    }
+
+                    return;
+
+                } //channels == 2
+
+                for(int c = 0; c < channels; ++c) {
+                    const float* plane = planes[c];
+                    float* out = dest + c;
+                    for(i = 0; i < frames; ++i) {
+                        out[i * channels] = plane[i];
+                    }
+                }
+
+            } //planar_to_f32
+
+        //planar -> interleaved int16
+
+            #if defined(SNOW_AUDIO_SSE2)
+
+                    //scale, clamp and round 8 samples to 8 shorts
+                static inline __m128i s16_pack( __m128 a, __m128 b ) {
+
+                    const __m128 scale = _mm_set1_ps(32768.0f);
+                    const __m128 hi = _mm_set1_ps(32767.0f);
+                    const __m128 lo = _mm_set1_ps(-32768.0f);
+
+                    a = _mm_max_ps( _mm_min_ps( _mm_mul_ps(a, scale), hi ), lo );
+                    b = _mm_max_ps( _mm_min_ps( _mm_mul_ps(b, scale), hi ), lo );
+
+                    return _mm_packs_epi32( _mm_cvtps_epi32(a), _mm_cvtps_epi32(b) );
+
+                } //s16_pack
+
+            #elif defined(SNOW_AUDIO_NEON)
+
+                    //scale, round and saturate 4 samples to 4 shorts
+                static inline int16x4_t s16_pack( float32x4_t a ) {
+
+                    return vqmovn_s32( vcvtnq_s32_f32( vmulq_n_f32(a, 32768.0f) ) );
+
+                } //s16_pack
+
+            #endif
+
+            void planar_to_s16( float** planes, int channels, long frames, short* dest ) {
+
+                long i = 0;
+
+                if(channels == 1) {
+
+                    const float* mono = planes[0];
+
+                    #if defined(SNOW_AUDIO_SSE2)
+
+                        for(; i + 8 <= frames; i += 8) {
+                            __m128i s = s16_pack( _mm_loadu_ps(mono + i), _mm_loadu_ps(mono + i + 4) );
+                            _mm_storeu_si128( (__m128i*)(dest + i), s );
+                        }
+
+                    #elif defined(SNOW_AUDIO_NEON)
+
+                        for(; i + 4 <= frames; i += 4) {
+                            vst1_s16( dest + i, s16_pack(vld1q_f32(mono + i)) );
+                        }
+
+                    #endif
+
+                    for(; i < frames; ++i) {
+                        dest[i] = sample_to_s16(mono[i]);
+                    }
+
+                    return;
+
+                } //channels == 1
+
+                if(channels == 2) {
+
+                    const float* left = planes[0];
+                    const float* right = planes[1];
+
+                    #if defined(SNOW_AUDIO_SSE2)
+
+                        for(; i + 4 <= frames; i += 4) {
+                            __m128 l = _mm_loadu_ps(left + i);
+                            __m128 r = _mm_loadu_ps(right + i);
+                            __m128i s = s16_pack( _mm_unpacklo_ps(l, r), _mm_unpackhi_ps(l, r) );
+                            _mm_storeu_si128( (__m128i*)(dest + i*2), s );
+                        }
+
+                    #elif defined(SNOW_AUDIO_NEON)
+
+                        for(; i + 4 <= frames; i += 4) {
+                            int16x4x2_t lr = { { s16_pack(vld1q_f32(left + i)), s16_pack(vld1q_f32(right + i)) } };
+                            vst2_s16( dest + i*2, lr );
+                        }
+
+                    #endif
+
+                    for(; i < frames; ++i) {
+                        dest[i*2]     = sample_to_s16(left[i]);
+                        dest[i*2 + 1] = sample_to_s16(right[i]);
+                    }
+
+                    return;
+
+                } //channels == 2
+
+                for(int c = 0; c < channels; ++c) {
+                    const float* plane = planes[c];
+                    short* out = dest + c;
+                    for(i = 0; i < frames; ++i) {
+                        out[i * channels] = sample_to_s16(plane[i]);
+                    }
+                }
+
+            } //planar_to_s16
+
+        //u8 -> int16
+
+            void u8_to_s16( const unsigned char* src, long count, short* dest ) {
+
+                long i = 0;
+
+                #if defined(SNOW_AUDIO_SSE2)
+
+                        //interleaving zeros below each byte gives x << 8, the xor recenters it
+                    const __m128i zero = _mm_setzero_si128();
+                    const __m128i bias = _mm_set1_epi16((short)0x8000);
+
+                    for(; i + 16 <= count; i += 16) {
+                        __m128i v = _mm_loadu_si128( (const __m128i*)(src + i) );
+                        _mm_storeu_si128( (__m128i*)(dest + i),     _mm_xor_si128(_mm_unpacklo_epi8(zero, v), bias) );
+                        _mm_storeu_si128( (__m128i*)(dest + i + 8), _mm_xor_si128(_mm_unpackhi_epi8(zero, v), bias) );
+                    }
+
+                #elif defined(SNOW_AUDIO_NEON)
+
+                    const uint16x8_t bias = vdupq_n_u16(0x8000);
+
+                    for(; i + 8 <= count; i += 8) {
+                        uint16x8_t v = vshlq_n_u16( vmovl_u8(vld1_u8(src + i)), 8 );
+                        vst1q_s16( dest + i, vreinterpretq_s16_u16(veorq_u16(v, bias)) );
+                    }
+
+                #endif
+
+                for(; i < count; ++i) {
+                    dest[i] = (short)((src[i] - 128) << 8);
+                }
+
+            } //u8_to_s16
+
+        //int16 -> float32
+
+            void s16_to_f32( const short* src, long count, float* dest ) {
+
+                const float scale = 1.0f / 32768.0f;
+
+                long i = 0;
+
+                #if defined(SNOW_AUDIO_SSE2)
+
+                    const __m128 vscale = _mm_set1_ps(scale);
+
+                    for(; i + 8 <= count; i += 8) {
+                        __m128i v = _mm_loadu_si128( (const __m128i*)(src + i) );
+                            //sign extend by placing each short in the top half and shifting down
+                        __m128i lo = _mm_srai_epi32( _mm_unpacklo_epi16(v, v), 16 );
+                        __m128i hi = _mm_srai_epi32( _mm_unpackhi_epi16(v, v), 16 );
+                        _mm_storeu_ps( dest + i,     _mm_mul_ps(_mm_cvtepi32_ps(lo), vscale) );
+                        _mm_storeu_ps( dest + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), vscale) );
+                    }
+
+                #elif defined(SNOW_AUDIO_NEON)
+
+                    for(; i + 8 <= count; i += 8) {
+                        int16x8_t v = vld1q_s16(src + i);
+                        vst1q_f32( dest + i,     vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale) );
+                        vst1q_f32( dest + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale) );
+                    }
+
+                #endif
+
+                for(; i < count; ++i) {
+                    dest[i] = src[i] * scale;
+                }
+
+            } //s16_to_f32
+
+        //float32 -> int16
+
+            void f32_to_s16( const float* src, long count, short* dest ) {
+
+                long i = 0;
+
+                #if defined(SNOW_AUDIO_SSE2)
+
+                    for(; i + 8 <= count; i += 8) {
+                        __m128i s = s16_pack( _mm_loadu_ps(src + i), _mm_loadu_ps(src + i + 4) );
+                        _mm_storeu_si128( (__m128i*)(dest + i), s );
+                    }
+
+                #elif defined(SNOW_AUDIO_NEON)
+
+                    for(; i + 4 <= count; i += 4) {
+                        vst1_s16( dest + i, s16_pack(vld1q_f32(src + i)) );
+                    }
+
+                #endif
+
+                for(; i < count; ++i) {
+                    dest[i] = sample_to_s16(src[i]);
+                }
+
+            } //f32_to_s16
+
+        //stereo -> mono
+
+            void downmix_s16( const short* src, long frames, short* dest ) {
+
+                long i = 0;
+
+                #if defined(SNOW_AUDIO_SSE2)
+
+                        //madd against ones sums each left/right pair into 32 bits
+                    const __m128i ones = _mm_set1_epi16(1);
+
+                    for(; i + 8 <= frames; i += 8) {
+                        __m128i a = _mm_madd_epi16( _mm_loadu_si128((const __m128i*)(src + i*2)), ones );
+                        __m128i b = _mm_madd_epi16( _mm_loadu_si128((const __m128i*)(src + i*2 + 8)), ones );
+                        __m128i m = _mm_packs_epi32( _mm_srai_epi32(a, 1), _mm_srai_epi32(b, 1) );
+                        _mm_storeu_si128( (__m128i*)(dest + i), m );
+                    }
+
+                #elif defined(SNOW_AUDIO_NEON)
+
+                    for(; i + 8 <= frames; i += 8) {
+                        int16x8x2_t lr = vld2q_s16(src + i*2);
+                        vst1q_s16( dest + i, vhaddq_s16(lr.val[0], lr.val[1]) );
+                    }
+
+                #endif
+
+                for(; i < frames; ++i) {
+                    dest[i] = (short)((src[i*2] + src[i*2 + 1]) >> 1);
+                }
+
+            } //downmix_s16
+
+            void downmix_f32( const float* src, long frames, float* dest ) {
+
+                long i = 0;
+
+                #if defined(SNOW_AUDIO_SSE2)
+
+                    const __m128 half = _mm_set1_ps(0.5f);
+
+                    for(; i + 4 <= frames; i += 4) {
+                        __m128 a = _mm_loadu_ps(src + i*2);
+                        __m128 b = _mm_loadu_ps(src + i*2 + 4);
+                        __m128 l = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+                        __m128 r = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+                        _mm_storeu_ps( dest + i, _mm_mul_ps(_mm_add_ps(l, r), half) );
+                    }
+
+                #elif defined(SNOW_AUDIO_NEON)
+
+                    for(; i + 4 <= frames; i += 4) {
+                        float32x4x2_t lr = vld2q_f32(src + i*2);
+                        vst1q_f32( dest + i, vmulq_n_f32(vaddq_f32(lr.val[0], lr.val[1]), 0.5f) );
+                    }
+
+                #endif
+
+                for(; i < frames; ++i) {
+                    dest[i] = (src[i*2] + src[i*2 + 1]) * 0.5f;
+                }
+
+            } //downmix_f32
+
+        //rate conversion
+
+                //Positions step through the source in 32.32 fixed point, so long files
+                //don't drift. The interpolation itself depends on the previous and next
+                //frame at a varying offset, which doesn't map onto the vector paths.
+
+            long resample_frames( long frames, int from_rate, int to_rate ) {
+
+                if(frames <= 0 || from_rate <= 0 || to_rate <= 0) {
+                    return 0;
+                }
+
+                return (long)( ((int64_t)frames * to_rate) / from_rate );
+
+            } //resample_frames
+
+            void resample_s16( const short* src, int channels, long frames, int from_rate, int to_rate, short* dest ) {
+
+                long count = resample_frames(frames, from_rate, to_rate);
+                uint64_t step = ((uint64_t)from_rate << 32) / (uint64_t)to_rate;
+                uint64_t pos = 0;
+
+                for(long i = 0; i < count; ++i, pos += step) {
+
+                    long index = (long)(pos >> 32);
+                    long next = index + 1 < frames ? index + 1 : index;
+                        //15 bits keeps the product within 32 bits
+                    int frac = (int)((pos >> 17) & 0x7fff);
+
+                    const short* a = src + index * channels;
+                    const short* b = src + next * channels;
+
+                    for(int c = 0; c < channels; ++c) {
+                        *dest++ = (short)(a[c] + (((b[c] - a[c]) * frac) >> 15));
+                    }
+
+                } //each frame
+
+            } //resample_s16
+
+            void resample_f32( const float* src, int channels, long frames, int from_rate, int to_rate, float* dest ) {
+
+                const float to_unit = 1.0f / 4294967296.0f;
+
+                long count = resample_frames(frames, from_rate, to_rate);
+                uint64_t step = ((uint64_t)from_rate << 32) / (uint64_t)to_rate;
+                uint64_t pos = 0;
+
+                for(long i = 0; i < count; ++i, pos += step) {
+
+                    long index = (long)(pos >> 32);
+                    long next = index + 1 < frames ? index + 1 : index;
+                    float frac = (float)(pos & 0xffffffff) * to_unit;
+
+                    const float* a = src + index * channels;
+                    const float* b = src + next * channels;
+
+                    for(int c = 0; c < channels; ++c) {
+                        *dest++ = a[c] + (b[c] - a[c]) * frac;
+                    }
+
+                } //each frame
+
+            } //resample_f32
+
+        //whole buffer conversion
+
+                //the stages run in int16 or float32, whichever the target is, through these
+            static inline void to_work( const unsigned char* src, int format, long count, short* dest ) {
+
+                if(format == sf_u8) {
+                    u8_to_s16( src, count, dest );
+                } else if(format == sf_s16) {
+                    memcpy( dest, src, count * sizeof(short) );
+                } else {
+                    f32_to_s16( (const float*)src, count, dest );
+                }
+
+            } //to_work
+
+            static inline void to_work( const unsigned char* src, int format, long count, float* dest ) {
+
+                if(format == sf_f32) {
+                    memcpy( dest, src, count * sizeof(float) );
+                    return;
+                }
+
+                if(format == sf_s16) {
+                    s16_to_f32( (const short*)src, count, dest );
+                    return;
+                }
+
+                    //u8 goes through int16, which is exact
+                std::vector<short> _s16(count);
+                u8_to_s16( src, count, _s16.data() );
+                s16_to_f32( _s16.data(), count, dest );
+
+            } //to_work
+
+            static inline void downmix( const short* src, long frames, short* dest ) { downmix_s16(src, frames, dest); }
+            static inline void downmix( const float* src, long frames, float* dest ) { downmix_f32(src, frames, dest); }
+
+            static inline void resample( const short* src, int channels, long frames, int from_rate, int to_rate, short* dest ) { resample_s16(src, channels, frames, from_rate, to_rate, dest); }
+            static inline void resample( const float* src, int channels, long frames, int from_rate, int to_rate, float* dest ) { resample_f32(src, channels, frames, from_rate, to_rate, dest); }
+
+            template<typename T>
+            static void convert_work( const unsigned char* src, long frames, const Audio_format &from, const Audio_format &to, std::vector<unsigned char> &out ) {
+
+                int channels = from.channels;
+
+                std::vector<T> _work( frames * channels );
+                to_work( src, from.sample_format, frames * channels, _work.data() );
+
+                if(channels != to.channels) {
+                        //in place is safe, each output frame is behind the input it reads
+                    downmix( _work.data(), frames, _work.data() );
+                    channels = to.channels;
+                    _work.resize(frames);
+                }
+
+                if(from.rate != to.rate) {
+                    long _frames = resample_frames(frames, from.rate, to.rate);
+                    std::vector<T> _resampled( _frames * channels );
+                    resample( _work.data(), channels, frames, from.rate, to.rate, _resampled.data() );
+                    _work.swap(_resampled);
+                }
+
+                out.resize( _work.size() * sizeof(T) );
+
+                if(!out.empty()) {
+                    memcpy( out.data(), _work.data(), out.size() );
+                }
+
+            } //convert_work
+
+            static inline int sample_bytes( int format ) {
+
+                switch(format) {
+                    case sf_u8:  return 1;
+                    case sf_s16: return 2;
+                    case sf_f32: return 4;
+                    default:     return 0;
+                }
+
+            } //sample_bytes
+
+            bool convert( const unsigned char* src, long length, const Audio_format &from, Audio_format &to, std::vector<unsigned char> &out ) {
+
+                out.clear();
+
+                int _bytes = sample_bytes(from.sample_format);
+
+                if(!src || _bytes == 0 || from.channels <= 0 || from.rate <= 0) {
+                    to = from;
+                    return false;
+                }
+
+                    //resolve the target to what can be produced
+                if(to.sample_format == sf_unknown) to.sample_format = from.sample_format;
+                if(to.channels == 0) to.channels = from.channels;
+                if(to.rate <= 0) to.rate = from.rate;
+
+                if(sample_bytes(to.sample_format) == 0) to.sample_format = from.sample_format;
+                if(!(from.channels == 2 && to.channels == 1)) to.channels = from.channels;
+
+                bool _same = to.sample_format == from.sample_format && to.channels == from.channels && to.rate == from.rate;
+
+                if(_same) {
+                    return false;
+                }
+
+                    //u8 is only ever a source, anything else it needs is done in int16
+                if(to.sample_format == sf_u8) {
+                    to.sample_format = sf_s16;
+                }
+
+                long frames = length / (_bytes * from.channels);
+
+                if(to.sample_format == sf_f32) {
+                    convert_work<float>( src, frames, from, to, out );
+                } else {
+                    convert_work<short>( src, frames, from, to, out );
+                }
+
+                return true;
+
+            } //convert
+
+        //IMA-ADPCM
+
+            static const int ima_step_table[89] = {
+                7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+                50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+                337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+                2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+                15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+            };
+
+            static const int ima_index_table[16] = { -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8 };
+
+            struct IMA_state {
+                int predictor;
+                int index;
+            };
+
+            static inline int ima_clamp_index( int index ) {
+                return index < 0 ? 0 : (index > 88 ? 88 : index);
+            }
+
+                //the reference decoder step, the vector paths below match it exactly
+            static inline short ima_decode_nibble( IMA_state &state, int nibble ) {
+
+                int step = ima_step_table[state.index];
+                int diff = step >> 3;
+
+                if(nibble & 4) diff += step;
+                if(nibble & 2) diff += step >> 1;
+                if(nibble & 1) diff += step >> 2;
+
+                state.predictor += (nibble & 8) ? -diff : diff;
+
+                if(state.predictor > 32767) state.predictor = 32767;
+                if(state.predictor < -32768) state.predictor = -32768;
+
+                state.index = ima_clamp_index( state.index + ima_index_table[nibble] );
+
+                return (short)state.predictor;
+
+            } //ima_decode_nibble
+
+            static inline void ima_read_header( const unsigned char* header, IMA_state &state ) {
+
+                state.predictor = (short)(header[0] | (header[1] << 8));
+                state.index = ima_clamp_index( header[2] );
+
+            } //ima_read_header
+
+            int ima_samples_per_block( int block_align, int channels ) {
+
+                if(channels <= 0 || block_align < 4 * channels) {
+                    return 0;
+                }
+
+                return ((block_align - 4 * channels) / (4 * channels)) * 8 + 1;
+
+            } //ima_samples_per_block
+
+                //one channel of one block, dest is that channel's first sample in the block
+            static void ima_decode_lane( const unsigned char* block, int channel, int channels, int groups, short* dest ) {
+
+                IMA_state state;
+                ima_read_header( block + channel * 4, state );
+
+                *dest = (short)state.predictor;
+                dest += channels;
+
+                const unsigned char* data = block + (channels + channel) * 4;
+
+                for(int g = 0; g < groups; ++g) {
+
+                    for(int b = 0; b < 4; ++b) {
+                        *dest = ima_decode_nibble( state, data[b] & 0x0f ); dest += channels;
+                        *dest = ima_decode_nibble( state, data[b] >> 4 );   dest += channels;
+                    }
+
+                    data += channels * 4;
+
+                } //each group
+
+            } //ima_decode_lane
+
+        #if defined(SNOW_AUDIO_SSE2) || defined(SNOW_AUDIO_NEON)
+
+                //each nibble depends on the one before it, so within a channel there is nothing to vectorise.
+                //instead four (block, channel) lanes, which are independent, decode side by side.
+                //the step table lookup and the scatter to the interleaved output stay scalar.
+            static void ima_decode_lanes4( const unsigned char** blocks, const int* lane_channels, int channels, int groups, short** dests ) {
+
+                int _predictor[4];
+                int _index[4];
+                int _step[4];
+                unsigned int _words[4];
+
+                for(int l = 0; l < 4; ++l) {
+                    IMA_state state;
+                    ima_read_header( blocks[l] + lane_channels[l] * 4, state );
+                    _predictor[l] = state.predictor;
+                    _index[l] = state.index;
+                    dests[l][0] = (short)state.predictor;
+                }
+
+                #if defined(SNOW_AUDIO_SSE2)
+
+                    const __m128i _one = _mm_set1_epi32(1);
+                    const __m128i _two = _mm_set1_epi32(2);
+                    const __m128i _three = _mm_set1_epi32(3);
+                    const __m128i _four = _mm_set1_epi32(4);
+                    const __m128i _seven = _mm_set1_epi32(7);
+                    const __m128i _eight = _mm_set1_epi32(8);
+                    const __m128i _fifteen = _mm_set1_epi32(15);
+                    const __m128i _zero = _mm_setzero_si128();
+                    const __m128i _max_index = _mm_set1_epi32(88);
+                    const __m128i _minus_one = _mm_set1_epi32(-1);
+
+                    __m128i predictor = _mm_loadu_si128((const __m128i*)_predictor);
+                    __m128i index = _mm_loadu_si128((const __m128i*)_index);
+
+                #else
+
+                    const int32x4_t _three = vdupq_n_s32(3);
+                    const int32x4_t _four = vdupq_n_s32(4);
+                    const int32x4_t _seven = vdupq_n_s32(7);
+                    const int32x4_t _zero = vdupq_n_s32(0);
+                    const int32x4_t _max_index = vdupq_n_s32(88);
+                    const int32x4_t _minus_one = vdupq_n_s32(-1);
+                    const uint32x4_t _fifteen = vdupq_n_u32(15);
+
+                    int32x4_t predictor = vld1q_s32(_predictor);
+                    int32x4_t index = vld1q_s32(_index);
+
+                #endif
+
+                long _out = channels;
+                long _group_stride = channels * 4;
+
+                for(int g = 0; g < groups; ++g) {
+
+                    for(int l = 0; l < 4; ++l) {
+                        memcpy( &_words[l], blocks[l] + (channels + lane_channels[l]) * 4 + g * _group_stride, 4 );
+                    }
+
+                    #if defined(SNOW_AUDIO_SSE2)
+                        __m128i words = _mm_loadu_si128((const __m128i*)_words);
+                    #else
+                        uint32x4_t words = vld1q_u32(_words);
+                    #endif
+
+                        //low nibble first
+                    for(int k = 0; k < 8; ++k) {
+
+                        #if defined(SNOW_AUDIO_SSE2)
+
+                            _mm_storeu_si128((__m128i*)_index, index);
+                            for(int l = 0; l < 4; ++l) _step[l] = ima_step_table[_index[l]];
+
+                            __m128i step = _mm_loadu_si128((const __m128i*)_step);
+                            __m128i nibble = _mm_and_si128(words, _fifteen);
+                            words = _mm_srli_epi32(words, 4);
+
+                            __m128i diff = _mm_srai_epi32(step, 3);
+                            diff = _mm_add_epi32(diff, _mm_and_si128(_mm_cmpeq_epi32(_mm_and_si128(nibble, _four), _four), step));
+                            diff = _mm_add_epi32(diff, _mm_and_si128(_mm_cmpeq_epi32(_mm_and_si128(nibble, _two), _two), _mm_srai_epi32(step, 1)));
+                            diff = _mm_add_epi32(diff, _mm_and_si128(_mm_cmpeq_epi32(_mm_and_si128(nibble, _one), _one), _mm_srai_epi32(step, 2)));
+
+                                //negate where the sign bit is set, (diff ^ -1) - -1 == -diff
+                            __m128i sign = _mm_cmpeq_epi32(_mm_and_si128(nibble, _eight), _eight);
+                            predictor = _mm_add_epi32(predictor, _mm_sub_epi32(_mm_xor_si128(diff, sign), sign));
+
+                                //clamp to int16 through a saturating pack, then widen back
+                            __m128i packed = _mm_packs_epi32(predictor, predictor);
+                            predictor = _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+
+                                //index adjust is -1 for the low 3 bits under 4, or 2,4,6,8 above
+                            __m128i low = _mm_and_si128(nibble, _seven);
+                            __m128i under = _mm_cmplt_epi32(low, _four);
+                            __m128i adjust = _mm_or_si128(_mm_and_si128(under, _minus_one), _mm_andnot_si128(under, _mm_slli_epi32(_mm_sub_epi32(low, _three), 1)));
+
+                                //the index is -1..96 here, which fits the 16 bit min/max sse2 has
+                            index = _mm_add_epi32(index, adjust);
+                            index = _mm_min_epi16(_mm_max_epi16(index, _zero), _max_index);
+
+                            _mm_storeu_si128((__m128i*)_predictor, predictor);
+
+                        #else
+
+                            vst1q_s32(_index, index);
+                            for(int l = 0; l < 4; ++l) _step[l] = ima_step_table[_index[l]];
+
+                            int32x4_t step = vld1q_s32(_step);
+                            int32x4_t nibble = vreinterpretq_s32_u32(vandq_u32(words, _fifteen));
+                            words = vshrq_n_u32(words, 4);
+
+                            int32x4_t diff = vshrq_n_s32(step, 3);
+                            diff = vaddq_s32(diff, vandq_s32(vreinterpretq_s32_u32(vtstq_s32(nibble, vdupq_n_s32(4))), step));
+                            diff = vaddq_s32(diff, vandq_s32(vreinterpretq_s32_u32(vtstq_s32(nibble, vdupq_n_s32(2))), vshrq_n_s32(step, 1)));
+                            diff = vaddq_s32(diff, vandq_s32(vreinterpretq_s32_u32(vtstq_s32(nibble, vdupq_n_s32(1))), vshrq_n_s32(step, 2)));
+
+                            int32x4_t sign = vreinterpretq_s32_u32(vtstq_s32(nibble, vdupq_n_s32(8)));
+                            predictor = vaddq_s32(predictor, vsubq_s32(veorq_s32(diff, sign), sign));
+                            predictor = vmovl_s16(vqmovn_s32(predictor));
+
+                            int32x4_t low = vandq_s32(nibble, _seven);
+                            int32x4_t adjust = vbslq_s32(vcltq_s32(low, _four), _minus_one, vshlq_n_s32(vsubq_s32(low, _three), 1));
+
+                            index = vminq_s32(vmaxq_s32(vaddq_s32(index, adjust), _zero), _max_index);
+
+                            vst1q_s32(_predictor, predictor);
+
+                        #endif
+
+                        for(int l = 0; l < 4; ++l) {
+                            dests[l][_out] = (short)_predictor[l];
+                        }
+
+                        _out += channels;
+
+                    } //each nibble
+
+                } //each group
+
+            } //ima_decode_lanes4
+
+        #endif //SNOW_AUDIO_SSE2 || SNOW_AUDIO_NEON
+
+            void ima_decode_blocks( const unsigned char* src, long blocks, int block_align, int channels, short* dest ) {
+
+                int _frames = ima_samples_per_block( block_align, channels );
+
+                if(_frames == 0) {
+                    return;
+                }
+
+                int _groups = (_frames - 1) / 8;
+                long _lanes = blocks * channels;
+                long _lane = 0;
+
+                #if defined(SNOW_AUDIO_SSE2) || defined(SNOW_AUDIO_NEON)
+
+                    const unsigned char* _blocks[4];
+                    int _channels[4];
+                    short* _dests[4];
+
+                    for(; _lane + 4 <= _lanes; _lane += 4) {
+
+                        for(int l = 0; l < 4; ++l) {
+                            long _block = (_lane + l) / channels;
+                            _channels[l] = (int)((_lane + l) % channels);
+                            _blocks[l] = src + _block * block_align;
+                            _dests[l] = dest + _block * _frames * channels + _channels[l];
+                        }
+
+                        ima_decode_lanes4( _blocks, _channels, channels, _groups, _dests );
+
+                    } //each 4 lanes
+
+                #endif
+
+                for(; _lane < _lanes; ++_lane) {
+
+                    long _block = _lane / channels;
+                    int _channel = (int)(_lane % channels);
+
+                    ima_decode_lane( src + _block * block_align, _channel, channels, _groups, dest + _block * _frames * channels + _channel );
+
+                } //each lane
+
+            } //ima_decode_blocks
+
+                //the nibble closest to the difference, tracking the state the decoder will reconstruct
+            static inline int ima_encode_nibble( IMA_state &state, int sample ) {
+
+                int step = ima_step_table[state.index];
+                int diff = sample - state.predictor;
+                int nibble = 0;
+
+                if(diff < 0) {
+                    nibble = 8;
+                    diff = -diff;
+                }
+
+                if(diff >= step) { nibble |= 4; diff -= step; }
+                step >>= 1;
+                if(diff >= step) { nibble |= 2; diff -= step; }
+                step >>= 1;
+                if(diff >= step) { nibble |= 1; }
+
+                ima_decode_nibble( state, nibble );
+
+                return nibble;
+
+            } //ima_encode_nibble
+
+            long ima_encode( const short* src, int channels, long frames, int block_align, std::vector<unsigned char> &out ) {
+
+                int _frames = ima_samples_per_block( block_align, channels );
+
+                if(_frames == 0 || frames <= 0) {
+                    return 0;
+                }
+
+                int _groups = (_frames - 1) / 8;
+                long _blocks = (frames + _frames - 1) / _frames;
+                size_t _start = out.size();
+
+                out.resize( _start + _blocks * block_align, 0 );
+
+                    //the step index carries over between blocks, the predictor restarts at each header
+                std::vector<IMA_state> _states( channels );
+                for(int c = 0; c < channels; ++c) {
+                    _states[c].predictor = 0;
+                    _states[c].index = 0;
+                }
+
+                for(long b = 0; b < _blocks; ++b) {
+
+                    unsigned char* _block = &out[_start + b * block_align];
+                    long _first = b * _frames;
+
+                    for(int c = 0; c < channels; ++c) {
+
+                        IMA_state &state = _states[c];
+                        int _sample = _first < frames ? src[_first * channels + c] : 0;
+
+                        state.predictor = _sample;
+
+                        unsigned char* _header = _block + c * 4;
+                        _header[0] = (unsigned char)(_sample & 0xff);
+                        _header[1] = (unsigned char)((_sample >> 8) & 0xff);
+                        _header[2] = (unsigned char)state.index;
+                        _header[3] = 0;
+
+                        unsigned char* _data = _block + (channels + c) * 4;
+                        long _frame = _first + 1;
+
+                        for(int g = 0; g < _groups; ++g) {
+
+                            for(int n = 0; n < 8; ++n, ++_frame) {
+                                int _next = _frame < frames ? src[_frame * channels + c] : 0;
+                                int _nibble = ima_encode_nibble( state, _next );
+                                _data[n >> 1] |= (unsigned char)((n & 1) ? (_nibble << 4) : _nibble);
+                            }
+
+                            _data += channels * 4;
+
+                        } //each group
+
+                    } //each channel
+
+                } //each block
+
+                return _blocks;
+
+            } //ima_encode
+
+
+    } //audio namespace
+
+} //snow namespace
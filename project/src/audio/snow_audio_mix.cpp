@@ -0,0 +1,402 @@
+/*
+    Copyright Sven Bergström 2014
+    created for snow https://github.com/underscorediscovery/snow
+    MIT license
+*/
+
+#include "audio/snow_audio_mix.h"
+
+#include <string.h> //memset, memcpy
+#include <math.h>
+
+#if defined(SNOW_AUDIO_SSE2)
+    #include <emmintrin.h>
+#elif defined(SNOW_AUDIO_NEON)
+    #include <arm_neon.h>
+#endif
+
+
+namespace snow {
+
+    namespace audio {
+
+        //kernels
+
+            void mix_mono( const float* src, long frames, float left_from, float right_from, float left_to, float right_to, float* dest ) {
+
+                if(frames <= 0) return;
+
+                const float dl = (left_to - left_from) / frames;
+                const float dr = (right_to - right_from) / frames;
+
+                long i = 0;
+
+                #if defined(SNOW_AUDIO_SSE2)
+
+                        //four frames a pass, each mono sample doubled up into a left/right pair
+                    __m128 g0 = _mm_setr_ps(left_from, right_from, left_from + dl, right_from + dr);
+                    __m128 g1 = _mm_add_ps(g0, _mm_setr_ps(dl*2, dr*2, dl*2, dr*2));
+                    const __m128 step = _mm_setr_ps(dl*4, dr*4, dl*4, dr*4);
+
+                    for(; i + 4 <= frames; i += 4) {
+
+                        __m128 s = _mm_loadu_ps(src + i);
+                        float* d = dest + i*2;
+
+                        _mm_storeu_ps(d,     _mm_add_ps(_mm_loadu_ps(d),     _mm_mul_ps(_mm_unpacklo_ps(s, s), g0)));
+                        _mm_storeu_ps(d + 4, _mm_add_ps(_mm_loadu_ps(d + 4), _mm_mul_ps(_mm_unpackhi_ps(s, s), g1)));
+
+                        g0 = _mm_add_ps(g0, step);
+                        g1 = _mm_add_ps(g1, step);
+
+                    }
+
+                #elif defined(SNOW_AUDIO_NEON)
+
+                    const float _g0[4] = { left_from, right_from, left_from + dl, right_from + dr };
+                    const float _step[4] = { dl*4, dr*4, dl*4, dr*4 };
+
+                    float32x4_t g0 = vld1q_f32(_g0);
+                    float32x4_t g1 = vaddq_f32(g0, vmulq_n_f32(vld1q_f32(_step), 0.5f));
+                    const float32x4_t step = vld1q_f32(_step);
+
+                    for(; i + 4 <= frames; i += 4) {
+
+                        float32x4x2_t s = vzipq_f32(vld1q_f32(src + i), vld1q_f32(src + i));
+                        float* d = dest + i*2;
+
+                        vst1q_f32(d,     vmlaq_f32(vld1q_f32(d),     s.val[0], g0));
+                        vst1q_f32(d + 4, vmlaq_f32(vld1q_f32(d + 4), s.val[1], g1));
+
+                        g0 = vaddq_f32(g0, step);
+                        g1 = vaddq_f32(g1, step);
+
+                    }
+
+                #endif
+
+                for(; i < frames; ++i) {
+                    dest[i*2]     += src[i] * (left_from + dl * i);
+                    dest[i*2 + 1] += src[i] * (right_from + dr * i);
+                }
+
+            } //mix_mono
+
+            void mix_stereo( const float* src, long frames, float left_from, float right_from, float left_to, float right_to, float* dest ) {
+
+                if(frames <= 0) return;
+
+                const float dl = (left_to - left_from) / frames;
+                const float dr = (right_to - right_from) / frames;
+
+                long i = 0;
+
+                #if defined(SNOW_AUDIO_SSE2)
+
+                    __m128 g0 = _mm_setr_ps(left_from, right_from, left_from + dl, right_from + dr);
+                    __m128 g1 = _mm_add_ps(g0, _mm_setr_ps(dl*2, dr*2, dl*2, dr*2));
+                    const __m128 step = _mm_setr_ps(dl*4, dr*4, dl*4, dr*4);
+
+                    for(; i + 4 <= frames; i += 4) {
+
+                        const float* s = src + i*2;
+                        float* d = dest + i*2;
+
+                        _mm_storeu_ps(d,     _mm_add_ps(_mm_loadu_ps(d),     _mm_mul_ps(_mm_loadu_ps(s),     g0)));
+                        _mm_storeu_ps(d + 4, _mm_add_ps(_mm_loadu_ps(d + 4), _mm_mul_ps(_mm_loadu_ps(s + 4), g1)));
+
+                        g0 = _mm_add_ps(g0, step);
+                        g1 = _mm_add_ps(g1, step);
+
+                    }
+
+                #elif defined(SNOW_AUDIO_NEON)
+
+                    const float _g0[4] = { left_from, right_from, left_from + dl, right_from + dr };
+                    const float _step[4] = { dl*4, dr*4, dl*4, dr*4 };
+
+                    float32x4_t g0 = vld1q_f32(_g0);
+                    float32x4_t g1 = vaddq_f32(g0, vmulq_n_f32(vld1q_f32(_step), 0.5f));
+                    const float32x4_t step = vld1q_f32(_step);
+
+                    for(; i + 4 <= frames; i += 4) {
+
+                        const float* s = src + i*2;
+                        float* d = dest + i*2;
+
+                        vst1q_f32(d,     vmlaq_f32(vld1q_f32(d),     vld1q_f32(s),     g0));
+                        vst1q_f32(d + 4, vmlaq_f32(vld1q_f32(d + 4), vld1q_f32(s + 4), g1));
+
+                        g0 = vaddq_f32(g0, step);
+                        g1 = vaddq_f32(g1, step);
+
+                    }
+
+                #endif
+
+                for(; i < frames; ++i) {
+                    dest[i*2]     += src[i*2]     * (left_from + dl * i);
+                    dest[i*2 + 1] += src[i*2 + 1] * (right_from + dr * i);
+                }
+
+            } //mix_stereo
+
+        //samples
+
+            std::shared_ptr<Mix_sample> mix_sample( const unsigned char* src, long length, int sample_format, int channels, int rate ) {
+
+                if(!src || length <= 0 || rate <= 0 || (channels != 1 && channels != 2)) {
+                    return std::shared_ptr<Mix_sample>();
+                }
+
+                std::shared_ptr<Mix_sample> sample(new Mix_sample());
+
+                sample->channels = channels;
+                sample->rate = rate;
+
+                Audio_format _from = { sample_format, channels, rate };
+                Audio_format _to = { sf_f32, channels, rate };
+                std::vector<unsigned char> _converted;
+
+                    //already float, it is only copied
+                if(convert(src, length, _from, _to, _converted)) {
+                    src = _converted.data();
+                    length = (long)_converted.size();
+                } else if(sample_format != sf_f32) {
+                    return std::shared_ptr<Mix_sample>();
+                }
+
+                sample->frames = length / (long)(sizeof(float) * channels);
+                sample->data.resize(sample->frames * channels);
+
+                if(sample->frames > 0) {
+                    memcpy(sample->data.data(), src, sample->frames * channels * sizeof(float));
+                }
+
+                return sample;
+
+            } //mix_sample
+
+        //mixer
+
+            //equal power panning for mono, so a sound keeps its loudness across the field,
+            //and a balance for stereo, which leaves the near side alone and fades the far one
+        static inline void voice_gains( const Mix_voice* voice, float &left, float &right ) {
+
+            float _pan = voice->pan < -1.0f ? -1.0f : (voice->pan > 1.0f ? 1.0f : voice->pan);
+
+            if(voice->sample->channels == 1) {
+                float _angle = (_pan + 1.0f) * 0.78539816f;
+                left = cosf(_angle) * voice->gain;
+                right = sinf(_angle) * voice->gain;
+            } else {
+                left = (_pan > 0.0f ? 1.0f - _pan : 1.0f) * voice->gain;
+                right = (_pan < 0.0f ? 1.0f + _pan : 1.0f) * voice->gain;
+            }
+
+        } //voice_gains
+
+        void Mixer::add( Mix_voice* voice ) {
+
+            voices.push_back(voice);
+
+        } //add
+
+        void Mixer::remove( Mix_voice* voice ) {
+
+            for(size_t i = 0; i < voices.size(); ++i) {
+                if(voices[i] == voice) {
+                    voices[i] = voices.back();
+                    voices.pop_back();
+                    break;
+                }
+            }
+
+        } //remove
+
+        void Mixer::play( Mix_voice* voice ) {
+
+            if(voice->state != mix_paused) {
+                voice->position = 0;
+                    //a new start takes its gains as they are, without a ramp up from silence
+                voice_gains(voice, voice->left, voice->right);
+            }
+
+            voice->state = mix_playing;
+
+        } //play
+
+        long Mixer::fetch( Mix_voice* voice, long frames, const float* &src ) {
+
+            const Mix_sample* sample = voice->sample.get();
+            const long length = sample->frames;
+            const int channels = sample->channels;
+            const float* data = sample->data.data();
+
+            if(length <= 0) return 0;
+
+            const double step = (double)voice->pitch * sample->rate / rate;
+            double position = voice->position;
+
+                //unpitched at the mixer rate, the frames are mixed straight from the sample,
+                //up to the end of it. the caller comes back for the rest after a loop
+            if(step == 1.0 && position == floor(position)) {
+
+                long _at = (long)position;
+
+                if(_at >= length) {
+                    if(!voice->looping) return 0;
+                    _at = 0;
+                }
+
+                long _count = length - _at;
+                if(_count > frames) _count = frames;
+
+                src = data + _at * channels;
+                voice->position = (double)(_at + _count);
+
+                return _count;
+
+            } //unpitched
+
+            size_t _needed = (size_t)frames * channels;
+            if(scratch.size() < _needed) {
+                scratch.resize(_needed);
+            }
+
+            float* _out = scratch.data();
+            long i = 0;
+
+            while(i < frames) {
+
+                    //the frames before the last one of the sample need no wrap or end checks,
+                    //less one so the rounding of the position as it steps can't reach the last frame
+                long _run = (long)ceil(((length - 1) - position) / step) - 1;
+                if(_run > frames - i) _run = frames - i;
+
+                if(_run > 0) {
+
+                    if(channels == 1) {
+                        for(long _end = i + _run; i < _end; ++i) {
+                            long _at = (long)position;
+                            float _frac = (float)(position - _at);
+                            _out[i] = data[_at] + (data[_at + 1] - data[_at]) * _frac;
+                            position += step;
+                        }
+                    } else {
+                        for(long _end = i + _run; i < _end; ++i) {
+                            long _at = (long)position;
+                            float _frac = (float)(position - _at);
+                            const float* _a = data + _at*2;
+                            _out[i*2]     = _a[0] + (_a[2] - _a[0]) * _frac;
+                            _out[i*2 + 1] = _a[1] + (_a[3] - _a[1]) * _frac;
+                            position += step;
+                        }
+                    }
+
+                    continue;
+
+                } //_run
+
+                if(position >= length) {
+                    if(!voice->looping) break;
+                    position = fmod(position, (double)length);
+                }
+
+                long _at = (long)position;
+                long _next = _at + 1;
+                float _frac = (float)(position - _at);
+
+                    //past the last frame it blends toward the start when looping, or silence when not
+                if(_next >= length) {
+                    _next = voice->looping ? 0 : -1;
+                }
+
+                if(channels == 1) {
+                    float _a = data[_at];
+                    float _b = _next < 0 ? 0.0f : data[_next];
+                    _out[i] = _a + (_b - _a) * _frac;
+                } else {
+                    float _al = data[_at*2];
+                    float _ar = data[_at*2 + 1];
+                    float _bl = _next < 0 ? 0.0f : data[_next*2];
+                    float _br = _next < 0 ? 0.0f : data[_next*2 + 1];
+                    _out[i*2]     = _al + (_bl - _al) * _frac;
+                    _out[i*2 + 1] = _ar + (_br - _ar) * _frac;
+                }
+
+                position += step;
+                ++i;
+
+            } //each frame
+
+            src = _out;
+            voice->position = position;
+
+            return i;
+
+        } //fetch
+
+        int Mixer::mix( float* dest, long frames ) {
+
+            memset(dest, 0, frames * 2 * sizeof(float));
+
+            int _mixed = 0;
+
+            for(size_t v = 0; v < voices.size(); ++v) {
+
+                Mix_voice* voice = voices[v];
+
+                if(voice->state != mix_playing) continue;
+
+                float _left = 0, _right = 0;
+                voice_gains(voice, _left, _right);
+
+                const float _dl = (_left - voice->left) / frames;
+                const float _dr = (_right - voice->right) / frames;
+                const bool _mono = voice->sample->channels == 1;
+
+                long _done = 0;
+
+                while(_done < frames) {
+
+                    const float* _src = 0;
+                    long _count = fetch(voice, frames - _done, _src);
+
+                    if(_count <= 0) break;
+
+                        //the ramp runs over the whole block, each run mixes its part of it
+                    float _lf = voice->left + _dl * _done;
+                    float _rf = voice->right + _dr * _done;
+                    float _lt = voice->left + _dl * (_done + _count);
+                    float _rt = voice->right + _dr * (_done + _count);
+
+                    if(_mono) {
+                        mix_mono(_src, _count, _lf, _rf, _lt, _rt, dest + _done*2);
+                    } else {
+                        mix_stereo(_src, _count, _lf, _rf, _lt, _rt, dest + _done*2);
+                    }
+
+                    _done += _count;
+
+                } //while frames
+
+                voice->left = _left;
+                voice->right = _right;
+
+                if(!voice->looping && (_done < frames || voice->position >= voice->sample->frames)) {
+                    voice->state = mix_stopped;
+                    voice->position = 0;
+                }
+
+                ++_mixed;
+
+            } //each voice
+
+            return _mixed;
+
+        } //mix
+
+    } //audio namespace
+
+} //snow namespace
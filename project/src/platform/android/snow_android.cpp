@@ -141,6 +141,8 @@ namespace snow {
         std::string dialog_folder(const std::string &title){}
         std::string dialog_open(const std::string &title, const std::vector<file_filter> &filters){}
         std::string dialog_save(const std::string &title, const std::vector<file_filter> &filters){}
+        bool map_file(const char *file, iomap &map){ return false; }
+        void unmap_file(iomap &map){}
 
     } //io namespace
 
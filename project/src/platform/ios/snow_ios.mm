@@ -61,6 +61,8 @@ namespace snow {
         std::string dialog_folder(const std::string &title){ return std::string(); }
         std::string dialog_open(const std::string &title, const std::vector<file_filter> &filters){ return std::string(); }
         std::string dialog_save(const std::string &title, const std::vector<file_filter> &filters){ return std::string(); }
+        bool map_file(const char *file, iomap &map){ return false; }
+        void unmap_file(iomap &map){}
 
     } //io namespace
 
@@ -8,9 +8,15 @@
 
 
 #include "snow_core.h"
+#include "snow_io.h"
 
 #include <string>
 
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
 #ifndef SNOW_NO_GTK
     #include <gtk/gtk.h>
 #endif //SNOW_NO_GTK
@@ -52,6 +58,51 @@ namespace snow {
 
         } //url_open
 
+        bool map_file(const char *file, iomap &map) {
+
+            int fd = open(file, O_RDONLY);
+
+            if(fd == -1) {
+                return false;
+            }
+
+            struct stat info;
+
+            if(fstat(fd, &info) != 0 || info.st_size <= 0) {
+                ::close(fd);
+                return false;
+            }
+
+            void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+                //the mapping holds its own reference to the file
+            ::close(fd);
+
+            if(data == MAP_FAILED) {
+                return false;
+            }
+
+                //audio is mostly read front to back, so ask for aggressive readahead
+            madvise(data, (size_t)info.st_size, MADV_SEQUENTIAL);
+
+            map.data = (const unsigned char*)data;
+            map.length = (size_t)info.st_size;
+
+            return true;
+
+        } //map_file
+
+        void unmap_file(iomap &map) {
+
+            if(map.data) {
+                munmap((void*)map.data, map.length);
+            }
+
+            map.data = NULL;
+            map.length = 0;
+
+        } //unmap_file
+
     } //io namespace
 
 } //snow namespace
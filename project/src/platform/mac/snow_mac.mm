@@ -8,6 +8,7 @@
 
 
 #include "snow_core.h"
+#include "snow_io.h"
 
 #include <string>
 
@@ -50,6 +51,10 @@ namespace snow {
 
         } //url_open
 
+            //:unsupported:
+        bool map_file(const char *file, iomap &map){ return false; }
+        void unmap_file(iomap &map){}
+
     } //io
 
 } //namespace snow
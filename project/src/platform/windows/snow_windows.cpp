@@ -8,6 +8,7 @@
 
 
 #include "snow_core.h"
+#include "snow_io.h"
 #include "snow_window.h"
 
 #include <string>
@@ -45,6 +46,10 @@ namespace snow {
 
         } //url_open
 
+            //:unsupported:
+        bool map_file(const char *file, iomap &map){ return false; }
+        void unmap_file(iomap &map){}
+
     } //io namespace
 
 } //snow namespace
@@ -22,8 +22,14 @@
 #include "common/snow_hx.h"
 #include "snow_hx_bindings.h"
 #include "snow_core.h"
+#include "snow_render.h"
+#include "snow_window.h"
 
 #include "render/opengl/snow_opengl.h"
+#include "render/opengl/snow_opengl_commands.h"
+#include "render/opengl/snow_opengl_state.h"
+#include "render/opengl/snow_opengl_stream.h"
+#include "render/opengl/snow_opengl_locations.h"
 
 #include <string>
 
@@ -51,6 +57,9 @@ namespace snow {
                 false, false
             );
 
+                //a new context, nothing the state shadow knew applies to it
+            gl_state_invalidate();
+
         } //set_context_attributes
 
     }
@@ -63,6 +72,8 @@ namespace snow {
 
     value snow_gl_get_error() {
 
+        snow::render::Render_thread_sync sync;
+
         return alloc_int( glGetError() );
 
     } DEFINE_PRIM(snow_gl_get_error,0);
@@ -70,6 +81,8 @@ namespace snow {
 
     value snow_gl_finish() {
 
+        snow::render::Render_thread_sync sync;
+
         glFinish();
 
         return alloc_null();
@@ -107,7 +120,7 @@ namespace snow {
 
     value snow_gl_enable(value inCap) {
 
-        glEnable(val_int(inCap));
+        snow::render::gl_state_enable(val_int(inCap), true);
 
         return alloc_null();
 
@@ -116,7 +129,7 @@ namespace snow {
 
     value snow_gl_disable(value inCap) {
 
-        glDisable(val_int(inCap));
+        snow::render::gl_state_enable(val_int(inCap), false);
 
         return alloc_null();
 
@@ -220,7 +233,7 @@ namespace snow {
 
     value snow_gl_front_face(value inFace) {
 
-        glFrontFace(val_int(inFace));
+        snow::render::gl_state_front_face(val_int(inFace));
 
         return alloc_null();
 
@@ -520,7 +533,7 @@ namespace snow {
 
     value snow_gl_blend_equation(value mode) {
 
-        glBlendEquation(val_int(mode));
+        snow::render::gl_state_blend_equation(val_int(mode));
 
         return alloc_null();
 
@@ -529,7 +542,7 @@ namespace snow {
 
     value snow_gl_blend_equation_separate(value rgb, value a) {
 
-        glBlendEquationSeparate(val_int(rgb), val_int(a));
+        snow::render::gl_state_blend_equation_separate(val_int(rgb), val_int(a));
 
         return alloc_null();
 
@@ -538,7 +551,7 @@ namespace snow {
 
     value snow_gl_blend_func(value s, value d) {
 
-        glBlendFunc(val_int(s), val_int(d));
+        snow::render::gl_state_blend_func(val_int(s), val_int(d));
 
         return alloc_null();
 
@@ -547,7 +560,7 @@ namespace snow {
 
     value snow_gl_blend_func_separate(value srgb, value drgb, value sa, value da) {
 
-        glBlendFuncSeparate(val_int(srgb), val_int(drgb), val_int(sa), val_int(da) );
+        snow::render::gl_state_blend_func_separate(val_int(srgb), val_int(drgb), val_int(sa), val_int(da) );
 
         return alloc_null();
 
@@ -572,6 +585,9 @@ namespace snow {
 
         glLinkProgram(id);
 
+            //a relink can move every location, read them again
+        snow::render::gl_locations_build(id);
+
         return alloc_null();
 
     } DEFINE_PRIM(snow_gl_link_program,1);
@@ -604,7 +620,8 @@ namespace snow {
 
         int id = val_int(inId);
 
-        glDeleteProgram(id);
+        snow::render::gl_locations_forget(id);
+        snow::render::gl_state_delete_program(id);
 
         return alloc_null();
 
@@ -641,6 +658,33 @@ namespace snow {
     } DEFINE_PRIM(snow_gl_get_uniform_location,2);
 
 
+// --- Location cache, not official api -------------------------------------------
+
+
+        //the id to look a uniform or attribute name up by, see the _id variants below
+    value snow_gl_intern_name(value inName) {
+
+        return alloc_int( snow::render::gl_name_intern(val_string(inName)) );
+
+    } DEFINE_PRIM(snow_gl_intern_name,1);
+
+
+    value snow_gl_get_attrib_location_id(value inId,value inName) {
+
+        return alloc_int( snow::render::gl_attrib_location(val_int(inId), val_int(inName)) );
+
+    } DEFINE_PRIM(snow_gl_get_attrib_location_id,2);
+
+
+    value snow_gl_get_uniform_location_id(value inId,value inName) {
+
+        int location = snow::render::gl_uniform_location(val_int(inId), val_int(inName));
+
+        return location < 0 ? alloc_null() : alloc_int(location);
+
+    } DEFINE_PRIM(snow_gl_get_uniform_location_id,2);
+
+
     value snow_gl_get_uniform(value inId,value inLocation) {
 
         int id = val_int(inId);
@@ -761,7 +805,7 @@ namespace snow {
 
         int id = val_int(inId);
 
-        glUseProgram(id);
+        snow::render::gl_state_use_program(id);
 
         return alloc_null();
 
@@ -1252,7 +1296,7 @@ namespace snow {
 
         GLuint id = val_int(inId);
 
-        glDeleteBuffers(1,&id);
+        snow::render::gl_state_delete_buffer(id);
 
         return alloc_null();
 
@@ -1261,7 +1305,7 @@ namespace snow {
 
     value snow_gl_bind_buffer(value inTarget, value inId ) {
 
-        glBindBuffer(val_int(inTarget),val_int(inId));
+        snow::render::gl_state_bind_buffer(val_int(inTarget),val_int(inId));
 
         return alloc_null();
 
@@ -1571,7 +1615,7 @@ namespace snow {
 
     value snow_gl_viewport(value inX, value inY, value inW,value inH) {
 
-        glViewport(val_int(inX),val_int(inY),val_int(inW),val_int(inH));
+        snow::render::gl_state_viewport(val_int(inX),val_int(inY),val_int(inW),val_int(inH));
 
         return alloc_null();
 
@@ -1638,7 +1682,7 @@ namespace snow {
 
     value snow_gl_depth_func(value func) {
 
-        glDepthFunc(val_int(func));
+        snow::render::gl_state_depth_func(val_int(func));
 
         return alloc_null();
 
@@ -1647,7 +1691,7 @@ namespace snow {
 
     value snow_gl_depth_mask(value mask) {
 
-        glDepthMask(val_bool(mask));
+        snow::render::gl_state_depth_mask(val_bool(mask));
 
         return alloc_null();
 
@@ -1669,7 +1713,7 @@ namespace snow {
 
     value snow_gl_cull_face(value mode) {
 
-        glCullFace(val_int(mode));
+        snow::render::gl_state_cull_face(val_int(mode));
 
         return alloc_null();
 
@@ -1689,6 +1733,9 @@ namespace snow {
 
         enum { aX, aY, aWidth, aHeight, aFormat, aType, aBytes, aByteOffset, aByteLength };
 
+            //a readback is a sync point, the frames handed to the render thread are drawn first
+        snow::render::Render_thread_sync sync;
+
         int byteOffset = val_int(arg[aByteOffset]);
         int byteLength = val_int(arg[aByteLength]);
         unsigned char* data = snow::bytes_from_hx_rw(arg[aBytes]);
@@ -1742,7 +1789,7 @@ namespace snow {
 
     value snow_gl_active_texture(value inSlot) {
 
-        glActiveTexture( val_int(inSlot) );
+        snow::render::gl_state_active_texture( val_int(inSlot) );
 
         return alloc_null();
 
@@ -1752,7 +1799,7 @@ namespace snow {
     value snow_gl_delete_texture(value inId) {
 
         GLuint id = val_int(inId);
-        glDeleteTextures(1,&id);
+        snow::render::gl_state_delete_texture(id);
 
         return alloc_null();
 
@@ -1761,7 +1808,7 @@ namespace snow {
 
     value snow_gl_bind_texture(value inTarget, value inTexture) {
 
-        glBindTexture(val_int(inTarget), val_int(inTexture) );
+        snow::render::gl_state_bind_texture(val_int(inTarget), val_int(inTexture) );
 
         return alloc_null();
 
@@ -1937,6 +1984,261 @@ namespace snow {
     } DEFINE_PRIM(snow_gl_get_tex_parameter,2);
 
 
+// --- Command buffer, not official api -------------------------------------------
+
+
+        //issue a recorded stream of commands in one call, see snow_opengl_commands.h.
+        //the offsets and lengths are in bytes, the float stream can be null when nothing uses it
+    value snow_gl_execute(value *arg, int argCount) {
+
+        enum { aInts, aIntOffset, aIntLength, aFloats, aFloatOffset, aFloatLength, aCount };
+
+        if(val_is_null(arg[aInts])) {
+            return alloc_int(0);
+        }
+
+        const int* ints = (const int*)(snow::bytes_from_hx(arg[aInts]) + val_int(arg[aIntOffset]));
+        int int_count = val_int(arg[aIntLength]) / sizeof(int);
+
+        const float* floats = 0;
+        int float_count = 0;
+
+        if(!val_is_null(arg[aFloats])) {
+            floats = (const float*)(snow::bytes_from_hx(arg[aFloats]) + val_int(arg[aFloatOffset]));
+            float_count = val_int(arg[aFloatLength]) / sizeof(float);
+        }
+
+            //issued from here, rather than handed to the render thread, so it needs the context
+        snow::render::Render_thread_sync sync;
+
+        int done = snow::render::gl_execute( ints, int_count, floats, float_count, val_int(arg[aCount]) );
+
+        return alloc_int(done);
+
+    } DEFINE_PRIM_MULT(snow_gl_execute);
+
+
+// --- State shadow, not official api -------------------------------------------
+
+
+    value snow_gl_state_cache(value enable) {
+
+        snow::render::gl_state_cache_enable( val_bool(enable) );
+
+        return alloc_null();
+
+    } DEFINE_PRIM(snow_gl_state_cache,1);
+
+
+    value snow_gl_state_cache_enabled() {
+
+        return alloc_bool( snow::render::gl_state_cache_enabled() );
+
+    } DEFINE_PRIM(snow_gl_state_cache_enabled,0);
+
+
+        //for after gl was used around the bindings, by other native code or the direct externs
+    value snow_gl_state_invalidate() {
+
+        snow::render::gl_state_invalidate();
+
+        return alloc_null();
+
+    } DEFINE_PRIM(snow_gl_state_invalidate,0);
+
+
+        //[issued, skipped] of the last frame
+    value snow_gl_state_counters() {
+
+        int issued = 0;
+        int skipped = 0;
+
+        snow::render::gl_state_counters(&issued, &skipped);
+
+        value result = alloc_array(2);
+
+        val_array_set_i(result, 0, alloc_int( issued ));
+        val_array_set_i(result, 1, alloc_int( skipped ));
+
+        return result;
+
+    } DEFINE_PRIM(snow_gl_state_counters,0);
+
+
+// --- Stream buffers, not official api -------------------------------------------
+
+        //stream buffers call gl as they go, and their fences have to follow the draws from them,
+        //so while a render thread runs they only work with the context acquired, and draw directly
+    static bool gl_stream_context( const char* call ) {
+
+        if(snow::render::render_thread_active() && !snow::render::render_thread_acquired()) {
+            snow::log(1, "snow / gl stream %s while the render thread has the context, acquire it first", call);
+            return false;
+        }
+
+        return true;
+
+    } //gl_stream_context
+
+
+    value snow_gl_stream_create(value target, value size, value usage) {
+
+        if(!gl_stream_context("create")) {
+            return alloc_null();
+        }
+
+        snow::render::GL_stream_buffer* stream = snow::render::gl_stream_create( val_int(target), val_int(size), val_int(usage) );
+
+        if(!stream) {
+            return alloc_null();
+        }
+
+        return snow::to_hx<snow::render::GL_stream_buffer>( stream );
+
+    } DEFINE_PRIM(snow_gl_stream_create,3);
+
+
+        //false if it couldn't be destroyed yet, see gl_stream_context
+    value snow_gl_stream_destroy(value stream) {
+
+        if(!gl_stream_context("destroy")) {
+            return alloc_bool(false);
+        }
+
+        snow::render::gl_stream_destroy( snow::from_hx<snow::render::GL_stream_buffer>(stream) );
+
+        return alloc_bool(true);
+
+    } DEFINE_PRIM(snow_gl_stream_destroy,1);
+
+
+    value snow_gl_stream_buffer(value stream) {
+
+        return alloc_int( snow::from_hx<snow::render::GL_stream_buffer>(stream)->buffer );
+
+    } DEFINE_PRIM(snow_gl_stream_buffer,1);
+
+
+        //returns the byte offset in the gl buffer the bytes went to, -1 if they didn't
+    value snow_gl_stream_write(value stream, value bytes, value byteOffset, value byteLength) {
+
+        if(val_is_null(bytes) || !gl_stream_context("write")) {
+            return alloc_int(-1);
+        }
+
+        int _offset = val_int(byteOffset);
+        int _length = val_int(byteLength);
+
+        if(_offset < 0 || _length < 0 || _offset > snow::bytes_length_hx(bytes) - _length) {
+            snow::log(1, "snow / gl stream write of %d bytes at %d is outside the %d bytes given", _length, _offset, snow::bytes_length_hx(bytes));
+            return alloc_int(-1);
+        }
+
+        const unsigned char* data = snow::bytes_from_hx(bytes) + _offset;
+
+        int at = snow::render::gl_stream_write( snow::from_hx<snow::render::GL_stream_buffer>(stream), data, _length );
+
+        return alloc_int(at);
+
+    } DEFINE_PRIM(snow_gl_stream_write,4);
+
+
+        //false if the fence couldn't be placed, see gl_stream_context
+    value snow_gl_stream_next(value stream) {
+
+        if(!gl_stream_context("next")) {
+            return alloc_bool(false);
+        }
+
+        snow::render::gl_stream_next( snow::from_hx<snow::render::GL_stream_buffer>(stream) );
+
+        return alloc_bool(true);
+
+    } DEFINE_PRIM(snow_gl_stream_next,1);
+
+
+// --- Render thread, not official api -------------------------------------------
+
+
+    value snow_gl_render_thread_start(value _window) {
+
+        snow::window::Window* window = snow::from_hx<snow::window::Window>(_window);
+
+        return alloc_bool( snow::render::render_thread_start(window) );
+
+    } DEFINE_PRIM(snow_gl_render_thread_start,1);
+
+
+    value snow_gl_render_thread_stop() {
+
+        snow::render::render_thread_stop();
+
+        return alloc_null();
+
+    } DEFINE_PRIM(snow_gl_render_thread_stop,0);
+
+
+    value snow_gl_render_thread_active() {
+
+        return alloc_bool( snow::render::render_thread_active() );
+
+    } DEFINE_PRIM(snow_gl_render_thread_active,0);
+
+
+        //the same streams as snow_gl_execute, copied for the render thread to draw, swapping after when asked
+    value snow_gl_render_thread_submit(value *arg, int argCount) {
+
+        enum { aInts, aIntOffset, aIntLength, aFloats, aFloatOffset, aFloatLength, aCount, aSwap };
+
+        if(val_is_null(arg[aInts])) {
+            return alloc_null();
+        }
+
+        const int* ints = (const int*)(snow::bytes_from_hx(arg[aInts]) + val_int(arg[aIntOffset]));
+        int int_count = val_int(arg[aIntLength]) / sizeof(int);
+
+        const float* floats = 0;
+        int float_count = 0;
+
+        if(!val_is_null(arg[aFloats])) {
+            floats = (const float*)(snow::bytes_from_hx(arg[aFloats]) + val_int(arg[aFloatOffset]));
+            float_count = val_int(arg[aFloatLength]) / sizeof(float);
+        }
+
+        snow::render::render_thread_submit( ints, int_count, floats, float_count, val_int(arg[aCount]), val_bool(arg[aSwap]) );
+
+        return alloc_null();
+
+    } DEFINE_PRIM_MULT(snow_gl_render_thread_submit);
+
+
+    value snow_gl_render_thread_finish() {
+
+        snow::render::render_thread_finish();
+
+        return alloc_null();
+
+    } DEFINE_PRIM(snow_gl_render_thread_finish,0);
+
+
+    value snow_gl_render_thread_acquire() {
+
+        snow::render::render_thread_acquire();
+
+        return alloc_null();
+
+    } DEFINE_PRIM(snow_gl_render_thread_acquire,0);
+
+
+    value snow_gl_render_thread_release() {
+
+        snow::render::render_thread_release();
+
+        return alloc_null();
+
+    } DEFINE_PRIM(snow_gl_render_thread_release,0);
+
+
 } //snow namespace
 
 
@@ -0,0 +1,285 @@
+/*
+    Copyright Sven Bergström 2014
+    created for snow https://github.com/underscorediscovery/snow
+    MIT license
+*/
+
+#include "snow_core.h"
+
+#include "render/opengl/snow_opengl.h"
+#include "render/opengl/snow_opengl_commands.h"
+#include "render/opengl/snow_opengl_state.h"
+
+#include <stdint.h>
+
+#ifdef NATIVE_TOOLKIT_GLEW
+    #define HAS_EXT_framebuffer_object GLEW_EXT_framebuffer_object
+#else
+    #define HAS_EXT_framebuffer_object true
+#endif
+
+namespace snow {
+
+    namespace render {
+
+            //the fixed arguments of each command, after the opcode.
+            //the array commands list only their leading ints, the elements are checked when read
+        struct GL_command_size {
+            int ints;
+            int floats;
+        };
+
+        static const GL_command_size command_sizes[glc_count] = {
+
+            { 0, 0 },   //0 is never a command
+
+            { 1, 0 },   //glc_enable
+            { 1, 0 },   //glc_disable
+            { 4, 0 },   //glc_viewport
+            { 4, 0 },   //glc_scissor
+            { 1, 0 },   //glc_clear
+            { 0, 4 },   //glc_clear_color
+            { 0, 1 },   //glc_clear_depth
+            { 1, 0 },   //glc_clear_stencil
+            { 4, 0 },   //glc_color_mask
+            { 1, 0 },   //glc_depth_func
+            { 1, 0 },   //glc_depth_mask
+            { 1, 0 },   //glc_cull_face
+            { 1, 0 },   //glc_front_face
+            { 2, 0 },   //glc_blend_func
+            { 4, 0 },   //glc_blend_func_separate
+            { 1, 0 },   //glc_blend_equation
+            { 2, 0 },   //glc_blend_equation_separate
+            { 0, 4 },   //glc_blend_color
+            { 3, 0 },   //glc_stencil_func
+            { 3, 0 },   //glc_stencil_op
+            { 1, 0 },   //glc_stencil_mask
+            { 0, 1 },   //glc_line_width
+            { 0, 2 },   //glc_polygon_offset
+            { 1, 0 },   //glc_use_program
+            { 2, 0 },   //glc_bind_buffer
+            { 2, 0 },   //glc_bind_framebuffer
+            { 2, 0 },   //glc_bind_renderbuffer
+            { 1, 0 },   //glc_active_texture
+            { 2, 0 },   //glc_bind_texture
+            { 3, 0 },   //glc_tex_parameteri
+            { 2, 0 },   //glc_pixel_storei
+            { 1, 0 },   //glc_enable_vertex_attrib_array
+            { 1, 0 },   //glc_disable_vertex_attrib_array
+            { 6, 0 },   //glc_vertex_attrib_pointer
+            { 2, 0 },   //glc_uniform1i
+            { 3, 0 },   //glc_uniform2i
+            { 4, 0 },   //glc_uniform3i
+            { 5, 0 },   //glc_uniform4i
+            { 1, 1 },   //glc_uniform1f
+            { 1, 2 },   //glc_uniform2f
+            { 1, 3 },   //glc_uniform3f
+            { 1, 4 },   //glc_uniform4f
+            { 3, 0 },   //glc_uniform_iv
+            { 3, 0 },   //glc_uniform_fv
+            { 4, 0 },   //glc_uniform_matrix
+            { 3, 0 },   //glc_draw_arrays
+            { 4, 0 }    //glc_draw_elements
+
+        }; //command_sizes
+
+        int gl_execute( const int* ints, int int_count, const float* floats, int float_count, int count ) {
+
+            int i = 0;
+            int f = 0;
+            int done = 0;
+
+            while(done < count) {
+
+                if(i >= int_count) {
+                    snow::log(1, "/ snow / gl command %d of %d is past the end of the int stream", done, count);
+                    break;
+                }
+
+                int op = ints[i];
+
+                if(op <= 0 || op >= glc_count) {
+                    snow::log(1, "/ snow / unknown gl command %d at %d, %d of %d issued", op, i, done, count);
+                    break;
+                }
+
+                const GL_command_size &size = command_sizes[op];
+
+                if(i + 1 + size.ints > int_count || f + size.floats > float_count) {
+                    snow::log(1, "/ snow / gl command %d at %d runs past the end of the streams, %d of %d issued", op, i, done, count);
+                    break;
+                }
+
+                const int* a = ints + i + 1;
+                const float* v = floats + f;
+
+                i += 1 + size.ints;
+                f += size.floats;
+
+                switch(op) {
+
+                    case glc_enable:                        gl_state_enable(a[0], true); break;
+                    case glc_disable:                       gl_state_enable(a[0], false); break;
+                    case glc_viewport:                      gl_state_viewport(a[0], a[1], a[2], a[3]); break;
+                    case glc_scissor:                       glScissor(a[0], a[1], a[2], a[3]); break;
+                    case glc_clear:                         glClear(a[0]); break;
+                    case glc_clear_color:                   glClearColor(v[0], v[1], v[2], v[3]); break;
+                    case glc_clear_stencil:                 glClearStencil(a[0]); break;
+                    case glc_color_mask:                    glColorMask(a[0] != 0, a[1] != 0, a[2] != 0, a[3] != 0); break;
+                    case glc_depth_func:                    gl_state_depth_func(a[0]); break;
+                    case glc_depth_mask:                    gl_state_depth_mask(a[0] != 0); break;
+                    case glc_cull_face:                     gl_state_cull_face(a[0]); break;
+                    case glc_front_face:                    gl_state_front_face(a[0]); break;
+                    case glc_blend_func:                    gl_state_blend_func(a[0], a[1]); break;
+                    case glc_blend_func_separate:           gl_state_blend_func_separate(a[0], a[1], a[2], a[3]); break;
+                    case glc_blend_equation:                gl_state_blend_equation(a[0]); break;
+                    case glc_blend_equation_separate:       gl_state_blend_equation_separate(a[0], a[1]); break;
+                    case glc_blend_color:                   glBlendColor(v[0], v[1], v[2], v[3]); break;
+                    case glc_stencil_func:                  glStencilFunc(a[0], a[1], a[2]); break;
+                    case glc_stencil_op:                    glStencilOp(a[0], a[1], a[2]); break;
+                    case glc_stencil_mask:                  glStencilMask(a[0]); break;
+                    case glc_line_width:                    glLineWidth(v[0]); break;
+                    case glc_polygon_offset:                glPolygonOffset(v[0], v[1]); break;
+                    case glc_use_program:                   gl_state_use_program(a[0]); break;
+                    case glc_bind_buffer:                   gl_state_bind_buffer(a[0], a[1]); break;
+                    case glc_active_texture:                gl_state_active_texture(a[0]); break;
+                    case glc_bind_texture:                  gl_state_bind_texture(a[0], a[1]); break;
+                    case glc_tex_parameteri:                glTexParameteri(a[0], a[1], a[2]); break;
+                    case glc_pixel_storei:                  glPixelStorei(a[0], a[1]); break;
+                    case glc_enable_vertex_attrib_array:    glEnableVertexAttribArray(a[0]); break;
+                    case glc_disable_vertex_attrib_array:   glDisableVertexAttribArray(a[0]); break;
+                    case glc_uniform1i:                     glUniform1i(a[0], a[1]); break;
+                    case glc_uniform2i:                     glUniform2i(a[0], a[1], a[2]); break;
+                    case glc_uniform3i:                     glUniform3i(a[0], a[1], a[2], a[3]); break;
+                    case glc_uniform4i:                     glUniform4i(a[0], a[1], a[2], a[3], a[4]); break;
+                    case glc_uniform1f:                     glUniform1f(a[0], v[0]); break;
+                    case glc_uniform2f:                     glUniform2f(a[0], v[0], v[1]); break;
+                    case glc_uniform3f:                     glUniform3f(a[0], v[0], v[1], v[2]); break;
+                    case glc_uniform4f:                     glUniform4f(a[0], v[0], v[1], v[2], v[3]); break;
+                    case glc_draw_arrays:                   glDrawArrays(a[0], a[1], a[2]); break;
+
+                    case glc_clear_depth: {
+
+                        #ifdef SNOW_GLES
+                            glClearDepthf(v[0]);
+                        #else
+                            glClearDepth(v[0]);
+                        #endif
+
+                        break;
+
+                    } //glc_clear_depth
+
+                    case glc_bind_framebuffer: {
+
+                        if(HAS_EXT_framebuffer_object) {
+                            glBindFramebuffer(a[0], a[1]);
+                        }
+
+                        break;
+
+                    } //glc_bind_framebuffer
+
+                    case glc_bind_renderbuffer: {
+
+                        if(HAS_EXT_framebuffer_object) {
+                            glBindRenderbuffer(a[0], a[1]);
+                        }
+
+                        break;
+
+                    } //glc_bind_renderbuffer
+
+                    case glc_vertex_attrib_pointer: {
+
+                        glVertexAttribPointer(a[0], a[1], a[2], a[3] != 0, a[4], (void *)(intptr_t)a[5]);
+
+                        break;
+
+                    } //glc_vertex_attrib_pointer
+
+                    case glc_draw_elements: {
+
+                        glDrawElements(a[0], a[1], a[2], (void *)(intptr_t)a[3]);
+
+                        break;
+
+                    } //glc_draw_elements
+
+                        //the array commands, the elements follow in their stream.
+                        //the count is checked against what's left of the stream before it's multiplied out,
+                        //so a bad one can't overflow past the check
+
+                    case glc_uniform_iv: {
+
+                        if(a[1] < 1 || a[1] > 4 || a[2] < 0 || a[2] > (int_count - i) / a[1]) {
+                            snow::log(1, "/ snow / gl command uniform_iv at %d has a bad size, %d of %d issued", i, done, count);
+                            return done;
+                        }
+
+                        const GLint* data = ints + i;
+                        i += a[1] * a[2];
+
+                        switch(a[1]) {
+                            case 1: glUniform1iv(a[0], a[2], data); break;
+                            case 2: glUniform2iv(a[0], a[2], data); break;
+                            case 3: glUniform3iv(a[0], a[2], data); break;
+                            case 4: glUniform4iv(a[0], a[2], data); break;
+                        }
+
+                        break;
+
+                    } //glc_uniform_iv
+
+                    case glc_uniform_fv: {
+
+                        if(a[1] < 1 || a[1] > 4 || a[2] < 0 || a[2] > (float_count - f) / a[1]) {
+                            snow::log(1, "/ snow / gl command uniform_fv at %d has a bad size, %d of %d issued", i, done, count);
+                            return done;
+                        }
+
+                        f += a[1] * a[2];
+
+                        switch(a[1]) {
+                            case 1: glUniform1fv(a[0], a[2], v); break;
+                            case 2: glUniform2fv(a[0], a[2], v); break;
+                            case 3: glUniform3fv(a[0], a[2], v); break;
+                            case 4: glUniform4fv(a[0], a[2], v); break;
+                        }
+
+                        break;
+
+                    } //glc_uniform_fv
+
+                    case glc_uniform_matrix: {
+
+                        if(a[2] < 2 || a[2] > 4 || a[3] < 0 || a[3] > (float_count - f) / (a[2] * a[2])) {
+                            snow::log(1, "/ snow / gl command uniform_matrix at %d has a bad size, %d of %d issued", i, done, count);
+                            return done;
+                        }
+
+                        f += a[2] * a[2] * a[3];
+
+                        switch(a[2]) {
+                            case 2: glUniformMatrix2fv(a[0], a[3], a[1] != 0, v); break;
+                            case 3: glUniformMatrix3fv(a[0], a[3], a[1] != 0, v); break;
+                            case 4: glUniformMatrix4fv(a[0], a[3], a[1] != 0, v); break;
+                        }
+
+                        break;
+
+                    } //glc_uniform_matrix
+
+                } //switch op
+
+                ++done;
+
+            } //while done < count
+
+            return done;
+
+        } //gl_execute
+
+    } //render namespace
+
+} //snow namespace
@@ -0,0 +1,184 @@
+/*
+    Copyright Sven Bergström 2014
+    created for snow https://github.com/underscorediscovery/snow
+    MIT license
+*/
+
+#include "snow_core.h"
+
+#include "render/opengl/snow_opengl.h"
+#include "render/opengl/snow_opengl_locations.h"
+
+#include <stdio.h> //sprintf
+#include <map>
+#include <string>
+#include <vector>
+
+namespace snow {
+
+    namespace render {
+
+            //the locations of one program, indexed by name id, -1 where it has none
+        struct GL_program_locations {
+
+            std::vector<GLint> uniforms;
+            std::vector<GLint> attribs;
+
+        }; //GL_program_locations
+
+        static std::map<std::string, int> names;
+        static std::map<GLuint, GL_program_locations> programs;
+
+        int gl_name_intern( const char* name ) {
+
+            std::map<std::string, int>::iterator found = names.find(name);
+
+            if(found != names.end()) {
+                return found->second;
+            }
+
+            int id = (int)names.size();
+            names[name] = id;
+
+            return id;
+
+        } //gl_name_intern
+
+        static void locations_set( std::vector<GLint> &table, const std::string &name, GLint location ) {
+
+            int id = gl_name_intern(name.c_str());
+
+            if(id >= (int)table.size()) {
+                table.resize(id + 1, -1);
+            }
+
+            table[id] = location;
+
+        } //locations_set
+
+        void gl_locations_build( GLuint program ) {
+
+            GL_program_locations &locations = programs[program];
+
+            locations.uniforms.clear();
+            locations.attribs.clear();
+
+            GLint linked = 0;
+            glGetProgramiv(program, GL_LINK_STATUS, &linked);
+
+            if(!linked) {
+                return;
+            }
+
+            GLint count = 0;
+            GLint length = 0;
+
+            glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &length);
+            std::vector<char> buffer(length > 0 ? length + 1 : 256);
+
+            glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+
+            for(int i = 0; i < count; ++i) {
+
+                GLint size = 0;
+                GLenum type = 0;
+
+                glGetActiveUniform(program, i, (GLsizei)buffer.size(), NULL, &size, &type, &buffer[0]);
+
+                std::string name(&buffer[0]);
+
+                    //the reported name is always found, as is. arrays come back as `name[0]`,
+                    //they're found by `name` as well as each element. only a trailing [0] marks one,
+                    //`lights[0].color` is a member of an array of structs and is reported per element
+                locations_set(locations.uniforms, name, glGetUniformLocation(program, name.c_str()));
+
+                std::string::size_type suffix = name.size() >= 3 ? name.size() - 3 : std::string::npos;
+
+                if(suffix != std::string::npos && name.compare(suffix, 3, "[0]") == 0) {
+
+                    std::string base = name.substr(0, suffix);
+
+                    locations_set(locations.uniforms, base, glGetUniformLocation(program, base.c_str()));
+
+                    char index[16];
+
+                    for(int e = 1; e < size; ++e) {
+                        sprintf(index, "[%d]", e);
+                        std::string element = base + index;
+                        locations_set(locations.uniforms, element, glGetUniformLocation(program, element.c_str()));
+                    }
+
+                } //array
+
+            } //each uniform
+
+            glGetProgramiv(program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &length);
+            buffer.resize(length > 0 ? length + 1 : 256);
+
+            glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &count);
+
+            for(int i = 0; i < count; ++i) {
+
+                GLint size = 0;
+                GLenum type = 0;
+
+                glGetActiveAttrib(program, i, (GLsizei)buffer.size(), NULL, &size, &type, &buffer[0]);
+
+                locations_set(locations.attribs, &buffer[0], glGetAttribLocation(program, &buffer[0]));
+
+            } //each attribute
+
+        } //gl_locations_build
+
+        void gl_locations_forget( GLuint program ) {
+
+            programs.erase(program);
+
+        } //gl_locations_forget
+
+        static GL_program_locations* locations_of( GLuint program ) {
+
+            std::map<GLuint, GL_program_locations>::iterator found = programs.find(program);
+
+            if(found != programs.end()) {
+                return &found->second;
+            }
+
+                //linked around the bindings, read it now
+            if(!glIsProgram(program)) {
+                return NULL;
+            }
+
+            gl_locations_build(program);
+
+            return &programs[program];
+
+        } //locations_of
+
+        GLint gl_uniform_location( GLuint program, int name ) {
+
+            GL_program_locations* locations = locations_of(program);
+
+            if(!locations || name < 0 || name >= (int)locations->uniforms.size()) {
+                return -1;
+            }
+
+            return locations->uniforms[name];
+
+        } //gl_uniform_location
+
+        GLint gl_attrib_location( GLuint program, int name ) {
+
+            GL_program_locations* locations = locations_of(program);
+
+            if(!locations || name < 0 || name >= (int)locations->attribs.size()) {
+                return -1;
+            }
+
+            return locations->attribs[name];
+
+        } //gl_attrib_location
+
+    } //render namespace
+
+} //snow namespace
@@ -0,0 +1,410 @@
+/*
+    Copyright Sven Bergström 2014
+    created for snow https://github.com/underscorediscovery/snow
+    MIT license
+*/
+
+#include "snow_core.h"
+
+#include "render/opengl/snow_opengl.h"
+#include "render/opengl/snow_opengl_state.h"
+
+#include <atomic>
+
+namespace snow {
+
+    namespace render {
+
+            //a value gl never has, for the state the shadow doesn't know
+        static const GLuint gl_unknown = 0xFFFFFFFF;
+
+        enum {
+            state_cap_count         = 9,
+            state_buffer_count      = 2,
+            state_texture_count     = 2,
+            state_unit_count        = 32
+        };
+
+            //the tracked ones, anything else passes through
+        static const GLenum state_caps[state_cap_count] = {
+            GL_BLEND, GL_CULL_FACE, GL_DEPTH_TEST, GL_SCISSOR_TEST, GL_STENCIL_TEST,
+            GL_POLYGON_OFFSET_FILL, GL_DITHER, GL_SAMPLE_ALPHA_TO_COVERAGE, GL_SAMPLE_COVERAGE
+        };
+
+        static const GLenum state_buffers[state_buffer_count] = { GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER };
+        static const GLenum state_textures[state_texture_count] = { GL_TEXTURE_2D, GL_TEXTURE_CUBE_MAP };
+
+        struct GL_state {
+
+            bool        enabled;
+
+            GLuint      caps[state_cap_count];
+            GLuint      program;
+            GLuint      buffers[state_buffer_count];
+                //the active unit as an index from GL_TEXTURE0
+            GLuint      unit;
+            GLuint      textures[state_unit_count][state_texture_count];
+
+            GLuint      blend_src_rgb;
+            GLuint      blend_dst_rgb;
+            GLuint      blend_src_alpha;
+            GLuint      blend_dst_alpha;
+            GLuint      blend_mode_rgb;
+            GLuint      blend_mode_alpha;
+
+            GLuint      depth_func;
+            GLuint      depth_mask;
+            GLuint      cull_face;
+            GLuint      front_face;
+
+            bool        viewport_known;
+            GLint       viewport[4];
+
+                //this frame, and the last one, which can be read from another thread
+            int                 issued;
+            int                 skipped;
+            std::atomic<int>    frame_issued;
+            std::atomic<int>    frame_skipped;
+
+            GL_state() : enabled(false), issued(0), skipped(0), frame_issued(0), frame_skipped(0) {}
+
+        }; //GL_state
+
+        static GL_state state;
+
+        static int cap_index( GLenum cap ) {
+
+            for(int i = 0; i < state_cap_count; ++i) {
+                if(state_caps[i] == cap) return i;
+            }
+
+            return -1;
+
+        } //cap_index
+
+        static int buffer_index( GLenum target ) {
+
+            for(int i = 0; i < state_buffer_count; ++i) {
+                if(state_buffers[i] == target) return i;
+            }
+
+            return -1;
+
+        } //buffer_index
+
+        static int texture_index( GLenum target ) {
+
+            for(int i = 0; i < state_texture_count; ++i) {
+                if(state_textures[i] == target) return i;
+            }
+
+            return -1;
+
+        } //texture_index
+
+            //whether a call setting _current to _value can be dropped, counting it either way,
+            //and updating _current when it can't
+        static inline bool state_same( GLuint &_current, GLuint _value ) {
+
+            if(state.enabled && _current == _value) {
+                ++state.skipped;
+                return true;
+            }
+
+            ++state.issued;
+            _current = _value;
+
+            return false;
+
+        } //state_same
+
+        void gl_state_cache_enable( bool enable ) {
+
+            gl_state_invalidate();
+            state.enabled = enable;
+
+        } //gl_state_cache_enable
+
+        bool gl_state_cache_enabled() {
+
+            return state.enabled;
+
+        } //gl_state_cache_enabled
+
+        void gl_state_invalidate() {
+
+            for(int i = 0; i < state_cap_count; ++i) state.caps[i] = gl_unknown;
+            for(int i = 0; i < state_buffer_count; ++i) state.buffers[i] = gl_unknown;
+
+            for(int u = 0; u < state_unit_count; ++u) {
+                for(int i = 0; i < state_texture_count; ++i) {
+                    state.textures[u][i] = gl_unknown;
+                }
+            }
+
+            state.program = gl_unknown;
+            state.unit = gl_unknown;
+
+            state.blend_src_rgb = gl_unknown;
+            state.blend_dst_rgb = gl_unknown;
+            state.blend_src_alpha = gl_unknown;
+            state.blend_dst_alpha = gl_unknown;
+            state.blend_mode_rgb = gl_unknown;
+            state.blend_mode_alpha = gl_unknown;
+
+            state.depth_func = gl_unknown;
+            state.depth_mask = gl_unknown;
+            state.cull_face = gl_unknown;
+            state.front_face = gl_unknown;
+
+            state.viewport_known = false;
+
+        } //gl_state_invalidate
+
+        void gl_state_frame() {
+
+            state.frame_issued = state.issued;
+            state.frame_skipped = state.skipped;
+
+            state.issued = 0;
+            state.skipped = 0;
+
+        } //gl_state_frame
+
+        void gl_state_counters( int* issued, int* skipped ) {
+
+            *issued = state.frame_issued;
+            *skipped = state.frame_skipped;
+
+        } //gl_state_counters
+
+        void gl_state_enable( GLenum cap, bool enable ) {
+
+            int index = cap_index(cap);
+
+            if(index != -1) {
+                if(state_same(state.caps[index], enable ? 1 : 0)) return;
+            } else {
+                ++state.issued;
+            }
+
+            if(enable) {
+                glEnable(cap);
+            } else {
+                glDisable(cap);
+            }
+
+        } //gl_state_enable
+
+        void gl_state_use_program( GLuint program ) {
+
+            if(state_same(state.program, program)) return;
+
+            glUseProgram(program);
+
+        } //gl_state_use_program
+
+        void gl_state_bind_buffer( GLenum target, GLuint buffer ) {
+
+            int index = buffer_index(target);
+
+            if(index != -1) {
+                if(state_same(state.buffers[index], buffer)) return;
+            } else {
+                ++state.issued;
+            }
+
+            glBindBuffer(target, buffer);
+
+        } //gl_state_bind_buffer
+
+        void gl_state_active_texture( GLenum texture ) {
+
+            GLuint unit = texture - GL_TEXTURE0;
+
+                //a unit past the tracked ones makes the bindings unknown until the next known unit
+            if(unit >= state_unit_count) {
+                ++state.issued;
+                state.unit = gl_unknown;
+                glActiveTexture(texture);
+                return;
+            }
+
+            if(state_same(state.unit, unit)) return;
+
+            glActiveTexture(texture);
+
+        } //gl_state_active_texture
+
+        void gl_state_bind_texture( GLenum target, GLuint texture ) {
+
+            int index = texture_index(target);
+
+            if(index != -1 && state.unit < state_unit_count) {
+                if(state_same(state.textures[state.unit][index], texture)) return;
+            } else {
+                ++state.issued;
+            }
+
+            glBindTexture(target, texture);
+
+        } //gl_state_bind_texture
+
+        void gl_state_blend_func( GLenum src, GLenum dst ) {
+
+            if(state.enabled &&
+                state.blend_src_rgb == src && state.blend_dst_rgb == dst &&
+                state.blend_src_alpha == src && state.blend_dst_alpha == dst) {
+                ++state.skipped;
+                return;
+            }
+
+            ++state.issued;
+
+            state.blend_src_rgb = state.blend_src_alpha = src;
+            state.blend_dst_rgb = state.blend_dst_alpha = dst;
+
+            glBlendFunc(src, dst);
+
+        } //gl_state_blend_func
+
+        void gl_state_blend_func_separate( GLenum src_rgb, GLenum dst_rgb, GLenum src_alpha, GLenum dst_alpha ) {
+
+            if(state.enabled &&
+                state.blend_src_rgb == src_rgb && state.blend_dst_rgb == dst_rgb &&
+                state.blend_src_alpha == src_alpha && state.blend_dst_alpha == dst_alpha) {
+                ++state.skipped;
+                return;
+            }
+
+            ++state.issued;
+
+            state.blend_src_rgb = src_rgb;
+            state.blend_dst_rgb = dst_rgb;
+            state.blend_src_alpha = src_alpha;
+            state.blend_dst_alpha = dst_alpha;
+
+            glBlendFuncSeparate(src_rgb, dst_rgb, src_alpha, dst_alpha);
+
+        } //gl_state_blend_func_separate
+
+        void gl_state_blend_equation( GLenum mode ) {
+
+            if(state.enabled && state.blend_mode_rgb == mode && state.blend_mode_alpha == mode) {
+                ++state.skipped;
+                return;
+            }
+
+            ++state.issued;
+
+            state.blend_mode_rgb = state.blend_mode_alpha = mode;
+
+            glBlendEquation(mode);
+
+        } //gl_state_blend_equation
+
+        void gl_state_blend_equation_separate( GLenum mode_rgb, GLenum mode_alpha ) {
+
+            if(state.enabled && state.blend_mode_rgb == mode_rgb && state.blend_mode_alpha == mode_alpha) {
+                ++state.skipped;
+                return;
+            }
+
+            ++state.issued;
+
+            state.blend_mode_rgb = mode_rgb;
+            state.blend_mode_alpha = mode_alpha;
+
+            glBlendEquationSeparate(mode_rgb, mode_alpha);
+
+        } //gl_state_blend_equation_separate
+
+        void gl_state_depth_func( GLenum func ) {
+
+            if(state_same(state.depth_func, func)) return;
+
+            glDepthFunc(func);
+
+        } //gl_state_depth_func
+
+        void gl_state_depth_mask( bool flag ) {
+
+            if(state_same(state.depth_mask, flag ? 1 : 0)) return;
+
+            glDepthMask(flag);
+
+        } //gl_state_depth_mask
+
+        void gl_state_cull_face( GLenum mode ) {
+
+            if(state_same(state.cull_face, mode)) return;
+
+            glCullFace(mode);
+
+        } //gl_state_cull_face
+
+        void gl_state_front_face( GLenum mode ) {
+
+            if(state_same(state.front_face, mode)) return;
+
+            glFrontFace(mode);
+
+        } //gl_state_front_face
+
+        void gl_state_viewport( GLint x, GLint y, GLsizei width, GLsizei height ) {
+
+            if(state.enabled && state.viewport_known &&
+                state.viewport[0] == x && state.viewport[1] == y &&
+                state.viewport[2] == width && state.viewport[3] == height) {
+                ++state.skipped;
+                return;
+            }
+
+            ++state.issued;
+
+            state.viewport_known = true;
+            state.viewport[0] = x;
+            state.viewport[1] = y;
+            state.viewport[2] = width;
+            state.viewport[3] = height;
+
+            glViewport(x, y, width, height);
+
+        } //gl_state_viewport
+
+        void gl_state_delete_program( GLuint program ) {
+
+                //the current program stays in use until another is, so it's no longer known what is
+            if(state.program == program) {
+                state.program = gl_unknown;
+            }
+
+            glDeleteProgram(program);
+
+        } //gl_state_delete_program
+
+        void gl_state_delete_buffer( GLuint buffer ) {
+
+            for(int i = 0; i < state_buffer_count; ++i) {
+                if(state.buffers[i] == buffer) state.buffers[i] = 0;
+            }
+
+            glDeleteBuffers(1, &buffer);
+
+        } //gl_state_delete_buffer
+
+        void gl_state_delete_texture( GLuint texture ) {
+
+            for(int u = 0; u < state_unit_count; ++u) {
+                for(int i = 0; i < state_texture_count; ++i) {
+                    if(state.textures[u][i] == texture) state.textures[u][i] = 0;
+                }
+            }
+
+            glDeleteTextures(1, &texture);
+
+        } //gl_state_delete_texture
+
+    } //render namespace
+
+} //snow namespace
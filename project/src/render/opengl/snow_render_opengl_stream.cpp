@@ -0,0 +1,200 @@
+/*
+    Copyright Sven Bergström 2014
+    created for snow https://github.com/underscorediscovery/snow
+    MIT license
+*/
+
+#include "snow_core.h"
+
+#include "render/opengl/snow_opengl.h"
+#include "render/opengl/snow_opengl_state.h"
+#include "render/opengl/snow_opengl_stream.h"
+
+#include <string.h> //memcpy
+
+#if defined(SNOW_GLES)
+    #define HAS_map_buffer_range false
+#elif defined(NATIVE_TOOLKIT_GLEW)
+    #define HAS_map_buffer_range ((GLEW_VERSION_3_0 || GLEW_ARB_map_buffer_range) && (GLEW_VERSION_3_2 || GLEW_ARB_sync))
+#else
+    #define HAS_map_buffer_range true
+#endif
+
+namespace snow {
+
+    namespace render {
+
+            //where each write starts, so any vertex format can start at the offset returned
+        static const int stream_align = 16;
+
+        GL_stream_buffer* gl_stream_create( GLenum target, int size, GLenum usage ) {
+
+            if(size <= 0) {
+                snow::log(1, "/ snow / stream buffer size %d is invalid", size);
+                return NULL;
+            }
+
+            GL_stream_buffer* stream = new GL_stream_buffer();
+
+            stream->target = target;
+            stream->usage = usage;
+            stream->size = size;
+            stream->segment = 0;
+            stream->offset = 0;
+            stream->mapped = HAS_map_buffer_range;
+
+            for(int i = 0; i < gl_stream_segments; ++i) {
+                stream->fences[i] = 0;
+            }
+
+            glGenBuffers(1, &stream->buffer);
+
+            if(!stream->buffer) {
+                snow::log(1, "/ snow / stream buffer could not be created");
+                delete stream;
+                return NULL;
+            }
+
+                //the mapped ring holds all the segments, an orphaned buffer only ever needs one
+            gl_state_bind_buffer(target, stream->buffer);
+            glBufferData(target, stream->mapped ? size * gl_stream_segments : size, NULL, usage);
+
+            snow::log(3, "/ snow / stream buffer %d created, %d bytes a segment, %s",
+                stream->buffer, size, stream->mapped ? "mapped" : "orphaned");
+
+            return stream;
+
+        } //gl_stream_create
+
+        void gl_stream_destroy( GL_stream_buffer* stream ) {
+
+            if(!stream) {
+                return;
+            }
+
+            #ifndef SNOW_GLES
+                for(int i = 0; i < gl_stream_segments; ++i) {
+                    if(stream->fences[i]) {
+                        glDeleteSync(stream->fences[i]);
+                    }
+                }
+            #endif
+
+            gl_state_delete_buffer(stream->buffer);
+
+            delete stream;
+
+        } //gl_stream_destroy
+
+            //with the buffer bound. move on to fresh storage for the writes that follow
+        static void stream_advance( GL_stream_buffer* stream ) {
+
+            stream->offset = 0;
+
+            if(!stream->mapped) {
+
+                    //orphaned, the driver hands over new storage while the old drains
+                glBufferData(stream->target, stream->size, NULL, stream->usage);
+
+                return;
+
+            } //!mapped
+
+            #ifndef SNOW_GLES
+
+                    //the gpu is done with the segment just written once it passes this
+                stream->fences[stream->segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+                stream->segment = (stream->segment + 1) % gl_stream_segments;
+
+                GLsync fence = stream->fences[stream->segment];
+
+                if(fence) {
+
+                        //usually long signaled, the segment was drawn from frames ago
+                    GLenum result = glClientWaitSync(fence, 0, 0);
+
+                    if(result == GL_TIMEOUT_EXPIRED) {
+                        result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+                    }
+
+                    if(result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED) {
+                        snow::log(1, "/ snow / stream buffer %d waited too long for segment %d", stream->buffer, stream->segment);
+                    }
+
+                    glDeleteSync(fence);
+                    stream->fences[stream->segment] = 0;
+
+                } //fence
+
+            #endif //!SNOW_GLES
+
+        } //stream_advance
+
+        int gl_stream_write( GL_stream_buffer* stream, const unsigned char* bytes, int length ) {
+
+            if(!stream || !bytes || length <= 0) {
+                return -1;
+            }
+
+            if(length > stream->size) {
+                snow::log(1, "/ snow / stream buffer %d can't take %d bytes, its segments are %d", stream->buffer, length, stream->size);
+                return -1;
+            }
+
+            gl_state_bind_buffer(stream->target, stream->buffer);
+
+            if(stream->offset + length > stream->size) {
+                stream_advance(stream);
+            }
+
+            int at = stream->offset;
+
+            if(stream->mapped) {
+
+                #ifndef SNOW_GLES
+
+                    at += stream->segment * stream->size;
+
+                        //no one reads this range until the fence after it, so there's nothing to wait for
+                    void* dest = glMapBufferRange(stream->target, at, length,
+                        GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+
+                    if(!dest) {
+                        snow::log(1, "/ snow / stream buffer %d failed to map %d bytes at %d", stream->buffer, length, at);
+                        return -1;
+                    }
+
+                    memcpy(dest, bytes, length);
+
+                    glUnmapBuffer(stream->target);
+
+                #endif //!SNOW_GLES
+
+            } else {
+
+                glBufferSubData(stream->target, at, length, bytes);
+
+            } //!mapped
+
+            stream->offset += (length + stream_align - 1) & ~(stream_align - 1);
+
+            return at;
+
+        } //gl_stream_write
+
+        void gl_stream_next( GL_stream_buffer* stream ) {
+
+            if(!stream || stream->offset == 0) {
+                return;
+            }
+
+            gl_state_bind_buffer(stream->target, stream->buffer);
+
+            stream_advance(stream);
+
+        } //gl_stream_next
+
+    } //render namespace
+
+} //snow namespace
@@ -0,0 +1,353 @@
+/*
+    Copyright Sven Bergström 2014
+    created for snow https://github.com/underscorediscovery/snow
+    MIT license
+*/
+
+#include "snow_core.h"
+#include "snow_render.h"
+#include "snow_window.h"
+
+#include "render/opengl/snow_opengl.h"
+#include "render/opengl/snow_opengl_commands.h"
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace snow {
+
+    namespace render {
+
+        enum Render_slot_state {
+            slot_free       = 0,
+            slot_queued     = 1,
+            slot_drawing    = 2
+        };
+
+            //one recorded frame, copied out of the haxe streams so they can be refilled right away
+        struct Render_frame {
+
+            std::vector<int>    ints;
+            std::vector<float>  floats;
+            int                 count;
+            bool                swap;
+                //the order frames were submitted in, the oldest queued one is drawn first
+            unsigned int        sequence;
+            int                 state;
+
+            Render_frame() : count(0), swap(false), sequence(0), state(slot_free) {}
+
+        }; //Render_frame
+
+        struct Render_thread {
+
+            std::thread                 thread;
+            std::mutex                  lock;
+                //the render thread waits on this for frames and requests
+            std::condition_variable     wake;
+                //the other threads wait on this for free slots, drawn frames and the context
+            std::condition_variable     done;
+
+            window::Window*             window;
+            Render_frame                frames[2];
+            unsigned int                sequence;
+
+            bool                        running;
+            bool                        stopping;
+                //whether the render thread has the context current
+            bool                        holding;
+                //how deep the acquires go, the render thread draws nothing while above 0
+            int                         borrowed;
+
+            Render_thread() : window(NULL), sequence(0), running(false), stopping(false), holding(false), borrowed(0) {}
+
+        }; //Render_thread
+
+        static Render_thread render_thread;
+
+            //with the lock held
+        static bool frames_pending() {
+
+            return render_thread.frames[0].state != slot_free || render_thread.frames[1].state != slot_free;
+
+        } //frames_pending
+
+        static int frame_next() {
+
+            int next = -1;
+
+            for(int i = 0; i < 2; ++i) {
+
+                const Render_frame &frame = render_thread.frames[i];
+
+                if(frame.state != slot_queued) continue;
+
+                if(next == -1 || frame.sequence < render_thread.frames[next].sequence) {
+                    next = i;
+                }
+
+            } //each slot
+
+            return next;
+
+        } //frame_next
+
+        static void render_thread_run() {
+
+            std::unique_lock<std::mutex> guard(render_thread.lock);
+
+            while(true) {
+
+                    //someone wants the context, let go of it and wait until they're done
+                if(render_thread.borrowed > 0) {
+
+                    if(render_thread.holding) {
+                        render_thread.window->make_current(false);
+                        render_thread.holding = false;
+                        render_thread.done.notify_all();
+                    }
+
+                    render_thread.wake.wait(guard);
+                    continue;
+
+                } //borrowed
+
+                int next = frame_next();
+
+                if(next == -1) {
+
+                    if(render_thread.stopping) break;
+
+                    render_thread.wake.wait(guard);
+                    continue;
+
+                } //nothing queued
+
+                Render_frame &frame = render_thread.frames[next];
+                frame.state = slot_drawing;
+
+                guard.unlock();
+
+                    if(!render_thread.holding) {
+                        render_thread.window->make_current(true);
+                        render_thread.holding = true;
+                    }
+
+                    gl_execute(
+                        frame.ints.data(), (int)frame.ints.size(),
+                        frame.floats.data(), (int)frame.floats.size(),
+                        frame.count
+                    );
+
+                    if(frame.swap) {
+                        render_thread.window->swap();
+                    }
+
+                guard.lock();
+
+                frame.state = slot_free;
+                render_thread.done.notify_all();
+
+            } //while
+
+            if(render_thread.holding) {
+                render_thread.window->make_current(false);
+                render_thread.holding = false;
+            }
+
+        } //render_thread_run
+
+        bool render_thread_start( window::Window* window ) {
+
+            if(render_thread.running) {
+                snow::log(1, "/ snow / render thread is already running for window %d", render_thread.window->id);
+                return false;
+            }
+
+            if(!window) {
+                return false;
+            }
+
+                //let go of the context here first, it can only be current on one thread
+            window->make_current(false);
+
+            render_thread.window = window;
+            render_thread.stopping = false;
+            render_thread.holding = false;
+            render_thread.borrowed = 0;
+            render_thread.running = true;
+
+            render_thread.thread = std::thread(render_thread_run);
+
+            snow::log(2, "/ snow / render thread started for window %d", window->id);
+
+            return true;
+
+        } //render_thread_start
+
+        void render_thread_stop() {
+
+            if(!render_thread.running) {
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> guard(render_thread.lock);
+
+                render_thread.stopping = true;
+
+                    //a stop inside an acquire would never let the thread draw what's left,
+                    //give the context back so it can
+                if(render_thread.borrowed > 0) {
+                    render_thread.window->make_current(false);
+                    render_thread.borrowed = 0;
+                }
+
+                render_thread.wake.notify_all();
+            }
+
+            render_thread.thread.join();
+
+            render_thread.running = false;
+            render_thread.window->make_current(true);
+
+            snow::log(2, "/ snow / render thread stopped for window %d", render_thread.window->id);
+
+            render_thread.window = NULL;
+
+        } //render_thread_stop
+
+        bool render_thread_active() {
+
+            return render_thread.running;
+
+        } //render_thread_active
+
+        bool render_thread_owns( window::Window* window ) {
+
+            return render_thread.running && render_thread.window == window;
+
+        } //render_thread_owns
+
+        bool render_thread_acquired() {
+
+            std::lock_guard<std::mutex> guard(render_thread.lock);
+
+            return render_thread.borrowed > 0;
+
+        } //render_thread_acquired
+
+        void render_thread_submit( const int* ints, int int_count, const float* floats, int float_count, int count, bool swap ) {
+
+            if(!render_thread.running) {
+                return;
+            }
+
+            std::unique_lock<std::mutex> guard(render_thread.lock);
+
+            if(render_thread.borrowed > 0 && frames_pending()) {
+                    //the thread draws nothing until the release, so waiting here would never end
+                snow::log(1, "/ snow / render thread frame submitted while the context is acquired, dropped");
+                return;
+            }
+
+            int slot = -1;
+
+            render_thread.done.wait(guard, [&slot]() {
+                for(int i = 0; i < 2; ++i) {
+                    if(render_thread.frames[i].state == slot_free) {
+                        slot = i;
+                        return true;
+                    }
+                }
+                return false;
+            });
+
+            Render_frame &frame = render_thread.frames[slot];
+
+                //the slots keep their capacity, so after the first frames this doesn't allocate
+            frame.ints.assign(ints, ints + int_count);
+
+            if(floats && float_count > 0) {
+                frame.floats.assign(floats, floats + float_count);
+            } else {
+                frame.floats.clear();
+            }
+
+            frame.count = count;
+            frame.swap = swap;
+            frame.sequence = render_thread.sequence++;
+            frame.state = slot_queued;
+
+            render_thread.wake.notify_all();
+
+        } //render_thread_submit
+
+        void render_thread_finish() {
+
+            if(!render_thread.running) {
+                return;
+            }
+
+            std::unique_lock<std::mutex> guard(render_thread.lock);
+
+            if(render_thread.borrowed > 0) {
+                return;
+            }
+
+            render_thread.done.wait(guard, []() { return !frames_pending(); });
+
+        } //render_thread_finish
+
+        void render_thread_acquire() {
+
+            if(!render_thread.running) {
+                return;
+            }
+
+            std::unique_lock<std::mutex> guard(render_thread.lock);
+
+            if(render_thread.borrowed > 0) {
+                ++render_thread.borrowed;
+                return;
+            }
+
+                //the frames before this point draw first, with the context where it was
+            render_thread.done.wait(guard, []() { return !frames_pending(); });
+            render_thread.borrowed = 1;
+
+            render_thread.wake.notify_all();
+            render_thread.done.wait(guard, []() { return !render_thread.holding; });
+
+            guard.unlock();
+
+            render_thread.window->make_current(true);
+
+        } //render_thread_acquire
+
+        void render_thread_release() {
+
+            if(!render_thread.running) {
+                return;
+            }
+
+            std::lock_guard<std::mutex> guard(render_thread.lock);
+
+            if(render_thread.borrowed == 0) {
+                return;
+            }
+
+            if(--render_thread.borrowed > 0) {
+                return;
+            }
+
+            render_thread.window->make_current(false);
+            render_thread.wake.notify_all();
+
+        } //render_thread_release
+
+    } //render namespace
+
+} //snow namespace
@@ -22,11 +22,13 @@
 
 #include "snow_core.h"
 #include "snow_window.h"
+#include "snow_render.h"
 #include "snow_input.h"
 #include "snow_io.h"
 
 #include "assets/snow_assets_audio.h"
 #include "assets/snow_assets_image.h"
+#include "audio/snow_audio_convert.h"
 
 #include "common/snow_hx.h"
 
@@ -84,6 +86,11 @@ extern double timestamp();
 
     value snow_shutdown() {
 
+        #ifdef SNOW_USE_OPENGL
+                //the context goes back to this thread before anything it belongs to goes away
+            snow::render::render_thread_stop();
+        #endif
+
             //now shutdown the core
         snow::core::snow_shutdown();
 
@@ -251,7 +258,16 @@ extern double timestamp();
         snow::window::Window* window = snow::from_hx<snow::window::Window>(_window);
 
         if( window ) {
+
+            #ifdef SNOW_USE_OPENGL
+                    //the render thread has the context, and makes it current itself
+                if(snow::render::render_thread_owns(window)) {
+                    return alloc_null();
+                }
+            #endif
+
             window->render();
+
         }
 
         return alloc_null();
@@ -264,7 +280,16 @@ extern double timestamp();
         snow::window::Window* window = snow::from_hx<snow::window::Window>(_window);
 
         if( window ) {
+
+            #ifdef SNOW_USE_OPENGL
+                    //the render thread swaps after each frame submitted to it
+                if(snow::render::render_thread_owns(window)) {
+                    return alloc_null();
+                }
+            #endif
+
             window->swap();
+
         }
 
         return alloc_null();
@@ -300,6 +325,12 @@ extern double timestamp();
 
         snow::window::Window* window = snow::from_hx<snow::window::Window>(_window);
 
+        #ifdef SNOW_USE_OPENGL
+            if(snow::render::render_thread_owns(window)) {
+                snow::render::render_thread_stop();
+            }
+        #endif
+
         snow::window::destroy_window(window);
 
         return alloc_null();
@@ -497,41 +528,126 @@ extern double timestamp();
 
 // audio loading
 
+        //decodes a portion straight into a new haxe buffer, padded to align like the
+        //QuickVec readers, so the pcm never passes through a native staging copy first
+    template<typename T>
+    static value snow_assets_audio_read_to_hx( bool (*_reader)( T*, unsigned char*, long, long, long& ), T* _source, long _start, long _len, bool &_complete ) {
 
+        long byte_gap = (_len & 0x03);
+        long bytes_read = 0;
 
+        buffer buf = alloc_buffer_len( _len + byte_gap );
 
+        _complete = _reader( _source, (unsigned char*)buffer_data(buf), _start, _len, bytes_read );
 
-//ogg
+            //the buffer length has to reflect the real size if the read came up short
+        if(bytes_read != _len) {
+            buffer_set_size( buf, bytes_read > 0 ? bytes_read + byte_gap : 0 );
+        }
 
-    value snow_assets_audio_load_info_ogg( value _id, value _do_read, value _bytes, value _byteOffset, value _byteLength ) {
+        return buffer_val(buf);
 
-        bool from_bytes = !val_is_null(_bytes);
-        bool do_read = val_bool(_do_read);
-        std::string _asset_id(val_string(_id));
+    } //snow_assets_audio_read_to_hx
 
-            //the destination for the read, if any
-        QuickVec<unsigned char> buffer;
-            //the source data ogg info
-        snow::assets::audio::OGG_file_source* ogg_source = new snow::assets::audio::OGG_file_source();
-        ogg_source->source_name = _asset_id;
+        //reads a whole source into a new haxe buffer, through the decoded audio cache when _key is set.
+        //a hit copies the cached samples instead of decoding the file again.
+    template<typename T>
+    static value snow_assets_audio_read_cached_to_hx( bool (*_reader)( T*, unsigned char*, long, long, long& ), T* _source, long _start, const std::string &_key ) {
 
-        if(!from_bytes) {
-            ogg_source->file_source = snow::io::iosrc_from_file(_asset_id.c_str(), "rb");
-        } else {
-            int byteOffset = val_int(_byteOffset);
-            int byteLength = val_int(_byteLength);
-            const unsigned char* bytes = snow::bytes_from_hx(_bytes);
-            ogg_source->file_source = snow::io::iosrc_from_mem( (void*)(bytes + byteOffset), byteLength );
+        if(!_key.empty()) {
+
+            snow::assets::audio::Audio_cache_samples _cached = snow::assets::audio::cache_find(_key);
+
+            if(_cached) {
+
+                buffer buf = alloc_buffer_len( (int)_cached->size() );
+
+                if(!_cached->empty()) {
+                    memcpy( buffer_data(buf), &(*_cached)[0], _cached->size() );
+                }
+
+                return buffer_val(buf);
+
+            } //hit
+
+        } //_key
+
+        bool complete = false;
+        value data = snow_assets_audio_read_to_hx( _reader, _source, _start, _source->length_pcm, complete );
+
+        if(!_key.empty()) {
+            buffer buf = val_to_buffer(data);
+            snow::assets::audio::cache_store( _key, (const unsigned char*)buffer_data(buf), buffer_size(buf) );
         }
 
-        bool success = snow::assets::audio::load_info_ogg( buffer, _asset_id.c_str(), ogg_source, do_read );
+        return data;
 
-        if(!success) {
-            if(ogg_source) { delete ogg_source; ogg_source = NULL; }
+    } //snow_assets_audio_read_cached_to_hx
+
+        //reads a whole source from the start into a new haxe buffer, through the cache when the source has a key
+    template<typename T>
+    static value snow_assets_audio_read_all_hx( bool (*_reader)( T*, unsigned char*, long, long, long& ), value _info ) {
+
+        value _handle = property_value(_info, id_handle);
+
+        T* _source = snow::from_hx<T>(_handle);
+
+        if( val_is_null(_handle) || !_source ) {
             return alloc_null();
-        } //!success
+        }
+
+        return snow_assets_audio_read_cached_to_hx( _reader, _source, 0, _source->cache_key );
+
+    } //snow_assets_audio_read_all_hx
+
+        //decodes a portion into caller owned bytes at _dest_offset. So that a refill allocates nothing,
+        //the result is packed in an int, the bytes read shifted up one with the low bit set once the
+        //end of the data was reached. -1 when it can't read, which includes _dest not holding _len bytes from the offset
+    template<typename T>
+    static value snow_assets_audio_read_into_hx( bool (*_reader)( T*, unsigned char*, long, long, long& ), value _info, value _start, value _len, value _dest, value _dest_offset ) {
+
+        value _handle = property_value(_info, id_handle);
+
+        T* _source = snow::from_hx<T>(_handle);
+
+        if( val_is_null(_handle) || !_source || val_is_null(_dest) ) {
+            return alloc_int(-1);
+        }
+
+        long long _offset = val_int(_dest_offset);
+        long long _length = val_int(_len);
+
+        if(_offset < 0 || _length < 0 || _offset + _length > snow::bytes_length_hx(_dest)) {
+            snow::log(1, "/ snow / audio read into %lld bytes at %lld doesn't fit a %d byte destination", _length, _offset, snow::bytes_length_hx(_dest));
+            return alloc_int(-1);
+        }
+
+        unsigned char* dest = snow::bytes_from_hx_rw(_dest) + _offset;
+        long bytes_read = 0;
+
+        bool complete = _reader( _source, dest, val_int(_start), (long)_length, bytes_read );
+
+        return alloc_int( (int)(bytes_read << 1) | (complete ? 1 : 0) );
+
+    } //snow_assets_audio_read_into_hx
 
-        value data = snow::bytes_to_hx( &buffer[0], buffer.size() );
+
+        //integer pcm by its width, matching AudioSampleFormat on the haxe side
+    static int snow_assets_audio_sample_format( int bits_per_sample ) {
+
+        switch(bits_per_sample) {
+            case 8:  return 1; //u8
+            case 16: return 2; //s16
+        }
+
+        return 0; //unknown
+
+    } //snow_assets_audio_sample_format
+
+
+//ogg
+
+    static value snow_assets_audio_info_ogg_to_hx( value _id, snow::assets::audio::OGG_file_source* ogg_source, value data ) {
 
         value _object = alloc_empty_object();
 
@@ -545,20 +661,88 @@ extern double timestamp();
                 alloc_field( _dataobject, id_channels, alloc_int( ogg_source->info->channels ));
                 alloc_field( _dataobject, id_rate, alloc_int( ogg_source->info->rate ));
                 alloc_field( _dataobject, id_bitrate, alloc_int( ogg_source->info->bitrate_nominal ));
-                alloc_field( _dataobject, id_bits_per_sample, alloc_int( 16 ) ); //:todo: optionize?
+                alloc_field( _dataobject, id_bits_per_sample, alloc_int( ogg_source->decode_float ? 32 : 16 ) );
+                alloc_field( _dataobject, id_sample_format, alloc_int( ogg_source->decode_float ? 3 : 2 ) ); //f32 : s16
+                alloc_field( _dataobject, id_mapped, alloc_bool(false) );
                 alloc_field( _dataobject, id_bytes, data );
                 alloc_field( _dataobject, id_length, alloc_int(ogg_source->length) );
                 alloc_field( _dataobject, id_length_pcm, alloc_int(ogg_source->length_pcm) );
 
+                if(ogg_source->loop_start >= 0) {
+                    alloc_field( _dataobject, id_loop_start, alloc_int(ogg_source->loop_start) );
+                }
+
+                if(ogg_source->loop_length > 0) {
+                    alloc_field( _dataobject, id_loop_length, alloc_int(ogg_source->loop_length) );
+                }
+
             alloc_field( _object, id_data, _dataobject );
 
         return _object;
 
-    } DEFINE_PRIM(snow_assets_audio_load_info_ogg, 5);
+    } //snow_assets_audio_info_ogg_to_hx
 
-    value snow_assets_audio_read_bytes_ogg( value _info, value _start, value _len ) {
+    value snow_assets_audio_load_info_ogg( value *arg, int argCount ) {
+
+        enum { A_id, A_do_read, A_bytes, A_byteOffset, A_byteLength, A_float, A_resident };
 
+        value _id = arg[A_id];
+        value _bytes = arg[A_bytes];
+
+        bool from_bytes = !val_is_null(_bytes);
+        bool do_read = val_bool(arg[A_do_read]);
+        bool resident = argCount > A_resident && val_bool(arg[A_resident]);
+        std::string _asset_id(val_string(_id));
+
+            //the destination for the read, if any
         QuickVec<unsigned char> buffer;
+            //the source data ogg info
+        snow::assets::audio::OGG_file_source* ogg_source = new snow::assets::audio::OGG_file_source();
+        ogg_source->source_name = _asset_id;
+        ogg_source->decode_float = val_bool(arg[A_float]);
+
+            //resident files are read into memory once, and every source of them decodes from
+            //the shared bytes with a cursor of its own, so streaming them touches no disk
+        if(!from_bytes && resident) {
+            ogg_source->resident = snow::assets::audio::resident_bytes(_asset_id);
+        }
+
+        if(ogg_source->resident) {
+            ogg_source->file_source = snow::io::iosrc_from_const_mem( ogg_source->resident->data(), (int)ogg_source->resident->size() );
+            ogg_source->seek_index_key = _asset_id;
+        } else if(!from_bytes) {
+            ogg_source->file_source = snow::io::iosrc_from_file(_asset_id.c_str(), "rb");
+                //file sources can share a seek index by path
+            ogg_source->seek_index_key = _asset_id;
+        } else {
+            int byteOffset = val_int(arg[A_byteOffset]);
+            int byteLength = val_int(arg[A_byteLength]);
+            const unsigned char* bytes = snow::bytes_from_hx(_bytes);
+            ogg_source->file_source = snow::io::iosrc_from_mem( (void*)(bytes + byteOffset), byteLength );
+        }
+
+            //the info is loaded without reading, the pcm is decoded into the haxe buffer below
+        bool success = snow::assets::audio::load_info_ogg( buffer, _asset_id.c_str(), ogg_source, false );
+
+        if(!success) {
+            if(ogg_source) { delete ogg_source; ogg_source = NULL; }
+            return alloc_null();
+        } //!success
+
+            //only files are cached, by path and decode parameters
+        if(!from_bytes) {
+            ogg_source->cache_key = snow::assets::audio::cache_key( _asset_id, 1, ogg_source->decode_float );
+        }
+
+        value data = do_read ?
+            snow_assets_audio_read_cached_to_hx( snow::assets::audio::read_bytes_ogg_into, ogg_source, 0, ogg_source->cache_key ) :
+            buffer_val( alloc_buffer_len(0) );
+
+        return snow_assets_audio_info_ogg_to_hx( _id, ogg_source, data );
+
+    } DEFINE_PRIM_MULT(snow_assets_audio_load_info_ogg);
+
+    value snow_assets_audio_read_bytes_ogg( value _info, value _start, value _len ) {
 
         value _handle = property_value(_info, id_handle);
 
@@ -566,9 +750,8 @@ extern double timestamp();
 
         if( !val_is_null(_handle) && ogg_source ) {
 
-            bool complete = snow::assets::audio::read_bytes_ogg( ogg_source, buffer, val_int(_start), val_int(_len) );
-
-            value data = snow::bytes_to_hx( &buffer[0], buffer.size() );
+            bool complete = false;
+            value data = snow_assets_audio_read_to_hx( snow::assets::audio::read_bytes_ogg_into, ogg_source, val_int(_start), val_int(_len), complete );
 
             value _object = alloc_empty_object();
 
@@ -585,6 +768,18 @@ extern double timestamp();
 
     } DEFINE_PRIM(snow_assets_audio_read_bytes_ogg, 3);
 
+    value snow_assets_audio_read_into_ogg( value _info, value _start, value _len, value _dest, value _dest_offset ) {
+
+        return snow_assets_audio_read_into_hx<snow::assets::audio::OGG_file_source>( snow::assets::audio::read_bytes_ogg_into, _info, _start, _len, _dest, _dest_offset );
+
+    } DEFINE_PRIM(snow_assets_audio_read_into_ogg, 5);
+
+    value snow_assets_audio_read_all_ogg( value _info ) {
+
+        return snow_assets_audio_read_all_hx<snow::assets::audio::OGG_file_source>( snow::assets::audio::read_bytes_ogg_into, _info );
+
+    } DEFINE_PRIM(snow_assets_audio_read_all_ogg, 1);
+
     value snow_assets_audio_seek_bytes_ogg( value _info, value _to ) {
 
         value _handle = property_value(_info, id_handle);
@@ -601,8 +796,83 @@ extern double timestamp();
 
     } DEFINE_PRIM(snow_assets_audio_seek_bytes_ogg, 2);
 
+    value snow_assets_audio_stream_ogg( value _info, value _ring_length ) {
+
+        value _handle = property_value(_info, id_handle);
+
+        snow::assets::audio::OGG_file_source* ogg_source = snow::from_hx<snow::assets::audio::OGG_file_source>(_handle);
+
+        if( !val_is_null(_handle) && ogg_source ) {
+
+            return alloc_bool(snow::assets::audio::stream_start_ogg( ogg_source, val_int(_ring_length) ));
+
+        }
+
+        return alloc_bool(false);
+
+    } DEFINE_PRIM(snow_assets_audio_stream_ogg, 2);
+
+    value snow_assets_audio_seek_index_ogg( value _info ) {
+
+        value _handle = property_value(_info, id_handle);
+
+        snow::assets::audio::OGG_file_source* ogg_source = snow::from_hx<snow::assets::audio::OGG_file_source>(_handle);
+
+        if( !val_is_null(_handle) && ogg_source ) {
+
+            return alloc_bool(snow::assets::audio::seek_index_ogg( ogg_source ));
+
+        }
+
+        return alloc_bool(false);
+
+    } DEFINE_PRIM(snow_assets_audio_seek_index_ogg, 1);
+
+    value snow_assets_audio_seek_index_files( value _enabled ) {
+
+        snow::assets::audio::seek_index_files_ogg( val_bool(_enabled) );
+
+        return alloc_null();
+
+    } DEFINE_PRIM(snow_assets_audio_seek_index_files, 1);
+
+    value snow_assets_audio_shutdown() {
+
+        snow::assets::audio::stream_shutdown_ogg();
+
+        return alloc_null();
+
+    } DEFINE_PRIM(snow_assets_audio_shutdown, 0);
+
 //wav
 
+    static value snow_assets_audio_info_wav_to_hx( value _id, snow::assets::audio::WAV_file_source* wav_source, value data ) {
+
+        value _object = alloc_empty_object();
+
+            alloc_field( _object, id_id, _id );
+            alloc_field( _object, id_format, alloc_int(2) ); //2 here is wav
+
+            alloc_field( _object, id_handle, snow::to_hx<snow::assets::audio::WAV_file_source>( wav_source ) );
+
+            value _dataobject = alloc_empty_object();
+
+                alloc_field( _dataobject, id_channels, alloc_int(wav_source->channels) );
+                alloc_field( _dataobject, id_rate, alloc_int(wav_source->rate) );
+                alloc_field( _dataobject, id_bitrate, alloc_int(wav_source->bitrate) );
+                alloc_field( _dataobject, id_bits_per_sample, alloc_int(wav_source->bits_per_sample) );
+                alloc_field( _dataobject, id_sample_format, alloc_int( snow_assets_audio_sample_format(wav_source->bits_per_sample) ) );
+                alloc_field( _dataobject, id_mapped, alloc_bool( wav_source->map.data != NULL ) );
+                alloc_field( _dataobject, id_bytes, data );
+                alloc_field( _dataobject, id_length, alloc_int(wav_source->length) );
+                alloc_field( _dataobject, id_length_pcm, alloc_int(wav_source->length_pcm) );
+
+            alloc_field( _object, id_data, _dataobject );
+
+        return _object;
+
+    } //snow_assets_audio_info_wav_to_hx
+
     value snow_assets_audio_load_info_wav( value _id, value _do_read, value _bytes, value _byteOffset, value _byteLength ) {
 
         bool from_bytes = !val_is_null(_bytes);
@@ -617,7 +887,13 @@ extern double timestamp();
         wav_source->source_name = _asset_id;
 
         if(!from_bytes) {
-            wav_source->file_source = snow::io::iosrc_from_file(_asset_id.c_str(), "rb");
+                //uncompressed files are read through a mapping where possible,
+                //so parsing and streaming them costs no syscalls
+            if(snow::io::map_file(_asset_id.c_str(), wav_source->map)) {
+                wav_source->file_source = snow::io::iosrc_from_const_mem( wav_source->map.data, (int)wav_source->map.length );
+            } else {
+                wav_source->file_source = snow::io::iosrc_from_file(_asset_id.c_str(), "rb");
+            }
         } else {
             int byteOffset = val_int(_byteOffset);
             int byteLength = val_int(_byteLength);
@@ -625,52 +901,38 @@ extern double timestamp();
             wav_source->file_source = snow::io::iosrc_from_mem( (void*)(bytes + byteOffset), byteLength );
         }
 
-        bool success = snow::assets::audio::load_info_wav( buffer, _asset_id.c_str(), wav_source, do_read );
+            //the info is loaded without reading, the pcm is decoded into the haxe buffer below
+        bool success = snow::assets::audio::load_info_wav( buffer, _asset_id.c_str(), wav_source, false );
 
         if(!success) {
             if(wav_source) { delete wav_source; wav_source = NULL; }
             return alloc_null();
         } //!success
 
-        value data = snow::bytes_to_hx( &buffer[0], buffer.size() );
-
-        value _object = alloc_empty_object();
-
-            alloc_field( _object, id_id, _id );
-            alloc_field( _object, id_format, alloc_int(2) ); //2 here is wav
-
-            alloc_field( _object, id_handle, snow::to_hx<snow::assets::audio::WAV_file_source>( wav_source ) );
-
-            value _dataobject = alloc_empty_object();
-
-                alloc_field( _dataobject, id_channels, alloc_int(wav_source->channels) );
-                alloc_field( _dataobject, id_rate, alloc_int(wav_source->rate) );
-                alloc_field( _dataobject, id_bitrate, alloc_int(wav_source->bitrate) );
-                alloc_field( _dataobject, id_bits_per_sample, alloc_int(wav_source->bits_per_sample) );
-                alloc_field( _dataobject, id_bytes, data );
-                alloc_field( _dataobject, id_length, alloc_int(wav_source->length) );
-                alloc_field( _dataobject, id_length_pcm, alloc_int(wav_source->length_pcm) );
+            //mapped files are already in memory, so only unmapped files are cached
+        if(!from_bytes && !wav_source->map.data) {
+            wav_source->cache_key = snow::assets::audio::cache_key( _asset_id, 2, false );
+        }
 
-            alloc_field( _object, id_data, _dataobject );
+        value data = do_read ?
+            snow_assets_audio_read_cached_to_hx( snow::assets::audio::read_bytes_wav_into, wav_source, -1, wav_source->cache_key ) :
+            buffer_val( alloc_buffer_len(0) );
 
-        return _object;
+        return snow_assets_audio_info_wav_to_hx( _id, wav_source, data );
 
     } DEFINE_PRIM(snow_assets_audio_load_info_wav, 5);
 
 
     value snow_assets_audio_read_bytes_wav( value _info, value _start, value _len ) {
 
-        QuickVec<unsigned char> buffer;
-
         value _handle = property_value(_info, id_handle);
 
         snow::assets::audio::WAV_file_source* wav_source = snow::from_hx<snow::assets::audio::WAV_file_source>(_handle);
 
         if( !val_is_null(_handle) && wav_source ) {
 
-            bool complete = snow::assets::audio::read_bytes_wav( wav_source, buffer, val_int(_start), val_int(_len) );
-
-            value data = snow::bytes_to_hx( &buffer[0], buffer.size() );
+            bool complete = false;
+            value data = snow_assets_audio_read_to_hx( snow::assets::audio::read_bytes_wav_into, wav_source, val_int(_start), val_int(_len), complete );
 
             value _object = alloc_empty_object();
 
@@ -687,6 +949,18 @@ extern double timestamp();
 
     } DEFINE_PRIM(snow_assets_audio_read_bytes_wav, 3);
 
+    value snow_assets_audio_read_into_wav( value _info, value _start, value _len, value _dest, value _dest_offset ) {
+
+        return snow_assets_audio_read_into_hx<snow::assets::audio::WAV_file_source>( snow::assets::audio::read_bytes_wav_into, _info, _start, _len, _dest, _dest_offset );
+
+    } DEFINE_PRIM(snow_assets_audio_read_into_wav, 5);
+
+    value snow_assets_audio_read_all_wav( value _info ) {
+
+        return snow_assets_audio_read_all_hx<snow::assets::audio::WAV_file_source>( snow::assets::audio::read_bytes_wav_into, _info );
+
+    } DEFINE_PRIM(snow_assets_audio_read_all_wav, 1);
+
 
     value snow_assets_audio_seek_bytes_wav( value _info, value _to ) {
 
@@ -707,6 +981,33 @@ extern double timestamp();
 //pcm
 
 
+    static value snow_assets_audio_info_pcm_to_hx( value _id, snow::assets::audio::PCM_file_source* pcm_source, value data ) {
+
+        value _object = alloc_empty_object();
+
+            alloc_field( _object, id_id, _id );
+            alloc_field( _object, id_format, alloc_int(3) ); //3 here is pcm
+
+            alloc_field( _object, id_handle, snow::to_hx<snow::assets::audio::PCM_file_source>( pcm_source ) );
+
+            value _dataobject = alloc_empty_object();
+
+                alloc_field( _dataobject, id_channels, alloc_int(pcm_source->channels) );
+                alloc_field( _dataobject, id_rate, alloc_int(pcm_source->rate) );
+                alloc_field( _dataobject, id_bitrate, alloc_int(pcm_source->bitrate) );
+                alloc_field( _dataobject, id_bits_per_sample, alloc_int(pcm_source->bits_per_sample) );
+                alloc_field( _dataobject, id_sample_format, alloc_int( snow_assets_audio_sample_format(pcm_source->bits_per_sample) ) );
+                alloc_field( _dataobject, id_mapped, alloc_bool( pcm_source->map.data != NULL ) );
+                alloc_field( _dataobject, id_bytes, data );
+                alloc_field( _dataobject, id_length, alloc_int(pcm_source->length) );
+                alloc_field( _dataobject, id_length_pcm, alloc_int(pcm_source->length_pcm) );
+
+            alloc_field( _object, id_data, _dataobject );
+
+        return _object;
+
+    } //snow_assets_audio_info_pcm_to_hx
+
     value snow_assets_audio_load_info_pcm( value _id, value _do_read, value _bytes, value _byteOffset, value _byteLength ) {
 
         bool from_bytes = !val_is_null(_bytes);
@@ -720,7 +1021,13 @@ extern double timestamp();
         pcm_source->source_name = _asset_id;
 
         if(!from_bytes) {
-            pcm_source->file_source = snow::io::iosrc_from_file(_asset_id.c_str(), "rb");
+                //uncompressed files are read through a mapping where possible,
+                //so parsing and streaming them costs no syscalls
+            if(snow::io::map_file(_asset_id.c_str(), pcm_source->map)) {
+                pcm_source->file_source = snow::io::iosrc_from_const_mem( pcm_source->map.data, (int)pcm_source->map.length );
+            } else {
+                pcm_source->file_source = snow::io::iosrc_from_file(_asset_id.c_str(), "rb");
+            }
         } else {
             int byteOffset = val_int(_byteOffset);
             int byteLength = val_int(_byteLength);
@@ -728,52 +1035,159 @@ extern double timestamp();
             pcm_source->file_source = snow::io::iosrc_from_mem( (void*)(bytes + byteOffset), byteLength );
         }
 
-        bool success = snow::assets::audio::load_info_pcm( buffer, _asset_id.c_str(), pcm_source, do_read );
+            //the info is loaded without reading, the pcm is decoded into the haxe buffer below
+        bool success = snow::assets::audio::load_info_pcm( buffer, _asset_id.c_str(), pcm_source, false );
 
         if(!success) {
             if(pcm_source) { delete pcm_source; pcm_source = NULL; }
             return alloc_null();
         } //!success
 
-        value data = snow::bytes_to_hx( &buffer[0], buffer.size() );
+            //mapped files are already in memory, so only unmapped files are cached
+        if(!from_bytes && !pcm_source->map.data) {
+            pcm_source->cache_key = snow::assets::audio::cache_key( _asset_id, 3, false );
+        }
+
+        value data = do_read ?
+            snow_assets_audio_read_cached_to_hx( snow::assets::audio::read_bytes_pcm_into, pcm_source, -1, pcm_source->cache_key ) :
+            buffer_val( alloc_buffer_len(0) );
+
+        return snow_assets_audio_info_pcm_to_hx( _id, pcm_source, data );
+
+    } DEFINE_PRIM(snow_assets_audio_load_info_pcm, 5);
+
+
+    value snow_assets_audio_read_bytes_pcm( value _info, value _start, value _len ) {
+
+        value _handle = property_value(_info, id_handle);
+
+        snow::assets::audio::PCM_file_source* pcm_source = snow::from_hx<snow::assets::audio::PCM_file_source>(_handle);
+
+        if( !val_is_null(_handle) && pcm_source ) {
+
+            bool complete = false;
+            value data = snow_assets_audio_read_to_hx( snow::assets::audio::read_bytes_pcm_into, pcm_source, val_int(_start), val_int(_len), complete );
+
+            value _object = alloc_empty_object();
+
+                alloc_field( _object, id_bytes, data );
+                alloc_field( _object, id_complete, alloc_bool(complete) );
+
+            return _object;
+
+        } else {
+
+            return alloc_null();
+
+        }
+
+    } DEFINE_PRIM(snow_assets_audio_read_bytes_pcm, 3);
+
+    value snow_assets_audio_read_into_pcm( value _info, value _start, value _len, value _dest, value _dest_offset ) {
+
+        return snow_assets_audio_read_into_hx<snow::assets::audio::PCM_file_source>( snow::assets::audio::read_bytes_pcm_into, _info, _start, _len, _dest, _dest_offset );
+
+    } DEFINE_PRIM(snow_assets_audio_read_into_pcm, 5);
+
+    value snow_assets_audio_read_all_pcm( value _info ) {
+
+        return snow_assets_audio_read_all_hx<snow::assets::audio::PCM_file_source>( snow::assets::audio::read_bytes_pcm_into, _info );
+
+    } DEFINE_PRIM(snow_assets_audio_read_all_pcm, 1);
+
+
+    value snow_assets_audio_seek_bytes_pcm( value _info, value _to ) {
+
+        value _handle = property_value(_info, id_handle);
+
+        snow::assets::audio::PCM_file_source* pcm_source = snow::from_hx<snow::assets::audio::PCM_file_source>(_handle);
+
+        if( !val_is_null(_handle) && pcm_source ) {
+
+            return alloc_bool(snow::assets::audio::seek_bytes_pcm( pcm_source, val_int(_to) ));
+
+        }
+
+        return alloc_bool(false);
+
+    } DEFINE_PRIM(snow_assets_audio_seek_bytes_pcm, 2);
+
+//adpcm
+
+    static value snow_assets_audio_info_adpcm_to_hx( value _id, snow::assets::audio::ADPCM_file_source* adpcm_source, value data ) {
 
         value _object = alloc_empty_object();
 
             alloc_field( _object, id_id, _id );
-            alloc_field( _object, id_format, alloc_int(3) ); //3 here is pcm
+            alloc_field( _object, id_format, alloc_int(4) ); //4 here is adpcm
 
-            alloc_field( _object, id_handle, snow::to_hx<snow::assets::audio::PCM_file_source>( pcm_source ) );
+            alloc_field( _object, id_handle, snow::to_hx<snow::assets::audio::ADPCM_file_source>( adpcm_source ) );
 
             value _dataobject = alloc_empty_object();
 
-                alloc_field( _dataobject, id_channels, alloc_int(pcm_source->channels) );
-                alloc_field( _dataobject, id_rate, alloc_int(pcm_source->rate) );
-                alloc_field( _dataobject, id_bitrate, alloc_int(pcm_source->bitrate) );
-                alloc_field( _dataobject, id_bits_per_sample, alloc_int(pcm_source->bits_per_sample) );
+                alloc_field( _dataobject, id_channels, alloc_int(adpcm_source->channels) );
+                alloc_field( _dataobject, id_rate, alloc_int(adpcm_source->rate) );
+                alloc_field( _dataobject, id_bitrate, alloc_int(adpcm_source->bitrate) );
+                alloc_field( _dataobject, id_bits_per_sample, alloc_int(adpcm_source->bits_per_sample) );
+                alloc_field( _dataobject, id_sample_format, alloc_int( snow_assets_audio_sample_format(adpcm_source->bits_per_sample) ) );
+                alloc_field( _dataobject, id_mapped, alloc_bool(false) );
                 alloc_field( _dataobject, id_bytes, data );
-                alloc_field( _dataobject, id_length, alloc_int(pcm_source->length) );
-                alloc_field( _dataobject, id_length_pcm, alloc_int(pcm_source->length_pcm) );
+                alloc_field( _dataobject, id_length, alloc_int(adpcm_source->length) );
+                alloc_field( _dataobject, id_length_pcm, alloc_int(adpcm_source->length_pcm) );
 
             alloc_field( _object, id_data, _dataobject );
 
         return _object;
 
-    } DEFINE_PRIM(snow_assets_audio_load_info_pcm, 5);
+    } //snow_assets_audio_info_adpcm_to_hx
 
+    value snow_assets_audio_load_info_adpcm( value _id, value _do_read, value _bytes, value _byteOffset, value _byteLength ) {
 
-    value snow_assets_audio_read_bytes_pcm( value _info, value _start, value _len ) {
+        bool from_bytes = !val_is_null(_bytes);
+        bool do_read = val_bool(_do_read);
+        std::string _asset_id(val_string(_id));
 
+            //the destination for the read, if any
         QuickVec<unsigned char> buffer;
+            //the source information for the adpcm file
+        snow::assets::audio::ADPCM_file_source* adpcm_source = new snow::assets::audio::ADPCM_file_source();
+        adpcm_source->source_name = _asset_id;
 
-        value _handle = property_value(_info, id_handle);
+            //the file is read (and encoded if need be) in full by load_info_adpcm, then closed
+        if(!from_bytes) {
+            adpcm_source->file_source = snow::io::iosrc_from_file(_asset_id.c_str(), "rb");
+        } else {
+            int byteOffset = val_int(_byteOffset);
+            int byteLength = val_int(_byteLength);
+            const unsigned char* bytes = snow::bytes_from_hx(_bytes);
+            adpcm_source->file_source = snow::io::iosrc_from_mem( (void*)(bytes + byteOffset), byteLength );
+        }
 
-        snow::assets::audio::PCM_file_source* pcm_source = snow::from_hx<snow::assets::audio::PCM_file_source>(_handle);
+        bool success = snow::assets::audio::load_info_adpcm( buffer, _asset_id.c_str(), adpcm_source, false );
 
-        if( !val_is_null(_handle) && pcm_source ) {
+        if(!success) {
+            if(adpcm_source) { delete adpcm_source; adpcm_source = NULL; }
+            return alloc_null();
+        } //!success
+
+        value data = do_read ?
+            snow_assets_audio_read_cached_to_hx( snow::assets::audio::read_bytes_adpcm_into, adpcm_source, 0, adpcm_source->cache_key ) :
+            buffer_val( alloc_buffer_len(0) );
 
-            bool complete = snow::assets::audio::read_bytes_pcm( pcm_source, buffer, val_int(_start), val_int(_len) );
+        return snow_assets_audio_info_adpcm_to_hx( _id, adpcm_source, data );
 
-            value data = snow::bytes_to_hx( &buffer[0], buffer.size() );
+    } DEFINE_PRIM(snow_assets_audio_load_info_adpcm, 5);
+
+    value snow_assets_audio_read_bytes_adpcm( value _info, value _start, value _len ) {
+
+        value _handle = property_value(_info, id_handle);
+
+        snow::assets::audio::ADPCM_file_source* adpcm_source = snow::from_hx<snow::assets::audio::ADPCM_file_source>(_handle);
+
+        if( !val_is_null(_handle) && adpcm_source ) {
+
+            bool complete = false;
+            value data = snow_assets_audio_read_to_hx( snow::assets::audio::read_bytes_adpcm_into, adpcm_source, val_int(_start), val_int(_len), complete );
 
             value _object = alloc_empty_object();
 
@@ -788,24 +1202,222 @@ extern double timestamp();
 
         }
 
-    } DEFINE_PRIM(snow_assets_audio_read_bytes_pcm, 3);
+    } DEFINE_PRIM(snow_assets_audio_read_bytes_adpcm, 3);
 
+    value snow_assets_audio_read_into_adpcm( value _info, value _start, value _len, value _dest, value _dest_offset ) {
 
-    value snow_assets_audio_seek_bytes_pcm( value _info, value _to ) {
+        return snow_assets_audio_read_into_hx<snow::assets::audio::ADPCM_file_source>( snow::assets::audio::read_bytes_adpcm_into, _info, _start, _len, _dest, _dest_offset );
+
+    } DEFINE_PRIM(snow_assets_audio_read_into_adpcm, 5);
+
+    value snow_assets_audio_read_all_adpcm( value _info ) {
+
+        return snow_assets_audio_read_all_hx<snow::assets::audio::ADPCM_file_source>( snow::assets::audio::read_bytes_adpcm_into, _info );
+
+    } DEFINE_PRIM(snow_assets_audio_read_all_adpcm, 1);
+
+    value snow_assets_audio_seek_bytes_adpcm( value _info, value _to ) {
 
         value _handle = property_value(_info, id_handle);
 
-        snow::assets::audio::PCM_file_source* pcm_source = snow::from_hx<snow::assets::audio::PCM_file_source>(_handle);
+        snow::assets::audio::ADPCM_file_source* adpcm_source = snow::from_hx<snow::assets::audio::ADPCM_file_source>(_handle);
 
-        if( !val_is_null(_handle) && pcm_source ) {
+        if( !val_is_null(_handle) && adpcm_source ) {
 
-            return alloc_bool(snow::assets::audio::seek_bytes_pcm( pcm_source, val_int(_to) ));
+            return alloc_bool(snow::assets::audio::seek_bytes_adpcm( adpcm_source, val_int(_to) ));
 
         }
 
         return alloc_bool(false);
 
-    } DEFINE_PRIM(snow_assets_audio_seek_bytes_pcm, 2);
+    } DEFINE_PRIM(snow_assets_audio_seek_bytes_adpcm, 2);
+
+//conversion
+
+        //converts interleaved samples from one { sample_format, channels, rate } to another,
+        //returning { bytes, sample_format, channels, rate } as produced, or null if nothing changed
+    value snow_assets_audio_convert( value _bytes, value _byteOffset, value _byteLength, value _from, value _to ) {
+
+        if(val_is_null(_bytes)) {
+            return alloc_null();
+        }
+
+        const unsigned char* bytes = snow::bytes_from_hx(_bytes) + val_int(_byteOffset);
+
+        snow::audio::Audio_format from;
+
+            from.sample_format = property_int(_from, id_sample_format, 0);
+            from.channels = property_int(_from, id_channels, 0);
+            from.rate = property_int(_from, id_rate, 0);
+
+        snow::audio::Audio_format to;
+
+            to.sample_format = property_int(_to, id_sample_format, 0);
+            to.channels = property_int(_to, id_channels, 0);
+            to.rate = property_int(_to, id_rate, 0);
+
+        std::vector<unsigned char> converted;
+
+        if(!snow::audio::convert( bytes, val_int(_byteLength), from, to, converted )) {
+            return alloc_null();
+        }
+
+        buffer buf = alloc_buffer_len( (int)converted.size() );
+
+        if(!converted.empty()) {
+            memcpy( buffer_data(buf), converted.data(), converted.size() );
+        }
+
+        value _object = alloc_empty_object();
+
+            alloc_field( _object, id_bytes, buffer_val(buf) );
+            alloc_field( _object, id_sample_format, alloc_int(to.sample_format) );
+            alloc_field( _object, id_channels, alloc_int(to.channels) );
+            alloc_field( _object, id_rate, alloc_int(to.rate) );
+
+        return _object;
+
+    } DEFINE_PRIM(snow_assets_audio_convert, 5);
+
+//cache
+
+    value snow_assets_audio_cache_budget( value _bytes ) {
+
+        snow::assets::audio::cache_budget( (size_t)val_int(_bytes) );
+
+        return alloc_null();
+
+    } DEFINE_PRIM(snow_assets_audio_cache_budget, 1);
+
+    value snow_assets_audio_cache_clear() {
+
+        snow::assets::audio::cache_clear();
+
+        return alloc_null();
+
+    } DEFINE_PRIM(snow_assets_audio_cache_clear, 0);
+
+    value snow_assets_audio_cache_stats() {
+
+        snow::assets::audio::Audio_cache_stats _stats = snow::assets::audio::cache_stats();
+
+        value _object = alloc_empty_object();
+
+            alloc_field( _object, id_hits, alloc_int( (int)_stats.hits ) );
+            alloc_field( _object, id_misses, alloc_int( (int)_stats.misses ) );
+            alloc_field( _object, id_evictions, alloc_int( (int)_stats.evictions ) );
+            alloc_field( _object, id_entries, alloc_int( (int)_stats.entries ) );
+            alloc_field( _object, id_bytes, alloc_int( (int)_stats.bytes ) );
+            alloc_field( _object, id_budget, alloc_int( (int)_stats.budget ) );
+
+        return _object;
+
+    } DEFINE_PRIM(snow_assets_audio_cache_stats, 0);
+
+    value snow_assets_audio_resident_stats() {
+
+        snow::assets::audio::Audio_resident_stats _stats = snow::assets::audio::resident_stats();
+
+        value _object = alloc_empty_object();
+
+            alloc_field( _object, id_entries, alloc_int( (int)_stats.entries ) );
+            alloc_field( _object, id_bytes, alloc_int( (int)_stats.bytes ) );
+
+        return _object;
+
+    } DEFINE_PRIM(snow_assets_audio_resident_stats, 0);
+
+//batch
+
+    value snow_assets_audio_load_batch( value _ids, value _formats, value _float ) {
+
+        int _count = val_array_size(_ids);
+
+        std::vector<std::string> ids(_count);
+        std::vector<int> formats(_count);
+
+        for(int i = 0; i < _count; ++i) {
+            ids[i] = val_string( val_array_i(_ids, i) );
+            formats[i] = val_int( val_array_i(_formats, i) );
+        }
+
+        snow::assets::audio::Audio_batch* batch = snow::assets::audio::load_batch_start( ids, formats, val_bool(_float) );
+
+        return snow::to_hx<snow::assets::audio::Audio_batch>( batch );
+
+    } DEFINE_PRIM(snow_assets_audio_load_batch, 3);
+
+        //returns the items finished since the last poll, as { index, info }, where info is null if it failed.
+        //the decoded samples are copied into the haxe heap here, on the main thread.
+    value snow_assets_audio_load_batch_poll( value _handle ) {
+
+        snow::assets::audio::Audio_batch* batch = snow::from_hx<snow::assets::audio::Audio_batch>(_handle);
+
+        std::vector<size_t> finished;
+        snow::assets::audio::load_batch_poll( batch, finished );
+
+        value _list = alloc_array( (int)finished.size() );
+
+        for(size_t i = 0; i < finished.size(); ++i) {
+
+            snow::assets::audio::Audio_batch_item &item = batch->items[finished[i]];
+
+            value _info = alloc_null();
+            value _id = alloc_string( item.id.c_str() );
+
+            if(item.ogg_source || item.wav_source || item.pcm_source) {
+
+                    //cached samples are shared with the cache, and copied from there
+                const std::vector<unsigned char> &_samples = item.shared ? *item.shared : item.samples;
+
+                int _length = (int)_samples.size();
+                buffer _buffer = alloc_buffer_len(_length);
+
+                if(_length > 0) {
+                    memcpy( buffer_data(_buffer), &_samples[0], _length );
+                }
+
+                    //release the native copy now that haxe owns one
+                std::vector<unsigned char>().swap(item.samples);
+                item.shared.reset();
+
+                value data = buffer_val(_buffer);
+
+                if(item.ogg_source) {
+                    _info = snow_assets_audio_info_ogg_to_hx( _id, item.ogg_source, data );
+                } else if(item.wav_source) {
+                    _info = snow_assets_audio_info_wav_to_hx( _id, item.wav_source, data );
+                } else {
+                    _info = snow_assets_audio_info_pcm_to_hx( _id, item.pcm_source, data );
+                }
+
+                    //the handle now belongs to the info
+                item.ogg_source = NULL;
+                item.wav_source = NULL;
+                item.pcm_source = NULL;
+
+            } //loaded
+
+            value _result = alloc_empty_object();
+
+                alloc_field( _result, id_index, alloc_int( (int)finished[i] ) );
+                alloc_field( _result, id_info, _info );
+
+            val_array_set_i( _list, (int)i, _result );
+
+        } //each finished
+
+        return _list;
+
+    } DEFINE_PRIM(snow_assets_audio_load_batch_poll, 1);
+
+    value snow_assets_audio_load_batch_end( value _handle ) {
+
+        snow::assets::audio::load_batch_end( snow::from_hx<snow::assets::audio::Audio_batch>(_handle) );
+
+        return alloc_null();
+
+    } DEFINE_PRIM(snow_assets_audio_load_batch_end, 1);
 
 
 
@@ -1140,6 +1752,17 @@ extern double timestamp();
     int id_rate;
     int id_bitrate;
     int id_bits_per_sample;
+    int id_sample_format;
+    int id_mapped;
+    int id_loop_start;
+    int id_loop_length;
+    int id_index;
+    int id_info;
+    int id_hits;
+    int id_misses;
+    int id_evictions;
+    int id_entries;
+    int id_budget;
     int id_bitrate_upper;
     int id_bitrate_nominal;
     int id_bitrate_lower;
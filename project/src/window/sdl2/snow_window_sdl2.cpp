@@ -10,6 +10,7 @@
 
 #include "SDL.h"
 #include "render/opengl/snow_opengl.h"
+#include "render/opengl/snow_opengl_state.h"
 
 #include "snow_core.h"
 #include "snow_render.h"
@@ -59,6 +60,7 @@ namespace snow {
                 void update();
                 void render();
                 void swap();
+                void make_current( bool current );
                 void close();
                 void show();
                 void destroy();
@@ -459,8 +461,23 @@ namespace snow {
 
             SDL_GL_SwapWindow(window);
 
+                //the end of a frame, for the state shadow counters
+            snow::render::gl_state_frame();
+
         } //swap
 
+        void WindowSDL2::make_current( bool current ) {
+
+            if(current) {
+                SDL_GL_MakeCurrent(window, snow_gl_context);
+                current_gl_window = this;
+            } else {
+                SDL_GL_MakeCurrent(window, NULL);
+                current_gl_window = NULL;
+            }
+
+        } //make_current
+
         void WindowSDL2::update() {
 
             if(closed) {
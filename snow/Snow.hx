@@ -111,6 +111,11 @@ class Snow {
 
         shutting_down = true;
 
+            //the context comes back to this thread, for anything ondestroy cleans up
+        #if snow_native
+            snow.modules.opengl.native.GLRenderThread.stop();
+        #end
+
         host.ondestroy();
         io.destroy();
         audio.destroy();
@@ -263,6 +268,15 @@ class Snow {
         is_ready = true;
         host.ready();
 
+            //after ready, so the loading done there still has the context on this thread
+        #if snow_native
+            if(config.native.render_thread == true && window != null) {
+                if(!snow.modules.opengl.native.GLRenderThread.start(window)) {
+                    log('init / render thread could not start, rendering from the main thread');
+                }
+            }
+        #end
+
     } //on_ready
 
     function on_snow_update() {
@@ -470,6 +484,16 @@ class Snow {
 
         config = host.config( config );
 
+        #if snow_native
+            if(config.native.audio_cache_budget != null) {
+                assets.module.audio_cache_budget( config.native.audio_cache_budget );
+            }
+
+            if(config.native.gl_state_cache == true) {
+                snow.modules.opengl.native.GLState.enable(true);
+            }
+        #end
+
     } //setup_host_config
 
     function setup_default_window() {
@@ -522,7 +546,17 @@ class Snow {
             },
             native : {
                 audio_buffer_length : 176400,
-                audio_buffer_count : 4
+                audio_buffer_count : 4,
+                audio_decode_float : false,
+                audio_convert : false,
+                audio_downmix : false,
+                audio_cache_budget : 33554432,
+                audio_stream_native : true,
+                audio_stream_memory : false,
+                audio_voices : 64,
+                audio_mixer : false,
+                render_thread : false,
+                gl_state_cache : false
             }
         }
     }
@@ -1,5 +1,6 @@
 package snow.core.native.assets;
 
+import snow.Snow;
 import snow.types.Types;
 import snow.api.Libs;
 import snow.api.buffers.Uint8Array;
@@ -102,22 +103,18 @@ class Assets implements snow.modules.interfaces.Assets {
 
 //audio
 
-    public function audio_load_info( _path:String, ?_load:Bool = true, ?_format:AudioFormatType ) : AudioInfo {
+        /** Load audio info from a file. If `_float` is true, formats that can will decode to 32 bit float samples.
+            If `_resident` is true, ogg files are read into memory once and decoded from there, the bytes shared
+            by every source of the same file while any is alive, so streaming them needs no disk reads. */
+    public function audio_load_info( _path:String, ?_load:Bool = true, ?_format:AudioFormatType, ?_float:Bool = false, ?_resident:Bool = false ) : AudioInfo {
 
-        if(_format == null) {
-            var _ext = haxe.io.Path.extension(_path);
-            _format = switch(_ext) {
-                case 'wav': AudioFormatType.wav;
-                case 'ogg': AudioFormatType.ogg;
-                case 'pcm': AudioFormatType.pcm;
-                case _: AudioFormatType.unknown;
-            }
-        }
+        if(_format == null) _format = audio_format_from_path(_path);
 
         var _native_info : NativeAudioInfo = switch(_format) {
             case AudioFormatType.wav: audio_load_wav( _path, _load );
-            case AudioFormatType.ogg: audio_load_ogg( _path, _load );
+            case AudioFormatType.ogg: audio_load_ogg( _path, _load, _float, _resident );
             case AudioFormatType.pcm: audio_load_pcm( _path, _load );
+            case AudioFormatType.adpcm: audio_load_adpcm( _path, _load );
             case _: null;
         } //switch _format
 
@@ -125,33 +122,12 @@ class Assets implements snow.modules.interfaces.Assets {
         if(_native_info == null) throw Error.error('failed to load $_path : does the file exist?');
         if(_native_info.data == null) throw Error.error('failed to load $_path : data was null.');
 
-        var _result_bytes = haxe.io.Bytes.ofData(_native_info.data.bytes);
-        var _result_info : AudioInfo = {
-
-            id:     _native_info.id,
-            format: _native_info.format,
-            handle: _native_info.handle,
-
-            data: {
-                samples         : new Uint8Array( _result_bytes ),
-                length          : _native_info.data.length,
-                length_pcm      : _native_info.data.length_pcm,
-                channels        : _native_info.data.channels,
-                rate            : _native_info.data.rate,
-                bitrate         : _native_info.data.bitrate,
-                bits_per_sample : _native_info.data.bits_per_sample
-            }
-
-        } //result_info
-
-        _native_info = null;
-
-        return _result_info;
+        return audio_info_from_native(_native_info);
 
     } //audio_load_info
 
 
-    public function audio_info_from_bytes( _bytes:Uint8Array, _format:AudioFormatType ) : AudioInfo {
+    public function audio_info_from_bytes( _bytes:Uint8Array, _format:AudioFormatType, ?_float:Bool = false ) : AudioInfo {
 
         assertnull(_bytes);
 
@@ -159,8 +135,9 @@ class Assets implements snow.modules.interfaces.Assets {
 
         var _native_info : NativeAudioInfo = switch(_format) {
                 case AudioFormatType.wav: audio_load_wav_from_bytes( _id, _bytes );
-                case AudioFormatType.ogg: audio_load_ogg_from_bytes( _id, _bytes );
+                case AudioFormatType.ogg: audio_load_ogg_from_bytes( _id, _bytes, _float );
                 case AudioFormatType.pcm: audio_load_pcm_from_bytes( _id, _bytes );
+                case AudioFormatType.adpcm: audio_load_adpcm_from_bytes( _id, _bytes );
                 case _ : null;
             } //switch _format
 
@@ -168,31 +145,91 @@ class Assets implements snow.modules.interfaces.Assets {
             if(_native_info == null) throw Error.error('failed to process bytes for $_id');
             if(_native_info.data == null) throw Error.error('failed to process bytes for $_id, data was null.');
 
-            var _result_bytes = haxe.io.Bytes.ofData(_native_info.data.bytes);
-            var _result_info : AudioInfo = {
-
-                id:     _native_info.id,
-                format: _native_info.format,
-                handle: _native_info.handle,
-
-                data: {
-                    samples         : new Uint8Array( _result_bytes ),
-                    length          : _native_info.data.length,
-                    length_pcm      : _native_info.data.length_pcm,
-                    channels        : _native_info.data.channels,
-                    rate            : _native_info.data.rate,
-                    bitrate         : _native_info.data.bitrate,
-                    bits_per_sample : _native_info.data.bits_per_sample
+        return audio_info_from_native(_native_info);
+
+    } //audio_info_from_bytes
+
+
+        /** Load and decode a list of audio files in parallel, on native worker threads sized to the machine.
+            The promise resolves with one AudioInfo per path, in the same order, or null for any that failed to load.
+            `_on_progress` is called on the main thread as each file finishes, with (index, info, loaded, total). */
+    public function audio_load_batch( _paths:Array<String>, ?_on_progress:Int->AudioInfo->Int->Int->Void, ?_float:Bool = false ) : Promise {
+
+        assertnull(_paths);
+
+        return new Promise(function(resolve, reject) {
+
+            var _total = _paths.length;
+            var _loaded = 0;
+            var _infos : Array<AudioInfo> = [for(i in 0 ... _total) null];
+
+            if(_total == 0) return resolve(_infos);
+
+            var _formats = [for(_path in _paths) audio_format_from_path(_path)];
+            var _batch = snow_assets_audio_load_batch( _paths, _formats, _float );
+
+                //the results are collected once a frame until every file has finished
+            function poll() {
+
+                var _finished : Array<NativeAudioBatchResult> = snow_assets_audio_load_batch_poll( _batch );
+
+                for(_result in _finished) {
+
+                    var _info = _result.info == null ? null : audio_info_from_native( _result.info );
+                    if(_info == null) log('failed to load ${_paths[_result.index]} in batch : does the file exist?');
+
+                    _infos[_result.index] = _info;
+                    _loaded++;
+
+                    if(_on_progress != null) _on_progress( _result.index, _info, _loaded, _total );
+
+                } //each finished
+
+                if(_loaded < _total) {
+                    Snow.next(poll);
+                    return;
                 }
 
-            } //result_info
+                snow_assets_audio_load_batch_end( _batch );
+                _batch = null;
 
-            _native_info = null;
+                resolve(_infos);
 
-        return _result_info;
+            } //poll
 
-    } //audio_info_from_bytes
+            poll();
+
+        });
+
+    } //audio_load_batch
+
+        /** Set the byte budget for the native decoded audio cache, evicting least recently used sounds to fit. 0 disables it. */
+    public function audio_cache_budget( _bytes:Int ) : Void {
+
+        snow_assets_audio_cache_budget(_bytes);
+
+    } //audio_cache_budget
+
+        /** Drop every decoded sound from the native cache. This happens automatically on low memory. */
+    public function audio_cache_clear() : Void {
 
+        snow_assets_audio_cache_clear();
+
+    } //audio_cache_clear
+
+        /** The hit/miss counters and memory use of the native decoded audio cache. */
+    public function audio_cache_stats() : AudioCacheStats {
+
+        return snow_assets_audio_cache_stats();
+
+    } //audio_cache_stats
+
+        /** The compressed files held in memory for streaming, see `audio_load_info`. */
+    public function audio_resident_stats() : AudioResidentStats {
+
+        return snow_assets_audio_resident_stats();
+
+    } //audio_resident_stats
 
     public function audio_seek_source( _info:AudioInfo, _to:Int ) : Bool {
 
@@ -200,6 +237,7 @@ class Assets implements snow.modules.interfaces.Assets {
             case AudioFormatType.ogg: return audio_seek_source_ogg(_info, _to);
             case AudioFormatType.wav: return audio_seek_source_wav(_info, _to);
             case AudioFormatType.pcm: return audio_seek_source_pcm(_info, _to);
+            case AudioFormatType.adpcm: return audio_seek_source_adpcm(_info, _to);
             case _: return false;
         }
 
@@ -207,6 +245,96 @@ class Assets implements snow.modules.interfaces.Assets {
 
     } //audio_seek_source
 
+        /** Ask the native side to decode ahead of `audio_load_portion` on a worker thread,
+            into a ring of `_ring_length` bytes. Returns false if the format can't stream this way. */
+    public function audio_stream_source( _info:AudioInfo, _ring_length:Int ) : Bool {
+
+        switch(_info.format) {
+            case AudioFormatType.ogg: return audio_stream_source_ogg(_info, _ring_length);
+            case _: return false;
+        }
+
+        return false;
+
+    } //audio_stream_source
+
+        /** Build the seek index for a source now, rather than on its first seek past the start.
+            Sources opened from the same path share one index. Returns false if the format (or file) has none. */
+    public function audio_seek_index( _info:AudioInfo ) : Bool {
+
+        switch(_info.format) {
+            case AudioFormatType.ogg: return snow_assets_audio_seek_index_ogg(_info);
+            case _: return false;
+        }
+
+        return false;
+
+    } //audio_seek_index
+
+        /** When enabled, seek indices are loaded from and saved to `<path>.seekindex` next to the asset. default: false */
+    public function audio_seek_index_files( _enabled:Bool ) : Void {
+
+        snow_assets_audio_seek_index_files(_enabled);
+
+    } //audio_seek_index_files
+
+        /** Ends the threads that decode streamed sources ahead, once the sounds are destroyed. Called as audio shuts down. */
+    public function audio_shutdown() : Void {
+
+        snow_assets_audio_shutdown();
+
+    } //audio_shutdown
+
+        /** Read the whole of a source's samples from the start. Sources loaded from files
+            go through the decoded audio cache, so loading the same file again skips decoding. */
+    public function audio_load_samples( _info:AudioInfo ) : Uint8Array {
+
+        var _data : haxe.io.BytesData = switch(_info.format) {
+            case AudioFormatType.ogg: snow_assets_audio_read_all_ogg(_info);
+            case AudioFormatType.wav: snow_assets_audio_read_all_wav(_info);
+            case AudioFormatType.pcm: snow_assets_audio_read_all_pcm(_info);
+            case AudioFormatType.adpcm: snow_assets_audio_read_all_adpcm(_info);
+            case _: null;
+        }
+
+        if(_data == null) return null;
+
+        return new Uint8Array( haxe.io.Bytes.ofData(_data) );
+
+    } //audio_load_samples
+
+        /** Convert the loaded samples of an info, in place, to another sample format, channel count and rate.
+            Any of the targets left at 0 keeps the current value. Only stereo to mono downmixing is done,
+            and u8 is widened to s16 when anything else changes. Returns false if nothing needed converting.
+            Sources streamed from the handle are not converted, this is for fully loaded samples. */
+    public function audio_convert( _info:AudioInfo, ?_sample_format:AudioSampleFormat, ?_channels:Int = 0, ?_rate:Int = 0 ) : Bool {
+
+        assertnull(_info);
+
+        var _samples = _info.data.samples;
+        if(_samples == null || _samples.length == 0) return false;
+
+        var _from = { sample_format:_info.data.sample_format, channels:_info.data.channels, rate:_info.data.rate };
+        var _to = { sample_format:(_sample_format == null ? 0 : (_sample_format:Int)), channels:_channels, rate:_rate };
+
+        var _result : NativeAudioConverted = snow_assets_audio_convert( _samples.buffer.getData(), _samples.byteOffset, _samples.byteLength, _from, _to );
+
+        if(_result == null) return false;
+
+        var _bytes_per_sample = (_result.sample_format == AudioSampleFormat.f32) ? 4 : 2;
+
+        _info.data.samples          = new Uint8Array( haxe.io.Bytes.ofData(_result.bytes) );
+        _info.data.length_pcm       = _info.data.samples.length;
+        _info.data.sample_format    = _result.sample_format;
+        _info.data.bits_per_sample  = _bytes_per_sample * 8;
+        _info.data.channels         = _result.channels;
+        _info.data.rate             = _result.rate;
+        _info.data.bitrate          = _result.rate * _result.channels * _bytes_per_sample;
+
+        return true;
+
+    } //audio_convert
+
     public function audio_load_portion( _info:AudioInfo, _start:Int, _len:Int ) : AudioDataBlob {
 
         var native_blob : NativeAudioDataBlob = null;
@@ -216,6 +344,7 @@ class Assets implements snow.modules.interfaces.Assets {
             case AudioFormatType.ogg: audio_load_portion_ogg(_info, _start, _len);
             case AudioFormatType.wav: audio_load_portion_wav(_info, _start, _len);
             case AudioFormatType.pcm: audio_load_portion_pcm(_info, _start, _len);
+            case AudioFormatType.adpcm: audio_load_portion_adpcm(_info, _start, _len);
             case _: null;
         }
 
@@ -231,14 +360,96 @@ class Assets implements snow.modules.interfaces.Assets {
 
     } //audio_load_portion
 
+        /** Decode a portion directly into `_dest` from `_dest_offset`, without allocating.
+            The returned blob `bytes` is `_dest` itself when the read fills all of it, otherwise a view into `_dest`
+            of the length that was actually read. Pass `_into` to have it filled and returned instead of a new blob.
+            Returns null if the read fails, or `_dest` can't hold `_len` bytes from `_dest_offset`. */
+    public function audio_load_portion_into( _info:AudioInfo, _start:Int, _len:Int, _dest:Uint8Array, ?_dest_offset:Int=0, ?_into:AudioDataBlob ) : AudioDataBlob {
+
+        assertnull(_dest);
+
+        var _data = _dest.buffer.getData();
+        var _offset = _dest.byteOffset + _dest_offset;
+
+            //the native side checks the bounds against the bytes as well, this keeps the read inside the view
+        if(_dest_offset < 0 || _len < 0 || _dest_offset + _len > _dest.length) {
+            log('audio_load_portion_into / ${_len} bytes at ${_dest_offset} doesn\'t fit a destination of ${_dest.length}');
+            return null;
+        }
+
+            //the length read and whether it completed, packed in one int, see snow_assets_audio_read_into_hx
+        var _read : Int = switch(_info.format) {
+            case AudioFormatType.ogg: snow_assets_audio_read_into_ogg(_info, _start, _len, _data, _offset);
+            case AudioFormatType.wav: snow_assets_audio_read_into_wav(_info, _start, _len, _data, _offset);
+            case AudioFormatType.pcm: snow_assets_audio_read_into_pcm(_info, _start, _len, _data, _offset);
+            case AudioFormatType.adpcm: snow_assets_audio_read_into_adpcm(_info, _start, _len, _data, _offset);
+            case _: -1;
+        }
+
+        if(_read < 0) return null;
+
+        var _length = _read >> 1;
+        var _bytes = (_dest_offset == 0 && _length == _dest.length) ? _dest : _dest.subarray(_dest_offset, _dest_offset + _length);
+
+        if(_into == null) {
+            return { bytes: _bytes, complete: (_read & 1) != 0 };
+        }
+
+        _into.bytes = _bytes;
+        _into.complete = (_read & 1) != 0;
+
+        return _into;
+
+    } //audio_load_portion_into
+
+        /** The format `audio_load_info` loads a path as when none is given, from the extension */
+    public function audio_format_from_path( _path:String ) : AudioFormatType {
+
+        return switch(haxe.io.Path.extension(_path)) {
+            case 'wav': AudioFormatType.wav;
+            case 'ogg': AudioFormatType.ogg;
+            case 'pcm': AudioFormatType.pcm;
+            case _: AudioFormatType.unknown;
+        }
+
+    } //audio_format_from_path
+
+    function audio_info_from_native( _native_info:NativeAudioInfo ) : AudioInfo {
+
+        var _result_bytes = haxe.io.Bytes.ofData(_native_info.data.bytes);
+
+        return {
+
+            id:     _native_info.id,
+            format: _native_info.format,
+            handle: _native_info.handle,
+
+            data: {
+                samples         : new Uint8Array( _result_bytes ),
+                length          : _native_info.data.length,
+                length_pcm      : _native_info.data.length_pcm,
+                channels        : _native_info.data.channels,
+                rate            : _native_info.data.rate,
+                bitrate         : _native_info.data.bitrate,
+                bits_per_sample : _native_info.data.bits_per_sample,
+                sample_format   : _native_info.data.sample_format,
+                mapped          : _native_info.data.mapped,
+                loop_start      : _native_info.data.loop_start,
+                loop_length     : _native_info.data.loop_length
+            }
+
+        } //result_info
+
+    } //audio_info_from_native
+
 //ogg
 
-    function audio_load_ogg( _path:String, ?load:Bool=true ) : NativeAudioInfo {
-        return snow_assets_audio_load_info_ogg( _path, load, null, 0, 0 );
+    function audio_load_ogg( _path:String, ?load:Bool=true, ?_float:Bool=false, ?_resident:Bool=false ) : NativeAudioInfo {
+        return snow_assets_audio_load_info_ogg( _path, load, null, 0, 0, _float, _resident );
     } //audio_load_ogg
 
-    function audio_load_ogg_from_bytes( _path:String, _bytes:Uint8Array ) : NativeAudioInfo {
-        return snow_assets_audio_load_info_ogg( _path, true, _bytes.toBytes().getData(), _bytes.byteOffset, _bytes.byteLength );
+    function audio_load_ogg_from_bytes( _path:String, _bytes:Uint8Array, ?_float:Bool=false ) : NativeAudioInfo {
+        return snow_assets_audio_load_info_ogg( _path, true, _bytes.toBytes().getData(), _bytes.byteOffset, _bytes.byteLength, _float );
     } //audio_load_ogg
 
     function audio_load_portion_ogg( _info:AudioInfo, _start:Int, _len:Int ) : NativeAudioDataBlob {
@@ -249,6 +460,10 @@ class Assets implements snow.modules.interfaces.Assets {
         return snow_assets_audio_seek_bytes_ogg( _info, _to );
     } //audio_seek_source_ogg
 
+    function audio_stream_source_ogg( _info:AudioInfo, _ring_length:Int ) : Bool {
+        return snow_assets_audio_stream_ogg( _info, _ring_length );
+    } //audio_stream_source_ogg
+
 //wav
 
     function audio_load_wav( _path:String, ?load:Bool=true ) : NativeAudioInfo {
@@ -285,6 +500,24 @@ class Assets implements snow.modules.interfaces.Assets {
         return snow_assets_audio_seek_bytes_pcm( _info, _to );
     } //audio_seek_source_pcm
 
+//adpcm
+
+    function audio_load_adpcm( _path:String, ?load:Bool=true ) : NativeAudioInfo {
+        return snow_assets_audio_load_info_adpcm( _path, load, null, 0, 0 );
+    } //audio_load_adpcm
+
+    function audio_load_adpcm_from_bytes( _path:String, _bytes:Uint8Array ) : NativeAudioInfo {
+        return snow_assets_audio_load_info_adpcm( _path, true, _bytes.toBytes().getData(), _bytes.byteOffset, _bytes.byteLength );
+    } //audio_load_adpcm_from_bytes
+
+    function audio_load_portion_adpcm( _info:AudioInfo, _start:Int, _len:Int ) : NativeAudioDataBlob {
+        return snow_assets_audio_read_bytes_adpcm( _info, _start, _len );
+    } //audio_load_portion_adpcm
+
+    function audio_seek_source_adpcm( _info:AudioInfo, _to:Int ) : Bool {
+        return snow_assets_audio_seek_bytes_adpcm( _info, _to );
+    } //audio_seek_source_adpcm
+
 
 
 //Native bindings
@@ -293,18 +526,45 @@ class Assets implements snow.modules.interfaces.Assets {
     static var snow_assets_image_load_info       = Libs.load( "snow", "snow_assets_image_load_info", 2 );
     static var snow_assets_image_info_from_bytes = Libs.load( "snow", "snow_assets_image_info_from_bytes", 5 );
 
-    static var snow_assets_audio_load_info_ogg   = Libs.load( "snow", "snow_assets_audio_load_info_ogg", 5 );
+    static var snow_assets_audio_load_info_ogg   = Libs.load( "snow", "snow_assets_audio_load_info_ogg", -1 );
     static var snow_assets_audio_read_bytes_ogg  = Libs.load( "snow", "snow_assets_audio_read_bytes_ogg", 3 );
+    static var snow_assets_audio_read_into_ogg   = Libs.load( "snow", "snow_assets_audio_read_into_ogg", 5 );
+    static var snow_assets_audio_read_all_ogg    = Libs.load( "snow", "snow_assets_audio_read_all_ogg", 1 );
     static var snow_assets_audio_seek_bytes_ogg  = Libs.load( "snow", "snow_assets_audio_seek_bytes_ogg", 2 );
+    static var snow_assets_audio_stream_ogg      = Libs.load( "snow", "snow_assets_audio_stream_ogg", 2 );
+    static var snow_assets_audio_seek_index_ogg  = Libs.load( "snow", "snow_assets_audio_seek_index_ogg", 1 );
+    static var snow_assets_audio_seek_index_files = Libs.load( "snow", "snow_assets_audio_seek_index_files", 1 );
+    static var snow_assets_audio_shutdown        = Libs.load( "snow", "snow_assets_audio_shutdown", 0 );
 
     static var snow_assets_audio_load_info_wav   = Libs.load( "snow", "snow_assets_audio_load_info_wav", 5 );
     static var snow_assets_audio_read_bytes_wav  = Libs.load( "snow", "snow_assets_audio_read_bytes_wav", 3 );
+    static var snow_assets_audio_read_into_wav   = Libs.load( "snow", "snow_assets_audio_read_into_wav", 5 );
+    static var snow_assets_audio_read_all_wav    = Libs.load( "snow", "snow_assets_audio_read_all_wav", 1 );
     static var snow_assets_audio_seek_bytes_wav  = Libs.load( "snow", "snow_assets_audio_seek_bytes_wav", 2 );
 
     static var snow_assets_audio_load_info_pcm   = Libs.load( "snow", "snow_assets_audio_load_info_pcm", 5 );
     static var snow_assets_audio_read_bytes_pcm  = Libs.load( "snow", "snow_assets_audio_read_bytes_pcm", 3 );
+    static var snow_assets_audio_read_into_pcm   = Libs.load( "snow", "snow_assets_audio_read_into_pcm", 5 );
+    static var snow_assets_audio_read_all_pcm    = Libs.load( "snow", "snow_assets_audio_read_all_pcm", 1 );
     static var snow_assets_audio_seek_bytes_pcm  = Libs.load( "snow", "snow_assets_audio_seek_bytes_pcm", 2 );
 
+    static var snow_assets_audio_load_info_adpcm  = Libs.load( "snow", "snow_assets_audio_load_info_adpcm", 5 );
+    static var snow_assets_audio_read_bytes_adpcm = Libs.load( "snow", "snow_assets_audio_read_bytes_adpcm", 3 );
+    static var snow_assets_audio_read_into_adpcm  = Libs.load( "snow", "snow_assets_audio_read_into_adpcm", 5 );
+    static var snow_assets_audio_read_all_adpcm   = Libs.load( "snow", "snow_assets_audio_read_all_adpcm", 1 );
+    static var snow_assets_audio_seek_bytes_adpcm = Libs.load( "snow", "snow_assets_audio_seek_bytes_adpcm", 2 );
+
+    static var snow_assets_audio_convert         = Libs.load( "snow", "snow_assets_audio_convert", 5 );
+
+    static var snow_assets_audio_cache_budget    = Libs.load( "snow", "snow_assets_audio_cache_budget", 1 );
+    static var snow_assets_audio_cache_clear     = Libs.load( "snow", "snow_assets_audio_cache_clear", 0 );
+    static var snow_assets_audio_cache_stats     = Libs.load( "snow", "snow_assets_audio_cache_stats", 0 );
+    static var snow_assets_audio_resident_stats  = Libs.load( "snow", "snow_assets_audio_resident_stats", 0 );
+
+    static var snow_assets_audio_load_batch      = Libs.load( "snow", "snow_assets_audio_load_batch", 3 );
+    static var snow_assets_audio_load_batch_poll = Libs.load( "snow", "snow_assets_audio_load_batch_poll", 1 );
+    static var snow_assets_audio_load_batch_end  = Libs.load( "snow", "snow_assets_audio_load_batch_end", 1 );
+
 //Required by module interface
 
     function init():Void {}
@@ -333,6 +593,10 @@ private typedef NativeAudioDataInfo = {
     rate : Int,
     bitrate : Int,
     bits_per_sample : Int,
+    sample_format : Int,
+    mapped : Bool,
+    ?loop_start : Int,
+    ?loop_length : Int,
     bytes : haxe.io.BytesData
 }
 
@@ -340,3 +604,16 @@ private typedef NativeAudioDataBlob = {
     bytes : haxe.io.BytesData,
     complete : Bool
 }
+
+private typedef NativeAudioConverted = {
+    bytes : haxe.io.BytesData,
+    sample_format : Int,
+    channels : Int,
+    rate : Int
+}
+
+private typedef NativeAudioBatchResult = {
+    index : Int,
+    info : NativeAudioInfo
+}
+
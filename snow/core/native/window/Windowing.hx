@@ -5,6 +5,7 @@ import snow.Snow;
 import snow.types.Types;
 import snow.system.window.Window;
 import snow.system.window.Windowing;
+import snow.modules.opengl.native.GLRenderThread;
 
 import snow.api.Libs;
 
@@ -38,9 +39,16 @@ class Windowing implements snow.modules.interfaces.Windowing {
         snow_window_show( window.handle );
     }
 
-    public inline function destroy_window( window:Window ) {
+    public function destroy_window( window:Window ) {
+
+            //the render thread gives the context back before the window goes
+        if(GLRenderThread.window == window) {
+            GLRenderThread.stop();
+        }
+
 		snow_window_destroy_window( window.handle );
-    }
+
+    } //destroy_window
 
     public inline function update_window( window:Window ) {
 		snow_window_update( window.handle );
@@ -50,9 +58,17 @@ class Windowing implements snow.modules.interfaces.Windowing {
 		snow_window_render( window.handle );
     }
 
-    public inline function swap( window:Window ) {
+    public function swap( window:Window ) {
+
+            //the render thread swaps after drawing the frame recorded for it
+        if(GLRenderThread.window == window) {
+            GLRenderThread.submit( window.commands, true );
+            return;
+        }
+
 		snow_window_swap( window.handle );
-    }
+
+    } //swap
 
     public inline function simple_message( window:Window, message:String, ?title:String="" ) {
 		snow_window_simple_message( window.handle, message, title );
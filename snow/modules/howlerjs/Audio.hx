@@ -102,6 +102,7 @@ class Audio implements snow.modules.interfaces.Audio {
             case AudioFormatType.ogg: 'ogg';
             case AudioFormatType.wav: 'wav';
             case AudioFormatType.pcm: throw Error.error('pcm audio format unsupported atm');
+            case AudioFormatType.adpcm: throw Error.error('adpcm audio format unsupported atm');
             case AudioFormatType.unknown: throw Error.error('unknown audio format for create_sound_from_bytes ' + _name);
         }
 
@@ -7,10 +7,16 @@ package snow.modules.openal;
 
 import snow.api.Libs;
 import snow.api.buffers.Float32Array;
+import snow.api.buffers.Float64Array;
+import snow.api.buffers.Int32Array;
+import snow.api.buffers.ArrayBufferView;
 
 
 abstract Context(Null<Float>) from Null<Float> to Null<Float> { }
 abstract Device(Null<Float>) from Null<Float> to Null<Float> { }
+abstract Stream(Null<Float>) from Null<Float> to Null<Float> { }
+abstract Voice(Null<Float>) from Null<Float> to Null<Float> { }
+abstract MixerVoice(Null<Float>) from Null<Float> to Null<Float> { }
 
 class AL {
 
@@ -55,6 +61,16 @@ class AL {
     public static var FORMAT_MONO16 : Int                       = 0x1101;
     public static var FORMAT_STEREO8 : Int                      = 0x1102;
     public static var FORMAT_STEREO16 : Int                     = 0x1103;
+        /** AL_EXT_FLOAT32 */
+    public static var FORMAT_MONO_FLOAT32 : Int                 = 0x10010;
+        /** AL_EXT_FLOAT32 */
+    public static var FORMAT_STEREO_FLOAT32 : Int               = 0x10011;
+        /** AL_EXT_IMA4 */
+    public static var FORMAT_MONO_IMA4 : Int                    = 0x1300;
+        /** AL_EXT_IMA4 */
+    public static var FORMAT_STEREO_IMA4 : Int                  = 0x1301;
+        /** AL_SOFT_block_alignment */
+    public static var UNPACK_BLOCK_ALIGNMENT_SOFT : Int         = 0x200C;
     public static var FREQUENCY : Int                           = 0x2001;
     public static var BITS : Int                                = 0x2002;
     public static var CHANNELS : Int                            = 0x2003;
@@ -210,6 +226,12 @@ class AL {
         return alhx_GetListenerfv(param, count);
     }
 
+        /** Like `getListenerfv` but writes into `values` instead of allocating an array.
+            Returns the number of floats written, which is 0 if `values` is too small for `param`. */
+    public static function getListenerfvInto(param:Int, values:Float32Array) : Int {
+        return alhx_GetListenerfvInto(param, values.buffer.getData(), values.byteOffset, values.byteLength);
+    }
+
     public static function getListeneri(param:Int) : Int {
         return alhx_GetListeneri(param);
     }
@@ -274,6 +296,12 @@ class AL {
         return alhx_GetSourcefv(source,param);
     }
 
+        /** Like `getSourcefv` but writes into `values` instead of allocating an array.
+            Returns the number of floats written, which is 0 if `values` is too small for `param`. */
+    public static function getSourcefvInto(source:Int, param:Int, values:Float32Array) : Int {
+        return alhx_GetSourcefvInto(source, param, values.buffer.getData(), values.byteOffset, values.byteLength);
+    }
+
     public static function getSourcei(source:Int,  param:Int) : Int {
         return alhx_GetSourcei(source,param);
     }
@@ -328,12 +356,31 @@ class AL {
         return alhx_SourceUnqueueBuffers(source, nb);
     }
 
+        /** Queues the first `nb` buffer names from `buffers`, without allocating.
+            Returns the number queued, clamped to the length of `buffers`. */
+    public static function sourceQueueBuffersFrom(source:Int, nb:Int, buffers:Int32Array) : Int {
+        return alhx_SourceQueueBuffersFrom(source, nb, buffers.buffer.getData(), buffers.byteOffset, buffers.byteLength);
+    }
+
+        /** Unqueues up to `nb` processed buffers into `buffers`, without allocating.
+            Only buffers the source has finished with are unqueued, so this never raises an AL error
+            when asked for more than are ready. Returns the number written into `buffers`. */
+    public static function sourceUnqueueBuffersInto(source:Int, nb:Int, buffers:Int32Array) : Int {
+        return alhx_SourceUnqueueBuffersInto(source, nb, buffers.buffer.getData(), buffers.byteOffset, buffers.byteLength);
+    }
+
 //buffer management
 
     public static function genBuffers(n:Int) : Array<Int>  {
         return alhx_GenBuffers(n);
     }
 
+        /** Generates `n` buffers into `buffers`, without allocating.
+            Returns the number generated, clamped to the length of `buffers`. */
+    public static function genBuffersInto(n:Int, buffers:Int32Array) : Int {
+        return alhx_GenBuffersInto(n, buffers.buffer.getData(), buffers.byteOffset, buffers.byteLength);
+    }
+
     public static function deleteBuffers(buffers:Array<Int>) : Void {
         alhx_DeleteBuffers(buffers.length, buffers);
     }
@@ -344,10 +391,23 @@ class AL {
 
 //buffer data and state
 
-    public static function bufferData(buffer:Int, format:Int, data:Float32Array, frequency:Int) : Void {
+        /** Uploads `data.byteLength` bytes from the view's `byteOffset`, so any typed array view over pcm can be given directly. */
+    public static function bufferData(buffer:Int, format:Int, data:ArrayBufferView, frequency:Int) : Void {
         alhx_BufferData(buffer, format, data.buffer.getData(), data.byteOffset, data.byteLength, frequency);
     }
 
+        /** Uploads the whole pcm of a memory mapped audio source (`info.data.mapped`) straight from the mapping.
+            Returns false if the source isn't mapped. */
+    public static function bufferDataMapped(buffer:Int, format:Int, info:snow.types.Types.AudioInfo, frequency:Int) : Bool {
+        return alhx_BufferDataMapped(buffer, format, info, frequency);
+    }
+
+        /** Decodes the whole of an audio source natively and uploads it, without the samples passing through haxe.
+            Goes through the decoded audio cache like `Assets.audio_load_samples`. Returns false if nothing was uploaded. */
+    public static function bufferDataDecode(buffer:Int, format:Int, info:snow.types.Types.AudioInfo, frequency:Int) : Bool {
+        return alhx_BufferDataDecode(buffer, format, info, frequency);
+    }
+
     public static function bufferf(buffer:Int, param:Int, value:Float) : Void {
         alhx_Bufferf(buffer, param, value);
     }
@@ -415,13 +475,326 @@ class AL {
         alhx_DeleteBuffer(buffer);
     }
 
+        //one scratch name for the single buffer helpers, these
+        //are called per buffer by streams so they shouldn't allocate
+    static var single_buffer = new Int32Array(1);
+
     public static function sourceQueueBuffer(source:Int, buffer:Int) : Void {
-        alhx_SourceQueueBuffers(source, 1, [buffer]);
+        single_buffer[0] = buffer;
+        sourceQueueBuffersFrom(source, 1, single_buffer);
     }
 
     public static function sourceUnqueueBuffer(source:Int) : Int {
-        var res = alhx_SourceUnqueueBuffers(source, 1);
-        return res[0];
+        single_buffer[0] = 0;
+        sourceUnqueueBuffersInto(source, 1, single_buffer);
+        return single_buffer[0];
+    }
+
+//batched source updates
+
+        /** Applies a packed list of float source properties in one call, rather than a call per property.
+            Each record is a `source, param, count` header in `headers`, with its `count` values taken in turn
+            from `values`. A count of 1 is applied like `sourcef`, 3 like `source3f` and anything else like `sourcefv`.
+            The ids stay in an int array, as a float can't hold every source id exactly.
+            `records` is the number of headers in use, so the arrays can be refilled each frame, and is all of them by default.
+            With `defer` set, the whole batch reaches the mixer at once.
+            Returns the number of records applied, which stops early at a malformed record. */
+    public static function sourceBatchf(headers:Int32Array, values:Float32Array, ?records:Int = -1, ?defer:Bool = false) : Int {
+        var _headersLength = (records < 0 || records * 3 > headers.length) ? headers.byteLength : records * 12;
+        return alhx_SourceBatchf(headers.buffer.getData(), headers.byteOffset, _headersLength, values.buffer.getData(), values.byteOffset, values.byteLength, defer);
+    }
+
+        /** As `sourceBatchf`, for integer properties like `BUFFER` and `LOOPING`, each record being `source, param, count, values...` */
+    public static function sourceBatchi(records:Int32Array, ?length:Int = -1, ?defer:Bool = false) : Int {
+        var _byteLength = (length < 0 || length > records.length) ? records.byteLength : length * 4;
+        return alhx_SourceBatchi(records.buffer.getData(), records.byteOffset, _byteLength, defer);
+    }
+
+//shared buffers
+
+        /** True if a buffer was already filled for `key`, without taking a reference to it */
+    public static function bufferShared(key:String) : Bool {
+        return alhx_BufferShared(key);
+    }
+
+        /** Takes a reference to the buffer filled for `key` and returns it, or 0 if there isn't one yet */
+    public static function bufferShare(key:String) : Int {
+        return alhx_BufferShare(key);
+    }
+
+        /** Hands a filled buffer to the cache under `key`, as its first reference.
+            Returns false if the key or the buffer is already shared. */
+    public static function bufferShareStore(key:String, buffer:Int) : Bool {
+        return alhx_BufferShareStore(key, buffer);
+    }
+
+        /** Lets go of a reference from `bufferShare` or `bufferShareStore`, deleting the buffer with the last one.
+            A buffer that isn't shared is deleted straight away. Returns true if the buffer was deleted. */
+    public static function bufferRelease(buffer:Int) : Bool {
+        return alhx_BufferRelease(buffer);
+    }
+
+        /** Returns `[buffers, references, resident, deduplicated, hits, misses]`, where resident is the bytes
+            the shared buffers hold, and deduplicated the bytes the references beyond the first would have cost */
+    public static function bufferShareStats() : Array<Float> {
+        return alhx_BufferShareStats();
+    }
+
+//voices
+
+        /** Creates a pool of up to `count` sources shared by the voices, stopping early where the device runs out.
+            A few of the device sources are always left out of the pool, for streams, the mixer and `genSource`.
+            Returns the number of sources in the pool. */
+    public static function voicesInit(count:Int) : Int {
+        return alhx_VoicesInit(count);
+    }
+
+        /** Deletes the pool sources, once every voice is destroyed */
+    public static function voicesDestroy() : Void {
+        alhx_VoicesDestroy();
+    }
+
+        /** Ranks the voices by priority × audibility, gives the pool sources to the top ones taking them from the quietest,
+            and moves the virtual voices on in time. Called once per frame. */
+    public static function voicesUpdate() : Void {
+        alhx_VoicesUpdate();
+    }
+
+        /** Returns `[sources, real, virtual, stolen]`: the pool size, the playing voices with and without a source,
+            and the number of times a voice lost its source to a louder one */
+    public static function voicesStats() : Array<Int> {
+        return alhx_VoicesStats();
+    }
+
+        /** A voice playing `buffer`, which lasts `duration` seconds. It holds a source from the pool only while it ranks high enough. */
+    public static function voiceCreate(buffer:Int, duration:Float) : Voice {
+        return alhx_VoiceCreate(buffer, duration);
+    }
+
+    public static function voiceDestroy(voice:Voice) : Void {
+        alhx_VoiceDestroy(voice);
+    }
+
+    public static function voicePlay(voice:Voice) : Void {
+        alhx_VoicePlay(voice);
+    }
+
+    public static function voicePause(voice:Voice) : Void {
+        alhx_VoicePause(voice);
+    }
+
+    public static function voiceStop(voice:Voice) : Void {
+        alhx_VoiceStop(voice);
+    }
+
+        /** `INITIAL`, `PLAYING`, `PAUSED` or `STOPPED`, whether or not the voice holds a source */
+    public static function voiceState(voice:Voice) : Int {
+        return alhx_VoiceState(voice);
+    }
+
+        /** Like `sourcef`, for `GAIN`, `PITCH`, the distance and cone properties, `MIN_GAIN`, `MAX_GAIN`,
+            `SEC_OFFSET` and `SAMPLE_OFFSET`. The voice keeps these while virtual and sets them all on any source
+            it is given, any other property is ignored so it can't be left behind on a shared source. */
+    public static function voiceSourcef(voice:Voice, param:Int, value:Float) : Void {
+        alhx_VoiceSourcef(voice, param, value);
+    }
+
+        /** Like `source3f`, for `POSITION`, `VELOCITY` and `DIRECTION`, kept while the voice is virtual */
+    public static function voiceSource3f(voice:Voice, param:Int, value1:Float, value2:Float, value3:Float) : Void {
+        alhx_VoiceSource3f(voice, param, value1, value2, value3);
+    }
+
+        /** Like `sourcei`, for `LOOPING`, `SOURCE_RELATIVE` and the float properties of `voiceSourcef`, kept while the voice is virtual.
+            The buffer belongs to the voice and isn't set this way. */
+    public static function voiceSourcei(voice:Voice, param:Int, value:Int) : Void {
+        alhx_VoiceSourcei(voice, param, value);
+    }
+
+    public static function voiceGetSourcef(voice:Voice, param:Int) : Float {
+        return alhx_VoiceGetSourcef(voice, param);
+    }
+
+        /** How much the voice matters against others that are as loud, 1 by default. 0 never gets a source. */
+    public static function voicePriority(voice:Voice, priority:Float) : Void {
+        alhx_VoicePriority(voice, priority);
+    }
+
+//native streaming
+
+        /** Raised by `streamEvents` when a stream played out the end of its data */
+    public static var STREAM_ENDED : Int                        = 1;
+        /** Raised by `streamEvents` when a looping stream went back to the start */
+    public static var STREAM_LOOPED : Int                       = 2;
+
+        /** Hands a streamed source and its buffers to the native stream thread, which unqueues, decodes and requeues
+            from the `info` source from then on, independent of the frame rate. The info source must not be read elsewhere after this.
+            Returns null if the info source can't be streamed natively. */
+    public static function streamCreate(source:Int, buffers:Array<Int>, info:snow.types.Types.AudioInfo, format:Int, buffer_length:Int) : Stream {
+        return alhx_StreamCreate(source, buffers, info, format, buffer_length);
+    }
+
+    public static function streamPlay(stream:Stream) : Void {
+        alhx_StreamPlay(stream);
+    }
+
+        /** Pauses the source, keeping what is queued so playing again resumes without a gap */
+    public static function streamPause(stream:Stream) : Void {
+        alhx_StreamPause(stream);
+    }
+
+        /** Stops the source and rewinds the stream to the start */
+    public static function streamStop(stream:Stream) : Void {
+        alhx_StreamStop(stream);
+    }
+
+    public static function streamSeek(stream:Stream, bytes:Int) : Void {
+        alhx_StreamSeek(stream, bytes);
+    }
+
+    public static function streamLoop(stream:Stream, loop:Bool) : Void {
+        alhx_StreamLoop(stream, loop);
+    }
+
+        /** The region a looping stream repeats, in bytes, where an `end` of 0 is the end of the data.
+            The head of the loop is decoded ahead, so the stream wraps inside one buffer fill without a seek or a gap. */
+    public static function streamLoopPoints(stream:Stream, start:Int, end:Int) : Void {
+        alhx_StreamLoopPoints(stream, start, end);
+    }
+
+        /** The playback position of the stream in bytes */
+    public static function streamPosition(stream:Stream) : Int {
+        return alhx_StreamPosition(stream);
+    }
+
+        /** Returns the `STREAM_*` flags raised since the last call, and clears them */
+    public static function streamEvents(stream:Stream) : Int {
+        return alhx_StreamEvents(stream);
+    }
+
+        /** Takes the stream off the stream thread. The source and buffers are left to delete. */
+    public static function streamDestroy(stream:Stream) : Void {
+        alhx_StreamDestroy(stream);
+    }
+
+        /** Writes the counters of one stream into `into`, indexed by the `STREAM_COUNTER_*` values,
+            and returns how many were written. With `reset`, the longest decode and the queue depths start over. */
+    public static function streamCounters(stream:Stream, into:Float64Array, ?reset:Bool = false) : Int {
+        return alhx_StreamCounters(stream, into.buffer.getData(), into.byteOffset, into.byteLength, reset);
+    }
+
+        /** The times the source stopped with data left to play */
+    public static var STREAM_COUNTER_UNDERRUNS : Int            = 0;
+        /** The buffers decoded */
+    public static var STREAM_COUNTER_DECODES : Int              = 1;
+        /** The milliseconds spent decoding, in total */
+    public static var STREAM_COUNTER_DECODE_MS : Int            = 2;
+        /** The longest single decode in milliseconds */
+    public static var STREAM_COUNTER_DECODE_MS_MAX : Int        = 3;
+        /** The fewest buffers queued while playing */
+    public static var STREAM_COUNTER_QUEUE_MIN : Int            = 4;
+        /** The average buffers queued while playing */
+    public static var STREAM_COUNTER_QUEUE_AVG : Int            = 5;
+    public static var STREAM_COUNTER_COUNT : Int                = 6;
+
+//instrumentation
+
+        /** A snapshot of the whole audio engine written into `into`, indexed by the `COUNTER_*` values,
+            returning how many were written. It doesn't allocate, so it can be read every frame, for example
+            to tune `stream_buffer_length` against the underruns and the queue depth. With `reset`, the
+            longest decode and the queue depths start over after this read. */
+    public static function audioCounters(into:Float64Array, ?reset:Bool = false) : Int {
+        return alhx_AudioCounters(into.buffer.getData(), into.byteOffset, into.byteLength, reset);
+    }
+
+        /** The sources made through these bindings that are alive */
+    public static var COUNTER_SOURCES : Int                     = 0;
+        /** The buffers made through these bindings that are alive */
+    public static var COUNTER_BUFFERS : Int                     = 1;
+        /** The bytes of pcm uploaded into buffers that are alive */
+    public static var COUNTER_PCM_BYTES : Int                   = 2;
+        /** The bytes held by the decoded audio cache */
+    public static var COUNTER_CACHE_BYTES : Int                 = 3;
+        /** The native streams on the stream thread */
+    public static var COUNTER_STREAMS : Int                     = 4;
+        /** The times any native stream stopped with data left to play */
+    public static var COUNTER_UNDERRUNS : Int                   = 5;
+        /** The calls into the decoders, from every thread */
+    public static var COUNTER_DECODES : Int                     = 6;
+        /** The milliseconds spent in the decoders, in total */
+    public static var COUNTER_DECODE_MS : Int                   = 7;
+        /** The longest single decode in milliseconds */
+    public static var COUNTER_DECODE_MS_MAX : Int               = 8;
+        /** The fewest buffers queued by a playing native stream */
+    public static var COUNTER_QUEUE_MIN : Int                   = 9;
+        /** The average buffers queued across the playing native streams */
+    public static var COUNTER_QUEUE_AVG : Int                   = 10;
+    public static var COUNTER_COUNT : Int                       = 11;
+
+//software mixer
+
+        /** Starts the native mixer, which mixes its voices on its own thread at `rate`, the device rate,
+            into one streamed source. Returns true if it is running. */
+    public static function mixerInit(rate:Int) : Bool {
+        return alhx_MixerInit(rate);
+    }
+
+        /** Stops the mixer and deletes its source. Its voices stay valid to destroy, but won't play again. */
+    public static function mixerDestroy() : Void {
+        alhx_MixerDestroy();
+    }
+
+        /** Returns `[voices, mixed, underruns, load]`: the voices that exist, the voices mixed into the last block,
+            the times the output ran dry, and the time the last block took to mix as a fraction of the time it plays for */
+    public static function mixerStats() : Array<Float> {
+        return alhx_MixerStats();
+    }
+
+        /** A mixer voice for the interleaved samples in `samples`, of 1 or 2 channels in a `snow.types.Types.AudioSampleFormat`.
+            The samples are copied, as float. Returns null if the mixer isn't running or the samples can't be mixed. */
+    public static function mixerVoiceCreate(samples:ArrayBufferView, sample_format:Int, channels:Int, rate:Int) : MixerVoice {
+        return alhx_MixerVoiceCreate(samples.buffer.getData(), samples.byteOffset, samples.byteLength, sample_format, channels, rate);
+    }
+
+    public static function mixerVoiceDestroy(voice:MixerVoice) : Void {
+        alhx_MixerVoiceDestroy(voice);
+    }
+
+        /** Plays the voice from the start, or from where it was paused */
+    public static function mixerVoicePlay(voice:MixerVoice) : Void {
+        alhx_MixerVoicePlay(voice);
+    }
+
+    public static function mixerVoicePause(voice:MixerVoice) : Void {
+        alhx_MixerVoicePause(voice);
+    }
+
+    public static function mixerVoiceStop(voice:MixerVoice) : Void {
+        alhx_MixerVoiceStop(voice);
+    }
+
+        /** `PLAYING`, `PAUSED` or `STOPPED`, like a source */
+    public static function mixerVoiceState(voice:MixerVoice) : Int {
+        return alhx_MixerVoiceState(voice);
+    }
+
+        /** Like `sourcef`, for `GAIN`, `PITCH`, `SEC_OFFSET` and `SAMPLE_OFFSET` */
+    public static function mixerVoicef(voice:MixerVoice, param:Int, value:Float) : Void {
+        alhx_MixerVoicef(voice, param, value);
+    }
+
+        /** Like `sourcei`, for `LOOPING` */
+    public static function mixerVoicei(voice:MixerVoice, param:Int, value:Int) : Void {
+        alhx_MixerVoicei(voice, param, value);
+    }
+
+        /** -1 is left and 1 is right. Mono voices are panned with equal power, stereo voices are balanced. */
+    public static function mixerVoicePan(voice:MixerVoice, pan:Float) : Void {
+        alhx_MixerVoicePan(voice, pan);
+    }
+
+        /** Like `getSourcef`, for `GAIN`, `PITCH`, `SEC_OFFSET` and `SAMPLE_OFFSET` */
+    public static function mixerGetVoicef(voice:MixerVoice, param:Int) : Float {
+        return alhx_MixerGetVoicef(voice, param);
     }
 
     public static var INVALID_NAME_MEANING : String             = "AL.INVALID_NAME: Invalid parameter name";
@@ -477,6 +850,7 @@ class AL {
     static var alhx_GetListenerf            = Libs.load("snow", "alhx_GetListenerf", 1);
     static var alhx_GetListener3f           = Libs.load("snow", "alhx_GetListener3f", 1);
     static var alhx_GetListenerfv           = Libs.load("snow", "alhx_GetListenerfv", 2);
+    static var alhx_GetListenerfvInto       = Libs.load("snow", "alhx_GetListenerfvInto", 4);
     static var alhx_GetListeneri            = Libs.load("snow", "alhx_GetListeneri", 1);
     static var alhx_GetListener3i           = Libs.load("snow", "alhx_GetListener3i", 1);
     static var alhx_GetListeneriv           = Libs.load("snow", "alhx_GetListeneriv", 2);
@@ -495,6 +869,7 @@ class AL {
     static var alhx_GetSourcef              = Libs.load("snow", "alhx_GetSourcef", 2);
     static var alhx_GetSource3f             = Libs.load("snow", "alhx_GetSource3f", 2);
     static var alhx_GetSourcefv             = Libs.load("snow", "alhx_GetSourcefv", 2);
+    static var alhx_GetSourcefvInto         = Libs.load("snow", "alhx_GetSourcefvInto", -1);
     static var alhx_GetSourcei              = Libs.load("snow", "alhx_GetSourcei", 2);
     static var alhx_GetSource3i             = Libs.load("snow", "alhx_GetSource3i", 2);
     static var alhx_GetSourceiv             = Libs.load("snow", "alhx_GetSourceiv", 3);
@@ -506,6 +881,8 @@ class AL {
 
     static var alhx_SourceQueueBuffers      = Libs.load("snow", "alhx_SourceQueueBuffers", 3);
     static var alhx_SourceUnqueueBuffers    = Libs.load("snow", "alhx_SourceUnqueueBuffers", 2);
+    static var alhx_SourceQueueBuffersFrom  = Libs.load("snow", "alhx_SourceQueueBuffersFrom", -1);
+    static var alhx_SourceUnqueueBuffersInto = Libs.load("snow", "alhx_SourceUnqueueBuffersInto", -1);
 
     static var alhx_SourcePlay              = Libs.load("snow", "alhx_SourcePlay", 1);
     static var alhx_SourceStop              = Libs.load("snow", "alhx_SourceStop", 1);
@@ -513,10 +890,13 @@ class AL {
     static var alhx_SourcePause             = Libs.load("snow", "alhx_SourcePause", 1);
 
     static var alhx_GenBuffers              = Libs.load("snow", "alhx_GenBuffers", 1);
+    static var alhx_GenBuffersInto          = Libs.load("snow", "alhx_GenBuffersInto", 4);
     static var alhx_DeleteBuffers           = Libs.load("snow", "alhx_DeleteBuffers", 2);
     static var alhx_IsBuffer                = Libs.load("snow", "alhx_IsBuffer", 1);
 
     static var alhx_BufferData              = Libs.load("snow", "alhx_BufferData", -1);
+    static var alhx_BufferDataMapped        = Libs.load("snow", "alhx_BufferDataMapped", 4);
+    static var alhx_BufferDataDecode        = Libs.load("snow", "alhx_BufferDataDecode", 4);
 
     static var alhx_Bufferf                 = Libs.load("snow", "alhx_Bufferf", 3);
     static var alhx_Buffer3f                = Libs.load("snow", "alhx_Buffer3f", 5);
@@ -539,6 +919,59 @@ class AL {
     static var alhx_GenBuffer               = Libs.load("snow", "alhx_GenBuffer", 0);
     static var alhx_DeleteBuffer            = Libs.load("snow", "alhx_DeleteBuffer", 1);
 
+    static var alhx_SourceBatchf            = Libs.load("snow", "alhx_SourceBatchf", -1);
+    static var alhx_SourceBatchi            = Libs.load("snow", "alhx_SourceBatchi", 4);
+
+    static var alhx_BufferShared            = Libs.load("snow", "alhx_BufferShared", 1);
+    static var alhx_BufferShare             = Libs.load("snow", "alhx_BufferShare", 1);
+    static var alhx_BufferShareStore        = Libs.load("snow", "alhx_BufferShareStore", 2);
+    static var alhx_BufferRelease           = Libs.load("snow", "alhx_BufferRelease", 1);
+    static var alhx_BufferShareStats        = Libs.load("snow", "alhx_BufferShareStats", 0);
+
+    static var alhx_VoicesInit              = Libs.load("snow", "alhx_VoicesInit", 1);
+    static var alhx_VoicesDestroy           = Libs.load("snow", "alhx_VoicesDestroy", 0);
+    static var alhx_VoicesUpdate            = Libs.load("snow", "alhx_VoicesUpdate", 0);
+    static var alhx_VoicesStats             = Libs.load("snow", "alhx_VoicesStats", 0);
+    static var alhx_VoiceCreate             = Libs.load("snow", "alhx_VoiceCreate", 2);
+    static var alhx_VoiceDestroy            = Libs.load("snow", "alhx_VoiceDestroy", 1);
+    static var alhx_VoicePlay               = Libs.load("snow", "alhx_VoicePlay", 1);
+    static var alhx_VoicePause              = Libs.load("snow", "alhx_VoicePause", 1);
+    static var alhx_VoiceStop               = Libs.load("snow", "alhx_VoiceStop", 1);
+    static var alhx_VoiceState              = Libs.load("snow", "alhx_VoiceState", 1);
+    static var alhx_VoiceSourcef            = Libs.load("snow", "alhx_VoiceSourcef", 3);
+    static var alhx_VoiceSource3f           = Libs.load("snow", "alhx_VoiceSource3f", 5);
+    static var alhx_VoiceSourcei            = Libs.load("snow", "alhx_VoiceSourcei", 3);
+    static var alhx_VoiceGetSourcef         = Libs.load("snow", "alhx_VoiceGetSourcef", 2);
+    static var alhx_VoicePriority           = Libs.load("snow", "alhx_VoicePriority", 2);
+
+    static var alhx_StreamCreate            = Libs.load("snow", "alhx_StreamCreate", 5);
+    static var alhx_StreamPlay              = Libs.load("snow", "alhx_StreamPlay", 1);
+    static var alhx_StreamPause             = Libs.load("snow", "alhx_StreamPause", 1);
+    static var alhx_StreamStop              = Libs.load("snow", "alhx_StreamStop", 1);
+    static var alhx_StreamSeek              = Libs.load("snow", "alhx_StreamSeek", 2);
+    static var alhx_StreamLoop              = Libs.load("snow", "alhx_StreamLoop", 2);
+    static var alhx_StreamLoopPoints        = Libs.load("snow", "alhx_StreamLoopPoints", 3);
+    static var alhx_StreamPosition          = Libs.load("snow", "alhx_StreamPosition", 1);
+    static var alhx_StreamEvents            = Libs.load("snow", "alhx_StreamEvents", 1);
+    static var alhx_StreamDestroy           = Libs.load("snow", "alhx_StreamDestroy", 1);
+    static var alhx_StreamCounters          = Libs.load("snow", "alhx_StreamCounters", 5);
+
+    static var alhx_AudioCounters           = Libs.load("snow", "alhx_AudioCounters", 4);
+
+    static var alhx_MixerInit               = Libs.load("snow", "alhx_MixerInit", 1);
+    static var alhx_MixerDestroy            = Libs.load("snow", "alhx_MixerDestroy", 0);
+    static var alhx_MixerStats              = Libs.load("snow", "alhx_MixerStats", 0);
+    static var alhx_MixerVoiceCreate        = Libs.load("snow", "alhx_MixerVoiceCreate", -1);
+    static var alhx_MixerVoiceDestroy       = Libs.load("snow", "alhx_MixerVoiceDestroy", 1);
+    static var alhx_MixerVoicePlay          = Libs.load("snow", "alhx_MixerVoicePlay", 1);
+    static var alhx_MixerVoicePause         = Libs.load("snow", "alhx_MixerVoicePause", 1);
+    static var alhx_MixerVoiceStop          = Libs.load("snow", "alhx_MixerVoiceStop", 1);
+    static var alhx_MixerVoiceState         = Libs.load("snow", "alhx_MixerVoiceState", 1);
+    static var alhx_MixerVoicef             = Libs.load("snow", "alhx_MixerVoicef", 3);
+    static var alhx_MixerVoicei             = Libs.load("snow", "alhx_MixerVoicei", 3);
+    static var alhx_MixerVoicePan           = Libs.load("snow", "alhx_MixerVoicePan", 2);
+    static var alhx_MixerGetVoicef          = Libs.load("snow", "alhx_MixerGetVoicef", 2);
+
 
 } //AL
 
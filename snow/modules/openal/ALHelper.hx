@@ -2,6 +2,8 @@ package snow.modules.openal;
 
 import snow.types.Types;
 import snow.modules.openal.AL;
+import snow.api.buffers.Float32Array;
+import snow.api.buffers.Int32Array;
 
 import snow.api.Debug.*;
 
@@ -10,16 +12,38 @@ import snow.api.Debug.*;
 @:log_as('audio')
 class ALHelper {
 
+        //the default source properties as batch records, with the source filled in per call
+    static var default_setup : Int32Array;
+    static var default_values : Float32Array;
+
         /** Set up a source using default values for PITCH, GAIN, POSITION, VELOCITY, and LOOPING */
     public static function default_source_setup( source:Int ) {
 
-            //default to 1 pitch
-        AL.sourcef( source, AL.PITCH, 1.0 );
-            //default to max volume
-        AL.sourcef( source, AL.GAIN, 1.0 );
-            //default to 2d sound
-        AL.source3f( source, AL.POSITION, 0.0, 0.0, 0.0 );
-        AL.source3f( source, AL.VELOCITY, 0.0, 0.0, 0.0 );
+        if(default_setup == null) {
+            default_setup = new Int32Array([
+                0, AL.PITCH, 1,
+                0, AL.GAIN, 1,
+                0, AL.POSITION, 3,
+                0, AL.VELOCITY, 3
+            ]);
+            default_values = new Float32Array([
+                    //default to 1 pitch
+                1.0,
+                    //default to max volume
+                1.0,
+                    //default to 2d sound
+                0.0, 0.0, 0.0,
+                0.0, 0.0, 0.0
+            ]);
+        }
+
+            //one call for all of the float properties
+        default_setup[0] = source;
+        default_setup[3] = source;
+        default_setup[6] = source;
+        default_setup[9] = source;
+        AL.sourceBatchf( default_setup, default_values );
+
             //looping is false by default
         AL.sourcei( source, AL.LOOPING, AL.FALSE );
 
@@ -31,6 +55,18 @@ class ALHelper {
             //default format is mono 16
         var format = AL.FORMAT_MONO16;
 
+            //float samples are only decoded when AL_EXT_FLOAT32 is present, see `float32_available`
+        if(_info.data.sample_format == AudioSampleFormat.f32) {
+            if(_info.data.channels > 1) {
+                format = AL.FORMAT_STEREO_FLOAT32;
+                _debug("\t > format : STEREO FLOAT32");
+            } else {
+                format = AL.FORMAT_MONO_FLOAT32;
+                _debug("\t > format : MONO FLOAT32");
+            }
+            return format;
+        }
+
                 //if 2+ channels, it's stereo
             if(_info.data.channels > 1) {
                 if(_info.data.bits_per_sample == 8) {
@@ -54,5 +90,27 @@ class ALHelper {
 
     } //determine_format
 
+        /** The AL.FORMAT_*_IMA4 format for an adpcm `AudioInfo`, see `ima4_available` */
+    public static function determine_format_ima4( _info:AudioInfo ) : Int {
+
+        return (_info.data.channels > 1) ? AL.FORMAT_STEREO_IMA4 : AL.FORMAT_MONO_IMA4;
+
+    } //determine_format_ima4
+
+        /** Whether the current context can take adpcm blocks as they are, as AL.FORMAT_*_IMA4 buffers.
+            The blocks snow encodes are bigger than the default, so AL_SOFT_block_alignment is needed too. */
+    public static function ima4_available() : Bool {
+
+        return AL.isExtensionPresent('AL_EXT_IMA4') && AL.isExtensionPresent('AL_SOFT_block_alignment');
+
+    } //ima4_available
+
+        /** Whether the current context can take AL.FORMAT_*_FLOAT32 buffers */
+    public static function float32_available() : Bool {
+
+        return AL.isExtensionPresent('AL_EXT_FLOAT32');
+
+    } //float32_available
+
 } //ALHelper
 
@@ -9,6 +9,7 @@ import snow.modules.openal.AL.Device;
 
 import snow.system.audio.Sound;
 import snow.api.buffers.Uint8Array;
+import snow.api.buffers.Float64Array;
 
 import snow.api.Debug.*;
 
@@ -21,6 +22,22 @@ class Audio extends snow.core.native.audio.Audio {
 
     var device : Device;
     var context : Context;
+        /** true if sounds should decode to float samples, requested by config and supported by the device */
+    var decode_float (get, never) : Bool;
+        /** true if sounds that aren't streamed share the voice pool */
+    var voices_enabled (get, never) : Bool;
+        /** true if sounds that aren't streamed play through the native software mixer */
+    var mixer_enabled (get, never) : Bool;
+        /** true if the device can play float samples */
+    var float32 : Bool = false;
+        /** the rate the device mixes at, sounds are converted to it when config.native.audio_convert is set */
+    var device_rate : Int = 0;
+        /** the number of sources shared by the voices, 0 when sounds each have their own, -1 until the first sound */
+    var voices : Int = -1;
+        /** 1 when the mixer is running, 0 when it isn't used, -1 until the first sound */
+    var mixer : Int = -1;
+        /** the info of the asset behind each shared buffer, without samples, so sounds sharing one don't open the asset again */
+    var shared_data : Map<String, AudioDataInfo>;
 
     override public function init() {
 
@@ -43,10 +60,42 @@ class Audio extends snow.core.native.audio.Audio {
 
             _debug('set current / ${ ALC.getErrorMeaning(ALC.getError(device)) }');
 
+        float32 = ALHelper.float32_available();
+        device_rate = ALC.getIntegerv(device, ALC.FREQUENCY, 1)[0];
+
+            _debug('float32 / ${float32} / device rate / ${device_rate}');
+
     } //init
 
+        //the config is read when used, as the host config is applied after the modules init
+    function get_decode_float() : Bool {
+
+        return float32 && system.app.config.native.audio_decode_float == true;
+
+    } //get_decode_float
+
+    override function update() {
+
+        if(voices > 0) {
+            AL.voicesUpdate();
+        }
+
+    } //update
+
     override public function destroy() {
 
+            //the sounds are destroyed by now, the pool and the mixer go with the context
+        if(voices > 0) {
+            AL.voicesDestroy();
+        }
+
+        if(mixer > 0) {
+            AL.mixerDestroy();
+        }
+
+            //and nothing is left streaming, so the decode workers can end
+        system.app.assets.module.audio_shutdown();
+
         ALC.makeContextCurrent( null );
         ALC.destroyContext( context );
         ALC.closeDevice( device );
@@ -73,14 +122,155 @@ class Audio extends snow.core.native.audio.Audio {
 
     } //resume
 
+        /** The counters for the voices the sounds share, see `config.native.audio_voices` */
+    public function voice_stats() : AudioVoiceStats {
+
+        var _stats = voices > 0 ? AL.voicesStats() : [0, 0, 0, 0];
+
+        return {
+            sources : _stats[0],
+            real : _stats[1],
+            virtual : _stats[2],
+            stolen : _stats[3]
+        };
+
+    } //voice_stats
+
+        /** The counters for the native software mixer, see `config.native.audio_mixer` */
+    public function mixer_stats() : AudioMixerStats {
+
+        var _stats = mixer > 0 ? AL.mixerStats() : [0, 0, 0, 0];
+
+        return {
+            voices : Std.int(_stats[0]),
+            mixed : Std.int(_stats[1]),
+            underruns : Std.int(_stats[2]),
+            load : _stats[3]
+        };
+
+    } //mixer_stats
+
+        /** A snapshot of the engine counters into `into`, indexed by `AL.COUNTER_*`, returning how many were written.
+            Allocation free, so it can be read each frame. With `reset`, the windowed values start over. */
+    public function counters( into:Float64Array, ?reset:Bool=false ) : Int {
+
+        return AL.audioCounters(into, reset);
+
+    } //counters
+
+        /** The counters of a streamed sound into `into`, indexed by `AL.STREAM_COUNTER_*`,
+            returning how many were written. 0 when the sound isn't streamed natively. */
+    public function stream_counters( sound:snow.system.audio.Sound, into:Float64Array, ?reset:Bool=false ) : Int {
+
+        var _sound : snow.modules.openal.sound.Sound = cast sound;
+        var _stream = Std.instance(_sound.instance, snow.modules.openal.sound.ALStream);
+
+        if(_stream == null || _stream.native == null) {
+            return 0;
+        }
+
+        return AL.streamCounters(_stream.native, into, reset);
+
+    } //stream_counters
+
+        //the pool is made with the first sound, as the host config is applied after the modules init
+    function get_voices_enabled() : Bool {
+
+        if(voices == -1) {
+
+            var _count = system.app.config.native.audio_voices;
+            voices = (_count != null && _count > 0) ? AL.voicesInit(_count) : 0;
+
+                _debug('voices / ${voices} sources / requested ${_count}');
+
+        }
+
+        return voices > 0;
+
+    } //get_voices_enabled
+
+        //likewise the mixer starts with the first sound
+    function get_mixer_enabled() : Bool {
+
+        if(mixer == -1) {
+
+            var _wanted = system.app.config.native.audio_mixer == true;
+            mixer = (_wanted && AL.mixerInit(device_rate)) ? 1 : 0;
+
+                _debug('mixer / ${mixer > 0} / requested ${_wanted} / rate ${device_rate}');
+
+        }
+
+        return mixer > 0;
+
+    } //get_mixer_enabled
+
     override public function create_sound( _id:String, _name:String, _streaming:Bool=false, ?_format:AudioFormatType ) : Promise {
 
-        var sound = new Sound(system, _name, _streaming);
         var assets = system.app.assets;
+        var _path = assets.path(_id);
+
+        if(_format == null) _format = assets.module.audio_format_from_path(_path);
+
+            //streams can decode from the compressed file held in memory, shared between sounds of the same file
+        var _resident = _streaming && system.app.config.native.audio_stream_memory == true;
+
+            //adpcm stays compressed in memory either way, handed to openal as it is when it can take it,
+            //otherwise streamed so only the small stream buffers ever hold decoded pcm
+        var _adpcm = _format == AudioFormatType.adpcm;
+        if(_adpcm && !ALHelper.ima4_available()) {
+            _streaming = true;
+        }
+
+            //the mixer takes decoded samples, so adpcm keeps to a source of its own
+        var _mixed = !_streaming && !_adpcm && mixer_enabled;
+
+            //sounds with a buffer of their own share it with the others from the same asset,
+            //and when it is already filled the asset isn't opened, read or converted for this one
+        var _key : String = null;
+        var _shared = false;
+
+        if(!_streaming && !_mixed) {
+            _key = shared_key(_path, _format);
+            _shared = AL.bufferShared(_key) && shared_data != null && shared_data.exists(_key);
+        }
+
+        var _info : AudioInfo = null;
+
+        if(_shared) {
+            _info = { id:_path, format:_format, handle:null, data:shared_copy(shared_data.get(_key)) };
+        } else {
+            _info = assets.module.audio_load_info(_path, false, _format, decode_float, _resident);
+        }
+
+        var sound = new Sound(system, _name, _streaming, _mixed);
+
+        sound.instance.shared_key = _key;
+
+        if(!_streaming && !_adpcm && !_shared) {
+
+            var _convert = needs_convert(_info);
+
+                //samples are only read into haxe when something there needs them, otherwise
+                //the sound uploads straight from the mapping, or decodes natively into its buffer
+            if(_convert || _mixed) {
+                _info.data.samples = assets.module.audio_load_samples(_info);
+            }
+
+            if(_convert) {
+                convert(_info);
+            }
+
+        } //!_streaming && !_adpcm && !_shared
+
+        if(_key != null && !_shared) {
+            if(shared_data == null) shared_data = new Map();
+            shared_data.set(_key, shared_copy(_info.data));
+        }
 
             //:todo:this triggers the creation/init of the sound, but was
             //a by product of earlier code, will refactor.
-        sound.info = assets.module.audio_load_info(assets.path(_id), !_streaming, _format);
+        sound.info = _info;
 
         return Promise.resolve(sound);
 
@@ -88,13 +278,95 @@ class Audio extends snow.core.native.audio.Audio {
 
     override public function create_sound_from_bytes( _name:String, _bytes:Uint8Array, _format:AudioFormatType ) : Sound {
 
-        var sound = new Sound(system, _name, false);
         var assets = system.app.assets;
 
-        sound.info = assets.module.audio_info_from_bytes(_bytes, _format);
+        var _info = assets.module.audio_info_from_bytes(_bytes, _format, decode_float);
+
+        var _mixed = _info.format != AudioFormatType.adpcm && mixer_enabled;
+        var sound = new Sound(system, _name, false, _mixed);
+
+        if(needs_convert(_info)) {
+            convert(_info);
+        }
+
+        sound.info = _info;
 
         return sound;
 
     } //create_sound_from_bytes
 
+//shared buffers
+
+        /** The counters for the buffers shared by sounds made from the same asset */
+    public function buffer_share_stats() : AudioBufferShareStats {
+
+        var _stats = AL.bufferShareStats();
+
+        return {
+            buffers : Std.int(_stats[0]),
+            references : Std.int(_stats[1]),
+            resident : _stats[2],
+            deduplicated : _stats[3],
+            hits : Std.int(_stats[4]),
+            misses : Std.int(_stats[5])
+        };
+
+    } //buffer_share_stats
+
+        //the buffer contents depend on the asset, how it is decoded and what it would be converted to,
+        //all of which is known before the asset is opened
+    function shared_key( _path:String, _format:AudioFormatType ) : String {
+
+        var _native = system.app.config.native;
+        var _convert = '${_native.audio_downmix == true}:${_native.audio_convert == true}:${device_rate}';
+
+        return '${_path}|${_format}|${decode_float}|${_convert}';
+
+    } //shared_key
+
+        //the description of the samples without the samples, each sound gets its own as they update it
+    function shared_copy( _data:AudioDataInfo ) : AudioDataInfo {
+
+        return {
+            length          : _data.length,
+            length_pcm      : _data.length_pcm,
+            channels        : _data.channels,
+            rate            : _data.rate,
+            bitrate         : _data.bitrate,
+            bits_per_sample : _data.bits_per_sample,
+            sample_format   : _data.sample_format,
+            loop_start      : _data.loop_start,
+            loop_length     : _data.loop_length,
+            samples         : null
+        };
+
+    } //shared_copy
+
+//conversion
+
+    function needs_convert( _info:AudioInfo ) : Bool {
+
+        var _native = system.app.config.native;
+        var _data = _info.data;
+
+        if(_native.audio_downmix == true && _data.channels == 2) return true;
+        if(_native.audio_convert != true) return false;
+
+        return _data.sample_format == AudioSampleFormat.u8 || (device_rate > 0 && _data.rate != device_rate);
+
+    } //needs_convert
+
+    function convert( _info:AudioInfo ) {
+
+        var _native = system.app.config.native;
+        var _channels = _native.audio_downmix == true ? 1 : 0;
+        var _rate = _native.audio_convert == true ? device_rate : 0;
+        var _format = (_native.audio_convert == true && _info.data.sample_format == AudioSampleFormat.u8) ? AudioSampleFormat.s16 : AudioSampleFormat.unknown;
+
+        system.app.assets.module.audio_convert(_info, _format, _channels, _rate);
+
+            _debug('converted / ${_info.id} / ${_info.data.channels} channels / ${_info.data.rate}hz / format ${_info.data.sample_format}');
+
+    } //convert
+
 } //Audio
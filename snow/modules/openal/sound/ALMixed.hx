@@ -0,0 +1,201 @@
+package snow.modules.openal.sound;
+
+import snow.types.Types;
+
+import snow.modules.openal.AL;
+import snow.modules.openal.AL.MixerVoice;
+
+import snow.api.Debug.*;
+
+/** The openal specifics for a sound played by the native software mixer,
+    which has no source or buffer of its own, see `config.native.audio_mixer` */
+@:noCompletion
+class ALMixed extends snow.modules.openal.sound.ALSound {
+
+        /** the mixer voice playing this sound */
+    public var mixed : MixerVoice = null;
+
+    override function play() {
+
+        if(mixed == null) return;
+
+        AL.mixerVoicePlay(mixed);
+
+        _debug('${owner.name} playing mixed sound');
+
+    } //play
+
+    override function loop() {
+
+        if(mixed == null) return;
+
+        AL.mixerVoicePlay(mixed);
+
+        _debug('${owner.name} looping mixed sound');
+
+    } //loop
+
+    override function pause() {
+
+        if(mixed == null) return;
+
+        AL.mixerVoicePause(mixed);
+
+    } //pause
+
+    override function stop() {
+
+        if(mixed == null) return;
+
+        AL.mixerVoiceStop(mixed);
+
+    } //stop
+
+    override function destroy() {
+
+        if(mixed != null) {
+            AL.mixerVoiceDestroy(mixed);
+            mixed = null;
+        }
+
+    } //destroy
+
+//internal
+
+    override function internal_update() {
+
+        if(!owner.playing || mixed == null) {
+            return;
+        }
+
+        if(AL.mixerVoiceState(mixed) == AL.STOPPED) {
+            owner.onended();
+        }
+
+    } //internal_update
+
+//getters / setters
+
+    override function update_info( info:AudioInfo ) {
+
+        _debug('creating mixed sound / ${owner.name} / ${info.id} / ${info.format}');
+
+        _debug('\t > rate : ${info.data.rate}');
+        _debug('\t > channels : ${info.data.channels}');
+        _debug('\t > bits_per_sample : ${info.data.bits_per_sample}');
+        _debug('\t > byte length: ${info.data.length_pcm}');
+
+        if(info.data.samples == null || info.data.samples.length == 0) {
+            _debug('${owner.name} cannot create sound, empty/null data provided!');
+            return;
+        }
+
+        var _sample_format = info.data.sample_format;
+
+        if(_sample_format == null || _sample_format == AudioSampleFormat.unknown) {
+            _sample_format = switch(info.data.bits_per_sample) {
+                case 8: AudioSampleFormat.u8;
+                case 32: AudioSampleFormat.f32;
+                case _: AudioSampleFormat.s16;
+            }
+        }
+
+            //the mixer keeps its own float copy of the samples
+        mixed = AL.mixerVoiceCreate(info.data.samples, _sample_format, info.data.channels, info.data.rate);
+
+        if(mixed == null) {
+            log('${owner.name} could not create a mixed sound, ${info.data.channels} channels');
+            return;
+        }
+
+            //the properties set before the samples arrived
+        AL.mixerVoicef(mixed, AL.GAIN, owner.volume);
+        AL.mixerVoicef(mixed, AL.PITCH, owner.pitch);
+        AL.mixerVoicePan(mixed, owner.pan);
+
+    } //update_info
+
+    override function get_position_bytes() : Int {
+
+        if(mixed == null) return 0;
+
+        return Std.int(AL.mixerGetVoicef(mixed, AL.SAMPLE_OFFSET));
+
+    } //get_position_bytes
+
+    override function get_position() : Float {
+
+        if(mixed == null) return 0;
+
+        return AL.mixerGetVoicef(mixed, AL.SEC_OFFSET);
+
+    } //get_position
+
+    override function set_pan( _pan:Float ) {
+
+        if(mixed != null) {
+            AL.mixerVoicePan(mixed, _pan);
+        }
+
+        return _pan;
+
+    } //set_pan
+
+    override function set_pitch( _pitch:Float ) {
+
+        if(mixed != null) {
+            AL.mixerVoicef(mixed, AL.PITCH, _pitch);
+        }
+
+        return _pitch;
+
+    } //set_pitch
+
+    override function set_volume( _volume:Float ) {
+
+        if(mixed != null) {
+            AL.mixerVoicef(mixed, AL.GAIN, _volume);
+        }
+
+        return _volume;
+
+    } //set_volume
+
+    override function set_looping( _looping:Bool ) {
+
+        if(mixed != null) {
+            AL.mixerVoicei(mixed, AL.LOOPING, _looping ? AL.TRUE : AL.FALSE);
+        }
+
+        return _looping;
+
+    } //set_looping
+
+    override function set_position_bytes( _position_bytes:Int ) {
+
+        if(mixed != null) {
+            AL.mixerVoicef(mixed, AL.SAMPLE_OFFSET, _position_bytes);
+        }
+
+        return _position_bytes;
+
+    } //set_position_bytes
+
+    override function set_priority( _priority:Float ) {
+
+            //every mixed sound is heard, there is nothing to rank
+        return _priority;
+
+    } //set_priority
+
+    override function set_position( _position:Float ) {
+
+        if(mixed != null) {
+            AL.mixerVoicef(mixed, AL.SEC_OFFSET, _position);
+        }
+
+        return _position;
+
+    } //set_position
+
+} //ALMixed
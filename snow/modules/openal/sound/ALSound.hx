@@ -5,6 +5,7 @@ import snow.types.Types;
 import snow.api.buffers.Float32Array;
 
 import snow.modules.openal.AL;
+import snow.modules.openal.AL.Voice;
 import snow.modules.openal.ALHelper;
 
 import snow.api.Debug.*;
@@ -20,6 +21,10 @@ class ALSound {
     public var buffer : Int = -1;
         /** mono8? stereo16? */
     public var format : Int;
+        /** the voice playing this sound when sounds share the voice pool, in place of its own source */
+    public var voice : Voice = null;
+        /** the key of the buffer this sound shares with others from the same asset, or null for a buffer of its own */
+    public var shared_key : String = null;
 
         /** The openal system Sound controlling this instance */
     var owner : Sound;
@@ -28,6 +33,11 @@ class ALSound {
 
     function play() {
 
+        if(voice != null) {
+            AL.voicePlay(voice);
+            return;
+        }
+
         AL.sourcePlay(source);
 
         _debug('${owner.name} playing sound / ${AL.getErrorMeaning(AL.getError())} ');
@@ -38,6 +48,11 @@ class ALSound {
 
      function loop() {
 
+        if(voice != null) {
+            AL.voicePlay(voice);
+            return;
+        }
+
         AL.sourcePlay(source);
 
         _debug('${owner.name} looping sound / ${AL.getErrorMeaning(AL.getError())} ');
@@ -46,6 +61,11 @@ class ALSound {
 
     function pause() {
 
+        if(voice != null) {
+            AL.voicePause(voice);
+            return;
+        }
+
         AL.sourcePause(source);
 
         _debug('${owner.name} pausing sound / ${AL.getErrorMeaning(AL.getError())} ');
@@ -54,6 +74,11 @@ class ALSound {
 
     function stop() {
 
+        if(voice != null) {
+            AL.voiceStop(voice);
+            return;
+        }
+
         AL.sourceStop(source);
 
         _debug('${owner.name} stopping sound / ${AL.getErrorMeaning(AL.getError())} ');
@@ -62,8 +87,16 @@ class ALSound {
 
     function destroy() {
 
-        AL.deleteSource(source);
-        if(buffer != -1) AL.deleteBuffer(buffer);
+            //the voice gives its pool source back before the buffer goes
+        if(voice != null) {
+            AL.voiceDestroy(voice);
+            voice = null;
+        } else {
+            AL.deleteSource(source);
+        }
+
+            //a shared buffer is only deleted with the last sound using it
+        if(buffer != -1) AL.bufferRelease(buffer);
 
     } //destroy
 
@@ -75,7 +108,9 @@ class ALSound {
             return;
         }
 
-        if(AL.getSourcei(source, AL.SOURCE_STATE) == AL.STOPPED) {
+        var _state = voice != null ? AL.voiceState(voice) : AL.getSourcei(source, AL.SOURCE_STATE);
+
+        if(_state == AL.STOPPED) {
             owner.onended();
         }
 
@@ -100,31 +135,95 @@ class ALSound {
         _debug('\t > byte length: ${info.data.length_pcm}');
         _debug('\t > duration : ${owner.duration}');
 
-        source = AL.genSource();
+            //when sounds share the voice pool, the voice is made once the buffer is ready
+        var _voices : Bool = @:privateAccess (cast owner.system.module : snow.modules.openal.Audio).voices_enabled;
 
-            _debug('${owner.name} generating source for sound / ${AL.getErrorMeaning(AL.getError())} ');
+        if(!_voices) {
 
-            //ask the shared openal helper function
-        ALHelper.default_source_setup( source );
+            source = AL.genSource();
 
-            //generate a buffer for this sound
-        buffer = AL.genBuffer();
+                _debug('${owner.name} generating source for sound / ${AL.getErrorMeaning(AL.getError())} ');
 
-            _debug('${owner.name} generating buffer for sound / ${AL.getErrorMeaning(AL.getError())} ');
+                //ask the shared openal helper function
+            ALHelper.default_source_setup( source );
 
-            //ask the helper to determine the format
-        format = ALHelper.determine_format( info );
+        } //!_voices
 
-            //check that we have valid data info
-        if(info.data.samples == null || info.data.samples.length == 0) {
-            _debug('${owner.name} cannot create sound, empty/null data provided!');
-            return;
-        }
+            //sounds from the same asset share one filled buffer
+        var _shared = shared_key != null ? AL.bufferShare(shared_key) : 0;
+
+        if(_shared > 0) {
+
+            buffer = _shared;
+            shared_info(info);
+
+            format = info.format == AudioFormatType.adpcm ? ALHelper.determine_format_ima4(info) : ALHelper.determine_format(info);
+
+                _debug('${owner.name} sharing buffer ${buffer} / ${shared_key}');
+
+        } else {
+
+                //generate a buffer for this sound
+            buffer = AL.genBuffer();
+
+                _debug('${owner.name} generating buffer for sound / ${AL.getErrorMeaning(AL.getError())} ');
+
+                //ask the helper to determine the format
+            format = ALHelper.determine_format( info );
+
+            var _has_samples = info.data.samples != null && info.data.samples.length != 0;
+
+            if(!_has_samples && info.format == AudioFormatType.adpcm) {
+
+                    //the compressed blocks go to openal as they are, it decodes them
+                format = ALHelper.determine_format_ima4( info );
+                AL.bufferDataMapped(buffer, format, info, info.data.rate);
+
+            } else if(!_has_samples && info.data.mapped == true) {
+
+                    //no copy of the samples, the buffer is filled from the mapped file
+                AL.bufferDataMapped(buffer, format, info, info.data.rate);
+
+            } else if(!_has_samples && info.handle != null) {
+
+                    //decoded natively into the buffer, the samples never reach haxe
+                if(!AL.bufferDataDecode(buffer, format, info, info.data.rate)) {
+                    _debug('${owner.name} cannot create sound, nothing decoded from the source!');
+                    return;
+                }
+
+            } else {
+
+                    //check that we have valid data info
+                if(!_has_samples) {
+                    _debug('${owner.name} cannot create sound, empty/null data provided!');
+                    return;
+                }
 
-            //give the data from the sound info to the buffer
-        AL.bufferData(buffer, format, new Float32Array(info.data.samples.buffer), info.data.rate );
+                    //give the data from the sound info to the buffer
+                AL.bufferData(buffer, format, new Float32Array(info.data.samples.buffer), info.data.rate );
 
-            _debug('${owner.name} buffered data / ${AL.getErrorMeaning(AL.getError())} ');
+            }
+
+                _debug('${owner.name} buffered data / ${AL.getErrorMeaning(AL.getError())} ');
+
+            if(shared_key != null) {
+                AL.bufferShareStore(shared_key, buffer);
+            }
+
+        } //_shared
+
+        if(_voices) {
+
+                //the voice only holds a source while it ranks high enough to be heard
+            voice = AL.voiceCreate(buffer, owner.duration);
+            AL.voicePriority(voice, owner.priority);
+
+                _debug('${owner.name} created voice / ${AL.getErrorMeaning(AL.getError())} ');
+
+            return;
+
+        } //_voices
 
             //give the buffer to the source
         AL.sourcei(source, AL.BUFFER, buffer);
@@ -133,6 +232,31 @@ class ALSound {
 
     } //update_info
 
+        //a shared buffer may hold samples converted from what the info describes,
+        //when the conversion was skipped because the buffer was already filled
+    function shared_info( info:AudioInfo ) {
+
+        if(info.format == AudioFormatType.adpcm) {
+            return;
+        }
+
+        var _bits = AL.getBufferi(buffer, AL.BITS);
+
+        info.data.rate = AL.getBufferi(buffer, AL.FREQUENCY);
+        info.data.channels = AL.getBufferi(buffer, AL.CHANNELS);
+        info.data.bits_per_sample = _bits;
+        info.data.length_pcm = AL.getBufferi(buffer, AL.SIZE);
+        info.data.sample_format = switch(_bits) {
+            case 8: AudioSampleFormat.u8;
+            case 32: AudioSampleFormat.f32;
+            case _: AudioSampleFormat.s16;
+        }
+
+    } //shared_info
+
+        //only streams loop a region, a sound with a buffer of its own loops all of it
+    function set_loop_points( _loop_start:Int, _loop_end:Int ) {}
+
     function set_playing(_playing:Bool) { return _playing; }
     function set_paused(_paused:Bool) { return _paused; }
     function set_loaded(_loaded:Bool) { return _loaded; }
@@ -141,19 +265,34 @@ class ALSound {
 
     function get_position_bytes() : Int {
 
+        if(voice != null) {
+            return Std.int(AL.voiceGetSourcef(voice, AL.SAMPLE_OFFSET));
+        }
+
         return Std.int(AL.getSourcef(source, AL.SAMPLE_OFFSET));
 
     } //get_position_bytes
 
     function get_position() : Float {
 
+        if(voice != null) {
+            return AL.voiceGetSourcef(voice, AL.SEC_OFFSET);
+        }
+
         return AL.getSourcef(source, AL.SEC_OFFSET);
 
     } //get_position
 
     function set_pan( _pan:Float ) {
 
-        AL.source3f(source, AL.POSITION, Math.cos((_pan - 1) * (half_pi)), 0, Math.sin((_pan + 1) * (half_pi)));
+        var _x = Math.cos((_pan - 1) * (half_pi));
+        var _z = Math.sin((_pan + 1) * (half_pi));
+
+        if(voice != null) {
+            AL.voiceSource3f(voice, AL.POSITION, _x, 0, _z);
+        } else {
+            AL.source3f(source, AL.POSITION, _x, 0, _z);
+        }
 
         return _pan;
 
@@ -161,7 +300,11 @@ class ALSound {
 
     function set_pitch( _pitch:Float ) {
 
-        AL.sourcef( source, AL.PITCH, _pitch );
+        if(voice != null) {
+            AL.voiceSourcef( voice, AL.PITCH, _pitch );
+        } else {
+            AL.sourcef( source, AL.PITCH, _pitch );
+        }
 
         return _pitch;
 
@@ -169,7 +312,11 @@ class ALSound {
 
     function set_volume( _volume:Float ) {
 
-        AL.sourcef( source, AL.GAIN, _volume );
+        if(voice != null) {
+            AL.voiceSourcef( voice, AL.GAIN, _volume );
+        } else {
+            AL.sourcef( source, AL.GAIN, _volume );
+        }
 
         return _volume;
 
@@ -179,7 +326,11 @@ class ALSound {
 
         log('${owner.name} pre looping / ${AL.getErrorMeaning(AL.getError())} ');
 
-        AL.sourcei( source, AL.LOOPING, _looping ? AL.TRUE : AL.FALSE );
+        if(voice != null) {
+            AL.voiceSourcei( voice, AL.LOOPING, _looping ? AL.TRUE : AL.FALSE );
+        } else {
+            AL.sourcei( source, AL.LOOPING, _looping ? AL.TRUE : AL.FALSE );
+        }
 
         log('${owner.name} set looping on sound source / ${AL.getErrorMeaning(AL.getError())} ');
 
@@ -189,15 +340,33 @@ class ALSound {
 
     function set_position_bytes( _position_bytes:Int ) {
 
-        AL.sourcef(source, AL.SAMPLE_OFFSET, _position_bytes);
+        if(voice != null) {
+            AL.voiceSourcef(voice, AL.SAMPLE_OFFSET, _position_bytes);
+        } else {
+            AL.sourcef(source, AL.SAMPLE_OFFSET, _position_bytes);
+        }
 
         return _position_bytes;
 
     } //set_position_bytes
 
+    function set_priority( _priority:Float ) {
+
+        if(voice != null) {
+            AL.voicePriority(voice, _priority);
+        }
+
+        return _priority;
+
+    } //set_priority
+
     function set_position( _position:Float ) {
 
-        AL.sourcef(source, AL.SEC_OFFSET, _position);
+        if(voice != null) {
+            AL.voiceSourcef(voice, AL.SEC_OFFSET, _position);
+        } else {
+            AL.sourcef(source, AL.SEC_OFFSET, _position);
+        }
 
         return _position;
 
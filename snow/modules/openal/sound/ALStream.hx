@@ -5,6 +5,7 @@ import snow.types.Types;
 import snow.api.buffers.Float32Array;
 
 import snow.modules.openal.AL;
+import snow.modules.openal.AL.Stream;
 import snow.modules.openal.ALHelper;
 
 import snow.api.Debug.*;
@@ -17,6 +18,8 @@ class ALStream extends snow.modules.openal.sound.ALSound {
     public var buffers : Array<Int>;
         /** remaining buffers to play */
     public var buffers_left : Int = 0;
+        /** the native stream keeping the queue full from the stream thread, or null when streamed from haxe */
+    public var native : Stream = null;
 
 //Internal API
 
@@ -51,6 +54,30 @@ class ALStream extends snow.modules.openal.sound.ALSound {
 
         format = ALHelper.determine_format( info );
 
+            //where it can, the native stream thread owns the queue from here on
+        if(native_available()) {
+            native = AL.streamCreate( source, buffers, info, format, owner.stream_buffer_length );
+        }
+
+            //loop points the file carries, which go through to the stream as they are set
+        if(info.data.loop_start != null && info.data.loop_start > 0) {
+            owner.loop_start = info.data.loop_start;
+        }
+
+        if(info.data.loop_length != null && info.data.loop_length > 0) {
+            owner.loop_end = owner.loop_start + info.data.loop_length;
+        }
+
+            //native oggs decode ahead on the workers too, the stream starts that itself
+        if(native != null) {
+            _debug('${owner.name} streaming natively');
+            return;
+        }
+
+            //where supported, decode ahead on a worker thread so
+            //refilling a buffer is only a copy on this thread
+        owner.system.app.assets.module.audio_stream_source( info, owner.stream_buffer_length * 2 );
+
             //fill the first set of buffers up
         init_queue();
 
@@ -58,6 +85,35 @@ class ALStream extends snow.modules.openal.sound.ALSound {
 
     } //update_info
 
+        //custom stream functions can only be called from haxe, so only the defaults stream natively.
+        //the config is read here, as the host config is applied after the modules init
+    function native_available() : Bool {
+
+        if(owner.system.app.config.native.audio_stream_native == false) {
+            return false;
+        }
+
+        return Reflect.compareMethods(owner.stream_data_get, @:privateAccess owner.default_stream_data_get)
+            && Reflect.compareMethods(owner.stream_data_seek, @:privateAccess owner.default_stream_data_seek);
+
+    } //native_available
+
+        //the native stream reports back here, once a frame
+    function update_native() {
+
+        var _events = AL.streamEvents(native);
+
+        if((_events & AL.STREAM_LOOPED) != 0) {
+            owner.emit('end');
+        }
+
+        if((_events & AL.STREAM_ENDED) != 0) {
+            _debug('${owner.name} streaming sound complete');
+            owner.stop();
+        }
+
+    } //update_native
+
         //will try and fill the buffer, will return false if there
         //was no data to get (i.e end of file )
     function fill_buffer(_buffer:Int) : AudioDataBlob {
@@ -66,7 +122,7 @@ class ALStream extends snow.modules.openal.sound.ALSound {
         var _blob : AudioDataBlob = owner.stream_data_get( -1, owner.stream_buffer_length );
 
         if(_blob != null && _blob.bytes != null && _blob.bytes.length != 0) {
-            AL.bufferData( _buffer, format, new Float32Array(_blob.bytes.buffer), owner.info.data.rate ); AL.getError();
+            AL.bufferData( _buffer, format, _blob.bytes, owner.info.data.rate ); AL.getError();
         }
 
         return _blob;
@@ -154,15 +210,15 @@ class ALStream extends snow.modules.openal.sound.ALSound {
                 //make sure the time resets correctly when looping
             var at_end = owner.position >= owner.duration;
             if(at_end && owner.looping) {
-                current_time = 0;
+                current_time = owner.system.bytes_to_seconds(owner.info, owner.loop_start * frame_bytes());
                 owner.emit('end');
             }
 
             if(blob.complete) {
 
                 if(owner.looping) {
-                        //if we are looping, we must seek to the beginning again
-                    owner.stream_data_seek(0);
+                        //if we are looping, we must seek to the loop start again
+                    owner.stream_data_seek(owner.loop_start * frame_bytes());
 
                 } else {
                     buffers_left--;
@@ -201,6 +257,11 @@ class ALStream extends snow.modules.openal.sound.ALSound {
             return;
         }
 
+        if(native != null) {
+            update_native();
+            return;
+        }
+
         if(!update_stream()) {
             _debug('${owner.name} streaming sound complete');
             owner.stop();
@@ -210,6 +271,11 @@ class ALStream extends snow.modules.openal.sound.ALSound {
 
     override function internal_pause() {
 
+        if(native != null) {
+            AL.streamPause(native);
+            return;
+        }
+
         AL.sourcePause(source);
 
         flush_queue();
@@ -218,6 +284,11 @@ class ALStream extends snow.modules.openal.sound.ALSound {
 
     override function internal_play() {
 
+        if(native != null) {
+            if(owner.playing) AL.streamPlay(native);
+            return;
+        }
+
         if(owner.playing) {
                 //make sure the queue is clear and ready
             flush_queue();
@@ -227,8 +298,35 @@ class ALStream extends snow.modules.openal.sound.ALSound {
 
     } //internal_play
 
+    override function play() {
+
+        if(native != null) {
+            AL.streamPlay(native);
+            return;
+        }
+
+        super.play();
+
+    } //play
+
+    override function loop() {
+
+        if(native != null) {
+            AL.streamPlay(native);
+            return;
+        }
+
+        super.loop();
+
+    } //loop
+
     override public function pause() {
 
+        if(native != null) {
+            AL.streamPause(native);
+            return;
+        }
+
         super.pause();
         flush_queue();
 
@@ -236,6 +334,12 @@ class ALStream extends snow.modules.openal.sound.ALSound {
 
     override public function stop() {
 
+            //the native stream rewinds itself
+        if(native != null) {
+            AL.streamStop(native);
+            return;
+        }
+
         super.stop();
 
         flush_queue();
@@ -245,6 +349,12 @@ class ALStream extends snow.modules.openal.sound.ALSound {
 
     override function destroy() {
 
+            //the stream thread has to let go of the source before it goes
+        if(native != null) {
+            AL.streamDestroy(native);
+            native = null;
+        }
+
         super.destroy();
 
         AL.deleteBuffers(buffers);
@@ -255,6 +365,22 @@ class ALStream extends snow.modules.openal.sound.ALSound {
 
     static var half_pi : Float = 1.5707;
 
+    inline function frame_bytes() : Int {
+
+        return owner.info.data.channels * (owner.info.data.bits_per_sample >> 3);
+
+    } //frame_bytes
+
+        //the native stream wraps within a buffer fill at the loop end, from a head it decoded ahead.
+        //streamed from haxe only the loop start is kept, where the data is sought back to at the end
+    override function set_loop_points( _loop_start:Int, _loop_end:Int ) {
+
+        if(native != null) {
+            AL.streamLoopPoints(native, _loop_start * frame_bytes(), _loop_end * frame_bytes());
+        }
+
+    } //set_loop_points
+
     var current_time : Float = 0;
 
     override function get_position_bytes() : Int {
@@ -265,6 +391,10 @@ class ALStream extends snow.modules.openal.sound.ALSound {
 
     override function get_position() : Float {
 
+        if(native != null) {
+            return owner.system.bytes_to_seconds(owner.info, AL.streamPosition(native));
+        }
+
         // return bytes_to_seconds(position_bytes);
         var _pos_sec : Float = AL.getSourcef(source, AL.SEC_OFFSET);
 
@@ -282,15 +412,20 @@ class ALStream extends snow.modules.openal.sound.ALSound {
 
     override function set_position( _position:Float ) : Float {
 
+            //sanity checks
+        if(_position < 0) { _position = 0; }
+        if(_position > owner.duration) { _position = owner.duration; }
+
+        if(native != null) {
+            AL.streamSeek(native, owner.system.seconds_to_bytes(owner.info, _position));
+            return _position;
+        }
+
             //stop source so it lets go of buffers
         AL.sourceStop(source);
             //clear queue
         flush_queue();
 
-            //sanity checks
-        if(_position < 0) { _position = 0; }
-        if(_position > owner.duration) { _position = owner.duration; }
-
         current_time = _position;
 
             //fill up the first buffers again, seeking there first
@@ -307,8 +442,15 @@ class ALStream extends snow.modules.openal.sound.ALSound {
 
         //Don't set AL source to looping in streamed
         //sounds, it will break with unqueuing a buffer.
+        //The native stream loops the data itself instead.
     override function set_looping(_looping:Bool) {
+
+        if(native != null) {
+            AL.streamLoop(native, _looping);
+        }
+
         return _looping;
+
     }
 
 
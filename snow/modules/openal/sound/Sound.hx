@@ -6,25 +6,26 @@ import snow.api.Debug.*;
 /** Not generally used directly. See the `snow.system.audio.Sound` docs for reference.
 
     The concrete implementation of the snow audio system sound type for OpenAL.
-    This class handles the difference between streaming and normal sounds by creating
-    an instance of either ALSound or ALStream and managing it. */
+    This class handles the difference between streaming, mixed and normal sounds by creating
+    an instance of either ALStream, ALMixed or ALSound and managing it. */
 @:allow(snow.system.audio.Audio)
 @:allow(snow.modules.openal.Audio)
 @:allow(snow.modules.openal.sound.ALSound)
 @:allow(snow.modules.openal.sound.ALStream)
+@:allow(snow.modules.openal.sound.ALMixed)
 @:noCompletion
 class Sound extends snow.system.audio.Sound {
 
-        //The sound instance, which can be ALStream or ALSound depending on is_stream
+        //The sound instance, which can be ALStream, ALMixed or ALSound depending on is_stream and is_mixed
     var instance: ALSound;
 
-    function new( _system:snow.system.audio.Audio, _name:String, ?_is_stream:Bool=false ) {
+    function new( _system:snow.system.audio.Audio, _name:String, ?_is_stream:Bool=false, ?_is_mixed:Bool=false ) {
 
         super(_system, _name, _is_stream);
 
         instance = switch(_is_stream) {
             case true: new ALStream(this);
-            case false: new ALSound(this);
+            case false: _is_mixed ? new ALMixed(this) : new ALSound(this);
             case _: null;
         }
 
@@ -146,6 +147,7 @@ class Sound extends snow.system.audio.Sound {
     override function get_pitch() : Float        return pitch;
     override function get_volume() : Float       return volume;
     override function get_looping() : Bool       return looping;
+    override function get_priority() : Float     return priority;
 
     override function get_length_bytes() : Int   return info.data.length_pcm;
     override function get_position() : Float     return instance.get_position();
@@ -169,7 +171,7 @@ class Sound extends snow.system.audio.Sound {
 
 
     override function set_pan( _pan:Float ) : Float {
-        if(info.data.channels > 1) log('OpenAL: Pan on Stereo sound sources is not supported, nothing will happen!');
+        if(info.data.channels > 1 && !Std.is(instance, ALMixed)) log('OpenAL: Pan on Stereo sound sources is not supported, nothing will happen!');
         pan = instance.set_pan(_pan);
         return pan;
     }
@@ -194,9 +196,26 @@ class Sound extends snow.system.audio.Sound {
         return looping;
     }
 
+    override function set_priority( _priority:Float ) : Float {
+        priority = instance.set_priority(_priority);
+        return priority;
+    }
+
     override function set_position_bytes(_position_bytes) : Int {
         position_bytes = instance.set_position_bytes(_position_bytes);
         return position_bytes;
     }
 
+    override function set_loop_start( _loop_start:Int ) : Int {
+        loop_start = _loop_start;
+        instance.set_loop_points(loop_start, loop_end);
+        return loop_start;
+    }
+
+    override function set_loop_end( _loop_end:Int ) : Int {
+        loop_end = _loop_end;
+        instance.set_loop_points(loop_start, loop_end);
+        return loop_end;
+    }
+
 } //Sound
\ No newline at end of file
@@ -32,6 +32,16 @@ typedef GLContextAttributes = {
 
 } //GLContextAttributes
 
+    /** The counters of the gl state shadow, see `GLState` */
+typedef GLStateStats = {
+
+        /** The tracked calls that reached gl in the last frame */
+    issued : Int,
+        /** The calls dropped in the last frame, for setting what was already set */
+    skipped : Int
+
+} //GLStateStats
+
 
 class GLObject {
         /** The native GL handle/id. read only */
@@ -0,0 +1,429 @@
+package snow.modules.opengl.native;
+
+import snow.modules.opengl.native.GL;
+import snow.api.buffers.Float32Array;
+import snow.api.buffers.Int32Array;
+
+import snow.api.Libs;
+
+/** A recorded stream of gl calls, issued by `submit` in one native call
+    rather than one native call each. The recording methods match the `GL` ones they stand in for,
+    for the calls a frame makes most, state changes, binds, uniforms and draws.
+    Calls that return something or take data to upload stay on `GL`, and as the recorded calls
+    only happen at `submit`, submit before any of those that depend on them. */
+@:noCompletion
+@:allow(snow.modules.opengl.native.GLRenderThread)
+class GLCommands {
+
+//opcodes, mirrored from snow_opengl_commands.h, keep them in sync
+
+    public static inline var ENABLE                         = 1;
+    public static inline var DISABLE                        = 2;
+    public static inline var VIEWPORT                       = 3;
+    public static inline var SCISSOR                        = 4;
+    public static inline var CLEAR                          = 5;
+    public static inline var CLEAR_COLOR                    = 6;
+    public static inline var CLEAR_DEPTH                    = 7;
+    public static inline var CLEAR_STENCIL                  = 8;
+    public static inline var COLOR_MASK                     = 9;
+    public static inline var DEPTH_FUNC                     = 10;
+    public static inline var DEPTH_MASK                     = 11;
+    public static inline var CULL_FACE                      = 12;
+    public static inline var FRONT_FACE                     = 13;
+    public static inline var BLEND_FUNC                     = 14;
+    public static inline var BLEND_FUNC_SEPARATE            = 15;
+    public static inline var BLEND_EQUATION                 = 16;
+    public static inline var BLEND_EQUATION_SEPARATE        = 17;
+    public static inline var BLEND_COLOR                    = 18;
+    public static inline var STENCIL_FUNC                   = 19;
+    public static inline var STENCIL_OP                     = 20;
+    public static inline var STENCIL_MASK                   = 21;
+    public static inline var LINE_WIDTH                     = 22;
+    public static inline var POLYGON_OFFSET                 = 23;
+    public static inline var USE_PROGRAM                    = 24;
+    public static inline var BIND_BUFFER                    = 25;
+    public static inline var BIND_FRAMEBUFFER               = 26;
+    public static inline var BIND_RENDERBUFFER              = 27;
+    public static inline var ACTIVE_TEXTURE                 = 28;
+    public static inline var BIND_TEXTURE                   = 29;
+    public static inline var TEX_PARAMETERI                 = 30;
+    public static inline var PIXEL_STOREI                   = 31;
+    public static inline var ENABLE_VERTEX_ATTRIB_ARRAY     = 32;
+    public static inline var DISABLE_VERTEX_ATTRIB_ARRAY    = 33;
+    public static inline var VERTEX_ATTRIB_POINTER          = 34;
+    public static inline var UNIFORM1I                      = 35;
+    public static inline var UNIFORM2I                      = 36;
+    public static inline var UNIFORM3I                      = 37;
+    public static inline var UNIFORM4I                      = 38;
+    public static inline var UNIFORM1F                      = 39;
+    public static inline var UNIFORM2F                      = 40;
+    public static inline var UNIFORM3F                      = 41;
+    public static inline var UNIFORM4F                      = 42;
+    public static inline var UNIFORM_IV                     = 43;
+    public static inline var UNIFORM_FV                     = 44;
+    public static inline var UNIFORM_MATRIX                 = 45;
+    public static inline var DRAW_ARRAYS                    = 46;
+    public static inline var DRAW_ELEMENTS                  = 47;
+
+        /** The number of commands recorded since the last submit or reset. read only */
+    public var count (default, null) : Int = 0;
+
+    var ints : Int32Array;
+    var floats : Float32Array;
+    var int_count : Int = 0;
+    var float_count : Int = 0;
+
+        /** The streams start at the given number of elements, and double as needed.
+            They are kept between submits, so after the first few frames recording doesn't allocate. */
+    public function new( ?_int_capacity:Int = 4096, ?_float_capacity:Int = 4096 ) {
+
+        ints = new Int32Array(_int_capacity < 16 ? 16 : _int_capacity);
+        floats = new Float32Array(_float_capacity < 16 ? 16 : _float_capacity);
+
+    } //new
+
+        /** Issue the recorded commands, in order, and start recording again.
+            Returns the number issued, less than `count` only if the stream was malformed,
+            in which case the reason is logged natively. */
+    public function submit() : Int {
+
+        if(count == 0) return 0;
+
+        var _done : Int = snow_gl_execute(
+            ints.buffer.getData(), ints.byteOffset, int_count * 4,
+            floats.buffer.getData(), floats.byteOffset, float_count * 4,
+            count
+        );
+
+        reset();
+
+        return _done;
+
+    } //submit
+
+        /** Drop the recorded commands without issuing them. */
+    public function reset() {
+
+        count = 0;
+        int_count = 0;
+        float_count = 0;
+
+    } //reset
+
+//recording
+
+    public function enable(cap:Int) : Void {
+        command(ENABLE, 1, 0);
+        i(cap);
+    }
+
+    public function disable(cap:Int) : Void {
+        command(DISABLE, 1, 0);
+        i(cap);
+    }
+
+    public function viewport(x:Int, y:Int, width:Int, height:Int) : Void {
+        command(VIEWPORT, 4, 0);
+        i(x); i(y); i(width); i(height);
+    }
+
+    public function scissor(x:Int, y:Int, width:Int, height:Int) : Void {
+        command(SCISSOR, 4, 0);
+        i(x); i(y); i(width); i(height);
+    }
+
+    public function clear(mask:Int) : Void {
+        command(CLEAR, 1, 0);
+        i(mask);
+    }
+
+    public function clearColor(red:Float, green:Float, blue:Float, alpha:Float) : Void {
+        command(CLEAR_COLOR, 0, 4);
+        f(red); f(green); f(blue); f(alpha);
+    }
+
+    public function clearDepth(depth:Float) : Void {
+        command(CLEAR_DEPTH, 0, 1);
+        f(depth);
+    }
+
+    public function clearStencil(s:Int) : Void {
+        command(CLEAR_STENCIL, 1, 0);
+        i(s);
+    }
+
+    public function colorMask(red:Bool, green:Bool, blue:Bool, alpha:Bool) : Void {
+        command(COLOR_MASK, 4, 0);
+        b(red); b(green); b(blue); b(alpha);
+    }
+
+    public function depthFunc(func:Int) : Void {
+        command(DEPTH_FUNC, 1, 0);
+        i(func);
+    }
+
+    public function depthMask(flag:Bool) : Void {
+        command(DEPTH_MASK, 1, 0);
+        b(flag);
+    }
+
+    public function cullFace(mode:Int) : Void {
+        command(CULL_FACE, 1, 0);
+        i(mode);
+    }
+
+    public function frontFace(mode:Int) : Void {
+        command(FRONT_FACE, 1, 0);
+        i(mode);
+    }
+
+    public function blendFunc(sfactor:Int, dfactor:Int) : Void {
+        command(BLEND_FUNC, 2, 0);
+        i(sfactor); i(dfactor);
+    }
+
+    public function blendFuncSeparate(srcRGB:Int, dstRGB:Int, srcAlpha:Int, dstAlpha:Int) : Void {
+        command(BLEND_FUNC_SEPARATE, 4, 0);
+        i(srcRGB); i(dstRGB); i(srcAlpha); i(dstAlpha);
+    }
+
+    public function blendEquation(mode:Int) : Void {
+        command(BLEND_EQUATION, 1, 0);
+        i(mode);
+    }
+
+    public function blendEquationSeparate(modeRGB:Int, modeAlpha:Int) : Void {
+        command(BLEND_EQUATION_SEPARATE, 2, 0);
+        i(modeRGB); i(modeAlpha);
+    }
+
+    public function blendColor(red:Float, green:Float, blue:Float, alpha:Float) : Void {
+        command(BLEND_COLOR, 0, 4);
+        f(red); f(green); f(blue); f(alpha);
+    }
+
+    public function stencilFunc(func:Int, ref:Int, mask:Int) : Void {
+        command(STENCIL_FUNC, 3, 0);
+        i(func); i(ref); i(mask);
+    }
+
+    public function stencilOp(fail:Int, zfail:Int, zpass:Int) : Void {
+        command(STENCIL_OP, 3, 0);
+        i(fail); i(zfail); i(zpass);
+    }
+
+    public function stencilMask(mask:Int) : Void {
+        command(STENCIL_MASK, 1, 0);
+        i(mask);
+    }
+
+    public function lineWidth(width:Float) : Void {
+        command(LINE_WIDTH, 0, 1);
+        f(width);
+    }
+
+    public function polygonOffset(factor:Float, units:Float) : Void {
+        command(POLYGON_OFFSET, 0, 2);
+        f(factor); f(units);
+    }
+
+    public function useProgram(program:GLProgram) : Void {
+        command(USE_PROGRAM, 1, 0);
+        i(program == null ? 0 : program.id);
+    }
+
+    public function bindBuffer(target:Int, buffer:GLBuffer) : Void {
+        command(BIND_BUFFER, 2, 0);
+        i(target); i(buffer == null ? 0 : buffer.id);
+    }
+
+    public function bindFramebuffer(target:Int, framebuffer:GLFramebuffer) : Void {
+        command(BIND_FRAMEBUFFER, 2, 0);
+        i(target); i(framebuffer == null ? 0 : framebuffer.id);
+    }
+
+    public function bindRenderbuffer(target:Int, renderbuffer:GLRenderbuffer) : Void {
+        command(BIND_RENDERBUFFER, 2, 0);
+        i(target); i(renderbuffer == null ? 0 : renderbuffer.id);
+    }
+
+    public function activeTexture(texture:Int) : Void {
+        command(ACTIVE_TEXTURE, 1, 0);
+        i(texture);
+    }
+
+    public function bindTexture(target:Int, texture:GLTexture) : Void {
+        command(BIND_TEXTURE, 2, 0);
+        i(target); i(texture == null ? 0 : texture.id);
+    }
+
+    public function texParameteri(target:Int, pname:Int, param:Int) : Void {
+        command(TEX_PARAMETERI, 3, 0);
+        i(target); i(pname); i(param);
+    }
+
+    public function pixelStorei(pname:Int, param:Int) : Void {
+        command(PIXEL_STOREI, 2, 0);
+        i(pname); i(param);
+    }
+
+    public function enableVertexAttribArray(index:Int) : Void {
+        command(ENABLE_VERTEX_ATTRIB_ARRAY, 1, 0);
+        i(index);
+    }
+
+    public function disableVertexAttribArray(index:Int) : Void {
+        command(DISABLE_VERTEX_ATTRIB_ARRAY, 1, 0);
+        i(index);
+    }
+
+    public function vertexAttribPointer(indx:Int, size:Int, type:Int, normalized:Bool, stride:Int, offset:Int) : Void {
+        command(VERTEX_ATTRIB_POINTER, 6, 0);
+        i(indx); i(size); i(type); b(normalized); i(stride); i(offset);
+    }
+
+    public function uniform1i(location:GLUniformLocation, x:Int) : Void {
+        command(UNIFORM1I, 2, 0);
+        loc(location); i(x);
+    }
+
+    public function uniform2i(location:GLUniformLocation, x:Int, y:Int) : Void {
+        command(UNIFORM2I, 3, 0);
+        loc(location); i(x); i(y);
+    }
+
+    public function uniform3i(location:GLUniformLocation, x:Int, y:Int, z:Int) : Void {
+        command(UNIFORM3I, 4, 0);
+        loc(location); i(x); i(y); i(z);
+    }
+
+    public function uniform4i(location:GLUniformLocation, x:Int, y:Int, z:Int, w:Int) : Void {
+        command(UNIFORM4I, 5, 0);
+        loc(location); i(x); i(y); i(z); i(w);
+    }
+
+    public function uniform1f(location:GLUniformLocation, x:Float) : Void {
+        command(UNIFORM1F, 1, 1);
+        loc(location); f(x);
+    }
+
+    public function uniform2f(location:GLUniformLocation, x:Float, y:Float) : Void {
+        command(UNIFORM2F, 1, 2);
+        loc(location); f(x); f(y);
+    }
+
+    public function uniform3f(location:GLUniformLocation, x:Float, y:Float, z:Float) : Void {
+        command(UNIFORM3F, 1, 3);
+        loc(location); f(x); f(y); f(z);
+    }
+
+    public function uniform4f(location:GLUniformLocation, x:Float, y:Float, z:Float, w:Float) : Void {
+        command(UNIFORM4F, 1, 4);
+        loc(location); f(x); f(y); f(z); f(w);
+    }
+
+    public function uniform1iv(location:GLUniformLocation, data:Int32Array) : Void uniform_iv(location, 1, data);
+    public function uniform2iv(location:GLUniformLocation, data:Int32Array) : Void uniform_iv(location, 2, data);
+    public function uniform3iv(location:GLUniformLocation, data:Int32Array) : Void uniform_iv(location, 3, data);
+    public function uniform4iv(location:GLUniformLocation, data:Int32Array) : Void uniform_iv(location, 4, data);
+
+    public function uniform1fv(location:GLUniformLocation, data:Float32Array) : Void uniform_fv(location, 1, data);
+    public function uniform2fv(location:GLUniformLocation, data:Float32Array) : Void uniform_fv(location, 2, data);
+    public function uniform3fv(location:GLUniformLocation, data:Float32Array) : Void uniform_fv(location, 3, data);
+    public function uniform4fv(location:GLUniformLocation, data:Float32Array) : Void uniform_fv(location, 4, data);
+
+    public function uniformMatrix2fv(location:GLUniformLocation, transpose:Bool, data:Float32Array) : Void uniform_matrix(location, transpose, 2, data);
+    public function uniformMatrix3fv(location:GLUniformLocation, transpose:Bool, data:Float32Array) : Void uniform_matrix(location, transpose, 3, data);
+    public function uniformMatrix4fv(location:GLUniformLocation, transpose:Bool, data:Float32Array) : Void uniform_matrix(location, transpose, 4, data);
+
+    public function drawArrays(mode:Int, first:Int, count:Int) : Void {
+        command(DRAW_ARRAYS, 3, 0);
+        i(mode); i(first); i(count);
+    }
+
+    public function drawElements(mode:Int, count:Int, type:Int, offset:Int) : Void {
+        command(DRAW_ELEMENTS, 4, 0);
+        i(mode); i(count); i(type); i(offset);
+    }
+
+//internal
+
+        //the array data is copied in now, so the caller is free to reuse it before submit
+    function uniform_iv( location:GLUniformLocation, size:Int, data:Int32Array ) {
+
+        var _count = Std.int(data.length / size);
+        var _elements = _count * size;
+
+        command(UNIFORM_IV, 3 + _elements, 0);
+        loc(location); i(size); i(_count);
+
+        for(_n in 0 ... _elements) i(data[_n]);
+
+    } //uniform_iv
+
+    function uniform_fv( location:GLUniformLocation, size:Int, data:Float32Array ) {
+
+        var _count = Std.int(data.length / size);
+        var _elements = _count * size;
+
+        command(UNIFORM_FV, 3, _elements);
+        loc(location); i(size); i(_count);
+
+        for(_n in 0 ... _elements) f(data[_n]);
+
+    } //uniform_fv
+
+    function uniform_matrix( location:GLUniformLocation, transpose:Bool, size:Int, data:Float32Array ) {
+
+        var _count = Std.int(data.length / (size * size));
+        var _elements = _count * size * size;
+
+        command(UNIFORM_MATRIX, 4, _elements);
+        loc(location); b(transpose); i(size); i(_count);
+
+        for(_n in 0 ... _elements) f(data[_n]);
+
+    } //uniform_matrix
+
+        //start a command with room for its arguments
+    inline function command( _op:Int, _ints:Int, _floats:Int ) {
+
+        if(int_count + 1 + _ints > ints.length) grow_ints(int_count + 1 + _ints);
+        if(float_count + _floats > floats.length) grow_floats(float_count + _floats);
+
+        ints[int_count++] = _op;
+        count++;
+
+    } //command
+
+    inline function i( _value:Int ) ints[int_count++] = _value;
+    inline function b( _value:Bool ) ints[int_count++] = _value ? 1 : 0;
+    inline function f( _value:Float ) floats[float_count++] = _value;
+        //a null location is -1, which gl ignores, like the direct calls
+    inline function loc( _location:GLUniformLocation ) ints[int_count++] = (_location == null) ? -1 : _location;
+
+    function grow_ints( _need:Int ) {
+
+        var _size = ints.length * 2;
+        while(_size < _need) _size *= 2;
+
+        var _next = new Int32Array(_size);
+        _next.buffer.blit(_next.byteOffset, ints.buffer, ints.byteOffset, int_count * 4);
+        ints = _next;
+
+    } //grow_ints
+
+    function grow_floats( _need:Int ) {
+
+        var _size = floats.length * 2;
+        while(_size < _need) _size *= 2;
+
+        var _next = new Float32Array(_size);
+        _next.buffer.blit(_next.byteOffset, floats.buffer, floats.byteOffset, float_count * 4);
+        floats = _next;
+
+    } //grow_floats
+
+    static var snow_gl_execute = Libs.load("snow", "snow_gl_execute", -1);
+
+} //GLCommands
@@ -0,0 +1,49 @@
+package snow.modules.opengl.native;
+
+import snow.modules.opengl.native.GL;
+
+import snow.api.Libs;
+
+/** Uniform and attribute locations by interned name id instead of by string.
+    Natively each program's active uniforms and attributes are read once when it links,
+    so a lookup is an index into a table rather than a string across to the driver.
+    Intern the names once, with `name`, and keep the ids. Array uniforms are found as `name` and as `name[i]`.
+    A relink reads the locations again, and deleting the program drops them. */
+@:noCompletion
+class GLLocations {
+
+    static var names : Map<String, Int> = new Map();
+
+        /** The id of `_name`, the same for the same name across every program. */
+    public static function name( _name:String ) : Int {
+
+        var _id = names.get(_name);
+
+        if(_id == null) {
+            _id = snow_gl_intern_name(_name);
+            names.set(_name, _id);
+        }
+
+        return _id;
+
+    } //name
+
+        /** The location of the uniform with the name id `_name`, null when the program has no such active uniform, like `getUniformLocation`. */
+    public static inline function uniform( _program:GLProgram, _name:Int ) : GLUniformLocation {
+
+        return snow_gl_get_uniform_location_id(_program.id, _name);
+
+    } //uniform
+
+        /** The location of the attribute with the name id `_name`, -1 when the program has no such active attribute, like `getAttribLocation`. */
+    public static inline function attrib( _program:GLProgram, _name:Int ) : Int {
+
+        return snow_gl_get_attrib_location_id(_program.id, _name);
+
+    } //attrib
+
+    static var snow_gl_intern_name                  = Libs.load("snow", "snow_gl_intern_name", 1);
+    static var snow_gl_get_uniform_location_id      = Libs.load("snow", "snow_gl_get_uniform_location_id", 2);
+    static var snow_gl_get_attrib_location_id       = Libs.load("snow", "snow_gl_get_attrib_location_id", 2);
+
+} //GLLocations
@@ -0,0 +1,128 @@
+package snow.modules.opengl.native;
+
+import snow.system.window.Window;
+import snow.modules.opengl.native.GLCommands;
+
+import snow.api.Libs;
+
+/** A native thread that owns the gl context of one window, and draws the frames recorded into its `commands`,
+    swapping after each one, while the main thread goes on to the next frame. See `config.native.render_thread`.
+    At most two frames are in flight, a submit waits for the older one to be drawn before handing over a third.
+    While it runs the context is not current on the main thread, so direct `GL` calls must go inside `sync`,
+    or between `acquire` and `release`. The native readbacks, like `readPixels` and `getError`, do this for themselves.
+    Desktop only, on mobile `start` returns false. */
+@:noCompletion
+class GLRenderThread {
+
+        /** The window the render thread is drawing, or null if it isn't running. read only */
+    public static var window (default, null) : Window;
+
+        /** Hand the context of the window to a new render thread, and give the window a `commands` stream to record into.
+            Returns false if the thread is already running, or can't run here. */
+    public static function start( _window:Window ) : Bool {
+
+        if(window != null || _window == null || _window.handle == null) return false;
+
+        #if mobile
+            return false;
+        #else
+
+            if(!snow_gl_render_thread_start(_window.handle)) return false;
+
+            if(_window.commands == null) {
+                _window.commands = new GLCommands();
+            }
+
+            window = _window;
+
+            return true;
+
+        #end
+
+    } //start
+
+        /** Draw the frames already submitted, end the thread and take the context back on the main thread.
+            Anything recorded but not submitted is issued right away, now that the context is here,
+            and the window goes back to drawing directly, without `commands`. */
+    public static function stop() : Void {
+
+        if(window == null) return;
+
+        snow_gl_render_thread_stop();
+
+        window.commands.submit();
+        window.commands = null;
+        window = null;
+
+    } //stop
+
+        /** Whether the render thread is running */
+    public static function active() : Bool {
+
+        return snow_gl_render_thread_active();
+
+    } //active
+
+        /** Hand the recorded commands to the render thread, and start recording again.
+            The commands are copied, so the streams can be refilled right away. */
+    public static function submit( _commands:GLCommands, ?_swap:Bool = false ) : Void {
+
+        if(window == null || _commands.count == 0 && !_swap) return;
+
+        snow_gl_render_thread_submit(
+            _commands.ints.buffer.getData(), _commands.ints.byteOffset, _commands.int_count * 4,
+            _commands.floats.buffer.getData(), _commands.floats.byteOffset, _commands.float_count * 4,
+            _commands.count, _swap
+        );
+
+        _commands.reset();
+
+    } //submit
+
+        /** Wait until every submitted frame has been drawn. */
+    public static function finish() : Void {
+
+        snow_gl_render_thread_finish();
+
+    } //finish
+
+        /** Make the context current on the main thread, once the submitted frames are drawn.
+            Nests, the render thread gets the context back at the matching `release`. */
+    public static function acquire() : Void {
+
+        snow_gl_render_thread_acquire();
+
+    } //acquire
+
+        /** Give the context back to the render thread, see `acquire`. */
+    public static function release() : Void {
+
+        snow_gl_render_thread_release();
+
+    } //release
+
+        /** Call `_fn` with the context current on the main thread, for direct `GL` calls while the render thread runs. */
+    public static function sync( _fn:Void->Void ) : Void {
+
+        acquire();
+
+        try {
+            _fn();
+        } catch(e:Dynamic) {
+            release();
+            throw e;
+        }
+
+        release();
+
+    } //sync
+
+    static var snow_gl_render_thread_start      = Libs.load("snow", "snow_gl_render_thread_start", 1);
+    static var snow_gl_render_thread_stop       = Libs.load("snow", "snow_gl_render_thread_stop", 0);
+    static var snow_gl_render_thread_active     = Libs.load("snow", "snow_gl_render_thread_active", 0);
+    static var snow_gl_render_thread_submit     = Libs.load("snow", "snow_gl_render_thread_submit", -1);
+    static var snow_gl_render_thread_finish     = Libs.load("snow", "snow_gl_render_thread_finish", 0);
+    static var snow_gl_render_thread_acquire    = Libs.load("snow", "snow_gl_render_thread_acquire", 0);
+    static var snow_gl_render_thread_release    = Libs.load("snow", "snow_gl_render_thread_release", 0);
+
+} //GLRenderThread
@@ -0,0 +1,54 @@
+package snow.modules.opengl.native;
+
+import snow.modules.opengl.native.GL;
+
+import snow.api.Libs;
+
+/** The native shadow of the gl state that's set most, which drops the calls setting it to what it already is,
+    before they reach the driver. See `config.native.gl_state_cache`.
+    It tracks the current program, the array and element array buffers, the active texture unit and its 2d and cube map textures,
+    the common caps, blend, depth, cull and the viewport, as set through `GL` and `GLCommands`.
+    The direct externs (`snow_render_gl_native`) and other native code go around it, call `invalidate` after using them. */
+@:noCompletion
+class GLState {
+
+        /** Turn the shadow on or off, either way it starts over knowing nothing. */
+    public static function enable( _enable:Bool ) : Void {
+
+        snow_gl_state_cache(_enable);
+
+    } //enable
+
+        /** Whether the shadow is on */
+    public static function enabled() : Bool {
+
+        return snow_gl_state_cache_enabled();
+
+    } //enabled
+
+        /** Forget the shadowed state, so the next call of each kind reaches gl.
+            Needed after gl state was changed around `GL`. */
+    public static function invalidate() : Void {
+
+        snow_gl_state_invalidate();
+
+    } //invalidate
+
+        /** The calls the shadow passed on and the ones it dropped, in the last frame. */
+    public static function stats() : GLStateStats {
+
+        var _counters : Array<Int> = snow_gl_state_counters();
+
+        return {
+            issued : _counters[0],
+            skipped : _counters[1]
+        };
+
+    } //stats
+
+    static var snow_gl_state_cache              = Libs.load("snow", "snow_gl_state_cache", 1);
+    static var snow_gl_state_cache_enabled      = Libs.load("snow", "snow_gl_state_cache_enabled", 0);
+    static var snow_gl_state_invalidate         = Libs.load("snow", "snow_gl_state_invalidate", 0);
+    static var snow_gl_state_counters           = Libs.load("snow", "snow_gl_state_counters", 0);
+
+} //GLState
@@ -0,0 +1,96 @@
+package snow.modules.opengl.native;
+
+import snow.modules.opengl.native.GL;
+import snow.api.buffers.ArrayBufferView;
+import snow.api.buffers.Float32Array;
+
+import snow.api.Libs;
+
+/** A gl buffer for geometry that's rewritten every frame, like sprite and particle batches,
+    uploaded without waiting on the gpu to finish drawing from the last frames.
+    Natively it's a ring of three segments of `size` bytes, written through unsynchronized mapped ranges,
+    with a fence after each segment. On gles2, which can't map buffers, it orphans the storage when it fills instead.
+    Write the vertices into `view`, then `commit` the range written, and draw from the offset returned.
+    Call `next` once a frame, after the draws, so the next frame writes to a segment the gpu is done with.
+    Every call goes to gl right away, so while a `GLRenderThread` runs, the frame's stream buffer work has to
+    happen between `GLRenderThread.acquire` and `release` (or inside `sync`), drawing with direct `GL` calls
+    rather than recording into `window.commands`, which would draw after the fence `next` places.
+    Outside of that, the calls log and fail: `commit` and `upload` return -1, and `next` and `destroy` return false. */
+@:noCompletion
+class GLStreamBuffer {
+
+        /** The gl buffer, bound to `target` after each commit. read only */
+    public var buffer (default, null) : GLBuffer;
+        /** The gl target the buffer is for, `GL.ARRAY_BUFFER` or `GL.ELEMENT_ARRAY_BUFFER`. read only */
+    public var target (default, null) : Int;
+        /** The size of a segment in bytes, the most that fits in a frame. read only */
+    public var size (default, null) : Int;
+        /** Somewhere to write the vertices of a frame, a segment in size.
+            A commit copies the range from here straight into the mapped buffer. */
+    public var view (default, null) : Float32Array;
+
+    var handle : Dynamic;
+
+        /** A stream buffer of segments of `_size` bytes, rounded up to a whole number of floats. */
+    public function new( _target:Int, _size:Int, ?_usage:Int = GL.STREAM_DRAW ) {
+
+        target = _target;
+        size = (_size + 3) & ~3;
+        view = new Float32Array(Std.int(size / 4));
+
+        handle = snow_gl_stream_create(target, size, _usage);
+
+        if(handle == null) {
+            throw 'GLStreamBuffer / could not create a stream buffer of $size bytes';
+        }
+
+        buffer = new GLBuffer(snow_gl_stream_buffer(handle));
+
+    } //new
+
+        /** Upload `_count` floats of `view` from `_start`, returning the byte offset in `buffer` they start at,
+            for `vertexAttribPointer` or `drawElements`, or -1 when they didn't fit or aren't all within `view`. */
+    public function commit( _start:Int, _count:Int ) : Int {
+
+        if(_count <= 0 || _start < 0 || _count > view.length - _start) return -1;
+
+        return snow_gl_stream_write(handle, view.buffer.getData(), view.byteOffset + _start * 4, _count * 4);
+
+    } //commit
+
+        /** Upload the bytes of any typed array, like `commit` but from outside `view`. */
+    public function upload( _data:ArrayBufferView ) : Int {
+
+        return snow_gl_stream_write(handle, _data.buffer.getData(), _data.byteOffset, _data.byteLength);
+
+    } //upload
+
+        /** End the frame for this buffer, the next commit starts on the next segment.
+            Returns false if the fence couldn't be placed, without the context (see above). */
+    public function next() : Bool {
+
+        return snow_gl_stream_next(handle);
+
+    } //next
+
+        /** Delete the buffer and its fences. Returns false, leaving it as it was, without the context (see above). */
+    public function destroy() : Bool {
+
+        if(handle == null) return true;
+
+        if(!snow_gl_stream_destroy(handle)) return false;
+
+        handle = null;
+        buffer.invalidated = true;
+
+        return true;
+
+    } //destroy
+
+    static var snow_gl_stream_create            = Libs.load("snow", "snow_gl_stream_create", 3);
+    static var snow_gl_stream_destroy           = Libs.load("snow", "snow_gl_stream_destroy", 1);
+    static var snow_gl_stream_buffer            = Libs.load("snow", "snow_gl_stream_buffer", 1);
+    static var snow_gl_stream_write             = Libs.load("snow", "snow_gl_stream_write", 4);
+    static var snow_gl_stream_next              = Libs.load("snow", "snow_gl_stream_next", 1);
+
+} //GLStreamBuffer
@@ -45,8 +45,10 @@ class Audio {
 //Public API
 
 
-        /** Create a sound for playing. If no name is given, a unique id is assigned. Use the sound instance or the public api by name. */
-    public function create( _id:String, ?_name:String = '', ?_streaming:Bool = false ) : Promise {
+        /** Create a sound for playing. If no name is given, a unique id is assigned. Use the sound instance or the public api by name.
+            The format is taken from the file extension unless given, such as AudioFormatType.adpcm for a wav to keep compressed.
+            The module may stream a sound that wasn't asked to, check `is_stream` on the sound. */
+    public function create( _id:String, ?_name:String = '', ?_streaming:Bool = false, ?_format:AudioFormatType ) : Promise {
 
         if(_name == '') _name = app.uniqueid;
 
@@ -54,13 +56,13 @@ class Audio {
 
         return new Promise(function(resolve, reject) {
 
-            var _create = module.create_sound(_id, _name, _streaming);
+            var _create = module.create_sound(_id, _name, _streaming, _format);
 
             _create.then(function(_sound:Sound) {
 
                 sound_list.set(_name, _sound);
 
-                if(_streaming) stream_list.set(_name, _sound);
+                if(_sound.is_stream) stream_list.set(_name, _sound);
 
                 resolve(_sound);
 
@@ -2,6 +2,7 @@ package snow.system.audio;
 
 import snow.system.audio.Audio;
 import snow.types.Types;
+import snow.api.buffers.Uint8Array;
 import snow.api.Debug.*;
 
 
@@ -27,6 +28,8 @@ class Sound {
     @:isVar public var volume   (get,set) : Float = 1.0;
         /** The pan of this sound. Pan only logically works on mono sounds, and is by default 2D sounds  */
     @:isVar public var pan      (get,set) : Float = 0.0;
+        /** How much this sound matters against others that are as loud, when the audio module has fewer voices than sounds playing. default:1 */
+    @:isVar public var priority (get,set) : Float = 1.0;
         /** If the sound is looping or not. Use `loop()` to change this. */
     @:isVar public var looping  (get,set) : Bool = false;
         /** The current playback position of this sound in `seconds` */
@@ -52,6 +55,17 @@ class Sound {
     public var stream_data_get : Int->Int->AudioDataBlob;
         /** `Stream only`: The seek function, assign a function here only if you want to stream data to the source manually, like generative sound. */
     public var stream_data_seek : Int->Bool;
+        /** `Stream only`: The reusable buffer the default `stream_data_get` decodes into.
+            The blob it returns, and its bytes, are reused and only valid until the next call. */
+    public var stream_data : Uint8Array;
+        //the blob the default `stream_data_get` returns, refilled on each call
+    var stream_blob : AudioDataBlob;
+        /** `Stream only`: The sample frame a looping stream goes back to when it reaches `loop_end`.
+            Set from the `LOOPSTART` comment of ogg files. default: `0` */
+    @:isVar public var loop_start (get, set) : Int = 0;
+        /** `Stream only`: The sample frame a looping stream wraps at, where `0` is the end of the data.
+            Set from the `LOOPSTART` and `LOOPLENGTH` comments of ogg files. default: `0` */
+    @:isVar public var loop_end (get, set) : Int = 0;
 #end //snow_native
 
 //
@@ -148,10 +162,20 @@ class Sound {
 
     } //default_data_seek
 
-        /** Default data get implementation for `SoundStream` uses `assets.system.audio_load_portion` */
+        /** Default data get implementation for `SoundStream` uses `assets.system.audio_load_portion_into`,
+            decoding into `stream_data` so that no buffer is allocated per refill. */
     function default_stream_data_get( _start:Int, _length:Int ) : AudioDataBlob {
 
-        return system.app.assets.module.audio_load_portion( info, _start, _length );
+            //sized to the refill exactly, so a full read hands back stream_data itself rather than a view
+        if(stream_data == null || stream_data.length != _length) {
+            stream_data = new Uint8Array(_length);
+        }
+
+        if(stream_blob == null) {
+            stream_blob = { bytes:null, complete:false };
+        }
+
+        return system.app.assets.module.audio_load_portion_into( info, _start, _length, stream_data, 0, stream_blob );
 
     } //default_data_get
 
@@ -168,6 +192,7 @@ class Sound {
     function get_pitch() : Float return pitch;
     function get_volume() : Float return volume;
     function get_looping() : Bool return looping;
+    function get_priority() : Float return priority;
     function get_position() : Float return position;
     function get_position_bytes() : Int return position_bytes;
     function get_length_bytes() : Int return length_bytes;
@@ -181,6 +206,13 @@ class Sound {
     function set_volume( _volume:Float ) : Float return volume = _volume;
     function set_position( _position:Float ) : Float return position = _position;
     function set_looping( _looping:Bool ) : Bool return looping = _looping;
+    function set_priority( _priority:Float ) : Float return priority = _priority;
     function set_position_bytes(_position_bytes) : Int return position_bytes = _position_bytes;
+#if snow_native
+    function get_loop_start() : Int return loop_start;
+    function get_loop_end() : Int return loop_end;
+    function set_loop_start( _loop_start:Int ) : Int return loop_start = _loop_start;
+    function set_loop_end( _loop_end:Int ) : Int return loop_end = _loop_end;
+#end //snow_native
 
 } //Sound
@@ -52,6 +52,12 @@ class Window {
     public var auto_swap : Bool = true;
         /** set this if you want to control when a window calls render() */
     public var auto_render : Bool = true;
+
+    #if snow_native
+        /** While a render thread draws this window, the gl calls of a frame are recorded here,
+            and handed to the thread at swap(). null otherwise. see `config.native.render_thread` */
+    public var commands : snow.modules.opengl.native.GLCommands;
+    #end
         /** A flag for whether this window is open or closed */
     public var closed : Bool = true;
 
@@ -213,6 +219,21 @@ class Window {
 
         } //has render handler
 
+        #if snow_native
+            if(commands != null) {
+
+                commands.clearColor( 0, 0, 0, 1.0 );
+                commands.clear(GL.COLOR_BUFFER_BIT);
+
+                if(auto_swap) {
+                    swap();
+                }
+
+                return;
+
+            } //render thread
+        #end
+
         GL.clearColor( 0, 0, 0, 1.0 );
         GL.clear(GL.COLOR_BUFFER_BIT);
 
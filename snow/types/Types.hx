@@ -135,6 +135,50 @@ typedef AppConfigNative = {
         /** The default number of audio buffers to use for a single stream. Set no less than 2, as it's a queue. See `Audio` docs. default:4 */
     @:optional var audio_buffer_count : Int;
 
+        /** Whether ogg audio should decode to 32 bit float samples, when the audio module can play them. default:false */
+    @:optional var audio_decode_float : Bool;
+
+        /** Whether sounds that aren't streamed are converted once at load to the device rate, with 8 bit samples widened to 16 bit.
+            This resamples once up front instead of on every mix. default:false */
+    @:optional var audio_convert : Bool;
+
+        /** Whether stereo sounds that aren't streamed are downmixed to mono at load. default:false */
+    @:optional var audio_downmix : Bool;
+
+        /** The byte budget for caching decoded audio files, so creating the same sound again skips decoding. 0 disables the cache. Cleared on low memory. default:33554432 (32MB) */
+    @:optional var audio_cache_budget : Int;
+
+        /** Whether streamed sounds keep their buffer queue full from a native thread, instead of from haxe each frame.
+            This keeps streams playing through main thread stalls. Sounds with custom `stream_data_get` functions are always streamed from haxe. default:true */
+    @:optional var audio_stream_native : Bool;
+
+        /** Whether streamed ogg sounds keep the compressed file in memory and decode from there, instead of reading from disk on each refill.
+            Sounds streaming the same file share one copy of the bytes, each decoding from its own position.
+            Compressed music is around a tenth the size of its pcm, and needs no disk access while it plays. default:false */
+    @:optional var audio_stream_memory : Bool;
+
+        /** The number of sources shared by sounds that aren't streamed, where the audio module supports it.
+            More sounds than this can play, and the ones with the lowest priority × audibility are virtual:
+            silent, but keeping time until they are loud enough to be given a source again. 0 gives each sound its own source. default:64 */
+    @:optional var audio_voices : Int;
+
+        /** Whether sounds that aren't streamed play through a native software mixer, where the audio module has one.
+            The mixer mixes every such sound on its own thread into one source, so hundreds of short overlapping effects
+            cost one voice of the device between them. Mixed sounds have gain, pan and pitch, but aren't positioned in 3D,
+            and take the place of `audio_voices` for the sounds they play. default:false */
+    @:optional var audio_mixer : Bool;
+
+        /** Whether the default window is drawn from a native render thread, on desktop.
+            After ready, the thread owns the gl context and `window.commands` records the gl calls of each frame,
+            which the thread draws while the next frame updates. Direct `GL` calls need `GLRenderThread.sync` from then on.
+            see `snow.modules.opengl.native.GLRenderThread`. default:false */
+    @:optional var render_thread : Bool;
+
+        /** Whether the native gl bindings keep a shadow of the state set most, and drop the calls that wouldn't change it.
+            Gl used around the bindings, by other native code or the direct externs, needs `GLState.invalidate` after.
+            see `snow.modules.opengl.native.GLState`. default:false */
+    @:optional var gl_state_cache : Bool;
+
 } //AppConfigNative
 
 typedef FileFilter = {
@@ -176,9 +220,24 @@ typedef ImageInfo = {
     var ogg      = 1;
     var wav      = 2;
     var pcm      = 3;
+        /** IMA-ADPCM wav, kept compressed in memory. 16 bit pcm wav files are encoded when loaded as this. */
+    var adpcm    = 4;
 
 } //AudioFormatType
 
+/** The format of the samples in decoded audio data */
+@:enum abstract AudioSampleFormat(Null<Int>) from Null<Int> to Null<Int> {
+
+    var unknown  = 0;
+        /** unsigned 8 bit integer */
+    var u8       = 1;
+        /** signed 16 bit integer */
+    var s16      = 2;
+        /** 32 bit float, -1 to 1 */
+    var f32      = 3;
+
+} //AudioSampleFormat
+
 
     /** The platform specific implementation detail about the audio data */
 typedef AudioDataInfo = {
@@ -193,8 +252,16 @@ typedef AudioDataInfo = {
     var rate : Int;
         /** sound bitrate */
     var bitrate : Int;
-        /** bits per sample, 8 / 16 */
+        /** bits per sample, 8 / 16 / 32 */
     var bits_per_sample : Int;
+        /** the format of each sample in `samples`. Use AudioSampleFormat */
+    @:optional var sample_format : AudioSampleFormat;
+        /** true if the source is memory mapped from the file, where audio modules can read the pcm directly */
+    @:optional var mapped : Bool;
+        /** the sample frame a loop starts at, from the `LOOPSTART` comment of ogg files */
+    @:optional var loop_start : Int;
+        /** the sample frames a loop lasts, from the `LOOPLENGTH` comment of ogg files */
+    @:optional var loop_length : Int;
         /** sound raw data */
     var samples : Uint8Array;
 
@@ -224,6 +291,80 @@ typedef AudioDataBlob = {
 
 } //AudioDataBlob
 
+/** Counters for the native decoded audio cache, see `Assets.audio_cache_stats` */
+typedef AudioCacheStats = {
+
+        /** The number of loads served from the cache */
+    var hits : Int;
+        /** The number of loads that had to decode the file */
+    var misses : Int;
+        /** The number of entries dropped to stay within the budget */
+    var evictions : Int;
+        /** The number of sounds currently cached */
+    var entries : Int;
+        /** The bytes of decoded samples currently cached */
+    var bytes : Int;
+        /** The maximum bytes of decoded samples kept */
+    var budget : Int;
+
+} //AudioCacheStats
+
+/** The compressed files held in memory for streaming, see `Assets.audio_resident_stats` */
+typedef AudioResidentStats = {
+
+        /** The number of files in memory */
+    var entries : Int;
+        /** The compressed bytes they hold between them */
+    var bytes : Int;
+
+} //AudioResidentStats
+
+/** Counters for the voices shared by sounds, see `config.native.audio_voices` */
+typedef AudioVoiceStats = {
+
+        /** The number of sources the voices share */
+    var sources : Int;
+        /** The playing sounds holding a source */
+    var real : Int;
+        /** The playing sounds without a source, keeping time silently */
+    var virtual : Int;
+        /** The number of times a sound lost its source to a louder one */
+    var stolen : Int;
+
+} //AudioVoiceStats
+
+/** Counters for the native software mixer, see `config.native.audio_mixer` */
+typedef AudioMixerStats = {
+
+        /** The number of mixed sounds that exist */
+    var voices : Int;
+        /** The sounds mixed into the last block */
+    var mixed : Int;
+        /** The number of times the mixer output ran dry before it was refilled */
+    var underruns : Int;
+        /** The time the last block took to mix, as a fraction of the time it plays for */
+    var load : Float;
+
+} //AudioMixerStats
+
+/** Counters for the buffers shared by sounds made from the same asset */
+typedef AudioBufferShareStats = {
+
+        /** The number of shared buffers */
+    var buffers : Int;
+        /** The sounds holding a reference to one of them */
+    var references : Int;
+        /** The bytes of pcm the shared buffers hold */
+    var resident : Float;
+        /** The bytes the references beyond the first to each buffer would otherwise have cost */
+    var deduplicated : Float;
+        /** The sounds that found their buffer already filled */
+    var hits : Int;
+        /** The sounds that had to fill their buffer */
+    var misses : Int;
+
+} //AudioBufferShareStats
+
 
 /** Config specific to the rendering context that would be used when creating windows */
 typedef RenderConfig = {